@@ -7,7 +7,6 @@
  */
 #include "DeviceView.h"
 #include "Core/LoggerHolder.h"
-#include "ProtocolProcessorBase.h"
 #include "RGBControllerKeyNames.h"
 
 #include <QPainter>
@@ -31,8 +30,7 @@ namespace LenovoLegionGui {
 DeviceView::DeviceView(QWidget *parent) :
     QWidget(parent),
     initSize(128,128),
-    mouseDown(false),
-    m_timerId(-1)
+    mouseDown(false)
 {
     controller = NULL;
     numerical_labels = false;
@@ -41,7 +39,6 @@ DeviceView::DeviceView(QWidget *parent) :
 
     size = width();
 
-    m_timerId = startTimer(50);
     m_keyboardBackgroundImage = "keyboard-background.png";
 }
 
@@ -640,11 +637,7 @@ void DeviceView::markLeds(const  QMap<int,QColor> &leds)
 
 void DeviceView::cleanup()
 {
-    if(m_timerId != -1)
-    {
-        killTimer(m_timerId);
-        m_timerId = -1;
-    }
+    led_colors.clear();
 }
 
 QSize DeviceView::sizeHint () const
@@ -922,17 +915,12 @@ void DeviceView::paintEvent(QPaintEvent* /* event */)
     }
 }
 
-void DeviceView::timerEvent(QTimerEvent *)
+void DeviceView::refreshLedColors()
 {
-    try {
-        if(controller && isVisible())
-        {
-            led_colors = controller->GetStateForAllLeds();
-            update();
-        }
-    } catch(const ProtocolProcessorBase::exception_T &ex)
+    if(controller)
     {
-        LOG_W(QString::asprintf("DeviceView: Caught exception while updating LED colors: %s", ex.what()));
+        led_colors = controller->GetStateForAllLeds();
+        update();
     }
 }
 
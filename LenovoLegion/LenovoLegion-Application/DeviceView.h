@@ -36,6 +36,11 @@ public:
     void markLeds(const QMap<int,QColor> &leds);
     void cleanup();
 
+    /*
+     * LED colors are taken from controller, called when daemon notifies a change
+     */
+    void refreshLedColors();
+
 protected:
     void mousePressEvent(QMouseEvent *event)    override;
     void mouseMoveEvent(QMouseEvent *event)     override;
@@ -43,8 +48,6 @@ protected:
     void resizeEvent(QResizeEvent *event)       override;
     void paintEvent(QPaintEvent *)              override;
 
-    void timerEvent(QTimerEvent *event) override;
-
 private:
     QSize initSize;
     bool mouseDown;
@@ -74,8 +77,6 @@ private:
 
     LenovoLegionDaemon::RGBControllerInterface* controller;
 
-    int                                 m_timerId;
-
     QColor posColor(const QPoint &point);
     void InitDeviceView();
     void updateSelection();
@@ -127,8 +127,6 @@ HWMonitoring::HWMonitoring(DataProvider *dataProvider,QWidget *parent)
     connect(m_windowFreqInfoByCore,&CPUFrequency::closed,this,&HWMonitoring::freqInfoByCoreClosed);
     connect(m_windowGPUDetails,&GPUDetails::closed,this,&HWMonitoring::gpuDetailsClosed);
 
-
-    m_timerId = startTimer(TIMER_EVENT_IN_MS);
 }
 
 void HWMonitoring::refresh()
@@ -308,7 +306,10 @@ void HWMonitoring::refresh()
 
 HWMonitoring::~HWMonitoring()
 {
-    killTimer(m_timerId);
+    if(m_timerId != -1)
+    {
+        killTimer(m_timerId);
+    }
 
     delete m_windowFreqInfoByCore;
     delete m_windowGPUDetails;
@@ -320,6 +321,28 @@ void HWMonitoring::timerEvent(QTimerEvent *)
     refresh();
 }
 
+void HWMonitoring::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    if(m_timerId == -1)
+    {
+        refresh();
+        m_timerId = startTimer(TIMER_EVENT_IN_MS);
+    }
+}
+
+void HWMonitoring::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+
+    if(m_timerId != -1)
+    {
+        killTimer(m_timerId);
+        m_timerId = -1;
+    }
+}
+
 void HWMonitoring::forAllCpuPerformanceCores(const std::function<bool (const int)> &func)
 {
     Utils::ProtoBuf::forAllCpuTopologyRange(func,m_cpuTopology.active_cpus_core());
@@ -47,6 +47,12 @@ public:
 
     virtual void timerEvent(QTimerEvent *event) override;
 
+    /*
+     * Polling runs only while the widget is visible
+     */
+    virtual void showEvent(QShowEvent *event) override;
+    virtual void hideEvent(QHideEvent *event) override;
+
     void refresh();
 
 private slots:
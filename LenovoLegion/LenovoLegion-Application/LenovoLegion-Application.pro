@@ -94,6 +94,7 @@ HEADERS +=          \
 
 HEADERS += \
         ../LenovoLegion-Daemon/ProtocolParser.h \
+        ../LenovoLegion-Daemon/RGBControllerIndex.h \
         ../LenovoLegion-PrepareBuild/HWMonitoring.pb.h \
         ../LenovoLegion-PrepareBuild/CPUTopology.pb.h \
         ../LenovoLegion-PrepareBuild/PowerProfile.pb.h \
@@ -108,12 +109,14 @@ HEADERS += \
         ../LenovoLegion-PrepareBuild/NvidiaNvml.pb.h \
         ../LenovoLegion-PrepareBuild/ComputerInfo.pb.h \
         ../LenovoLegion-PrepareBuild/DaemonSettings.pb.h \
+        ../LenovoLegion-PrepareBuild/Profiles.pb.h \
         ../LenovoLegion-PrepareBuild/Other.pb.h \
         ../LenovoLegion-PrepareBuild/RGBController.pb.h \
         ../LenovoLegion-PrepareBuild/MessageRegistry.pb.h
 
 SOURCES += \
         ../LenovoLegion-Daemon/ProtocolParser.cpp \
+        ../LenovoLegion-Daemon/RGBControllerIndex.cpp \
         ../LenovoLegion-PrepareBuild/HWMonitoring.pb.cc \
         ../LenovoLegion-PrepareBuild/CPUTopology.pb.cc \
         ../LenovoLegion-PrepareBuild/PowerProfile.pb.cc \
@@ -128,6 +131,7 @@ SOURCES += \
         ../LenovoLegion-PrepareBuild/NvidiaNvml.pb.cc \
         ../LenovoLegion-PrepareBuild/ComputerInfo.pb.cc \
         ../LenovoLegion-PrepareBuild/DaemonSettings.pb.cc \
+        ../LenovoLegion-PrepareBuild/Profiles.pb.cc \
         ../LenovoLegion-PrepareBuild/Other.pb.cc \
         ../LenovoLegion-PrepareBuild/RGBController.pb.cc \
         ../LenovoLegion-PrepareBuild/MessageRegistry.pb.cc
@@ -196,6 +196,12 @@ void RGBController::readRGBControllerData(const uint32_t requestFlags)
         }
     }
 
+    if(requestFlags & (legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_LEDS |
+                       legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_MODES))
+    {
+        m_index = LenovoLegionDaemon::RGBControllerIndex(m_leds,m_modes);
+    }
+
     if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_DEVICE_INFO)
     {
         m_name        = rgbControllerData.has_device_info() && rgbControllerData.device_info().has_name() ? rgbControllerData.device_info().name().data() : "";
@@ -207,6 +213,12 @@ void RGBController::readRGBControllerData(const uint32_t requestFlags)
         m_vendorId    = rgbControllerData.has_device_info() && rgbControllerData.device_info().vendor_id() ? rgbControllerData.device_info().vendor_id() : 0;
     }
 
+    if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_STATE_FOR_ALL_LEDS)
+    {
+        m_ledState.assign(rgbControllerData.colors().begin(),rgbControllerData.colors().end());
+        m_ledStateVersion = rgbControllerData.led_state_version();
+    }
+
     if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_LOGO_STATUS)
     {
         m_logoState = false;
@@ -351,15 +363,13 @@ LenovoLegionDaemon::mode RGBController::GetModeByIdx(unsigned int mode) const
 
 LenovoLegionDaemon::mode RGBController::GetModeByModeValue(int mode) const
 {
-    for (const auto & m : m_modes)
+    const std::optional<size_t> idx = m_index.modeByValue(mode);
+
+    if(!idx)
     {
-        if(m.value == mode)
-        {
-            return m;
-        }
+        return {};
     }
-
-    return {};
+    return m_modes[*idx];
 }
 
 std::string RGBController::GetZoneName(unsigned int zone) const
@@ -402,41 +412,14 @@ const std::vector<LenovoLegionDaemon::mode>& RGBController::GetModes() const
     return m_modes;
 }
 
-std::set<int> RGBController::GetLedsIndexesByDeviceSpecificValue(unsigned int value) const
+std::span<const int> RGBController::GetLedsIndexesByDeviceSpecificValue(unsigned int value) const
 {
-    return (std::set<int>)[&]() {
-
-        std::set<int> indices;
-
-        for (size_t i = 0; i < m_leds.size(); i++)
-        {
-            if (m_leds[i].value == value)
-            {
-                indices.insert(i);
-            }
-        }
-        return indices;
-    }();
+    return m_index.ledsByValue(value);
 }
 
 std::vector<LenovoLegionDaemon::RGBColor> RGBController::GetStateForAllLeds() const
 {
-    legion::messages::RGBControllerResponse rgbControllerData = m_dataProvider->getDataMessage<legion::messages::RGBControllerResponse,legion::messages::RGBControllerRequest>(LenovoLegionDaemon::DataProviderRGBController::dataType,[]{
-        legion::messages::RGBControllerRequest request;
-        request.set_request_flags(legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_STATE_FOR_ALL_LEDS);
-
-        return request;
-    }());
-
-
-    std::vector<LenovoLegionDaemon::RGBColor> colors;
-
-    for(int i = 0; i < rgbControllerData.colors_size(); i++)
-    {
-        colors.push_back(rgbControllerData.colors(i));
-    }
-
-    return colors;
+    return m_ledState;
 }
 
 bool RGBController::HasLogo() const
@@ -563,6 +546,42 @@ void RGBController::ApplyPendingChanges()
     sendRGBControllerData();
 }
 
+void RGBController::ApplyLedStateDiff(const legion::messages::Notification::LedStateDiff &diff)
+{
+    /*
+     * Already contained in state read after diff was sent
+     */
+    if(diff.version() <= m_ledStateVersion)
+    {
+        return;
+    }
+
+    if(diff.full())
+    {
+        m_ledState.assign(diff.colors().begin(),diff.colors().end());
+        m_ledStateVersion = diff.version();
+        return;
+    }
+
+    if(diff.version() != m_ledStateVersion + 1 || diff.indexes_size() != diff.colors_size())
+    {
+        LOG_D(QString("RGBController: LED state diff %1 does not follow %2, reading whole state").arg(diff.version()).arg(m_ledStateVersion));
+
+        readRGBControllerData(legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_STATE_FOR_ALL_LEDS);
+        return;
+    }
+
+    for(int i = 0; i < diff.indexes_size(); i++)
+    {
+        if(diff.indexes(i) < m_ledState.size())
+        {
+            m_ledState[diff.indexes(i)] = diff.colors(i);
+        }
+    }
+
+    m_ledStateVersion = diff.version();
+}
+
 void RGBController::RefreshData()
 {
     readRGBControllerData(legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_BRITNESS |
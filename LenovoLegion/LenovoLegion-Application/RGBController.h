@@ -10,6 +10,9 @@
 #include <Core/ExceptionBuilder.h>
 
 #include "../LenovoLegion-Daemon/RGBControllerInterface.h"
+#include "../LenovoLegion-Daemon/RGBControllerIndex.h"
+
+#include "../LenovoLegion-PrepareBuild/Notification.pb.h"
 
 #include <bitset>
 
@@ -95,11 +98,11 @@ public:
      */
     virtual const std::vector<LenovoLegionDaemon::led>&       GetLEDs()                         const              override;
     virtual std::string                                       GetLEDName(unsigned int led)      const              override;
-    virtual std::set<int>              GetLedsIndexesByDeviceSpecificValue(unsigned int value)  const              override;
+    virtual std::span<const int>       GetLedsIndexesByDeviceSpecificValue(unsigned int value)  const              override;
 
 
     /*
-     * Current states of leds
+     * Current states of leds, kept in sync by LED state notifications
      */
     virtual std::vector<LenovoLegionDaemon::RGBColor>         GetStateForAllLeds()              const              override;
 
@@ -119,6 +122,11 @@ public:
      */
     void RefreshData();
 
+    /*
+     * Applies notified diff, whole state is read again when a diff was missed
+     */
+    void ApplyLedStateDiff(const legion::messages::Notification::LedStateDiff& diff);
+
 
     /*
      * Device Information
@@ -142,6 +150,8 @@ private:
     std::vector<LenovoLegionDaemon::zone>       m_zones;
     std::vector<LenovoLegionDaemon::mode>       m_modes;
 
+    LenovoLegionDaemon::RGBControllerIndex      m_index;    /* Rebuilt when LEDs or modes are read */
+
     LenovoLegionDaemon::device_type   m_deviceType    = LenovoLegionDaemon::DEVICE_TYPE_UNKNOWN;
 
     LenovoLegionDaemon::Profiles                        m_profiles;
@@ -150,6 +160,9 @@ private:
 
     std::vector<LenovoLegionDaemon::led_group_effect>   m_effects;
 
+    std::vector<LenovoLegionDaemon::RGBColor>           m_ledState;
+    quint64                                             m_ledStateVersion = 0;
+
     std::bitset<MAXIMUM_CHANGES>            m_pendingChanges;
 
     /*
@@ -111,6 +111,8 @@ RGBKeyboardDevice::RGBKeyboardDevice(RGBController *dev, QWidget *parent) :
 
     connect(ui->DeviceViewBox, &DeviceView::selectionChanged, this, &RGBKeyboardDevice::on_DeviceViewBox_selectionChanged);
 
+    ui->DeviceViewBox->refreshLedColors();
+
     /*-----------------------------------------------------*\
      | The profile selection  box                           |
     \*-----------------------------------------------------*/
@@ -155,6 +157,12 @@ void RGBKeyboardDevice::dataProviderEvent(const legion::messages::Notification &
 {
     if(notification.has_action())
     {
+        if(notification.action() == legion::messages::Notification::RGB_LED_STATE_CHANGED && notification.has_led_state())
+        {
+            device->ApplyLedStateDiff(notification.led_state());
+            ui->DeviceViewBox->refreshLedColors();
+        }
+
         if(notification.action() == legion::messages::Notification::SPECIAL_KEY_PRESSED && notification.has_special_key())
         {
             switch (notification.special_key()) {
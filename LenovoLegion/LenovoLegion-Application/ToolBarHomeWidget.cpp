@@ -216,6 +216,15 @@ void ToolBarHomeWidget::dataProviderEvent(const legion::messages::Notification &
             });
         }
         break;
+        case legion::messages::Notification::CPU_X_CHANGED:
+        {
+            /*
+             * Single CPU toggled, controls stay in place and only take their data again
+             */
+            refreshControlTabByName<CPUControl>(CPUControl::NAME,*ui->tabWidget_Controls);
+            refreshControlTabByName<CPUFrequencyControl>(CPUFrequencyControl::NAME,*ui->tabWidget_Controls);
+        }
+        break;
         case legion::messages::Notification::THERMAL_MODE_CHANGE:
         {
             Utils::Layout::forAllLayoutsDo(*ui->verticalLayout_PowerProfiles,[](QLayoutItem &item){
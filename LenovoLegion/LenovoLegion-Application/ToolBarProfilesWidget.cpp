@@ -18,6 +18,7 @@
 #include "../LenovoLegion-Daemon/DataProviderNvidiaNvml.h"
 #include "../LenovoLegion-Daemon/SysFsDataProviderIntelMSR.h"
 #include "../LenovoLegion-Daemon/SysFsDataProviderOther.h"
+#include "../LenovoLegion-Daemon/DataProviderProfiles.h"
 
 #include <QMessageBox>
 
@@ -98,12 +99,128 @@ void ToolBarProfilesWidget::loadProfilesList()
     
     ui->listWidget_Profiles->clear();
     
-    QStringList profiles = ProfileManager::listProfiles();
-    for (const QString& profileName : profiles) {
-        ui->listWidget_Profiles->addItem(profileName);
+    try {
+        importLegacyProfiles();
+
+        m_profiles = m_dataProvider->getDataMessage<legion::messages::Profiles>(LenovoLegionDaemon::DataProviderProfiles::dataType);
+    }
+    catch (const std::exception& e) {
+        LOG_E(QString("Failed to list profiles: ").append(e.what()));
+        m_profiles.Clear();
+    }
+
+    for (const legion::messages::Profile& profile : m_profiles.profiles()) {
+        ui->listWidget_Profiles->addItem(QString::fromStdString(std::string(profile.name())));
     }
     
-    LOG_T(QString("Loaded %1 profiles").arg(profiles.size()));
+    LOG_T(QString("Loaded %1 profiles").arg(m_profiles.profiles_size()));
+}
+
+void ToolBarProfilesWidget::importLegacyProfiles()
+{
+    const QStringList legacyProfiles = ProfileManager::listProfiles();
+
+    if (legacyProfiles.isEmpty()) {
+        return;
+    }
+
+    const legion::messages::Profiles stored = m_dataProvider->getDataMessage<legion::messages::Profiles>(LenovoLegionDaemon::DataProviderProfiles::dataType);
+
+    for (const QString& profileName : legacyProfiles) {
+
+        bool exists = false;
+        for (const legion::messages::Profile& profile : stored.profiles()) {
+            exists = exists || QString::fromStdString(std::string(profile.name())) == profileName;
+        }
+
+        if (exists) {
+            LOG_W(QString("Profile already stored in daemon, legacy profile kept: ").append(profileName));
+            continue;
+        }
+
+        ProfileSettings                   legacy(profileName);
+        legion::messages::ProfileCommand  command;
+        legion::messages::Profile*        profile = command.mutable_profile();
+
+        auto addEntry = [profile](quint8 dataType,const google::protobuf::Message& message) {
+            // Settings not saved in profile load as empty messages
+            if (message.ByteSizeLong() > 0) {
+                legion::messages::Profile::Entry* entry = profile->add_entries();
+                entry->set_data_type(dataType);
+                entry->set_data(message.SerializeAsString());
+            }
+        };
+
+        command.set_command(legion::messages::ProfileCommand::IMPORT);
+        profile->set_name(profileName.toStdString());
+        profile->set_description(legacy.loadDescription().toStdString());
+
+        legion::messages::PowerProfile powerProfile;
+        legacy.loadPowerProfile(powerProfile);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderPowerProfile::dataType, powerProfile);
+
+        legion::messages::CPUPower cpuPower;
+        legacy.loadCPUPower(cpuPower);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderCPUPower::dataType, cpuPower);
+
+        legion::messages::GPUPower gpuPower;
+        legacy.loadGPUPower(gpuPower);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderGPUPower::dataType, gpuPower);
+
+        legion::messages::FanCurve fanCurve;
+        legacy.loadFanCurve(fanCurve);
+        if (fanCurve.current_value().ByteSizeLong() == 0) {
+            // Fan curve is saved in CUSTOM power profile only
+            fanCurve.clear_current_value();
+        }
+        addEntry(LenovoLegionDaemon::SysFsDataProviderFanCurve::dataType, fanCurve);
+
+        legion::messages::FanOption fanOption;
+        legacy.loadFanOption(fanOption);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderFanOption::dataType, fanOption);
+
+        legion::messages::CPUSMT cpuSmt;
+        legacy.loadCPUSMT(cpuSmt);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderCPUSMT::dataType, cpuSmt);
+
+        legion::messages::CPUOptions cpuOptions;
+        legacy.loadCPUOptions(cpuOptions);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderCPUOptions::dataType, cpuOptions);
+
+        legion::messages::CPUFrequency cpuFrequency;
+        legacy.loadCPUFrequency(cpuFrequency);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderCPUFrequency::dataType, cpuFrequency);
+
+        legion::messages::CpuIntelMSR intelMSR;
+        legacy.loadIntelMSR(intelMSR);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderIntelMSR::dataType, intelMSR);
+
+        legion::messages::NvidiaNvml nvidiaNvml;
+        legacy.loadNvidiaNvml(nvidiaNvml);
+        addEntry(LenovoLegionDaemon::DataProviderNvidiaNvml::dataType, nvidiaNvml);
+
+        legion::messages::OtherSettings otherSettings;
+        legacy.loadOther(otherSettings);
+        addEntry(LenovoLegionDaemon::SysFsDataProviderOther::dataType, otherSettings);
+
+        sendProfileCommand(command);
+        ProfileManager::deleteProfile(profileName);
+
+        LOG_D(QString("Legacy profile moved to daemon: ").append(profileName));
+    }
+}
+
+legion::messages::ProfileCommandResult ToolBarProfilesWidget::sendProfileCommand(const legion::messages::ProfileCommand &command)
+{
+    legion::messages::ProfileCommandResult result;
+
+    const QByteArray response = m_dataProvider->setDataMessage(LenovoLegionDaemon::DataProviderProfiles::dataType, command);
+
+    if (!result.ParseFromArray(response.data(), response.size())) {
+        THROW_EXCEPTION(DataProvider::exception_T, DataProvider::ERROR_CODES::PARSER_ERROR, "Parse of data message error !");
+    }
+
+    return result;
 }
 
 void ToolBarProfilesWidget::updateProfileDetails(const QString& profileName)
@@ -112,8 +229,11 @@ void ToolBarProfilesWidget::updateProfileDetails(const QString& profileName)
     
     ui->lineEdit_ProfileName->setText(profileName);
     
-    QString description = ProfileManager::getProfileDescription(profileName);
-    ui->lineEdit_ProfileDescription->setText(description);
+    for (const legion::messages::Profile& profile : m_profiles.profiles()) {
+        if (QString::fromStdString(std::string(profile.name())) == profileName) {
+            ui->lineEdit_ProfileDescription->setText(QString::fromStdString(std::string(profile.description())));
+        }
+    }
 }
 
 void ToolBarProfilesWidget::onSaveProfile()
@@ -137,7 +257,7 @@ void ToolBarProfilesWidget::onSaveProfile()
     }
     
     // Check if profile already exists
-    if (ProfileManager::profileExists(profileName)) {
+    if (!ui->listWidget_Profiles->findItems(profileName, Qt::MatchExactly).isEmpty()) {
         QMessageBox msgBox(this);
         QPixmap dialogIcon(":/images/icons/dialog.png");
         msgBox.setIconPixmap(dialogIcon.scaled(48, 48, Qt::KeepAspectRatio, Qt::SmoothTransformation));
@@ -154,73 +274,15 @@ void ToolBarProfilesWidget::onSaveProfile()
     LOG_D(QString("Saving profile: ").append(profileName));
     
     try {
-        // Create profile settings object
-        ProfileSettings profile(profileName);
-        
-        // Save description
-        profile.saveDescription(profileDescription);
-        
-        // Read current settings from daemon and save to profile
-        auto powerProfile = m_dataProvider->getDataMessage<legion::messages::PowerProfile>(
-            LenovoLegionDaemon::SysFsDataProviderPowerProfile::dataType);
-        profile.savePowerProfile(powerProfile);
-        
-        auto cpuOptions = m_dataProvider->getDataMessage<legion::messages::CPUOptions>(
-            LenovoLegionDaemon::SysFsDataProviderCPUOptions::dataType);
-        profile.saveCPUOptions(cpuOptions);
-        
-        auto cpuFrequency = m_dataProvider->getDataMessage<legion::messages::CPUFrequency>(
-            LenovoLegionDaemon::SysFsDataProviderCPUFrequency::dataType);
-        profile.saveCPUFrequency(cpuFrequency);
-        
-        // Check if power profile is CUSTOM - only save custom settings if it is
-        bool isCustomProfile = powerProfile.thermal_mode() &&
-                               powerProfile.thermal_mode() == legion::messages::PowerProfile_Profiles_POWER_PROFILE_CUSTOM;
-        
-        if (isCustomProfile) {
-            LOG_T("Power profile is CUSTOM - saving FanCurve, CPUPower, and GPUPower");
-            
-            auto fanCurve = m_dataProvider->getDataMessage<legion::messages::FanCurve>(
-                LenovoLegionDaemon::SysFsDataProviderFanCurve::dataType);
-            profile.saveFanCurve(fanCurve);
-            
-            auto cpuPower = m_dataProvider->getDataMessage<legion::messages::CPUPower>(
-                LenovoLegionDaemon::SysFsDataProviderCPUPower::dataType);
-            profile.saveCPUPower(cpuPower);
-            
-            auto gpuPower = m_dataProvider->getDataMessage<legion::messages::GPUPower>(
-                LenovoLegionDaemon::SysFsDataProviderGPUPower::dataType);
-            profile.saveGPUPower(gpuPower);
-        } else {
-            LOG_T("Power profile is not CUSTOM - skipping FanCurve, CPUPower, and GPUPower");
-        }
-        
-        auto fanOption = m_dataProvider->getDataMessage<legion::messages::FanOption>(
-            LenovoLegionDaemon::SysFsDataProviderFanOption::dataType);
-        profile.saveFanOption(fanOption);
-        
-        auto cpuSmt = m_dataProvider->getDataMessage<legion::messages::CPUSMT>(
-            LenovoLegionDaemon::SysFsDataProviderCPUSMT::dataType);
-        profile.saveCPUSMT(cpuSmt);
-        
-        auto nvidiaNvml = m_dataProvider->getDataMessage<legion::messages::NvidiaNvml>(
-            LenovoLegionDaemon::DataProviderNvidiaNvml::dataType);
-        profile.saveNvidiaNvml(nvidiaNvml);
-        
-        auto intelMSR = m_dataProvider->getDataMessage<legion::messages::CpuIntelMSR>(
-            LenovoLegionDaemon::SysFsDataProviderIntelMSR::dataType);
+        /*
+         * Daemon stores its current settings under the name
+         */
+        legion::messages::ProfileCommand command;
+        command.set_command(legion::messages::ProfileCommand::SAVE_CURRENT);
+        command.set_name(profileName.toStdString());
+        command.set_description(profileDescription.toStdString());
 
-        intelMSR.mutable_analogio()->set_offset(((intelMSR.analogio().offset() > 0 ? intelMSR.analogio().offset() + 999 : intelMSR.analogio().offset() - 999 ) / 1000) * 1000);
-        intelMSR.mutable_cache()->set_offset(((intelMSR.cache().offset() > 0 ? intelMSR.cache().offset() + 999 : intelMSR.cache().offset() - 999 ) / 1000) * 1000);
-        intelMSR.mutable_cpu()->set_offset(((intelMSR.cpu().offset() > 0 ? intelMSR.cpu().offset() + 999 : intelMSR.cpu().offset() - 999) / 1000) * 1000);
-        intelMSR.mutable_gpu()->set_offset(((intelMSR.gpu().offset() > 0 ? intelMSR.gpu().offset() + 999 : intelMSR.gpu().offset() - 999 ) / 1000) * 1000);
-        intelMSR.mutable_uncore()->set_offset(((intelMSR.uncore().offset() > 0 ? intelMSR.uncore().offset() + 999 : intelMSR.uncore().offset() - 999 ) / 1000) * 1000);
-
-        profile.saveIntelMSR(intelMSR);
-        
-        auto otherSettings = m_dataProvider->getDataMessage<legion::messages::OtherSettings>(
-            LenovoLegionDaemon::SysFsDataProviderOther::dataType);
-        profile.saveOther(otherSettings);
+        sendProfileCommand(command);
         
         LOG_T(QString("Profile saved successfully: ").append(profileName));
         
@@ -282,54 +344,31 @@ void ToolBarProfilesWidget::onLoadProfile()
     LOG_T(QString("Loading profile: ").append(profileName));
     
     try {
-        ProfileSettings profile(profileName);
-        
-        // Load settings from profile
-        legion::messages::PowerProfile powerProfile;
-        profile.loadPowerProfile(powerProfile);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderPowerProfile::dataType, powerProfile);
-        
-        legion::messages::CPUOptions cpuOptions;
-        profile.loadCPUOptions(cpuOptions);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderCPUOptions::dataType, cpuOptions);
-        
-        legion::messages::CPUFrequency cpuFrequency;
-        profile.loadCPUFrequency(cpuFrequency);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderCPUFrequency::dataType, cpuFrequency);
-        
-        legion::messages::FanCurve fanCurve;
-        profile.loadFanCurve(fanCurve);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderFanCurve::dataType, fanCurve);
-        
-        legion::messages::FanOption fanOption;
-        profile.loadFanOption(fanOption);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderFanOption::dataType, fanOption);
-        
-        legion::messages::CPUSMT cpuSmt;
-        profile.loadCPUSMT(cpuSmt);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderCPUSMT::dataType, cpuSmt);
-              
-        legion::messages::CPUPower cpuPower;
-        profile.loadCPUPower(cpuPower);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderCPUPower::dataType, cpuPower);
-        
-        legion::messages::GPUPower gpuPower;
-        profile.loadGPUPower(gpuPower);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderGPUPower::dataType, gpuPower);
-        
-        legion::messages::NvidiaNvml nvidiaNvml;
-        profile.loadNvidiaNvml(nvidiaNvml);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::DataProviderNvidiaNvml::dataType, nvidiaNvml);
-        
-        legion::messages::CpuIntelMSR intelMSR;
-        profile.loadIntelMSR(intelMSR);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderIntelMSR::dataType, intelMSR);
-        
-        legion::messages::OtherSettings otherSettings;
-        profile.loadOther(otherSettings);
-        m_dataProvider->setDataMessage(LenovoLegionDaemon::SysFsDataProviderOther::dataType, otherSettings);
-        
-        LOG_T(QString("Profile loaded successfully: ").append(profileName));
+        /*
+         * Daemon writes only settings which differ from hardware and restores them when a write fails
+         */
+        legion::messages::ProfileCommand command;
+        command.set_command(legion::messages::ProfileCommand::APPLY);
+        command.set_name(profileName.toStdString());
+
+        const legion::messages::ProfileCommandResult result = sendProfileCommand(command);
+
+        if (result.status() != legion::messages::ProfileCommandResult::OK) {
+            LOG_E(QString("Failed to load profile: ").append(profileName).append(", status ").append(QString::number(result.status())));
+
+            QMessageBox msgBox(this);
+            QPixmap errorIcon(":/images/icons/cross.png");
+            msgBox.setIconPixmap(errorIcon.scaled(48, 48, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+            msgBox.setWindowTitle("Load Failed");
+            msgBox.setText(result.status() == legion::messages::ProfileCommandResult::FAILED_ROLLED_BACK ?
+                               "Failed to load profile, previous settings were restored. Check logs for details." :
+                               "Failed to load profile. Check logs for details.");
+            msgBox.setStandardButtons(QMessageBox::Ok);
+            msgBox.exec();
+            return;
+        }
+
+        LOG_T(QString("Profile loaded successfully: ").append(profileName).append(", ").append(QString::number(result.written_data_types_size())).append(" settings written"));
         
         QMessageBox msgBox(this);
         QPixmap infoIcon(":/images/icons/info.png");
@@ -386,7 +425,19 @@ void ToolBarProfilesWidget::onDeleteProfile()
     
     LOG_T(QString("Deleting profile: ").append(profileName));
     
-    if (ProfileManager::deleteProfile(profileName)) {
+    legion::messages::ProfileCommand command;
+    command.set_command(legion::messages::ProfileCommand::DELETE);
+    command.set_name(profileName.toStdString());
+
+    bool deleted = false;
+    try {
+        deleted = sendProfileCommand(command).status() == legion::messages::ProfileCommandResult::OK;
+    }
+    catch (const std::exception& e) {
+        LOG_E(QString("Failed to delete profile: ").append(e.what()));
+    }
+
+    if (deleted) {
         LOG_T(QString("Profile deleted successfully: ").append(profileName));
         
         QMessageBox msgBox(this);
@@ -9,6 +9,8 @@
 
 #include "ToolBarWidget.h"
 
+#include "../LenovoLegion-PrepareBuild/Profiles.pb.h"
+
 
 namespace Ui {
 class ToolBarProfilesWidget;
@@ -50,8 +52,20 @@ private:
     void loadProfilesList();
     void updateProfileDetails(const QString& profileName);
 
+    /*
+     * Profiles saved by older versions in GUI settings are moved to daemon
+     */
+    void importLegacyProfiles();
+
+    legion::messages::ProfileCommandResult sendProfileCommand(const legion::messages::ProfileCommand& command);
+
     Ui::ToolBarProfilesWidget *ui;
 
+    /*
+     * Stored profiles as listed by daemon, without entries
+     */
+    legion::messages::Profiles m_profiles;
+
     /*
      * Default Action Map, Defined by user
      */
@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "HIDTransportEmulator.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace LenovoLegionDaemon {
+
+namespace {
+
+constexpr uint8_t REPORT_ID     = 0x07;
+constexpr size_t  HEADER_SIZE   = 4;
+constexpr size_t  EFFECT_INDEX  = 7;
+
+}
+
+HIDTransportEmulator::HIDTransportEmulator(const std::vector<std::vector<uint16_t> > &keyCodes, const Latency &latency) :
+    m_keyCodes(keyCodes),
+    m_latency(latency),
+    m_profile(1),
+    m_brightness(5),
+    m_logo(true),
+    m_direct(false)
+{
+    m_effects.fill(defaultEffect());
+    m_response.fill(0x00);
+}
+
+std::vector<std::vector<uint16_t> > HIDTransportEmulator::keyboard(uint8_t width, uint8_t height)
+{
+    std::vector<std::vector<uint16_t>> keyCodes(width,std::vector<uint16_t>(height,0x0000));
+
+    for(uint8_t x = 0; x < width; ++x)
+    {
+        for(uint8_t y = 0; y < height; ++y)
+        {
+            keyCodes[x][y] = static_cast<uint16_t>((y + 1) << 8 | (x + 1));
+        }
+    }
+
+    return keyCodes;
+}
+
+int HIDTransportEmulator::sendFeatureReport(const uint8_t *data, size_t length)
+{
+    Report request;
+
+    std::this_thread::sleep_for(latency(&Latency::m_send));
+
+    if(length < HEADER_SIZE || length > REPORT_SIZE || data[0] != REPORT_ID)
+    {
+        return -1;
+    }
+
+    request.fill(0x00);
+    std::copy(data,data + length,request.begin());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ++m_counters.m_sent;
+    handle(request);
+
+    return static_cast<int>(length);
+}
+
+int HIDTransportEmulator::getFeatureReport(uint8_t *data, size_t length)
+{
+    std::this_thread::sleep_for(latency(&Latency::m_get));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const size_t size = std::min(length,REPORT_SIZE);
+
+    ++m_counters.m_received;
+    std::copy(m_response.begin(),m_response.begin() + size,data);
+
+    return static_cast<int>(size);
+}
+
+std::optional<std::string> HIDTransportEmulator::getManufacturerString()
+{
+    return "ITE Tech. Inc.";
+}
+
+std::optional<std::string> HIDTransportEmulator::getProductString()
+{
+    return "ITE Device(8258) Emulator";
+}
+
+std::optional<std::string> HIDTransportEmulator::getSerialNumberString()
+{
+    return "EMULATOR";
+}
+
+std::string HIDTransportEmulator::error()
+{
+    return "Invalid feature report";
+}
+
+void HIDTransportEmulator::setLatency(const Latency &latency)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_latency = latency;
+}
+
+HIDTransportEmulator::Counters HIDTransportEmulator::counters() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_counters;
+}
+
+void HIDTransportEmulator::handle(const Report &request)
+{
+    const uint8_t operation = request[1];
+    const uint8_t value1    = request[4];
+    const uint8_t value2    = request[5];
+
+    m_response = response(operation);
+
+    switch (operation) {
+    case Compatibility:
+        m_response[4] = 0x00;
+        break;
+    case KeyCount:
+        m_response[4] = value1;
+        m_response[5] = m_keyCodes.empty() ? 0 : static_cast<uint8_t>(m_keyCodes.front().size());
+        m_response[6] = static_cast<uint8_t>(m_keyCodes.size());
+        break;
+    case KeyPage:
+        m_response[4] = value1;
+        m_response[5] = value2;
+
+        if(value1 == 0x07)
+        {
+            for(size_t x = 0; x < m_keyCodes.size() && value2 < m_keyCodes[x].size(); ++x)
+            {
+                m_response[6 + x * 3]     = static_cast<uint8_t>(x);
+                m_response[6 + x * 3 + 1] = m_keyCodes[x][value2] & 0xFF;
+                m_response[6 + x * 3 + 2] = m_keyCodes[x][value2] >> 8 & 0xFF;
+            }
+        }
+        break;
+    case ProfileChange:
+        if(value1 >= 1 && value1 <= PROFILES)
+        {
+            m_pendingProfile = value1;
+            m_profileSettled = std::chrono::steady_clock::now() + m_latency.m_profileSettle;
+            m_direct         = false;
+        }
+        break;
+    case ProfileDefault:
+        if(value1 >= 1 && value1 <= PROFILES)
+        {
+            m_effects[value1 - 1] = defaultEffect();
+        }
+        break;
+    case Profile:
+        m_response[4] = currentProfile();
+        break;
+    case EffectChange:
+        if(value1 >= 1 && value1 <= PROFILES)
+        {
+            m_effects[value1 - 1].assign(request.begin() + EFFECT_INDEX,request.end());
+        }
+        break;
+    case Effect:
+        if(value1 >= 1 && value1 <= PROFILES && currentProfile() != 0)
+        {
+            const std::vector<uint8_t>& effect = m_effects[value1 - 1];
+
+            m_response[4] = value1;
+            m_response[5] = 0x01;
+            m_response[6] = 0x01;
+            std::copy(effect.begin(),effect.begin() + std::min(effect.size(),REPORT_SIZE - EFFECT_INDEX),m_response.begin() + EFFECT_INDEX);
+        }
+        break;
+    case GetBrightness:
+        m_response[4] = m_brightness;
+        break;
+    case Brightness:
+        m_brightness = value1;
+        break;
+    case GetLogoStatus:
+        m_response[4] = m_logo ? 0x01 : 0x00;
+        break;
+    case LogoStatus:
+        m_logo = value1 == 0x01;
+        break;
+    case AuroraStartStop:
+        m_direct = value1 == 0x01;
+        break;
+    case AuroraSendBitmap:
+        ++m_counters.m_bitmaps;
+
+        for(size_t i = HEADER_SIZE; i + 4 < REPORT_SIZE; i += 5)
+        {
+            const uint16_t keyCode = request[i] | request[i + 1] << 8;
+
+            if(keyCode == 0x0000)
+            {
+                break;
+            }
+
+            m_colors[keyCode] = {request[i + 2],request[i + 3],request[i + 4]};
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+uint8_t HIDTransportEmulator::currentProfile()
+{
+    if(m_pendingProfile && std::chrono::steady_clock::now() >= m_profileSettled)
+    {
+        m_profile = *m_pendingProfile;
+        m_pendingProfile.reset();
+    }
+
+    return m_pendingProfile ? 0x00 : m_profile;
+}
+
+std::vector<uint8_t> HIDTransportEmulator::defaultEffect() const
+{
+    /*
+     * Rainbow wave over all keys, group settings, no colors, LEDs
+     */
+    std::vector<uint8_t> effect {0x01,0x06,0x01,0x02,0x02,0x02,0x03,0x00,0x04,0x02,0x05,0x00,0x06,0x00,0x00,0x00};
+    uint8_t              leds = 0;
+
+    for(const auto& column : m_keyCodes)
+    {
+        for(const uint16_t keyCode : column)
+        {
+            if(keyCode != 0x0000 && leds < 0xFF)
+            {
+                effect.push_back(keyCode & 0xFF);
+                effect.push_back(keyCode >> 8 & 0xFF);
+                ++leds;
+            }
+        }
+    }
+    effect[15] = leds;
+
+    return effect;
+}
+
+std::chrono::microseconds HIDTransportEmulator::latency(std::chrono::microseconds Latency::* transfer) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_latency.*transfer;
+}
+
+HIDTransportEmulator::Report HIDTransportEmulator::response(uint8_t operation) const
+{
+    Report report;
+
+    report.fill(0x00);
+    report[0] = REPORT_ID;
+    report[1] = operation;
+    report[2] = 0xC0;
+    report[3] = 0x03;
+
+    return report;
+}
+
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#pragma once
+
+#include "RGBControlers/HIDTransport.h"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * In memory model of Lenovo ITE keyboard controller
+ *
+ * Keeps profiles, effects, brightness, logo and direct mode colors and answers 960 byte
+ * feature reports like device does, response to a request is read by next get. Latency
+ * is added to every transfer, profile change is settled after its own delay, until then
+ * device reports profile 0 like real device during reset.
+ */
+class HIDTransportEmulator : public HIDTransport
+{
+public:
+
+    struct Latency {
+        std::chrono::microseconds m_send          {0};
+        std::chrono::microseconds m_get           {0};
+        std::chrono::microseconds m_profileSettle {0};
+    };
+
+    struct Counters {
+        uint64_t m_sent     = 0;
+        uint64_t m_received = 0;
+        uint64_t m_bitmaps  = 0;
+    };
+
+    static constexpr size_t     REPORT_SIZE     = 960;
+    static constexpr uint8_t    PROFILES        = 6;
+
+public:
+
+    /*
+     * Key codes [x][y], 0x0000 is no key
+     */
+    HIDTransportEmulator(const std::vector<std::vector<uint16_t>>& keyCodes,const Latency& latency);
+
+    /*
+     * Keyboard with height rows of width keys
+     */
+    static std::vector<std::vector<uint16_t>> keyboard(uint8_t width,uint8_t height);
+
+    int                         sendFeatureReport(const uint8_t* data,size_t length) override;
+    int                         getFeatureReport(uint8_t* data,size_t length)        override;
+
+    std::optional<std::string>  getManufacturerString() override;
+    std::optional<std::string>  getProductString()      override;
+    std::optional<std::string>  getSerialNumberString() override;
+
+    std::string                 error()                 override;
+
+    void                        setLatency(const Latency& latency);
+    Counters                    counters()              const;
+
+private:
+
+    enum Operation : uint8_t
+    {
+        Compatibility       = 0xD1,
+        KeyCount            = 0xC4,
+        KeyPage             = 0xC5,
+        ProfileChange       = 0xC8,
+        ProfileDefault      = 0xC9,
+        Profile             = 0xCA,
+        EffectChange        = 0xCB,
+        Effect              = 0xCC,
+        GetBrightness       = 0xCD,
+        Brightness          = 0xCE,
+        AuroraStartStop     = 0xD0,
+        AuroraSendBitmap    = 0xA1,
+        GetLogoStatus       = 0xA5,
+        LogoStatus          = 0xA6
+    };
+
+    using Report = std::array<uint8_t,REPORT_SIZE>;
+
+    void    handle(const Report& request);
+    uint8_t currentProfile();
+    Report  response(uint8_t operation) const;
+
+    std::vector<uint8_t>        defaultEffect() const;
+    std::chrono::microseconds   latency(std::chrono::microseconds Latency::* transfer) const;
+
+private:
+
+    const std::vector<std::vector<uint16_t>>    m_keyCodes;
+
+    mutable std::mutex                          m_mutex;
+    Latency                                     m_latency;
+    Counters                                    m_counters;
+
+    uint8_t                                     m_profile;
+    std::optional<uint8_t>                      m_pendingProfile;
+    std::chrono::steady_clock::time_point       m_profileSettled;
+
+    uint8_t                                     m_brightness;
+    bool                                        m_logo;
+    bool                                        m_direct;
+
+    std::array<std::vector<uint8_t>,PROFILES>   m_effects;      // Effect groups of profile as sent
+    std::map<uint16_t,std::array<uint8_t,3>>    m_colors;       // Direct mode colors
+
+    Report                                      m_response;
+};
+
+}
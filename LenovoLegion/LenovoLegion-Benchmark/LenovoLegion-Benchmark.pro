@@ -0,0 +1,75 @@
+TEMPLATE = app
+TARGET = $${PROJECT_BENCHMARK_NAME}
+
+DESTDIR = $${DESTINATION_LIB_PATH}
+
+
+QT += core
+QT -= gui
+
+CONFIG += c++20 console cmdline warn_on depend_includepath link_pkgconfig
+CONFIG -= app_bundle
+
+PKGCONFIG += protobuf
+
+SOURCES += \
+        HIDTransportEmulator.cpp \
+        NotifierBenchmark.cpp \
+        RGBBenchmark.cpp \
+        main.cpp
+
+HEADERS += \
+        HIDTransportEmulator.h \
+        NotifierBenchmark.h \
+        RGBBenchmark.h
+
+#
+# Daemon RGB pipeline under benchmark, without HID device detection
+#
+DAEMON_PATH = ../$${APPLICATION_NAME2}
+
+SOURCES += \
+        $${DAEMON_PATH}/RGBAudioSource.cpp \
+        $${DAEMON_PATH}/RGBAudioSpectrum.cpp \
+        $${DAEMON_PATH}/RGBController.cpp \
+        $${DAEMON_PATH}/RGBControllerGroup.cpp \
+        $${DAEMON_PATH}/RGBControllerIndex.cpp \
+        $${DAEMON_PATH}/RGBDirectModeEngine.cpp \
+        $${DAEMON_PATH}/RGBDirectModeEffects.cpp \
+        $${DAEMON_PATH}/RGBLedStateCache.cpp \
+        $${DAEMON_PATH}/RGBControlers/HIDWorker.cpp \
+        $${DAEMON_PATH}/RGBControlers/LenovoRGBController.cpp \
+        $${DAEMON_PATH}/RGBControlers/LenovoRGBControllerC9xx.cpp \
+        $${DAEMON_PATH}/RGBControlers/LenovoUSBController.cpp \
+        $${DAEMON_PATH}/RGBControlers/LenovoUSBControllerC9xx.cpp
+
+HEADERS += \
+        $${DAEMON_PATH}/RGBAudioSource.h \
+        $${DAEMON_PATH}/RGBAudioSpectrum.h \
+        $${DAEMON_PATH}/RGBController.h \
+        $${DAEMON_PATH}/RGBControllerGroup.h \
+        $${DAEMON_PATH}/RGBControllerIndex.h \
+        $${DAEMON_PATH}/RGBControllerInterface.h \
+        $${DAEMON_PATH}/RGBControllerKeyNames.h \
+        $${DAEMON_PATH}/RGBDirectModeEngine.h \
+        $${DAEMON_PATH}/RGBDirectModeEffects.h \
+        $${DAEMON_PATH}/RGBLedStateCache.h \
+        $${DAEMON_PATH}/RGBControlers/HIDTransport.h \
+        $${DAEMON_PATH}/RGBControlers/HIDWorker.h \
+        $${DAEMON_PATH}/RGBControlers/LenovoRGBController.h \
+        $${DAEMON_PATH}/RGBControlers/LenovoRGBControllerC9xx.h \
+        $${DAEMON_PATH}/RGBControlers/LenovoUSBController.h \
+        $${DAEMON_PATH}/RGBControlers/LenovoUSBControllerC9xx.h
+
+#
+# Daemon notifier routing under benchmark, without socket and protocol
+#
+SOURCES += \
+        $${DAEMON_PATH}/NotificationRouter.cpp \
+        ../LenovoLegion-PrepareBuild/Notification.pb.cc
+
+HEADERS += \
+        $${DAEMON_PATH}/NotificationRouter.h \
+        ../LenovoLegion-PrepareBuild/Notification.pb.h
+
+LIBS += -l$${PROJECT_LIBS_NAME}
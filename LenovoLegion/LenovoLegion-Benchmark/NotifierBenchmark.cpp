@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "NotifierBenchmark.h"
+#include "NotificationRouter.h"
+
+#include "SysFsDriverPowerSuplyBattery0.h"
+#include "SysFsDriverCPUXList.h"
+#include "SysFsDriverLegionEvents.h"
+#include "SysFsDriverLegionOther.h"
+#include "SysFSDriverLegionIntelMSR.h"
+#include "SysFSDriverLegionFanMode.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace LenovoLegionDaemon {
+
+int NotifierBenchmark::run()
+{
+    const std::vector<SysFsDriver::SubsystemEvent> events = eventMix();
+    std::vector<LegacyEvent>                       legacyEvents;
+
+    for(const SysFsDriver::SubsystemEvent& event : events)
+    {
+        legacyEvents.push_back(toLegacy(event));
+    }
+
+    if(!compare(events,legacyEvents))
+    {
+        return EXIT_FAILURE;
+    }
+
+    std::printf("\n%-20s %8s %8s %10s %12s %12s\n","dispatcher","events","passes","notified","avg [ns]","max [ns]");
+
+    dispatch("if-chain",events.size(),[&legacyEvents](size_t i,legion::messages::Notification& msg) {
+        return legacyRoute(legacyEvents[i],msg);
+    });
+
+    dispatch("route table",events.size(),[&events](size_t i,legion::messages::Notification& msg) {
+        return NotificationRouter::route(events[i],msg);
+    });
+
+    return EXIT_SUCCESS;
+}
+
+std::vector<SysFsDriver::SubsystemEvent> NotifierBenchmark::eventMix()
+{
+    using Action = SysFsDriver::SubsystemEvent::Action;
+
+    std::vector<SysFsDriver::SubsystemEvent> events;
+
+    auto add = [&events](const char* driverName,SysFsDriver::DriverId driverId,Action action,int eventType = SysFsDriver::SubsystemEvent::NO_EVENT_TYPE,quint32 eventValue = 0) {
+        events.push_back(SysFsDriver::SubsystemEvent{
+            .m_driverName = driverName,
+            .m_driverId   = driverId,
+            .m_action     = action,
+            .m_eventType  = eventType,
+            .m_eventValue = eventValue
+        });
+    };
+
+    /*
+     * Power mode switch, firmware reports every power limit and fan curve
+     */
+    for(const int type : {SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_STP,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_LTP,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_PP,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_TMP,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_CLP,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_PL1_TAU,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_APU_PPT,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_PB,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_TAC,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_TGP,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_TMP,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_FF_S,
+                          SysFsDriverLegionOther::LENOVO_WMI_OTHER_IGPU_M})
+    {
+        add(SysFsDriverLegionOther::DRIVER_NAME,SysFsDriverLegionOther::DRIVER_ID,Action::CHANGED,type);
+    }
+
+    add(SysFsDriverLegionEvents::DRIVER_NAME,SysFsDriverLegionEvents::DRIVER_ID,Action::CHANGED,SysFsDriverLegionEvents::LEGION_WMI_EVENT_THERMAL_MODE);
+    add(SysFsDriverLegionEvents::DRIVER_NAME,SysFsDriverLegionEvents::DRIVER_ID,Action::CHANGED,SysFsDriverLegionEvents::LEGION_WMI_EVENT_SMART_FAN_MODE);
+    add(SysFSDriverLegionFanMode::DRIVER_NAME,SysFSDriverLegionFanMode::DRIVER_ID,Action::CHANGED);
+
+    /*
+     * Hotkeys
+     */
+    add(SysFsDriverLegionEvents::DRIVER_NAME,SysFsDriverLegionEvents::DRIVER_ID,Action::CHANGED,SysFsDriverLegionEvents::LENOVO_WMI_EVENT_UTILITY,legion::messages::Notification::FNLOCKON);
+    add(SysFsDriverLegionEvents::DRIVER_NAME,SysFsDriverLegionEvents::DRIVER_ID,Action::CHANGED,SysFsDriverLegionEvents::LENOVO_WMI_EVENT_UTILITY,legion::messages::Notification::FNLOCKOFF);
+    add(SysFsDriverLegionEvents::DRIVER_NAME,SysFsDriverLegionEvents::DRIVER_ID,Action::CHANGED,SysFsDriverLegionEvents::LEGION_WMI_EVENT_KEYLOCK_STATUS,legion::messages::Notification::WINDOWS_KEY);
+
+    /*
+     * Battery, CPU offset and CPU hotplug
+     */
+    add(SysFsDriverPowerSuplyBattery0::DRIVER_NAME,SysFsDriverPowerSuplyBattery0::DRIVER_ID,Action::CHANGED);
+    add(SysFsDriverPowerSuplyBattery0::DRIVER_NAME,SysFsDriverPowerSuplyBattery0::DRIVER_ID,Action::CHANGED);
+    add(SysFSDriverLegionIntelMSR::DRIVER_NAME,SysFSDriverLegionIntelMSR::DRIVER_ID,Action::CHANGED);
+    add(SysFsDriverCPUXList::DRIVER_NAME,SysFsDriverCPUXList::DRIVER_ID,Action::CHANGED,SysFsDriverCPUXList::CPU_X_OFFLINE,7);
+    add(SysFsDriverCPUXList::DRIVER_NAME,SysFsDriverCPUXList::DRIVER_ID,Action::CHANGED,SysFsDriverCPUXList::CPU_X_ONLINE,7);
+    add(SysFsDriverCPUXList::DRIVER_NAME,SysFsDriverCPUXList::DRIVER_ID,Action::RELOADED);
+
+    return events;
+}
+
+NotifierBenchmark::LegacyEvent NotifierBenchmark::toLegacy(const SysFsDriver::SubsystemEvent &event)
+{
+    return LegacyEvent{
+        .m_driverName               = event.m_driverName,
+        .m_action                   = event.m_action,
+        .m_DriverSpecificEventType  = event.m_eventType == SysFsDriver::SubsystemEvent::NO_EVENT_TYPE ? QString() : QString::number(event.m_eventType),
+        .m_DriverSpecificEventValue = QString::number(event.m_eventValue)
+    };
+}
+
+bool NotifierBenchmark::legacyRoute(const LegacyEvent &event, legion::messages::Notification &msg)
+{
+    /*
+     * Notifier kernel event handler before the route table, trace message was built for every event
+     */
+    LOG_T("ProtocolProcessorNotifier: kernelEventHandler m_driverName=" + event.m_driverName + ", event.m_action=" + QString::number(static_cast<int>(event.m_action)) + ", m_DriverSpecificAction=" + QString(event.m_DriverSpecificEventType.data()) + ", m_DriverSpecificValue=" + event.m_DriverSpecificEventValue.data());
+
+    if(event.m_driverName == SysFsDriverPowerSuplyBattery0::DRIVER_NAME)
+    {
+        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+        {
+            msg.set_action(legion::messages::Notification::POWER_SUPPLY_BATTERY0_CHANGE);
+        }
+    }
+
+    if(event.m_driverName == SysFsDriverCPUXList::DRIVER_NAME)
+    {
+        if(event.m_action == SysFsDriver::SubsystemEvent::Action::RELOADED)
+        {
+            msg.set_action(legion::messages::Notification::CPU_X_LIST_RELOADED);
+        }
+    }
+
+    if(event.m_driverName == SysFsDriverLegionEvents::DRIVER_NAME)
+    {
+        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+        {
+            if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LEGION_WMI_EVENT_KEYLOCK_STATUS)
+            {
+                msg.set_action(legion::messages::Notification::KEYLOCK_STATUS_CHANGE);
+                msg.set_key_lock_key(static_cast<legion::messages::Notification_KeylockDisabledBit>(QString(event.m_DriverSpecificEventValue.data()).toUInt()));
+            }
+
+            if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LENOVO_WMI_EVENT_UTILITY)
+            {
+                msg.set_action(legion::messages::Notification::SPECIAL_KEY_PRESSED);
+                msg.set_special_key(static_cast<legion::messages::Notification_SpecialKey>(QString(event.m_DriverSpecificEventValue.data()).toUInt()));
+            }
+
+            if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LEGION_WMI_EVENT_THERMAL_MODE)
+            {
+                msg.set_action(legion::messages::Notification::THERMAL_MODE_CHANGE);
+            }
+        }
+    }
+
+    if(event.m_driverName == SysFsDriverLegionOther::DRIVER_NAME)
+    {
+        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+        {
+            if(static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_STP    ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_LTP    ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_PP     ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_TMP    ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_CLP    ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_PL1_TAU||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_APU_PPT    ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_PB     ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_TAC    ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_TGP    ||
+               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_TMP)
+            {
+
+                msg.set_action(legion::messages::Notification::POWER_CONTROL_CHANGED);
+            }
+
+            if(static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_FF_S)
+            {
+                msg.set_action(legion::messages::Notification::FAN_CURVE_CHANGED);
+            }
+        }
+    }
+
+    if(event.m_driverName == SysFSDriverLegionIntelMSR::DRIVER_NAME)
+    {
+        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+        {
+            msg.set_action(legion::messages::Notification::CPU_OFFSET_CHANGED);
+        }
+    }
+
+    if(event.m_driverName == SysFSDriverLegionFanMode::DRIVER_NAME)
+    {
+        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+        {
+            msg.set_action(legion::messages::Notification::FAN_CURVE_CHANGED);
+        }
+    }
+
+    return msg.has_action();
+}
+
+void NotifierBenchmark::dispatch(const char *name, size_t events, const std::function<bool (size_t, legion::messages::Notification &)> &route)
+{
+    std::chrono::nanoseconds total    {0};
+    std::chrono::nanoseconds max      {0};
+    size_t                   notified = 0;
+
+    for(int pass = 0; pass < ITERATIONS; ++pass)
+    {
+        for(size_t i = 0; i < events; ++i)
+        {
+            legion::messages::Notification msg;
+
+            const auto start = std::chrono::steady_clock::now();
+
+            notified += route(i,msg) ? 1 : 0;
+
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+            total += elapsed;
+            max    = std::max(max,elapsed);
+        }
+    }
+
+    std::printf("%-20s %8zu %8d %10zu %12lld %12lld\n",
+                name,
+                events,
+                ITERATIONS,
+                notified / ITERATIONS,
+                static_cast<long long>(total.count() / (static_cast<long long>(events) * ITERATIONS)),
+                static_cast<long long>(max.count()));
+}
+
+bool NotifierBenchmark::compare(const std::vector<SysFsDriver::SubsystemEvent> &events, const std::vector<LegacyEvent> &legacyEvents)
+{
+    for(size_t i = 0; i < events.size(); ++i)
+    {
+        legion::messages::Notification legacy;
+        legion::messages::Notification routed;
+
+        legacyRoute(legacyEvents[i],legacy);
+        NotificationRouter::route(events[i],routed);
+
+        /*
+         * CPU hotplug notification is newer than the if-chain
+         */
+        if(events[i].m_driverId == SysFsDriverCPUXList::DRIVER_ID && events[i].m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+        {
+            continue;
+        }
+
+        if(legacy.SerializeAsString() != routed.SerializeAsString())
+        {
+            std::printf("Notification of event %zu (%s) differs !\n",i,events[i].m_driverName.toStdString().c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "SysFsDriver.h"
+
+#include "../LenovoLegion-PrepareBuild/Notification.pb.h"
+
+#include <functional>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Notifier dispatch benchmark
+ *
+ * Replays fixed mix of kernel events, as sent by drivers while power limits, hotkeys, battery and
+ * CPU hotplug change, through the string compare if-chain the notifier used before the route
+ * table and through NotificationRouter. Both dispatchers must produce the same notifications.
+ * Serialization and socket write are the same for both and are not measured.
+ * Results are written to standard output.
+ */
+class NotifierBenchmark
+{
+public:
+
+    static constexpr int    ITERATIONS  = 10000;
+
+public:
+
+    static int run();
+
+private:
+
+    /*
+     * Kernel event as it was sent before drivers parsed EVENT_TYPE/EVENT_VALUE
+     */
+    struct LegacyEvent
+    {
+        QString                             m_driverName;
+        SysFsDriver::SubsystemEvent::Action m_action;
+        QString                             m_DriverSpecificEventType;
+        QString                             m_DriverSpecificEventValue;
+    };
+
+    static std::vector<SysFsDriver::SubsystemEvent> eventMix();
+    static LegacyEvent                              toLegacy(const SysFsDriver::SubsystemEvent& event);
+
+    static bool     legacyRoute(const LegacyEvent& event,legion::messages::Notification& msg);
+
+    /*
+     * Route returns true when notification was produced
+     */
+    static void     dispatch(const char* name,size_t events,const std::function<bool (size_t,legion::messages::Notification&)>& route);
+
+    static bool     compare(const std::vector<SysFsDriver::SubsystemEvent>& events,const std::vector<LegacyEvent>& legacyEvents);
+};
+
+}
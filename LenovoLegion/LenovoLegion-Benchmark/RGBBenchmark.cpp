@@ -0,0 +1,464 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "RGBBenchmark.h"
+#include "RGBDirectModeEffects.h"
+#include "RGBControllerGroup.h"
+#include "RGBControlers/LenovoRGBControllerC9xx.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <thread>
+
+namespace LenovoLegionDaemon {
+
+namespace {
+
+/*
+ * Keyboard sized like C9xx devices, 8 rows of 22 keys
+ */
+constexpr uint8_t KEYBOARD_WIDTH  = 22;
+constexpr uint8_t KEYBOARD_HEIGHT = 8;
+
+/*
+ * Transports, no latency, typical USB control transfer and slow device with profile reset
+ */
+const HIDTransportEmulator::Latency LATENCIES[] = {
+    {std::chrono::microseconds(0),    std::chrono::microseconds(0),    std::chrono::microseconds(0)},
+    {std::chrono::microseconds(1000), std::chrono::microseconds(1000), std::chrono::microseconds(20000)},
+    {std::chrono::microseconds(4000), std::chrono::microseconds(4000), std::chrono::microseconds(150000)}
+};
+
+QString latencyName(const HIDTransportEmulator::Latency& latency)
+{
+    return QString("%1/%2/%3 us").arg(latency.m_send.count()).arg(latency.m_get.count()).arg(latency.m_profileSettle.count());
+}
+
+/*
+ * Mono 16 bit WAV, sine sweeping from 50 Hz to 10 kHz
+ */
+void writeSweep(const std::string& path,quint32 rate,std::chrono::milliseconds length)
+{
+    const quint32 frames = static_cast<quint32>(static_cast<quint64>(rate) * length.count() / 1000);
+    QByteArray    data;
+    QDataStream   stream(&data,QIODevice::WriteOnly);
+    double        phase = 0.0;
+
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream.writeRawData("RIFF",4);
+    stream << static_cast<quint32>(36 + frames * 2);
+    stream.writeRawData("WAVEfmt ",8);
+    stream << quint32(16) << quint16(1) << quint16(1) << rate << rate * 2 << quint16(2) << quint16(16);
+    stream.writeRawData("data",4);
+    stream << frames * 2;
+
+    for(quint32 i = 0; i < frames; ++i)
+    {
+        phase += 2.0 * std::numbers::pi * 50.0 * std::pow(200.0,static_cast<double>(i) / frames) / rate;
+        stream << static_cast<qint16>(std::sin(phase) * 16000.0);
+    }
+
+    QFile file(QString::fromStdString(path));
+
+    if(file.open(QIODevice::WriteOnly))
+    {
+        file.write(data);
+    }
+}
+
+}
+
+int RGBBenchmark::run(int argc, char *argv[])
+{
+    /*
+     * Profile switch is confirmed from event loop
+     */
+    QCoreApplication application(argc,argv);
+
+    /*
+     * Logger is not initialized, nothing must be written
+     */
+    LoggerHolder::getInstance().setSeverity(bj::framework::Logger::SEVERITY_BITSET());
+
+    std::printf("%-16s %-22s %8s %12s %12s %12s %10s %10s %10s %10s %10s\n","operation","latency send/get/settle","count","avg [us]","max [us]","drain [us]","sent/op","recv/op","coalesced","skipped","max queue");
+
+    for(const HIDTransportEmulator::Latency& latency : LATENCIES)
+    {
+        profileSwitch(latency);
+        brightness(latency);
+        effectUpload(latency);
+        effectRepeat(latency);
+        brightnessDrag(latency);
+    }
+
+    std::printf("\n%-16s %-22s %8s %8s %12s %12s %12s\n","operation","latency send/get/settle","devices","count","avg [us]","max [us]","drain [us]");
+
+    for(const HIDTransportEmulator::Latency& latency : LATENCIES)
+    {
+        groupUpload(latency,1);
+        groupUpload(latency,GROUP_DEVICES);
+    }
+
+    std::printf("\n%-16s %-22s %8s %8s %8s %10s %12s %12s %12s\n","operation","latency send/get/settle","frames","dropped","errors","unchanged","last [us]","max [us]","budget [us]");
+
+    for(const HIDTransportEmulator::Latency& latency : LATENCIES)
+    {
+        directMode("direct mode",latency,std::make_unique<RGBDirectModeRainbowWaveEffect>(KEYBOARD_WIDTH));
+
+        /*
+         * Metric which does not change, only first frame has to be sent
+         */
+        auto                                levels = std::make_shared<RGBDirectModeMetricEffect::Levels>();
+        RGBDirectModeMetricEffect::Binding  binding;
+
+        binding.m_gradient.m_stops = {{0.0,ToRGBColor(0U,0U,255U)},{1.0,ToRGBColor(255U,0U,0U)}};
+        levels->set({0.5});
+
+        directMode("metric idle",latency,std::make_unique<RGBDirectModeMetricEffect>(std::vector<RGBDirectModeMetricEffect::Binding>{binding},levels,std::chrono::milliseconds(250)));
+    }
+
+    std::printf("\n%-16s %-22s %8s %8s %12s %12s %12s\n","operation","latency send/get/settle","frames","input","last [us]","max [us]","avg [us]");
+
+    {
+        QTemporaryDir     directory;
+        const std::string wav = QDir(directory.path()).filePath("sweep.wav").toStdString();
+
+        writeSweep(wav,AUDIO_RATE,RUN_TIME);
+
+        for(const HIDTransportEmulator::Latency& latency : LATENCIES)
+        {
+            audioSpectrum(latency,wav);
+        }
+    }
+
+    std::printf("\n%-20s %8s %10s %12s %12s\n","operation","count","leds/op","avg [ns]","max [ns]");
+
+    effectSerialization();
+
+    return EXIT_SUCCESS;
+}
+
+RGBBenchmark::Device RGBBenchmark::device(const HIDTransportEmulator::Latency &latency)
+{
+    std::unique_ptr<HIDTransportEmulator> emulator = std::make_unique<HIDTransportEmulator>(HIDTransportEmulator::keyboard(KEYBOARD_WIDTH,KEYBOARD_HEIGHT),HIDTransportEmulator::Latency{});
+    HIDTransportEmulator*                 transport = emulator.get();
+    LenovoUSBControllerC9xx*              usb       = new LenovoUSBControllerC9xx(std::move(emulator),"emulator",0xC965,0x048D);
+
+    /*
+     * Detection and initial refresh run without latency
+     */
+    Device device {
+        transport,
+        usb,
+        std::make_unique<LenovoRGBControllerC9xx>(usb)
+    };
+
+    usb->flush();
+    transport->setLatency(latency);
+
+    return device;
+}
+
+void RGBBenchmark::operation(const char *name, const HIDTransportEmulator::Latency &latency, const std::function<void (LenovoRGBControllerC9xx &, int)> &operation)
+{
+    Device                               device     = RGBBenchmark::device(latency);
+    const HIDTransportEmulator::Counters before     = device.m_emulator->counters();
+    const HIDWorker::Statistics          queueBefore= device.m_usb->getWorkerStatistics();
+    const auto                           begin      = std::chrono::steady_clock::now();
+    std::chrono::microseconds            total {0};
+    std::chrono::microseconds            max   {0};
+
+    for(int i = 0; i < ITERATIONS; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        operation(*device.m_controller,i);
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        total += elapsed;
+        max    = std::max(max,elapsed);
+    }
+
+    /*
+     * Until last queued transfer reached device
+     */
+    device.m_usb->flush();
+
+    const auto                           drain      = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+    const HIDTransportEmulator::Counters after      = device.m_emulator->counters();
+    const HIDWorker::Statistics          queueAfter = device.m_usb->getWorkerStatistics();
+
+    std::printf("%-16s %-22s %8d %12lld %12lld %12lld %10.1f %10.1f %10llu %10llu %10zu\n",
+                name,
+                latencyName(latency).toStdString().c_str(),
+                ITERATIONS,
+                static_cast<long long>(total.count() / ITERATIONS),
+                static_cast<long long>(max.count()),
+                static_cast<long long>(drain.count()),
+                static_cast<double>(after.m_sent - before.m_sent) / ITERATIONS,
+                static_cast<double>(after.m_received - before.m_received) / ITERATIONS,
+                static_cast<unsigned long long>(queueAfter.m_coalesced - queueBefore.m_coalesced),
+                static_cast<unsigned long long>(queueAfter.m_skipped - queueBefore.m_skipped),
+                queueAfter.m_maxQueueDepth);
+}
+
+void RGBBenchmark::profileSwitch(const HIDTransportEmulator::Latency &latency)
+{
+    operation("profile switch",latency,[](LenovoRGBControllerC9xx& controller,int i) {
+        QEventLoop loop;
+
+        QObject::connect(&controller,&RGBController::profileSettled,&loop,&QEventLoop::quit);
+
+        controller.SetProfile(controller.GetProfiles().min + (i + 1) % (controller.GetProfiles().max - controller.GetProfiles().min + 1));
+        controller.DeviceUpdateProfile();
+
+        if(controller.DeviceIsProfileSwitchPending())
+        {
+            loop.exec();
+        }
+    });
+}
+
+void RGBBenchmark::brightness(const HIDTransportEmulator::Latency &latency)
+{
+    operation("brightness",latency,[](LenovoRGBControllerC9xx& controller,int i) {
+        controller.SetBrightness(controller.GetBrightness().min + i % (controller.GetBrightness().max - controller.GetBrightness().min + 1));
+        controller.DeviceUpdateBrightness();
+    });
+}
+
+void RGBBenchmark::brightnessDrag(const HIDTransportEmulator::Latency &latency)
+{
+    /*
+     * Slider moved over whole range, only last value has to reach device
+     */
+    operation("brightness drag",latency,[](LenovoRGBControllerC9xx& controller,int i) {
+        for(unsigned int value = controller.GetBrightness().min; value <= controller.GetBrightness().max; ++value)
+        {
+            controller.SetBrightness(i % 2 == 0 ? value : controller.GetBrightness().max - (value - controller.GetBrightness().min));
+            controller.DeviceUpdateBrightness();
+        }
+    });
+}
+
+std::vector<led_group_effect> RGBBenchmark::rowEffects(const LenovoRGBControllerC9xx &controller, int shift)
+{
+    /*
+     * One group per keyboard row, hue of row moves with shift
+     */
+    std::vector<led_group_effect> effects;
+    const std::vector<led>&       leds = controller.GetLEDs();
+
+    for(size_t row = 0; row < KEYBOARD_HEIGHT; ++row)
+    {
+        led_group_effect effect {controller.GetModes().at(row % controller.GetModes().size()).value,2,0,MODE_COLORS_MODE_SPECIFIC,
+                                 {RGBDirectModeRainbowWaveEffect::fromHue(((row + shift) % KEYBOARD_HEIGHT) / static_cast<double>(KEYBOARD_HEIGHT))},
+                                 {}};
+
+        for(size_t j = row * KEYBOARD_WIDTH; j < std::min(leds.size(),(row + 1) * KEYBOARD_WIDTH); ++j)
+        {
+            effect.m_leds.push_back(leds[j]);
+        }
+
+        effects.push_back(effect);
+    }
+
+    return effects;
+}
+
+void RGBBenchmark::effectUpload(const HIDTransportEmulator::Latency &latency)
+{
+    operation("effect upload",latency,[](LenovoRGBControllerC9xx& controller,int i) {
+        controller.SetEfects(rowEffects(controller,i));
+        controller.DeviceUpdateEfects();
+    });
+}
+
+void RGBBenchmark::effectRepeat(const HIDTransportEmulator::Latency &latency)
+{
+    /*
+     * Same effects applied again, only first upload reaches device
+     */
+    operation("effect repeat",latency,[](LenovoRGBControllerC9xx& controller,int) {
+        controller.SetEfects(rowEffects(controller,0));
+        controller.DeviceUpdateEfects();
+    });
+}
+
+void RGBBenchmark::groupUpload(const HIDTransportEmulator::Latency &latency, size_t devices)
+{
+    RGBControllerGroup                      group;
+    std::vector<LenovoUSBControllerC9xx*>   usbs;
+    std::chrono::microseconds               total {0};
+    std::chrono::microseconds               max   {0};
+
+    for(size_t i = 0; i < devices; ++i)
+    {
+        Device device = RGBBenchmark::device(latency);
+
+        usbs.push_back(device.m_usb);
+        group.add(std::move(device.m_controller));
+    }
+
+    const LenovoRGBControllerC9xx& primary = static_cast<const LenovoRGBControllerC9xx&>(group.primary());
+    const auto                     begin   = std::chrono::steady_clock::now();
+
+    for(int i = 0; i < ITERATIONS; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        group.setEffects(rowEffects(primary,i));
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        total += elapsed;
+        max    = std::max(max,elapsed);
+    }
+
+    for(LenovoUSBControllerC9xx* usb : usbs)
+    {
+        usb->flush();
+    }
+
+    const auto drain = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+    std::printf("%-16s %-22s %8zu %8d %12lld %12lld %12lld\n",
+                "group upload",
+                latencyName(latency).toStdString().c_str(),
+                devices,
+                ITERATIONS,
+                static_cast<long long>(total.count() / ITERATIONS),
+                static_cast<long long>(max.count()),
+                static_cast<long long>(drain.count()));
+}
+
+void RGBBenchmark::directMode(const char *name, const HIDTransportEmulator::Latency &latency, std::unique_ptr<RGBDirectModeEngine::Effect> effect)
+{
+    Device device = RGBBenchmark::device(latency);
+
+    device.m_controller->DeviceStartDirectMode(std::move(effect));
+    std::this_thread::sleep_for(RUN_TIME);
+    device.m_controller->DeviceStopDirectMode();
+
+    const RGBDirectModeEngine::Statistics statistics = device.m_controller->DeviceGetDirectModeStatistics();
+
+    std::printf("%-16s %-22s %8llu %8llu %8llu %10llu %12lld %12lld %12lld\n",
+                name,
+                latencyName(latency).toStdString().c_str(),
+                static_cast<unsigned long long>(statistics.m_frames),
+                static_cast<unsigned long long>(statistics.m_dropped),
+                static_cast<unsigned long long>(statistics.m_sinkErrors),
+                static_cast<unsigned long long>(statistics.m_unchanged),
+                static_cast<long long>(statistics.m_lastFrame.count()),
+                static_cast<long long>(statistics.m_maxFrame.count()),
+                static_cast<long long>(statistics.m_budget.count()));
+}
+
+void RGBBenchmark::audioSpectrum(const HIDTransportEmulator::Latency &latency, const std::string &wav)
+{
+    Device device = RGBBenchmark::device(latency);
+
+    device.m_controller->DeviceStartDirectMode(std::make_unique<RGBDirectModeAudioSpectrumEffect>(std::make_shared<RGBAudioSpectrum>(std::make_unique<RGBAudioSource>(wav,RGBAudioSource::Format{}))));
+    std::this_thread::sleep_for(RUN_TIME);
+    device.m_controller->DeviceStopDirectMode();
+
+    const RGBDirectModeEngine::Statistics statistics = device.m_controller->DeviceGetDirectModeStatistics();
+
+    std::printf("%-16s %-22s %8llu %8llu %12lld %12lld %12lld\n",
+                "audio spectrum",
+                latencyName(latency).toStdString().c_str(),
+                static_cast<unsigned long long>(statistics.m_frames),
+                static_cast<unsigned long long>(statistics.m_inputFrames),
+                static_cast<long long>(statistics.m_lastInputLatency.count()),
+                static_cast<long long>(statistics.m_maxInputLatency.count()),
+                static_cast<long long>(statistics.m_avgInputLatency.count()));
+}
+
+void RGBBenchmark::conversion(const char *name, const std::function<size_t (const LenovoRGBControllerC9xx &)> &operation)
+{
+    Device                   device = RGBBenchmark::device(LATENCIES[0]);
+    std::chrono::nanoseconds total {0};
+    std::chrono::nanoseconds max   {0};
+    size_t                   leds  = 0;
+
+    for(int i = 0; i < CPU_ITERATIONS; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        leds += operation(*device.m_controller);
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        total += elapsed;
+        max    = std::max(max,elapsed);
+    }
+
+    std::printf("%-20s %8d %10zu %12lld %12lld\n",
+                name,
+                CPU_ITERATIONS,
+                leds / CPU_ITERATIONS,
+                static_cast<long long>(total.count() / CPU_ITERATIONS),
+                static_cast<long long>(max.count()));
+}
+
+void RGBBenchmark::effectSerialization()
+{
+    /*
+     * Whole layout, one group per row
+     */
+    conversion("effects to device",[](const LenovoRGBControllerC9xx& controller) {
+        static const std::vector<led_group_effect> effects = rowEffects(controller,0);
+        size_t                                      leds    = 0;
+
+        for(const auto& group : controller.toControlerGroups(effects))
+        {
+            leds += group.m_leds.size();
+        }
+
+        return leds;
+    });
+
+    conversion("effects from device",[](const LenovoRGBControllerC9xx& controller) {
+        static const std::vector<LenovoUSBController::led_group> groups = controller.toControlerGroups(rowEffects(controller,0));
+        size_t                                                  leds    = 0;
+
+        for(const auto& effect : controller.fromControlerGroups(groups))
+        {
+            leds += effect.m_leds.size();
+        }
+
+        return leds;
+    });
+
+    conversion("key lookup",[](const LenovoRGBControllerC9xx& controller) {
+        size_t leds = 0;
+
+        for(const auto& led : controller.GetLEDs())
+        {
+            leds += controller.GetLedsIndexesByDeviceSpecificValue(led.value).size();
+        }
+
+        return leds;
+    });
+}
+
+}
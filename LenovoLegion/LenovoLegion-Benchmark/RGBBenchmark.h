@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBControllerInterface.h"
+#include "RGBDirectModeEngine.h"
+#include "HIDTransportEmulator.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+class LenovoRGBControllerC9xx;
+class LenovoUSBControllerC9xx;
+
+/*
+ * RGB pipeline benchmarks over emulated keyboard controller
+ *
+ * Every scenario runs with several transport latencies. Set operations are queued on HID
+ * worker, time seen by caller and time until queue is drained are reported separately.
+ * Group upload writes the same effects to several devices, drain close to one device means
+ * that devices are written in parallel.
+ * Audio spectrum plays generated WAV file and reports latency from audio capture to sent
+ * frame. Conversions which do not touch transport are timed separately, without latency.
+ * Results are written to standard output.
+ */
+class RGBBenchmark
+{
+public:
+
+    static constexpr std::chrono::milliseconds  RUN_TIME        {2000};
+    static constexpr int                        ITERATIONS      = 50;
+    static constexpr int                        CPU_ITERATIONS  = 10000;
+    static constexpr quint32                    AUDIO_RATE      = 48000;
+    static constexpr size_t                     GROUP_DEVICES   = 3;
+
+public:
+
+    static int run(int argc, char *argv[]);
+
+private:
+
+    struct Device {
+        HIDTransportEmulator*                       m_emulator;     // Owned by controller
+        LenovoUSBControllerC9xx*                    m_usb;          // Owned by controller
+        std::unique_ptr<LenovoRGBControllerC9xx>    m_controller;
+    };
+
+    static Device   device(const HIDTransportEmulator::Latency& latency);
+
+    static std::vector<led_group_effect> rowEffects(const LenovoRGBControllerC9xx& controller,int shift);
+
+    static void     operation(const char* name,const HIDTransportEmulator::Latency& latency,const std::function<void (LenovoRGBControllerC9xx&,int)>& operation);
+
+    static void     profileSwitch(const HIDTransportEmulator::Latency& latency);
+    static void     brightness(const HIDTransportEmulator::Latency& latency);
+    static void     brightnessDrag(const HIDTransportEmulator::Latency& latency);
+    static void     effectUpload(const HIDTransportEmulator::Latency& latency);
+    static void     effectRepeat(const HIDTransportEmulator::Latency& latency);
+    static void     groupUpload(const HIDTransportEmulator::Latency& latency,size_t devices);
+    static void     directMode(const char* name,const HIDTransportEmulator::Latency& latency,std::unique_ptr<RGBDirectModeEngine::Effect> effect);
+    static void     audioSpectrum(const HIDTransportEmulator::Latency& latency,const std::string& wav);
+
+    /*
+     * Operation returns number of LEDs it went through
+     */
+    static void     conversion(const char* name,const std::function<size_t (const LenovoRGBControllerC9xx&)>& operation);
+
+    static void     effectSerialization();
+};
+
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "RGBBenchmark.h"
+#include "NotifierBenchmark.h"
+
+#include <cstdlib>
+
+int main(int argc, char *argv[])
+{
+    const int result = LenovoLegionDaemon::RGBBenchmark::run(argc,argv);
+
+    if(result != EXIT_SUCCESS)
+    {
+        return result;
+    }
+
+    return LenovoLegionDaemon::NotifierBenchmark::run();
+}
@@ -12,6 +12,7 @@
 
 #include "DataProviderManager.h"
 #include "SysFsDriverManager.h"
+#include "SamplingGovernor.h"
 
 
 /*
@@ -47,6 +48,7 @@
 #include "SysFsDataProviderFanOption.h"
 #include "SysFsDataProviderCPUFrequency.h"
 #include "SysFsDataProviderCPUOptions.h"
+#include "SysFsDataProviderCPUPolicy.h"
 #include "SysFsDataProviderCPUSMT.h"
 #include "SysFsDataProviderIntelMSR.h"
 #include "SysFsDataProviderCPUInfo.h"
@@ -55,10 +57,16 @@
 #include "SysFsDataProviderOtherGpuSwitch.h"
 
 #include "DataProviderNvidiaNvml.h"
+#include "DataProviderFanController.h"
+#include "DataProviderCPUStatistics.h"
 #include "DataProviderDaemonSettings.h"
+#include "DataProviderWorkloadRules.h"
+#include "DataProviderProfiles.h"
 #include "DataProviderRGBController.h"
 
 #include "DaemonSettingsManager.h"
+#include "MetricsExporter.h"
+#include "WorkloadRulesEngine.h"
 
 
 #include <Core/LoggerHolder.h>
@@ -79,6 +87,8 @@ Application::Application(int &argc, char *argv[]) :
     m_serverSocketNotification(new QLocalServer(this)),
     m_sysFsDriverManager(new SysFsDriverManager(this)),
     m_dataProviderManager(new DataProviderManager(m_sysFsDriverManager,this)),
+    m_metricsExporter(new MetricsExporter(m_sysFsDriverManager,m_dataProviderManager,this)),
+    m_workloadRulesEngine(new WorkloadRulesEngine(m_sysFsDriverManager,m_dataProviderManager,this)),
     m_protocolProcessor(nullptr),
     m_protocolProcessorNotification(nullptr)
 {
@@ -121,15 +131,20 @@ Application::Application(int &argc, char *argv[]) :
     m_dataProviderManager->addDataProvider(new SysFsDataProviderFanOption(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderCPUFrequency(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderCPUOptions(m_sysFsDriverManager,m_dataProviderManager));
+    m_dataProviderManager->addDataProvider(new SysFsDataProviderCPUPolicy(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderCPUSMT(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderIntelMSR(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderCPUInfo(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderMachineInformation(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderOther(m_sysFsDriverManager,m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new SysFsDataProviderOtherGpuSwitch(m_sysFsDriverManager,m_dataProviderManager));
+    m_dataProviderManager->addDataProvider(new DataProviderFanController(m_sysFsDriverManager,m_dataProviderManager));
+    m_dataProviderManager->addDataProvider(new DataProviderCPUStatistics(m_sysFsDriverManager,m_dataProviderManager));
 
     m_dataProviderManager->addDataProvider(new DataProviderNvidiaNvml(m_dataProviderManager));
     m_dataProviderManager->addDataProvider(new DataProviderDaemonSettings(m_dataProviderManager));
+    m_dataProviderManager->addDataProvider(new DataProviderProfiles(m_dataProviderManager));
+    m_dataProviderManager->addDataProvider(new DataProviderWorkloadRules(m_dataProviderManager,m_workloadRulesEngine));
     m_dataProviderManager->addDataProvider(new DataProviderRGBController(m_dataProviderManager));
 }
 
@@ -175,11 +190,33 @@ void Application::appInitImpl(std::unique_ptr<ApplicationModulesHandler_T>)
      */
     connect(m_sysFsDriverManager,&SysFsDriverManager::kernelEvent,m_dataProviderManager,&DataProviderManager::kernelEventHandler);
 
+    /*
+     * CPUs toggled by the daemon do not report udev event, CPU policy and statistics take them directly
+     */
+    connect(dynamic_cast<SysFsDataProviderCPUOptions*>(&m_dataProviderManager->getDataProvider(SysFsDataProviderCPUOptions::dataType)),&SysFsDataProviderCPUOptions::cpuOnlineChanged,
+            dynamic_cast<SysFsDataProviderCPUPolicy*>(&m_dataProviderManager->getDataProvider(SysFsDataProviderCPUPolicy::dataType)),&SysFsDataProviderCPUPolicy::cpuOnlineChanged);
+    connect(dynamic_cast<SysFsDataProviderCPUOptions*>(&m_dataProviderManager->getDataProvider(SysFsDataProviderCPUOptions::dataType)),&SysFsDataProviderCPUOptions::cpuOnlineChanged,
+            dynamic_cast<DataProviderCPUStatistics*>(&m_dataProviderManager->getDataProvider(DataProviderCPUStatistics::dataType)),&DataProviderCPUStatistics::cpuOnlineChanged);
+
 
     /*
      * Load settings
      */
-    DaemonSettingsManager::getInstance().loadAllSettings(m_dataProviderManager);
+    DaemonSettingsManager::getInstance().loadAllSettings(m_sysFsDriverManager,m_dataProviderManager);
+
+    /*
+     * Start metrics exporter, follows daemon settings changes
+     */
+    m_metricsExporter->listen(QString(DaemonSettingsManager::getInstance().getDaemonSettings().metrics_exporter_listen().data()));
+
+    connect(dynamic_cast<DataProviderDaemonSettings*>(&m_dataProviderManager->getDataProvider(DataProviderDaemonSettings::dataType)),&DataProviderDaemonSettings::daemonSettingsChanged,this,[this]() {
+        m_metricsExporter->listen(QString(DaemonSettingsManager::getInstance().getDaemonSettings().metrics_exporter_listen().data()));
+    });
+
+    /*
+     * Start workload rules, they switch profiles over the loaded settings
+     */
+    m_workloadRulesEngine->start();
 
     /*
      * Start Server
@@ -234,6 +271,16 @@ void Application::appStopImpl() noexcept
     disconnect(m_serverSocketNotification,&QLocalServer::newConnection,this,&Application::newConnectionNotificationHandler);
     m_serverSocketNotification->close();
 
+    /*
+     * Stop metrics exporter
+     */
+    m_metricsExporter->listen({});
+
+    /*
+     * Stop workload rules, no profile switch while saving settings
+     */
+    m_workloadRulesEngine->stop();
+
     /*
      * Save settings
      */
@@ -302,6 +349,8 @@ void Application::newConnectionHandler()
             
             // Only assign to member if everything succeeded
             m_protocolProcessor = newProcessor;
+
+            SamplingGovernor::getInstance().setSubscribers(1);
         }
         catch(...) {
             // Clean up on failure
@@ -358,6 +407,7 @@ void Application::newConnectionNotificationHandler()
         try {
             connect(m_sysFsDriverManager,&SysFsDriverManager::kernelEvent,dynamic_cast<ProtocolProcessorNotifier*>(newProcessor),&ProtocolProcessorNotifier::kernelEventHandler);
             connect(m_sysFsDriverManager,&SysFsDriverManager::moduleSubsystem,dynamic_cast<ProtocolProcessorNotifier*>(newProcessor),&ProtocolProcessorNotifier::moduleSubsystemHandler);
+            connect(dynamic_cast<DataProviderRGBController*>(&m_dataProviderManager->getDataProvider(DataProviderRGBController::dataType)),&DataProviderRGBController::ledStateChanged,dynamic_cast<ProtocolProcessorNotifier*>(newProcessor),&ProtocolProcessorNotifier::ledStateChangedHandler);
             connect(dynamic_cast<ProtocolProcessorNotifier*>(newProcessor),&ProtocolProcessorNotifier::clientDisconnected,this,&Application::connectionNotificationDisconnectedHandler);
             newProcessor->start();
             
@@ -393,6 +443,8 @@ void Application::connectionDisconnectedHandler()
     LOG_D("Client disconnected, stopping processor !");
 
     deleteProtocolProcessors<ProtocolProcessorBase,ProtocolProcessor>(m_protocolProcessor);
+
+    SamplingGovernor::getInstance().setSubscribers(0);
 }
 
 void Application::connectionNotificationDisconnectedHandler()
@@ -23,6 +23,8 @@ class SysFsStructure;
 class ProtocolProcessorBase;
 class DataProviderManager;
 class SysFsDriverManager;
+class MetricsExporter;
+class WorkloadRulesEngine;
 
 class Application : public QCoreApplication,
                     public bj::framework::ApplicationInterface
@@ -140,6 +142,18 @@ private:
     DataProviderManager*            m_dataProviderManager;
 
 
+    /*
+     * Optional Prometheus metrics exporter
+     */
+    MetricsExporter*                m_metricsExporter;
+
+
+    /*
+     * Automatic profile switching by workload
+     */
+    WorkloadRulesEngine*            m_workloadRulesEngine;
+
+
     /*
      * Processing of the server protocol part
      */
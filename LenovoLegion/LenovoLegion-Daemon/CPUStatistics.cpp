@@ -0,0 +1,444 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "CPUStatistics.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace LenovoLegionDaemon {
+
+static constexpr quint64 MASK_SET   = ~quint64(0);
+static constexpr quint64 MASK_CLEAR = 0;
+
+/*
+ * /proc/stat is generated on read, buffer grows when one read does not fit
+ */
+static constexpr size_t PROC_STAT_BUFFER_SIZE = 16 * 1024;
+
+
+CPUStatistics::CPUStatistics(const Layout &layout) :
+    m_cpuCount(layout.m_scalingCurFreq.size()),
+    m_stop(false),
+    m_reschedule(false),
+    m_governor("cpu_statistics",SamplingGovernor::Policy{PERIOD},[this] {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_reschedule = true;
+        }
+        m_wakeUp.notify_all();
+    }),
+    m_procStatFd(::open("/proc/stat",O_RDONLY | O_CLOEXEC)),
+    m_buffer(PROC_STAT_BUFFER_SIZE,'\0'),
+    m_coreMask(m_cpuCount,MASK_CLEAR),
+    m_atomMask(m_cpuCount,MASK_CLEAR),
+    m_allMask(m_cpuCount,MASK_SET),
+    m_online(m_cpuCount,MASK_CLEAR),
+    m_prevOnline(m_cpuCount,MASK_CLEAR),
+    m_busyTicks(m_cpuCount,0),
+    m_totalTicks(m_cpuCount,0),
+    m_prevBusyTicks(m_cpuCount,0),
+    m_prevTotalTicks(m_cpuCount,0),
+    m_freq(m_cpuCount,0),
+    m_windowBusy(m_cpuCount * WINDOW,0),
+    m_windowTotal(m_cpuCount * WINDOW,0),
+    m_windowFreqBusy(m_cpuCount * WINDOW,0),
+    m_sumBusy(m_cpuCount,0),
+    m_sumTotal(m_cpuCount,0),
+    m_sumFreqBusy(m_cpuCount,0),
+    m_windowSlot(0)
+{
+    if(m_procStatFd < 0)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Unable to open /proc/stat, utilization not available");
+    }
+
+    for(size_t cpu = 0; cpu < m_cpuCount; ++cpu)
+    {
+        m_freqFds.push_back(layout.m_scalingCurFreq[cpu].has_value() ? ::open(layout.m_scalingCurFreq[cpu].value().c_str(),O_RDONLY | O_CLOEXEC) : -1);
+
+        m_coreMask[cpu] = cpu < layout.m_core.size() && layout.m_core[cpu] ? MASK_SET : MASK_CLEAR;
+        m_atomMask[cpu] = cpu < layout.m_atom.size() && layout.m_atom[cpu] ? MASK_SET : MASK_CLEAR;
+    }
+
+    m_snapshot.m_cpus.resize(m_cpuCount);
+}
+
+CPUStatistics::~CPUStatistics()
+{
+    stop();
+
+    for(const int fd : m_freqFds)
+    {
+        if(fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    if(m_procStatFd >= 0)
+    {
+        ::close(m_procStatFd);
+    }
+}
+
+void CPUStatistics::start()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = false;
+    }
+
+    m_thread = std::thread(&CPUStatistics::run,this);
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + QString(" - CPU statistics sampler started for %1 CPUs").arg(m_cpuCount));
+}
+
+void CPUStatistics::stop()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    if(m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+CPUStatistics::Snapshot CPUStatistics::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_snapshot;
+}
+
+void CPUStatistics::refresh(size_t cpu, const Layout &layout)
+{
+    if(cpu >= m_cpuCount || cpu >= layout.m_scalingCurFreq.size())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_refreshes.push_back({
+        .m_cpu              = cpu,
+        .m_scalingCurFreq   = layout.m_scalingCurFreq[cpu],
+        .m_core             = cpu < layout.m_core.size() && layout.m_core[cpu],
+        .m_atom             = cpu < layout.m_atom.size() && layout.m_atom[cpu]
+    });
+}
+
+void CPUStatistics::run()
+{
+    auto deadline = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while(!m_stop)
+    {
+        m_reschedule = false;
+
+        std::vector<Refresh> refreshes;
+        refreshes.swap(m_refreshes);
+
+        lock.unlock();
+
+        for(const Refresh& refresh : refreshes)
+        {
+            applyRefresh(refresh);
+        }
+
+        const auto started  = std::chrono::steady_clock::now();
+        sample();
+        const auto done     = std::chrono::steady_clock::now();
+
+        // Governor is not called under m_mutex, its wake callback takes it
+        const auto interval = m_governor.next(changed());
+
+        lock.lock();
+
+        m_snapshot.m_samples++;
+        m_snapshot.m_maxSample = std::max(m_snapshot.m_maxSample,std::chrono::duration_cast<std::chrono::microseconds>(done - started));
+        m_snapshot.m_interval  = interval;
+
+        deadline += interval;
+
+        // Missed periods are dropped, window keeps tick deltas so averages stay correct
+        if(done >= deadline)
+        {
+            m_snapshot.m_overruns++;
+            deadline = done + interval;
+        }
+
+        m_wakeUp.wait_until(lock,deadline,[this] { return m_stop || m_reschedule; });
+
+        // Woken by governor, sample now and take the new interval from there
+        if(m_reschedule)
+        {
+            deadline = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+bool CPUStatistics::changed()
+{
+    Aggregate all;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        all = m_snapshot.m_all;
+    }
+
+    const quint32 freqDelta = all.m_avgFreq > m_governed.m_avgFreq ? all.m_avgFreq - m_governed.m_avgFreq : m_governed.m_avgFreq - all.m_avgFreq;
+
+    if(std::abs(all.m_busy - m_governed.m_busy) < CHANGE_BUSY && freqDelta < CHANGE_FREQ && all.m_cpus == m_governed.m_cpus)
+    {
+        return false;
+    }
+
+    m_governed = all;
+
+    return true;
+}
+
+void CPUStatistics::sample()
+{
+    if(!readProcStat())
+    {
+        return;
+    }
+
+    readFrequencies();
+
+    quint64* const slotBusy      = m_windowBusy.data()     + m_windowSlot * m_cpuCount;
+    quint64* const slotTotal     = m_windowTotal.data()    + m_windowSlot * m_cpuCount;
+    quint64* const slotFreqBusy  = m_windowFreqBusy.data() + m_windowSlot * m_cpuCount;
+
+    /*
+     * Delta only for CPUs online in both reads, counters of a CPU coming back from offline
+     * cover the time it was away
+     */
+    for(size_t cpu = 0; cpu < m_cpuCount; ++cpu)
+    {
+        const quint64 valid     = m_online[cpu] & m_prevOnline[cpu];
+        const quint64 busy      = (m_busyTicks[cpu]  >= m_prevBusyTicks[cpu]  ? m_busyTicks[cpu]  - m_prevBusyTicks[cpu]  : 0) & valid;
+        const quint64 total     = (m_totalTicks[cpu] >= m_prevTotalTicks[cpu] ? m_totalTicks[cpu] - m_prevTotalTicks[cpu] : 0) & valid;
+        const quint64 freqBusy  = m_freq[cpu] * busy;
+
+        m_sumBusy[cpu]          = m_sumBusy[cpu]     - slotBusy[cpu]     + busy;
+        m_sumTotal[cpu]         = m_sumTotal[cpu]    - slotTotal[cpu]    + total;
+        m_sumFreqBusy[cpu]      = m_sumFreqBusy[cpu] - slotFreqBusy[cpu] + freqBusy;
+
+        slotBusy[cpu]           = busy;
+        slotTotal[cpu]          = total;
+        slotFreqBusy[cpu]       = freqBusy;
+    }
+
+    m_prevOnline.swap(m_online);
+    m_prevBusyTicks.swap(m_busyTicks);
+    m_prevTotalTicks.swap(m_totalTicks);
+
+    m_windowSlot = (m_windowSlot + 1) % WINDOW;
+
+    publish();
+}
+
+void CPUStatistics::applyRefresh(const Refresh &refresh)
+{
+    const size_t cpu = refresh.m_cpu;
+
+    if(m_freqFds[cpu] >= 0)
+    {
+        ::close(m_freqFds[cpu]);
+    }
+
+    /*
+     * cpufreq files of offline CPU are gone, its old file is not read again after it comes back
+     */
+    m_freqFds[cpu]  = refresh.m_scalingCurFreq.has_value() ? ::open(refresh.m_scalingCurFreq.value().c_str(),O_RDONLY | O_CLOEXEC) : -1;
+    m_freq[cpu]     = 0;
+
+    m_coreMask[cpu] = refresh.m_core ? MASK_SET : MASK_CLEAR;
+    m_atomMask[cpu] = refresh.m_atom ? MASK_SET : MASK_CLEAR;
+
+    /*
+     * Counters of the toggled CPU are taken as first read again, no delta over the toggle
+     */
+    m_prevOnline[cpu] = MASK_CLEAR;
+}
+
+bool CPUStatistics::readProcStat()
+{
+    if(m_procStatFd < 0)
+    {
+        return false;
+    }
+
+    ssize_t size = 0;
+
+    for(;;)
+    {
+        size = ::pread(m_procStatFd,m_buffer.data(),m_buffer.size(),0);
+
+        if(size < 0)
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Read of /proc/stat failed");
+            return false;
+        }
+
+        if(static_cast<size_t>(size) < m_buffer.size())
+        {
+            break;
+        }
+
+        m_buffer.resize(m_buffer.size() * 2);
+    }
+
+    std::fill(m_online.begin(),m_online.end(),MASK_CLEAR);
+
+    const char*       line = m_buffer.data();
+    const char* const end  = m_buffer.data() + size;
+
+    /*
+     * Per CPU lines follow the summary line, the first line without "cpu" ends them
+     */
+    while(line < end)
+    {
+        const char* const eol = std::find(line,end,'\n');
+
+        if(eol - line < 3 || std::string_view(line,3) != "cpu")
+        {
+            break;
+        }
+
+        unsigned int cpu     = 0;
+        auto         result  = std::from_chars(line + 3,eol,cpu);
+
+        if(result.ec == std::errc() && cpu < m_cpuCount)
+        {
+            // user nice system idle iowait irq softirq steal
+            quint64     ticks[8] = {};
+            const char* field    = result.ptr;
+
+            for(quint64& tick : ticks)
+            {
+                while(field < eol && *field == ' ')
+                {
+                    ++field;
+                }
+
+                result = std::from_chars(field,eol,tick);
+                if(result.ec != std::errc())
+                {
+                    break;
+                }
+                field = result.ptr;
+            }
+
+            m_busyTicks[cpu]  = ticks[0] + ticks[1] + ticks[2] + ticks[5] + ticks[6] + ticks[7];
+            m_totalTicks[cpu] = m_busyTicks[cpu] + ticks[3] + ticks[4];
+            m_online[cpu]     = MASK_SET;
+        }
+
+        line = eol + 1;
+    }
+
+    return true;
+}
+
+void CPUStatistics::readFrequencies()
+{
+    char buffer[32];
+
+    for(size_t cpu = 0; cpu < m_cpuCount; ++cpu)
+    {
+        if(m_freqFds[cpu] < 0 || m_online[cpu] == MASK_CLEAR)
+        {
+            continue;
+        }
+
+        const ssize_t size = ::pread(m_freqFds[cpu],buffer,sizeof(buffer),0);
+
+        if(size > 0)
+        {
+            std::from_chars(buffer,buffer + size,m_freq[cpu]);
+        }
+    }
+}
+
+void CPUStatistics::publish()
+{
+    std::vector<CPUX> cpus(m_cpuCount);
+
+    for(size_t cpu = 0; cpu < m_cpuCount; ++cpu)
+    {
+        cpus[cpu].m_online  = m_prevOnline[cpu] != MASK_CLEAR;
+        cpus[cpu].m_busy    = m_sumTotal[cpu] > 0 ? 100.0 * m_sumBusy[cpu] / m_sumTotal[cpu] : 0;
+        cpus[cpu].m_avgFreq = static_cast<quint32>(m_sumBusy[cpu] > 0 ? m_sumFreqBusy[cpu] / m_sumBusy[cpu] : m_freq[cpu]);
+    }
+
+    const Aggregate all  = reduce(m_allMask);
+    const Aggregate core = reduce(m_coreMask);
+    const Aggregate atom = reduce(m_atomMask);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_snapshot.m_cpus.swap(cpus);
+    m_snapshot.m_all  = all;
+    m_snapshot.m_core = core;
+    m_snapshot.m_atom = atom;
+}
+
+CPUStatistics::Aggregate CPUStatistics::reduce(const std::vector<quint64> &mask) const
+{
+    quint64 cpus        = 0;
+    quint64 busy        = 0;
+    quint64 total       = 0;
+    quint64 freqBusy    = 0;
+
+    /*
+     * Branch free integer reductions, the compiler vectorizes them
+     */
+    for(size_t cpu = 0; cpu < m_cpuCount; ++cpu)
+    {
+        cpus     += m_prevOnline[cpu]  & mask[cpu] & 1;
+        busy     += m_sumBusy[cpu]     & mask[cpu];
+        total    += m_sumTotal[cpu]    & mask[cpu];
+        freqBusy += m_sumFreqBusy[cpu] & mask[cpu];
+    }
+
+    Aggregate aggregate;
+
+    aggregate.m_cpus    = static_cast<quint32>(cpus);
+    aggregate.m_busy    = total > 0 ? 100.0 * busy / total : 0;
+    aggregate.m_avgFreq = static_cast<quint32>(busy > 0 ? freqBusy / busy : 0);
+
+    return aggregate;
+}
+
+}
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "SamplingGovernor.h"
+
+#include <QtGlobal>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Per CPU utilization and frequency statistics
+ *
+ * Sampler thread reads /proc/stat and scaling_cur_freq of every CPU on a fixed cadence,
+ * files are kept open and re-read with pread. Values are kept over a sliding window of
+ * samples in per CPU arrays, window sums are updated incrementally and aggregates are
+ * masked reductions over those arrays. Effective frequency is the scaling_cur_freq
+ * weighted by busy time, the closest thing to APERF/MPERF available without MSR access.
+ *
+ * Sampling interval is PERIOD while values move, the sampling governor stretches it when
+ * they are stable, on battery or without clients. Window always holds the last WINDOW
+ * samples, so it covers a longer time when sampling slows down.
+ *
+ * CPU toggled by hotplug is refreshed alone, its scaling_cur_freq is reopened and its
+ * delta restarts, other CPUs keep their files and window.
+ */
+class CPUStatistics
+{
+public:
+
+    static constexpr std::chrono::milliseconds  PERIOD {100};
+
+    /*
+     * Aggregate changes counted as change by the sampling governor
+     */
+    static constexpr double                     CHANGE_BUSY     = 2;        // Percent
+    static constexpr quint32                    CHANGE_FREQ     = 100000;   // kHz
+
+    /*
+     * Samples in the sliding window, one second with the default period
+     */
+    static constexpr size_t                     WINDOW = 10;
+
+    struct Layout {
+        std::vector<std::optional<std::filesystem::path>>   m_scalingCurFreq;   // Indexed by CPU, size is the number of possible CPUs
+        std::vector<bool>                                   m_core;             // P-cores
+        std::vector<bool>                                   m_atom;             // E-cores
+    };
+
+    struct CPUX {
+        bool                        m_online    = false;
+        double                      m_busy      = 0;    // Percent
+        quint32                     m_avgFreq   = 0;    // kHz
+    };
+
+    struct Aggregate {
+        quint32                     m_cpus      = 0;    // Online CPUs
+        double                      m_busy      = 0;    // Percent
+        quint32                     m_avgFreq   = 0;    // kHz
+    };
+
+    struct Snapshot {
+        std::vector<CPUX>           m_cpus;
+        Aggregate                   m_all;
+        Aggregate                   m_core;
+        Aggregate                   m_atom;
+        quint64                     m_samples   = 0;
+        quint64                     m_overruns  = 0;
+        std::chrono::microseconds   m_maxSample {0};
+        std::chrono::milliseconds   m_interval  {PERIOD};
+    };
+
+public:
+
+    explicit CPUStatistics(const Layout& layout);
+    ~CPUStatistics();
+
+    CPUStatistics(const CPUStatistics&)            = delete;
+    CPUStatistics& operator=(const CPUStatistics&) = delete;
+
+    void     start();
+    void     stop();
+
+    /*
+     * Thread safe, result of the last sample
+     */
+    Snapshot snapshot() const;
+
+    /*
+     * Thread safe, CPU takes its entries of layout before the next sample
+     */
+    void     refresh(size_t cpu,const Layout& layout);
+
+private:
+
+    struct Refresh {
+        size_t                                  m_cpu;
+        std::optional<std::filesystem::path>    m_scalingCurFreq;
+        bool                                    m_core;
+        bool                                    m_atom;
+    };
+
+private:
+
+    void    run();
+    void    sample();
+    void    applyRefresh(const Refresh& refresh);
+
+    bool    changed();
+
+    bool    readProcStat();
+    void    readFrequencies();
+    void    publish();
+
+    Aggregate reduce(const std::vector<quint64>& mask) const;
+
+private:
+
+    const size_t                            m_cpuCount;
+
+    mutable std::mutex                      m_mutex;
+    std::condition_variable                 m_wakeUp;
+    std::thread                             m_thread;
+    bool                                    m_stop;
+    bool                                    m_reschedule;       // Governor state changed, interval has to be taken again
+    std::vector<Refresh>                    m_refreshes;        // Hotplugged CPUs waiting for the sampler thread
+
+    SamplingGovernor::Source                m_governor;
+
+    Snapshot                                m_snapshot;
+
+    /*
+     * Sampler state, owned by sampler thread
+     */
+    int                                     m_procStatFd;
+    std::vector<int>                        m_freqFds;
+    std::string                             m_buffer;
+
+    /*
+     * Per CPU arrays, masks are all ones or zero so reductions are plain and + add loops
+     */
+    std::vector<quint64>                    m_coreMask;
+    std::vector<quint64>                    m_atomMask;
+    std::vector<quint64>                    m_allMask;
+
+    std::vector<quint64>                    m_online;           // Mask, CPU is listed in /proc/stat
+    std::vector<quint64>                    m_prevOnline;
+    std::vector<quint64>                    m_busyTicks;        // Cumulative counters of the last read
+    std::vector<quint64>                    m_totalTicks;
+    std::vector<quint64>                    m_prevBusyTicks;
+    std::vector<quint64>                    m_prevTotalTicks;
+    std::vector<quint64>                    m_freq;             // Last sampled scaling_cur_freq, kHz
+
+    std::vector<quint64>                    m_windowBusy;       // WINDOW x CPUs ring of deltas
+    std::vector<quint64>                    m_windowTotal;
+    std::vector<quint64>                    m_windowFreqBusy;
+    std::vector<quint64>                    m_sumBusy;          // Window sums per CPU
+    std::vector<quint64>                    m_sumTotal;
+    std::vector<quint64>                    m_sumFreqBusy;
+    size_t                                  m_windowSlot;
+
+    Aggregate                               m_governed;         // Aggregate of the last change reported to governor
+};
+
+}
@@ -6,6 +6,7 @@
  *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
  */
 #include "Settings.h"
+#include "SettingsApplyGraph.h"
 #include "DaemonSettingsManager.h"
 
 #include "DataProviderManager.h"
@@ -13,6 +14,7 @@
 #include "SysFsDataProviderCPUOptions.h"
 #include "SysFsDataProviderCPUFrequency.h"
 #include "SysFsDataProviderFanCurve.h"
+#include "DataProviderFanController.h"
 #include "SysFsDataProviderFanOption.h"
 #include "SysFsDataProviderCPUSMT.h"
 #include "SysFsDataProviderCPUPower.h"
@@ -20,9 +22,20 @@
 #include "DataProviderNvidiaNvml.h"
 #include "SysFsDataProviderIntelMSR.h"
 #include "SysFsDataProviderOther.h"
+#include "DataProviderDaemonSettings.h"
+
+#include "SysFsDriverManager.h"
+#include "SysFsDriverLegionOther.h"
+#include "SysFsDriverLegionEvents.h"
+#include "SysFsDriverCPUXList.h"
+#include "SysFSDriverLegionIntelMSR.h"
 
 #include <Core/LoggerHolder.h>
 
+#include <QScopeGuard>
+
+#include <chrono>
+
 namespace LenovoLegionDaemon {
 
 DaemonSettingsManager& DaemonSettingsManager::getInstance()
@@ -35,9 +48,14 @@ DaemonSettingsManager::DaemonSettingsManager() : m_daemonSettings{}
 {
 }
 
-void DaemonSettingsManager::loadAllSettings(DataProviderManager* dataProviderManager)
+void DaemonSettingsManager::loadAllSettings(SysFsDriverManager* sysFsDriverManager,DataProviderManager* dataProviderManager)
 {
     LOG_T("DaemonSettingsManager::loadAllSettings - start");
+
+    const auto started = std::chrono::steady_clock::now();
+    auto       logTime = qScopeGuard([&started] {
+        LOG_D(QString("DaemonSettingsManager::loadAllSettings - took %1 ms").arg(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count()));
+    });
     
     // Always load daemon settings first
     loadDaemonSettings();
@@ -52,7 +70,12 @@ void DaemonSettingsManager::loadAllSettings(DataProviderManager* dataProviderMan
     
     // Load power profile first to check if CUSTOM mode is saved
     legion::messages::PowerProfile savedProfile;
-    SettingsLoaderPowerProfiles().loadPowerProfile(savedProfile);
+    {
+        SettingsStore::Transaction transaction;
+        const QByteArray           data = SettingsStore::getInstance().data(SysFsDataProviderPowerProfile::dataType);
+
+        savedProfile.ParseFromArray(data.data(),data.size());
+    }
     bool isCustomProfile = savedProfile.current_value() &&
                           savedProfile.current_value() == legion::messages::PowerProfile_Profiles_POWER_PROFILE_CUSTOM;
     
@@ -62,25 +85,64 @@ void DaemonSettingsManager::loadAllSettings(DataProviderManager* dataProviderMan
         LOG_D("DaemonSettingsManager::loadAllSettings - Non-CUSTOM power profile, will skip custom-only settings");
     }
     
-    // Always load power profile
-    loadPowerProfile(dataProviderManager);
-    loadCPUControlData(dataProviderManager);
-    loadCPUFrequency(dataProviderManager);
-    
+    /*
+     * Steps writing through the same driver are chained, drivers are not thread safe:
+     *  - Legion other firmware attributes  : power profile -> CPU power -> GPU power -> fan option
+     *  - Legion fan mode                   : power profile -> fan curve -> fan controller
+     *  - Legion game zone                  : power profile -> other
+     *  - CPU list                          : SMT -> CPU options -> CPU frequency
+     *  - Intel MSR, NVML                   : on their own
+     */
+    SettingsApplyGraph graph;
+
+    graph.addStep("PowerProfile",[this,dataProviderManager] { loadPowerProfile(dataProviderManager); });
+
     // Only load custom settings if CUSTOM power profile is saved
     if (isCustomProfile) {
-        loadFanCurve(dataProviderManager);
-        loadCPUPower(dataProviderManager);
-        loadGPUPower(dataProviderManager);
+        graph.addStep("CPUPower",     [this,dataProviderManager] { loadCPUPower(dataProviderManager); },     {"PowerProfile"});
+        graph.addStep("GPUPower",     [this,dataProviderManager] { loadGPUPower(dataProviderManager); },     {"CPUPower"});
+        graph.addStep("FanCurve",     [this,dataProviderManager] { loadFanCurve(dataProviderManager); },     {"PowerProfile"});
+        graph.addStep("FanController",[this,dataProviderManager] { loadFanController(dataProviderManager); },{"FanCurve"});
     } else {
-        LOG_D("DaemonSettingsManager::loadAllSettings - skipping FanCurve, CPUPower, GPUPower (not CUSTOM profile)");
+        LOG_D("DaemonSettingsManager::loadAllSettings - skipping FanCurve, FanController, CPUPower, GPUPower (not CUSTOM profile)");
     }
-    
-    loadFanOption(dataProviderManager);
-    loadCPUSMT(dataProviderManager);
-    loadNvidiaNvml(dataProviderManager);
-    loadIntelMSR(dataProviderManager);
-    loadOther(dataProviderManager);
+
+    graph.addStep("FanOption",   [this,dataProviderManager] { loadFanOption(dataProviderManager); },     {"PowerProfile","GPUPower"});
+    graph.addStep("CPUSMT",      [this,dataProviderManager] { loadCPUSMT(dataProviderManager); });
+    graph.addStep("CPUOptions",  [this,dataProviderManager] { loadCPUControlData(dataProviderManager); },{"CPUSMT"});
+    graph.addStep("CPUFrequency",[this,dataProviderManager] { loadCPUFrequency(dataProviderManager); },  {"CPUOptions"});
+    graph.addStep("IntelMSR",    [this,dataProviderManager] { loadIntelMSR(dataProviderManager); });
+    graph.addStep("NvidiaNvml",  [this,dataProviderManager] { loadNvidiaNvml(dataProviderManager); });
+    graph.addStep("Other",       [this,dataProviderManager] { loadOther(dataProviderManager); },         {"PowerProfile"});
+
+    /*
+     * Steps suppress echoes of their writes by blocking the driver and draining udev, but the monitor
+     * belongs to the daemon thread and is not drained on workers. Blocks are held here until the
+     * echoes are drained after the graph, and expectations count from the end of the graph.
+     */
+    static constexpr const char* SUPPRESSED_DRIVERS[] = {
+        SysFsDriverLegionOther::DRIVER_NAME,
+        SysFsDriverLegionEvents::DRIVER_NAME,
+        SysFsDriverCPUXList::DRIVER_NAME,
+        SysFSDriverLegionIntelMSR::DRIVER_NAME
+    };
+
+    for(const char* driverName : SUPPRESSED_DRIVERS)
+    {
+        sysFsDriverManager->blockKernelEvent(driverName,true);
+    }
+
+    auto unblock = qScopeGuard([sysFsDriverManager] {
+        for(const char* driverName : SUPPRESSED_DRIVERS)
+        {
+            sysFsDriverManager->blockKernelEvent(driverName,false);
+        }
+    });
+
+    graph.run(APPLY_WORKERS);
+
+    sysFsDriverManager->restartExpectedKernelEvents();
+    sysFsDriverManager->processAllUdevEvents(100);
     LOG_T("DaemonSettingsManager::loadAllSettings - complete");
 }
 
@@ -88,19 +150,30 @@ void DaemonSettingsManager::saveAllSettings(DataProviderManager* dataProviderMan
 {
     LOG_D("DaemonSettingsManager::saveAllSettings - start");
 
-    saveDaemonSettings();
-    savePowerProfile(dataProviderManager);
-    saveCPUControlData(dataProviderManager);
-    saveCPUFrequency(dataProviderManager);
-    saveFanCurve(dataProviderManager);
-    saveFanOption(dataProviderManager);
-    saveCPUSMT(dataProviderManager);
-    saveCPUPower(dataProviderManager);
-    saveGPUPower(dataProviderManager);
-    saveNvidiaNvml(dataProviderManager);
-    saveIntelMSR(dataProviderManager);
-    saveOther(dataProviderManager);
-    LOG_D("DaemonSettingsManager::saveAllSettings - complete");
+    const auto started = std::chrono::steady_clock::now();
+
+    {
+        /*
+         * All groups are staged in memory and the file is written once at the end
+         */
+        SettingsStore::Transaction transaction;
+
+        saveDaemonSettings();
+        savePowerProfile(dataProviderManager);
+        saveCPUControlData(dataProviderManager);
+        saveCPUFrequency(dataProviderManager);
+        saveFanCurve(dataProviderManager);
+        saveFanController(dataProviderManager);
+        saveFanOption(dataProviderManager);
+        saveCPUSMT(dataProviderManager);
+        saveCPUPower(dataProviderManager);
+        saveGPUPower(dataProviderManager);
+        saveNvidiaNvml(dataProviderManager);
+        saveIntelMSR(dataProviderManager);
+        saveOther(dataProviderManager);
+    }
+
+    LOG_D(QString("DaemonSettingsManager::saveAllSettings - complete, took %1 ms").arg(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count()));
 }
 
 void DaemonSettingsManager::saveAllSettingsOnExit(DataProviderManager *dataProviderManager)
@@ -120,8 +193,21 @@ void DaemonSettingsManager::saveAllSettingsOnExit(DataProviderManager *dataProvi
 void DaemonSettingsManager::loadDaemonSettings()
 {
     LOG_T("DaemonSettingsManager::loadDaemonSettings");
-    SettingsLoaderDaemonSettings loader;
-    loader.loadDaemonSettings(m_daemonSettings);
+
+    QByteArray data;
+    {
+        SettingsStore::Transaction transaction;
+        data = SettingsStore::getInstance().data(DataProviderDaemonSettings::dataType);
+    }
+
+    if(data.isEmpty() || !m_daemonSettings.ParseFromArray(data.data(),data.size()))
+    {
+        m_daemonSettings.Clear();
+        m_daemonSettings.set_apply_settings_on_start(true);
+        m_daemonSettings.set_save_settings_on_exit(true);
+        m_daemonSettings.set_debug_logging(false);
+        m_daemonSettings.set_trace_logging(false);
+    }
     
     // Apply debug and trace logging levels immediately after loading
     bj::framework::Logger::SEVERITY_BITSET severity;
@@ -152,420 +238,221 @@ void DaemonSettingsManager::loadDaemonSettings()
 void DaemonSettingsManager::saveDaemonSettings()
 {
     LOG_D("DaemonSettingsManager::saveDaemonSettings");
-    SettingsSaverDaemonSettings saver;
-    saver.saveDaemonSettings(m_daemonSettings);
+
+    legion::messages::DaemonSettings settings(m_daemonSettings);
+
+    // Command flag does not persist
+    settings.clear_save_now();
+
+    SettingsStore::Transaction transaction;
+    SettingsStore::getInstance().setMessage(DataProviderDaemonSettings::dataType,settings);
 }
 
 void DaemonSettingsManager::loadPowerProfile(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadPowerProfile");
-    try {
-        legion::messages::PowerProfile profile;
-        SettingsLoaderPowerProfiles().loadPowerProfile(profile);
-        // Skip if no fields are set
-        if(profile.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadPowerProfile - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(profile.ByteSizeLong());
-        if(profile.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderPowerProfile::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadPowerProfile - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderPowerProfile::dataType,"loadPowerProfile");
 }
 
 void DaemonSettingsManager::savePowerProfile(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::savePowerProfile");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderPowerProfile::dataType).serializeAndGetData();
-        legion::messages::PowerProfile profile;
-        if(profile.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverPowerProfiles().saverPowerProfile(profile);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::savePowerProfile - failed");
-    }
+    saveData<legion::messages::PowerProfile>(dataProviderManager,SysFsDataProviderPowerProfile::dataType,"savePowerProfile");
 }
 
 void DaemonSettingsManager::loadCPUControlData(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadCPUControlData");
-    try {
-        legion::messages::CPUOptions opts;
-        SettingsLoaderCPUControlData().loadPowerProfile(opts);
-        // Skip if no fields are set
-        if(opts.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadCPUControlData - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(opts.ByteSizeLong());
-        if(opts.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderCPUOptions::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadCPUControlData - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderCPUOptions::dataType,"loadCPUControlData");
 }
 
 void DaemonSettingsManager::saveCPUControlData(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::saveCPUControlData");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderCPUOptions::dataType).serializeAndGetData();
-        legion::messages::CPUOptions opts;
-        if(opts.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverCPUControlData().saverPowerProfile(opts);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveCPUControlData - failed");
-    }
+    saveData<legion::messages::CPUOptions>(dataProviderManager,SysFsDataProviderCPUOptions::dataType,"saveCPUControlData");
 }
 
 void DaemonSettingsManager::loadCPUFrequency(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadCPUFrequency");
-    try {
-        legion::messages::CPUFrequency freq;
-        SettingsLoaderCPUFrequency().loadCPUFrequency(freq);
-        // Skip if no fields are set
-        if(freq.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadCPUFrequency - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(freq.ByteSizeLong());
-        if(freq.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderCPUFrequency::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadCPUFrequency - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderCPUFrequency::dataType,"loadCPUFrequency");
 }
 
 void DaemonSettingsManager::saveCPUFrequency(DataProviderManager* dataProviderManager)
 {
-    LOG_D("DaemonSettingsManager::saveCPUFrequency");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderCPUFrequency::dataType).serializeAndGetData();
-        legion::messages::CPUFrequency freq;
-        if(freq.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverCPUFrequency().saveCPUFrequency(freq);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveCPUFrequency - failed");
-    }
+    saveData<legion::messages::CPUFrequency>(dataProviderManager,SysFsDataProviderCPUFrequency::dataType,"saveCPUFrequency");
 }
 
 void DaemonSettingsManager::loadFanCurve(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadFanCurve");
-    try {
-        legion::messages::FanCurve curve;
-        SettingsLoaderFanCurve().loadFanCurve(curve);
-        // Skip if no fields are set
-        if(curve.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadFanCurve - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(curve.ByteSizeLong());
-        if(curve.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderFanCurve::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadFanCurve - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderFanCurve::dataType,"loadFanCurve");
 }
 
 void DaemonSettingsManager::saveFanCurve(DataProviderManager* dataProviderManager)
 {
     LOG_T("DaemonSettingsManager::saveFanCurve");
     try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderFanCurve::dataType).serializeAndGetData();
-        legion::messages::FanCurve curve;
-        if(curve.ParseFromArray(data.data(), data.size()))
+        /*
+         * While the fan controller owns the fan curve the firmware holds its flat curve, keep the saved one
+         */
+        if(fanControllerRunning(dataProviderManager))
         {
-            SettingsSaverFanCurve().saveFanCurve(curve);
+            LOG_D("DaemonSettingsManager::saveFanCurve - fan controller is running, skipping");
+            return;
         }
     } catch(...) {
         LOG_W("DaemonSettingsManager::saveFanCurve - failed");
+        return;
     }
+
+    saveData<legion::messages::FanCurve>(dataProviderManager,SysFsDataProviderFanCurve::dataType,"saveFanCurve");
+}
+
+void DaemonSettingsManager::loadFanController(DataProviderManager* dataProviderManager)
+{
+    loadData(dataProviderManager,DataProviderFanController::dataType,"loadFanController");
+}
+
+void DaemonSettingsManager::saveFanController(DataProviderManager* dataProviderManager)
+{
+    saveData<legion::messages::FanController>(dataProviderManager,DataProviderFanController::dataType,"saveFanController");
 }
 
 void DaemonSettingsManager::loadFanOption(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadFanOption");
-    try {
-        legion::messages::FanOption opt;
-        SettingsLoaderFanOption().loadFanOption(opt);
-        // Skip if no fields are set
-        if(opt.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadFanOption - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(opt.ByteSizeLong());
-        if(opt.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderFanOption::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadFanOption - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderFanOption::dataType,"loadFanOption");
 }
 
 void DaemonSettingsManager::saveFanOption(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::saveFanOption");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderFanOption::dataType).serializeAndGetData();
-        legion::messages::FanOption opt;
-        if(opt.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverFanOption().saveFanOption(opt);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveFanOption - failed");
-    }
+    saveData<legion::messages::FanOption>(dataProviderManager,SysFsDataProviderFanOption::dataType,"saveFanOption");
 }
 
 void DaemonSettingsManager::loadCPUSMT(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadCPUSMT");
-    try {
-        legion::messages::CPUSMT smt;
-        SettingsLoaderCPUSMT().loadCPUSMT(smt);
-        // Skip if no fields are set
-        if(smt.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadCPUSMT - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(smt.ByteSizeLong());
-        if(smt.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderCPUSMT::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadCPUSMT - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderCPUSMT::dataType,"loadCPUSMT");
 }
 
 void DaemonSettingsManager::saveCPUSMT(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::saveCPUSMT");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderCPUSMT::dataType).serializeAndGetData();
-        legion::messages::CPUSMT smt;
-        if(smt.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverCPUSMT().saveCPUSMT(smt);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveCPUSMT - failed");
-    }
+    saveData<legion::messages::CPUSMT>(dataProviderManager,SysFsDataProviderCPUSMT::dataType,"saveCPUSMT");
 }
 
 void DaemonSettingsManager::loadCPUPower(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadCPUPower");
-    try {
-        legion::messages::CPUPower power;
-        SettingsLoaderCPUPower().loadCPUPower(power);
-        // Skip if no fields are set
-        if(power.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadCPUPower - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(power.ByteSizeLong());
-        if(power.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderCPUPower::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadCPUPower - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderCPUPower::dataType,"loadCPUPower");
 }
 
 void DaemonSettingsManager::saveCPUPower(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::saveCPUPower");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderCPUPower::dataType).serializeAndGetData();
-        legion::messages::CPUPower power;
-        if(power.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverCPUPower().saveCPUPower(power);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveCPUPower - failed");
-    }
+    saveData<legion::messages::CPUPower>(dataProviderManager,SysFsDataProviderCPUPower::dataType,"saveCPUPower");
 }
 
 void DaemonSettingsManager::loadGPUPower(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadGPUPower");
-    try {
-        legion::messages::GPUPower power;
-        SettingsLoaderGPUPower().loadGPUPower(power);
-        // Skip if no fields are set
-        if(power.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadGPUPower - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(power.ByteSizeLong());
-        if(power.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderGPUPower::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadGPUPower - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderGPUPower::dataType,"loadGPUPower");
 }
 
 void DaemonSettingsManager::saveGPUPower(DataProviderManager* dataProviderManager)
 {
-    LOG_D("DaemonSettingsManager::saveGPUPower");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderGPUPower::dataType).serializeAndGetData();
-        legion::messages::GPUPower power;
-        if(power.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverGPUPower().saveGPUPower(power);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveGPUPower - failed");
-    }
+    saveData<legion::messages::GPUPower>(dataProviderManager,SysFsDataProviderGPUPower::dataType,"saveGPUPower");
 }
 
 void DaemonSettingsManager::loadNvidiaNvml(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadNvidiaNvml");
-    try {
-        legion::messages::NvidiaNvml nvml;
-        SettingsLoaderNvidiaNvml().loadNvidiaNvml(nvml);
-        // Skip if no fields are set
-        if(nvml.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadNvidiaNvml - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(nvml.ByteSizeLong());
-        if(nvml.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(DataProviderNvidiaNvml::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadNvidiaNvml - failed");
-    }
+    loadData(dataProviderManager,DataProviderNvidiaNvml::dataType,"loadNvidiaNvml");
 }
 
 void DaemonSettingsManager::saveNvidiaNvml(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::saveNvidiaNvml");
-    try {
-        auto data = dataProviderManager->getDataProvider(DataProviderNvidiaNvml::dataType).serializeAndGetData();
-        legion::messages::NvidiaNvml nvml;
-        if(nvml.ParseFromArray(data.data(), data.size()))
-        {
-            SettingsSaverNvidiaNvml().saveNvidiaNvml(nvml);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveNvidiaNvml - failed");
-    }
+    saveData<legion::messages::NvidiaNvml>(dataProviderManager,DataProviderNvidiaNvml::dataType,"saveNvidiaNvml");
 }
 
 void DaemonSettingsManager::loadIntelMSR(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadIntelMSR");
-    try {
-        legion::messages::CpuIntelMSR intelMSR;
-        SettingsLoaderIntelMSR().loadIntelMSR(intelMSR);
-        // Skip if no fields are set
-        if(intelMSR.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadIntelMSR - no saved data, skipping");
-            return;
-        }
-        QByteArray data;
-        data.resize(intelMSR.ByteSizeLong());
-        if(intelMSR.SerializeToArray(data.data(),data.size()))
-        {
-            dataProviderManager->getDataProvider(SysFsDataProviderIntelMSR::dataType).deserializeAndSetData(data);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::loadIntelMSR - failed");
-    }
+    loadData(dataProviderManager,SysFsDataProviderIntelMSR::dataType,"loadIntelMSR");
 }
 
 void DaemonSettingsManager::saveIntelMSR(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::saveIntelMSR");
-    try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderIntelMSR::dataType).serializeAndGetData();
-        legion::messages::CpuIntelMSR intelMSR;
-        if(intelMSR.ParseFromArray(data.data(), data.size()))
-        {
-            intelMSR.mutable_analogio()->set_offset(((intelMSR.analogio().offset() > 0 ? intelMSR.analogio().offset() + 999 : intelMSR.analogio().offset() - 999 ) / 1000) * 1000);
-            intelMSR.mutable_cache()->set_offset(((intelMSR.cache().offset() > 0 ? intelMSR.cache().offset() + 999 : intelMSR.cache().offset() - 999 ) / 1000) * 1000);
-            intelMSR.mutable_cpu()->set_offset(((intelMSR.cpu().offset() > 0 ? intelMSR.cpu().offset() + 999 : intelMSR.cpu().offset() - 999) / 1000) * 1000);
-            intelMSR.mutable_gpu()->set_offset(((intelMSR.gpu().offset() > 0 ? intelMSR.gpu().offset() + 999 : intelMSR.gpu().offset() - 999 ) / 1000) * 1000);
-            intelMSR.mutable_uncore()->set_offset(((intelMSR.uncore().offset() > 0 ? intelMSR.uncore().offset() + 999 : intelMSR.uncore().offset() - 999 ) / 1000) * 1000);
+    saveData<legion::messages::CpuIntelMSR>(dataProviderManager,SysFsDataProviderIntelMSR::dataType,"saveIntelMSR",&DaemonSettingsManager::roundIntelMSROffsets);
+}
 
-            SettingsSaverIntelMSR().saveIntelMSR(intelMSR);
-        }
-    } catch(...) {
-        LOG_W("DaemonSettingsManager::saveIntelMSR - failed");
+bool DaemonSettingsManager::fanControllerRunning(DataProviderManager *dataProviderManager)
+{
+    auto controllerData = dataProviderManager->getDataProvider(DataProviderFanController::dataType).serializeAndGetData();
+    legion::messages::FanController controller;
+
+    return controller.ParseFromArray(controllerData.data(), controllerData.size()) &&
+           controller.status().state() == legion::messages::FanController::STATE_RUNNING;
+}
+
+bool DaemonSettingsManager::roundIntelMSROffsets(QByteArray &data)
+{
+    legion::messages::CpuIntelMSR intelMSR;
+    if(!intelMSR.ParseFromArray(data.data(), data.size()))
+    {
+        return false;
     }
+
+    intelMSR.mutable_analogio()->set_offset(((intelMSR.analogio().offset() > 0 ? intelMSR.analogio().offset() + 999 : intelMSR.analogio().offset() - 999 ) / 1000) * 1000);
+    intelMSR.mutable_cache()->set_offset(((intelMSR.cache().offset() > 0 ? intelMSR.cache().offset() + 999 : intelMSR.cache().offset() - 999 ) / 1000) * 1000);
+    intelMSR.mutable_cpu()->set_offset(((intelMSR.cpu().offset() > 0 ? intelMSR.cpu().offset() + 999 : intelMSR.cpu().offset() - 999) / 1000) * 1000);
+    intelMSR.mutable_gpu()->set_offset(((intelMSR.gpu().offset() > 0 ? intelMSR.gpu().offset() + 999 : intelMSR.gpu().offset() - 999 ) / 1000) * 1000);
+    intelMSR.mutable_uncore()->set_offset(((intelMSR.uncore().offset() > 0 ? intelMSR.uncore().offset() + 999 : intelMSR.uncore().offset() - 999 ) / 1000) * 1000);
+
+    data.resize(static_cast<qsizetype>(intelMSR.ByteSizeLong()));
+    return intelMSR.SerializeToArray(data.data(),data.size());
 }
 
 void DaemonSettingsManager::loadOther(DataProviderManager* dataProviderManager)
 {
-    LOG_T("DaemonSettingsManager::loadOther");
+    loadData(dataProviderManager,SysFsDataProviderOther::dataType,"loadOther");
+}
+
+void DaemonSettingsManager::saveOther(DataProviderManager* dataProviderManager)
+{
+    saveData<legion::messages::OtherSettings>(dataProviderManager,SysFsDataProviderOther::dataType,"saveOther");
+}
+
+void DaemonSettingsManager::loadData(DataProviderManager *dataProviderManager, quint8 dataType, const char *name)
+{
+    LOG_T(QString("DaemonSettingsManager::") + name);
     try {
-        legion::messages::OtherSettings otherSettings;
-        SettingsLoaderOther().loadOther(otherSettings);
-        // Skip if no fields are set
-        if(otherSettings.ByteSizeLong() == 0) {
-            LOG_D("DaemonSettingsManager::loadOther - no saved data, skipping");
-            return;
-        }
         QByteArray data;
-        data.resize(otherSettings.ByteSizeLong());
-        if(otherSettings.SerializeToArray(data.data(),data.size()))
         {
-            dataProviderManager->getDataProvider(SysFsDataProviderOther::dataType).deserializeAndSetData(data);
+            SettingsStore::Transaction transaction;
+            data = SettingsStore::getInstance().data(dataType);
+        }
+
+        // Skip if nothing is saved
+        if(data.isEmpty()) {
+            LOG_D(QString("DaemonSettingsManager::") + name + " - no saved data, skipping");
+            return;
         }
+
+        dataProviderManager->getDataProvider(dataType).deserializeAndSetData(data);
     } catch(...) {
-        LOG_W("DaemonSettingsManager::loadOther - failed");
+        LOG_W(QString("DaemonSettingsManager::") + name + " - failed");
     }
 }
 
-void DaemonSettingsManager::saveOther(DataProviderManager* dataProviderManager)
+template<class T>
+void DaemonSettingsManager::saveData(DataProviderManager *dataProviderManager, quint8 dataType, const char *name, const std::function<bool (QByteArray &)> &prepare)
 {
-    LOG_D("DaemonSettingsManager::saveOther");
+    LOG_T(QString("DaemonSettingsManager::") + name);
     try {
-        auto data = dataProviderManager->getDataProvider(SysFsDataProviderOther::dataType).serializeAndGetData();
-        legion::messages::OtherSettings otherSettings;
-        if(otherSettings.ParseFromArray(data.data(), data.size()))
+        /*
+         * Message is stored as the data provider serialized it, fields a newer daemon saved are kept
+         */
+        QByteArray data = dataProviderManager->getDataProvider(dataType).serializeAndGetData();
+        T          message;
+
+        if((prepare && !prepare(data)) || !message.ParseFromArray(data.data(),data.size()))
         {
-            SettingsSaverOther().saveOther(otherSettings);
+            LOG_W(QString("DaemonSettingsManager::") + name + " - invalid data");
+            return;
         }
+
+        SettingsStore::Transaction transaction;
+        SettingsStore::getInstance().setMessage(dataType,message);
     } catch(...) {
-        LOG_W("DaemonSettingsManager::saveOther - failed");
+        LOG_W(QString("DaemonSettingsManager::") + name + " - failed");
     }
 }
 
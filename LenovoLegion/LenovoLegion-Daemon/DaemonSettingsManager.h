@@ -11,9 +11,14 @@
 
 #include "../LenovoLegion-PrepareBuild/DaemonSettings.pb.h"
 
+#include <QByteArray>
+
+#include <functional>
+
 namespace LenovoLegionDaemon {
 
 class DataProviderManager;
+class SysFsDriverManager;
 
 class DaemonSettingsManager
 {
@@ -25,6 +30,9 @@ public:
         SAVE_ERROR = -2
     };
 
+    // Worker threads applying independent settings at start
+    static constexpr unsigned int APPLY_WORKERS = 4;
+
     // Singleton instance access
     static DaemonSettingsManager& getInstance();
 
@@ -32,8 +40,8 @@ public:
     DaemonSettingsManager(const DaemonSettingsManager&) = delete;
     DaemonSettingsManager& operator=(const DaemonSettingsManager&) = delete;
 
-    // Load all settings from storage
-    void loadAllSettings(DataProviderManager* dataProviderManager);
+    // Load all settings from storage, called on the daemon thread
+    void loadAllSettings(SysFsDriverManager* sysFsDriverManager,DataProviderManager* dataProviderManager);
 
     // Save all settings to storage
     void saveAllSettings(DataProviderManager* dataProviderManager);
@@ -45,6 +53,7 @@ public:
     void loadCPUControlData(DataProviderManager* dataProviderManager);
     void loadCPUFrequency(DataProviderManager* dataProviderManager);
     void loadFanCurve(DataProviderManager* dataProviderManager);
+    void loadFanController(DataProviderManager* dataProviderManager);
     void loadFanOption(DataProviderManager* dataProviderManager);
     void loadCPUSMT(DataProviderManager* dataProviderManager);
     void loadCPUPower(DataProviderManager* dataProviderManager);
@@ -59,6 +68,7 @@ public:
     void saveCPUControlData(DataProviderManager* dataProviderManager);
     void saveCPUFrequency(DataProviderManager* dataProviderManager);
     void saveFanCurve(DataProviderManager* dataProviderManager);
+    void saveFanController(DataProviderManager* dataProviderManager);
     void saveFanOption(DataProviderManager* dataProviderManager);
     void saveCPUSMT(DataProviderManager* dataProviderManager);
     void saveCPUPower(DataProviderManager* dataProviderManager);
@@ -74,10 +84,23 @@ public:
     // Check if settings should be saved on exit
     bool shouldSaveOnExit() const;
 
+    // Round Intel MSR offsets of serialized message away from zero to multiples of 1000
+    static bool roundIntelMSROffsets(QByteArray& data);
+
+    // Fan controller owns the fan curve, firmware holds its flat curve meanwhile
+    static bool fanControllerRunning(DataProviderManager* dataProviderManager);
+
 private:
     DaemonSettingsManager();
     ~DaemonSettingsManager() = default;
 
+    // Apply saved message of data type to its data provider
+    void loadData(DataProviderManager* dataProviderManager,quint8 dataType,const char* name);
+
+    // Store current message of data provider over the saved one, prepare may adjust it before it is stored
+    template<class T>
+    void saveData(DataProviderManager* dataProviderManager,quint8 dataType,const char* name,const std::function<bool(QByteArray&)>& prepare = {});
+
     legion::messages::DaemonSettings m_daemonSettings;
 };
 
@@ -12,6 +12,8 @@
 
 #include "SysFsDriver.h"
 
+#include <sys/types.h>
+
 namespace LenovoLegionDaemon {
 
 
@@ -27,6 +29,11 @@ public:
         SERIALIZE_ERROR                     = -2
     };
 
+    /*
+     * Request does not come from a client, or its credentials are not known
+     */
+    static constexpr uid_t NO_CLIENT = static_cast<uid_t>(-1);
+
 public:
 
     DataProvider(QObject* parent,quint8  dataType);
@@ -42,6 +49,11 @@ public:
     virtual QByteArray serializeAndGetData(const QByteArray&)                                                                            const {return {};};
     virtual QByteArray deserializeAndSetData(const QByteArray&)                                                                                {return {};};
 
+    /*
+     * Request of a client, client is uid from peer credentials of its socket
+     */
+    virtual QByteArray deserializeAndSetData(const QByteArray& data,uid_t)                                                                     {return deserializeAndSetData(data);};
+
     virtual void init()                 {};
     virtual void clean()                {};
 
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "DataProviderCPUStatistics.h"
+
+#include "SysFsDriverCPUXList.h"
+#include "SysFsDriverCPUCore.h"
+#include "SysFsDriverCPUAtom.h"
+
+#include "../LenovoLegion-PrepareBuild/CPUFrequency.pb.h"
+
+#include <Core/LoggerHolder.h>
+
+namespace LenovoLegionDaemon {
+
+DataProviderCPUStatistics::DataProviderCPUStatistics(SysFsDriverManager* sysFsDriverManager,QObject* parent) : SysFsDataProvider(sysFsDriverManager,parent,dataType) {}
+
+DataProviderCPUStatistics::~DataProviderCPUStatistics()
+{
+    clean();
+}
+
+QByteArray DataProviderCPUStatistics::serializeAndGetData() const
+{
+    legion::messages::CPUStatistics     cpuStatistics;
+    QByteArray                          byteArray;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(m_cpuStatistics != nullptr)
+    {
+        const CPUStatistics::Snapshot snapshot = m_cpuStatistics->snapshot();
+
+        auto setAggregate = [](legion::messages::CPUStatistics::Aggregate* msg,const CPUStatistics::Aggregate& aggregate) {
+            msg->set_cpus(aggregate.m_cpus);
+            msg->set_busy(aggregate.m_busy);
+            msg->set_avg_freq(aggregate.m_avgFreq);
+        };
+
+        for(const auto& cpu : snapshot.m_cpus)
+        {
+            legion::messages::CPUStatistics::CPUX *cpux = cpuStatistics.add_cpus();
+
+            cpux->set_online(cpu.m_online);
+            cpux->set_busy(cpu.m_busy);
+            cpux->set_avg_freq(cpu.m_avgFreq);
+        }
+
+        setAggregate(cpuStatistics.mutable_all(),snapshot.m_all);
+        setAggregate(cpuStatistics.mutable_core(),snapshot.m_core);
+        setAggregate(cpuStatistics.mutable_atom(),snapshot.m_atom);
+
+        cpuStatistics.set_period_ms(snapshot.m_interval.count());
+        cpuStatistics.set_samples(snapshot.m_samples);
+        cpuStatistics.set_overruns(snapshot.m_overruns);
+        cpuStatistics.set_max_sample_us(snapshot.m_maxSample.count());
+    }
+
+    byteArray.resize(cpuStatistics.ByteSizeLong());
+    if(!cpuStatistics.SerializeToArray(byteArray.data(),byteArray.size()))
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::SERIALIZE_ERROR,"Serialize of data message error !");
+    }
+
+    return byteArray;
+}
+
+QByteArray DataProviderCPUStatistics::deserializeAndSetData(const QByteArray &)
+{
+    return {};
+}
+
+void DataProviderCPUStatistics::init()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    clean();
+
+    try {
+        m_cpuStatistics = std::make_unique<CPUStatistics>(createLayout());
+        m_cpuStatistics->start();
+    } catch(SysFsDriver::exception_T& ex)
+    {
+        if(ex.errcodeInfo().value() == SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+        {
+            LOG_D(QString(__PRETTY_FUNCTION__) + "- Driver not available, CPU statistics not started");
+            m_cpuStatistics.reset();
+            return;
+        }
+
+        throw;
+    }
+}
+
+void DataProviderCPUStatistics::clean()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    m_cpuStatistics.reset();
+}
+
+void DataProviderCPUStatistics::kernelEventHandler(const SysFsDriver::SubsystemEvent &event)
+{
+    if(event.m_driverId != SysFsDriverCPUXList::DRIVER_ID)
+    {
+        return;
+    }
+
+    /*
+     * CPU list reloaded, per CPU files and P/E layout have to be taken again
+     */
+    if(event.m_action == SysFsDriver::SubsystemEvent::Action::RELOADED)
+    {
+        LOG_D(QString(__PRETTY_FUNCTION__) + " - CPU list reloaded, restarting CPU statistics");
+
+        init();
+    }
+    else if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED &&
+            (event.m_eventType == SysFsDriverCPUXList::CPU_X_ONLINE || event.m_eventType == SysFsDriverCPUXList::CPU_X_OFFLINE))
+    {
+        refreshCPU(event.m_eventValue);
+    }
+}
+
+void DataProviderCPUStatistics::cpuOnlineChanged(int cpu, bool)
+{
+    refreshCPU(static_cast<quint32>(cpu));
+}
+
+void DataProviderCPUStatistics::refreshCPU(quint32 cpu)
+{
+    LOG_D(QString(__PRETTY_FUNCTION__) + " - CPU " + QString::number(cpu) + " toggled, refreshing CPU statistics");
+
+    if(m_cpuStatistics == nullptr)
+    {
+        init();
+        return;
+    }
+
+    /*
+     * Only the toggled CPU is refreshed, the others keep their files and window
+     */
+    try {
+        m_cpuStatistics->refresh(cpu,createLayout());
+    } catch(SysFsDriver::exception_T& ex)
+    {
+        if(ex.errcodeInfo().value() != SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+        {
+            throw;
+        }
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + "- Driver not available, CPU statistics stopped");
+        m_cpuStatistics.reset();
+    }
+}
+
+CPUStatistics::Layout DataProviderCPUStatistics::createLayout() const
+{
+    CPUStatistics::Layout           layout;
+    SysFsDriverCPUXList::CPUXList   cpuXlist(m_sysFsDriverManager->getDriverDescriptorsInVector(SysFsDriverCPUXList::DRIVER_NAME));
+
+    for(const auto& cpu : cpuXlist.cpuList())
+    {
+        layout.m_scalingCurFreq.push_back(cpu.m_freq.m_cpuScalingCurFreq.empty() ? std::optional<std::filesystem::path>() : cpu.m_freq.m_cpuScalingCurFreq);
+    }
+
+    layout.m_core.resize(layout.m_scalingCurFreq.size(),false);
+    layout.m_atom.resize(layout.m_scalingCurFreq.size(),false);
+
+    /*
+     * Hybrid topology is optional, without it only the all CPUs aggregate is filled
+     */
+    try {
+        markCPUs(getData(SysFsDriverCPUCore::CPUCore(m_sysFsDriverManager->getDriverDesriptor(SysFsDriverCPUCore::DRIVER_NAME)).m_cpus),layout.m_core);
+        markCPUs(getData(SysFsDriverCPUAtom::CPUAtom(m_sysFsDriverManager->getDriverDesriptor(SysFsDriverCPUAtom::DRIVER_NAME)).m_cpus),layout.m_atom);
+    } catch(SysFsDriver::exception_T& ex)
+    {
+        if(ex.errcodeInfo().value() != SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+        {
+            throw;
+        }
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + "- CPU core/atom driver not available");
+    }
+
+    return layout;
+}
+
+}
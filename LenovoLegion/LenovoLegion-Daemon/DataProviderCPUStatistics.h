@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <SysFsDataProvider.h>
+
+#include "CPUStatistics.h"
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+
+#include <memory>
+
+namespace LenovoLegionDaemon {
+
+class DataProviderCPUStatistics : public SysFsDataProvider
+{
+    Q_OBJECT
+
+public:
+
+    DataProviderCPUStatistics(SysFsDriverManager* sysFsDriverManager,QObject* parent);
+
+    ~DataProviderCPUStatistics() override;
+
+    virtual QByteArray serializeAndGetData()                    const override;
+    virtual QByteArray deserializeAndSetData(const QByteArray&)       override;
+
+    virtual void init()  override;
+    virtual void clean() override;
+
+    virtual void kernelEventHandler(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent &event) override;
+
+    /*
+     * CPU toggled by the daemon itself, its udev event never gets here
+     */
+    void cpuOnlineChanged(int cpu,bool online);
+
+private:
+
+    void refreshCPU(quint32 cpu);
+
+    CPUStatistics::Layout createLayout() const;
+
+private:
+
+    std::unique_ptr<CPUStatistics>   m_cpuStatistics;
+
+public:
+
+    static constexpr quint8  dataType = legion::messages::DataType::CPU_STATISTICS;
+};
+
+}
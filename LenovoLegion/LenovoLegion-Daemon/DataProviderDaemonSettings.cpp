@@ -9,6 +9,7 @@
 #include "DataProviderDaemonSettings.h"
 #include "DaemonSettingsManager.h"
 #include "DataProviderManager.h"
+#include "MetricsExporter.h"
 
 #include <Core/LoggerHolder.h>
 
@@ -98,12 +99,26 @@ QByteArray DataProviderDaemonSettings::deserializeAndSetData(const QByteArray& d
         LoggerHolder::getInstance().setSeverity(severity);
     }
     
+    // Keep metrics exporter address when client does not send it
+    if(!newSettings.has_metrics_exporter_listen())
+    {
+        newSettings.set_metrics_exporter_listen(oldSettings.metrics_exporter_listen());
+    }
+
+    // Any local client gets here, exporter never listens on a path it sends
+    if(!MetricsExporter::isValidAddress(QString::fromStdString(newSettings.metrics_exporter_listen())))
+    {
+        THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Metrics exporter address must be empty, a localhost port or unix !");
+    }
+
     // Update daemon settings in singleton
     DaemonSettingsManager::getInstance().setDaemonSettings(newSettings);
     
     // Also save daemon settings to persistent storage
     DaemonSettingsManager::getInstance().saveDaemonSettings();
 
+    emit daemonSettingsChanged();
+
     return {};
 }
 
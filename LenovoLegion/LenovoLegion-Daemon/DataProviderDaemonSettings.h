@@ -28,6 +28,9 @@ public:
     void init() override;
     void clean() override;
 
+signals:
+    void daemonSettingsChanged();
+
 public:
     static constexpr quint8 dataType = legion::messages::DataType::DAEMON_SETTINGS;
 
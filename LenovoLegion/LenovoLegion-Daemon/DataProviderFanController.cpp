@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "DataProviderFanController.h"
+#include "FanControllerThermalPlant.h"
+
+#include "SysFSDriverLegionHWMon.h"
+#include "SysFSDriverLegionFanMode.h"
+#include "SysFsDriverLegionEvents.h"
+
+#include <Core/LoggerHolder.h>
+
+namespace LenovoLegionDaemon {
+
+DataProviderFanController::DataProviderFanController(SysFsDriverManager* sysFsDriverManager,QObject* parent) : SysFsDataProvider(sysFsDriverManager,parent,dataType) {}
+
+DataProviderFanController::~DataProviderFanController()
+{
+    clean();
+}
+
+QByteArray DataProviderFanController::serializeAndGetData() const
+{
+    legion::messages::FanController     fanControllerMsg;
+    QByteArray                          byteArray;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    *fanControllerMsg.mutable_settings() = m_settings;
+
+    if(m_fanController != nullptr)
+    {
+        const FanController::Status status = m_fanController->status();
+
+        fanControllerMsg.mutable_status()->set_state(static_cast<legion::messages::FanController::State>(status.m_state));
+        fanControllerMsg.mutable_status()->set_temperature(static_cast<quint32>(status.m_temperature));
+        fanControllerMsg.mutable_status()->set_level(status.m_level);
+        fanControllerMsg.mutable_status()->set_iterations(status.m_iterations);
+        fanControllerMsg.mutable_status()->set_overruns(status.m_overruns);
+        fanControllerMsg.mutable_status()->set_max_wakeup_latency_us(status.m_maxWakeupLatency.count());
+        fanControllerMsg.mutable_status()->set_max_iteration_us(status.m_maxIteration.count());
+    }
+    else
+    {
+        fanControllerMsg.mutable_status()->set_state(legion::messages::FanController::STATE_DISABLED);
+    }
+
+    byteArray.resize(fanControllerMsg.ByteSizeLong());
+    if(!fanControllerMsg.SerializeToArray(byteArray.data(),byteArray.size()))
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::SERIALIZE_ERROR,"Serialize of data message error !");
+    }
+
+    return byteArray;
+}
+
+QByteArray DataProviderFanController::deserializeAndSetData(const QByteArray &data)
+{
+    legion::messages::FanController     fanControllerMsg;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(!fanControllerMsg.ParseFromArray(data.data(),data.size()))
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,"Parse of data message error !");
+    }
+
+    if(!fanControllerMsg.has_settings())
+    {
+        return {};
+    }
+
+    const FanController::Settings settings = toControllerSettings(fanControllerMsg.settings());
+
+    if(settings.m_minLevel > settings.m_maxLevel || settings.m_maxLevel > FanController::MAX_FAN_LEVEL)
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,"Invalid fan controller level range !");
+    }
+
+    if(settings.m_targetTemperature >= settings.m_criticalTemperature)
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,"Fan controller target temperature must be under critical temperature !");
+    }
+
+    if(settings.m_period < std::chrono::milliseconds(50) || settings.m_period > std::chrono::milliseconds(5000))
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,"Fan controller period out of range (50 - 5000 ms) !");
+    }
+
+    m_settings = fanControllerMsg.settings();
+
+    if(!m_settings.enabled())
+    {
+        if(m_fanController != nullptr)
+        {
+            LOG_D(QString(__PRETTY_FUNCTION__) + " - Disabling fan controller");
+            m_fanController.reset();
+        }
+
+        return {};
+    }
+
+    if(m_fanController == nullptr)
+    {
+        try {
+            m_fanController = std::make_unique<FanController>(createPlant(),settings);
+        } catch(SysFsDriver::exception_T& ex)
+        {
+            if(ex.errcodeInfo().value() == SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+            {
+                LOG_D(QString(__PRETTY_FUNCTION__) + "- Driver not available, fan controller not started");
+                return {};
+            }
+
+            throw;
+        }
+    }
+    else
+    {
+        m_fanController->setSettings(settings);
+    }
+
+    /*
+     * Starts again also after fallback, re-enabling is the acknowledge
+     */
+    m_fanController->start();
+
+    return {};
+}
+
+void DataProviderFanController::init()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    clean();
+}
+
+void DataProviderFanController::clean()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    m_fanController.reset();
+}
+
+void DataProviderFanController::kernelEventHandler(const SysFsDriver::SubsystemEvent &event)
+{
+    if(m_fanController == nullptr || m_fanController->status().m_state != FanController::State::RUNNING)
+    {
+        return;
+    }
+
+    if(event.m_driverId == SysFsDriverLegionEvents::DRIVER_ID && event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+    {
+        if(event.m_eventType == SysFsDriverLegionEvents::LegionVmiEventType::LEGION_WMI_EVENT_THERMAL_MODE)
+        {
+            /*
+             * Firmware loaded curve of the new thermal mode, restart takes it as the fallback and writes
+             * the level again or falls back when the mode is not custom any more
+             */
+            LOG_D(QString(__PRETTY_FUNCTION__) + " - Thermal mode changed, restarting fan controller");
+
+            m_fanController->restart();
+        }
+    }
+}
+
+std::unique_ptr<FanControllerPlant> DataProviderFanController::createPlant() const
+{
+    if(qEnvironmentVariableIsSet(SIMULATION_ENV))
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Fan controller runs against simulated thermal plant !");
+        return std::make_unique<FanControllerThermalPlant>();
+    }
+
+    SysFSDriverLegionHWMon::HWMon                   hwMon(m_sysFsDriverManager->getDriverDescriptorsInVector(SysFSDriverLegionHWMon::DRIVER_NAME));
+    SysFSDriverLegionFanMode::FanMode::FanCurve     fanCurve(m_sysFsDriverManager->getDriverDesriptor(SysFSDriverLegionFanMode::DRIVER_NAME));
+
+    std::vector<std::filesystem::path> temperatures;
+
+    for(const auto& temp : hwMon.m_legion.m_temps)
+    {
+        temperatures.push_back(temp.m_input);
+    }
+
+    /*
+     * Plant writes from the controller thread, echo of each write is dropped by the fan mode driver
+     */
+    SysFsDriverManager* sysFsDriverManager = m_sysFsDriverManager;
+
+    return std::make_unique<FanControllerSysFsPlant>(temperatures,fanCurve.m_current_value,[sysFsDriverManager] {
+        sysFsDriverManager->expectKernelEvents(SysFSDriverLegionFanMode::DRIVER_NAME,SysFSDriverLegionFanMode::FAN_CURVE_WRITE_EVENTS);
+    });
+}
+
+FanController::Settings DataProviderFanController::toControllerSettings(const legion::messages::FanController::Settings &settings)
+{
+    FanController::Settings controllerSettings;
+
+    if(settings.has_target_temperature())   controllerSettings.m_targetTemperature   = settings.target_temperature();
+    if(settings.has_critical_temperature()) controllerSettings.m_criticalTemperature = settings.critical_temperature();
+    if(settings.has_hysteresis())           controllerSettings.m_hysteresis          = settings.hysteresis();
+    if(settings.has_period_ms())            controllerSettings.m_period              = std::chrono::milliseconds(settings.period_ms());
+    if(settings.has_ramp_up_step_ms())      controllerSettings.m_rampUpStep          = std::chrono::milliseconds(settings.ramp_up_step_ms());
+    if(settings.has_ramp_down_step_ms())    controllerSettings.m_rampDownStep        = std::chrono::milliseconds(settings.ramp_down_step_ms());
+    if(settings.has_kp())                   controllerSettings.m_kp                  = settings.kp();
+    if(settings.has_ki())                   controllerSettings.m_ki                  = settings.ki();
+    if(settings.has_kd())                   controllerSettings.m_kd                  = settings.kd();
+    if(settings.has_min_level())            controllerSettings.m_minLevel            = static_cast<quint8>(std::min<quint32>(settings.min_level(),FanController::MAX_FAN_LEVEL + 1));
+    if(settings.has_max_level())            controllerSettings.m_maxLevel            = static_cast<quint8>(std::min<quint32>(settings.max_level(),FanController::MAX_FAN_LEVEL + 1));
+
+    return controllerSettings;
+}
+
+}
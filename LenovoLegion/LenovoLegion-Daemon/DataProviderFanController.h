@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <SysFsDataProvider.h>
+
+#include "FanController.h"
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+#include "../LenovoLegion-PrepareBuild/FanControl.pb.h"
+
+#include <memory>
+
+namespace LenovoLegionDaemon {
+
+class DataProviderFanController : public SysFsDataProvider
+{
+    Q_OBJECT
+
+public:
+
+    /*
+     * Set to run the controller against FanControllerThermalPlant instead of hardware
+     */
+    static constexpr const char* SIMULATION_ENV = "LEGION_FAN_CONTROLLER_SIMULATION";
+
+public:
+
+    DataProviderFanController(SysFsDriverManager* sysFsDriverManager,QObject* parent);
+
+    ~DataProviderFanController() override;
+
+    virtual QByteArray serializeAndGetData()                    const override;
+    virtual QByteArray deserializeAndSetData(const QByteArray&)       override;
+
+    virtual void init()  override;
+    virtual void clean() override;
+
+    virtual void kernelEventHandler(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent &event) override;
+
+private:
+
+    std::unique_ptr<FanControllerPlant> createPlant() const;
+
+    static FanController::Settings toControllerSettings(const legion::messages::FanController::Settings& settings);
+
+private:
+
+    legion::messages::FanController::Settings   m_settings;
+    std::unique_ptr<FanController>              m_fanController;
+
+public:
+
+    static constexpr quint8  dataType = legion::messages::DataType::FAN_CONTROLLER;
+};
+
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "DataProviderProfiles.h"
+#include "DataProviderManager.h"
+#include "ProfileStore.h"
+
+#include "../LenovoLegion-PrepareBuild/Profiles.pb.h"
+
+#include <Core/LoggerHolder.h>
+
+namespace LenovoLegionDaemon {
+
+DataProviderProfiles::DataProviderProfiles(DataProviderManager* dataProviderManager) :
+    DataProvider(dataProviderManager, dataType),
+    m_dataProviderManager(dataProviderManager)
+{}
+
+QByteArray DataProviderProfiles::serializeAndGetData() const
+{
+    legion::messages::Profiles profiles;
+    QByteArray byteArray;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    profiles = ProfileStore::getInstance().list();
+
+    byteArray.resize(profiles.ByteSizeLong());
+    if(!profiles.SerializeToArray(byteArray.data(), byteArray.size()))
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::SERIALIZE_ERROR, "Serialize of data message error !");
+    }
+
+    return byteArray;
+}
+
+QByteArray DataProviderProfiles::deserializeAndSetData(const QByteArray& data)
+{
+    legion::messages::ProfileCommand       command;
+    legion::messages::ProfileCommandResult result;
+    QByteArray byteArray;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(!command.ParseFromArray(data.data(), data.size()))
+    {
+        THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Parse of data message error !");
+    }
+
+    const QString name = QString::fromStdString(std::string(command.name()));
+
+    switch (command.command()) {
+    case legion::messages::ProfileCommand::SAVE_CURRENT:
+        if(name.isEmpty())
+        {
+            THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Profile without name !");
+        }
+        ProfileStore::getInstance().saveCurrent(m_dataProviderManager, name, QString::fromStdString(std::string(command.description())));
+        break;
+    case legion::messages::ProfileCommand::APPLY: {
+        const ProfileStore::ApplyResult applied = ProfileStore::getInstance().apply(m_dataProviderManager, name);
+
+        result.set_status(applied.m_status);
+        for(const quint8 written : applied.m_written)
+        {
+            result.add_written_data_types(written);
+        }
+    }
+        break;
+    case legion::messages::ProfileCommand::DELETE:
+        if(!ProfileStore::getInstance().remove(name))
+        {
+            result.set_status(legion::messages::ProfileCommandResult::NOT_FOUND);
+        }
+        break;
+    case legion::messages::ProfileCommand::IMPORT:
+        if(command.profile().name().empty())
+        {
+            THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Profile without name !");
+        }
+        ProfileStore::getInstance().store(command.profile());
+        break;
+    default:
+        THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Unknown profile command !");
+    }
+
+    byteArray.resize(result.ByteSizeLong());
+    if(!result.SerializeToArray(byteArray.data(), byteArray.size()))
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::SERIALIZE_ERROR, "Serialize of data message error !");
+    }
+
+    return byteArray;
+}
+
+}
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "DataProvider.h"
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+
+namespace LenovoLegionDaemon {
+
+class DataProviderManager;
+
+/*
+ * GET lists stored profiles, SET takes ProfileCommand and answers ProfileCommandResult
+ */
+class DataProviderProfiles : public DataProvider
+{
+    Q_OBJECT
+
+public:
+    explicit DataProviderProfiles(DataProviderManager* dataProviderManager);
+    ~DataProviderProfiles() override = default;
+
+    QByteArray serializeAndGetData() const override;
+    QByteArray deserializeAndSetData(const QByteArray& data) override;
+
+public:
+    static constexpr quint8 dataType = legion::messages::DataType::PROFILES;
+
+private:
+    DataProviderManager* m_dataProviderManager;
+};
+
+}
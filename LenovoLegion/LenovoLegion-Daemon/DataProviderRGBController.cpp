@@ -7,6 +7,9 @@
  */
 #include "DataProviderRGBController.h"
 #include "RGBController.h"
+#include "RGBDirectModeEffects.h"
+#include "RGBMetricSampler.h"
+#include "DataProviderManager.h"
 
 #include "SysFsDriverLegionEvents.h"
 
@@ -17,9 +20,14 @@
 
 #include <hidapi.h>
 
+#include <set>
+
 namespace LenovoLegionDaemon {
 
-    DataProviderRGBController::DataProviderRGBController(QObject* parent)  :DataProvider(parent,dataType) {}
+    DataProviderRGBController::DataProviderRGBController(DataProviderManager* dataProviderManager)  :
+        DataProvider(dataProviderManager,dataType),
+        m_dataProviderManager(dataProviderManager)
+    {}
 
     DataProviderRGBController::~DataProviderRGBController()
     {}
@@ -31,7 +39,7 @@ namespace LenovoLegionDaemon {
 
         LOG_T(__PRETTY_FUNCTION__);
 
-        if(m_rgbController == nullptr)
+        if(m_rgbControllers.empty())
         {
             LOG_D(QString(__PRETTY_FUNCTION__) + " - RGB Controller not available");
             rgbController.Clear();
@@ -39,6 +47,7 @@ namespace LenovoLegionDaemon {
         else
         {
             legion::messages::RGBControllerRequest request;
+            RGBController&                         controller = m_rgbControllers.primary();
 
             if(!request.ParseFromArray(data.data(), data.size()))
             {
@@ -50,53 +59,53 @@ namespace LenovoLegionDaemon {
 
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_BRITNESS)
             {
-                m_rgbController->DeviceRefreshBrightness();
+                controller.DeviceRefreshBrightness();
             }
 
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_PROFILE           ||
                requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_LED_GROUP_EFFECTS
               )
             {
-                m_rgbController->DeviceRefresh();
+                controller.DeviceRefresh();
             }
 
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_LOGO_STATUS)
             {
-                m_rgbController->DeviceRefreshLogoState();
+                controller.DeviceRefreshLogoState();
             }
 
             // Set device type
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_DEVICE_TYPE)
             {
-                rgbController.set_device_type(static_cast<legion::messages::RGBController::DeviceType>(m_rgbController->GetDeviceType()));
+                rgbController.set_device_type(static_cast<legion::messages::RGBController::DeviceType>(controller.GetDeviceType()));
             }
 
             // Set profiles
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_PROFILE)
             {
-                rgbController.mutable_profile()->set_current(m_rgbController->GetProfiles().active);
-                rgbController.mutable_profile()->set_min(m_rgbController->GetProfiles().min);
-                rgbController.mutable_profile()->set_max(m_rgbController->GetProfiles().max);
+                rgbController.mutable_profile()->set_current(controller.GetProfiles().active);
+                rgbController.mutable_profile()->set_min(controller.GetProfiles().min);
+                rgbController.mutable_profile()->set_max(controller.GetProfiles().max);
             }
 
             // Set brightness
             if(requestFlags &  legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_BRITNESS)
             {
-                rgbController.mutable_britness()->set_current(m_rgbController->GetBrightness().active);
-                rgbController.mutable_britness()->set_min(m_rgbController->GetBrightness().min);
-                rgbController.mutable_britness()->set_max(m_rgbController->GetBrightness().max);
+                rgbController.mutable_britness()->set_current(controller.GetBrightness().active);
+                rgbController.mutable_britness()->set_min(controller.GetBrightness().min);
+                rgbController.mutable_britness()->set_max(controller.GetBrightness().max);
             }
 
             // Set max effects
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_MAX_EFFECTS)
             {
-                rgbController.set_max_effects(m_rgbController->GetMaxEffects());
+                rgbController.set_max_effects(controller.GetMaxEffects());
             }
 
             // Serialize Effects
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_LED_GROUP_EFFECTS)
             {
-                const auto& effects = m_rgbController->GetEffects();
+                const auto& effects = controller.GetEffects();
                 for(const auto& effect : effects)
                 {
                     auto* pbEffect = rgbController.add_led_group_effects();
@@ -124,7 +133,7 @@ namespace LenovoLegionDaemon {
             // Serialize LEDs
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_LEDS)
             {
-                const auto& leds = m_rgbController->GetLEDs();
+                const auto& leds = controller.GetLEDs();
                 for(const auto& led : leds)
                 {
                     auto* pbLed = rgbController.add_leds();
@@ -137,7 +146,7 @@ namespace LenovoLegionDaemon {
             // Serialize Zones
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_ZONES)
             {
-                const auto& zones = m_rgbController->GetZones();
+                const auto& zones = controller.GetZones();
                 for(const auto& zone : zones)
                 {
                     auto* pbZone = rgbController.add_zones();
@@ -167,7 +176,7 @@ namespace LenovoLegionDaemon {
             // Serialize Modes
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_MODES)
             {
-                const auto& modes = m_rgbController->GetModes();
+                const auto& modes = controller.GetModes();
                 for(const auto& mode : modes)
                 {
                     auto* pbMode = rgbController.add_modes();
@@ -191,33 +200,85 @@ namespace LenovoLegionDaemon {
                 }
             }
 
-            // Serialize Colors For All leds States
+            // Serialize Colors For All leds States, from LED state cache
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_STATE_FOR_ALL_LEDS)
             {
-                auto colors = m_rgbController->DeviceGetState();
+                auto colors = controller.GetStateForAllLeds();
                 for(const auto& color : colors)
                 {
                     rgbController.add_colors(color);
                 }
+                rgbController.set_led_state_version(controller.GetLedStateVersion());
             }
 
             // Serialize info
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_DEVICE_INFO)
             {
-                rgbController.mutable_device_info()->set_name(m_rgbController->GetName());
-                rgbController.mutable_device_info()->set_vendor(m_rgbController->GetVendor());
-                rgbController.mutable_device_info()->set_description(m_rgbController->GetDescription());
-                rgbController.mutable_device_info()->set_serial(m_rgbController->GetSerial());
-                rgbController.mutable_device_info()->set_location(m_rgbController->GetLocation());
-                rgbController.mutable_device_info()->set_vendor_id(m_rgbController->GetVendorID());
-                rgbController.mutable_device_info()->set_product_id(m_rgbController->GetProductID());
+                rgbController.mutable_device_info()->set_name(controller.GetName());
+                rgbController.mutable_device_info()->set_vendor(controller.GetVendor());
+                rgbController.mutable_device_info()->set_description(controller.GetDescription());
+                rgbController.mutable_device_info()->set_serial(controller.GetSerial());
+                rgbController.mutable_device_info()->set_location(controller.GetLocation());
+                rgbController.mutable_device_info()->set_vendor_id(controller.GetVendorID());
+                rgbController.mutable_device_info()->set_product_id(controller.GetProductID());
+
+                for(const auto& member : m_rgbControllers.controllers())
+                {
+                    auto* device = rgbController.add_group_devices();
+
+                    device->set_name(member->GetName());
+                    device->set_vendor(member->GetVendor());
+                    device->set_description(member->GetDescription());
+                    device->set_serial(member->GetSerial());
+                    device->set_location(member->GetLocation());
+                    device->set_vendor_id(member->GetVendorID());
+                    device->set_product_id(member->GetProductID());
+                }
             }
 
             // Serialize logo state
             if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_LOGO_STATUS)
             {
-                rgbController.mutable_logo_status()->set_has_logo(m_rgbController->HasLogo());
-                rgbController.mutable_logo_status()->set_logo_on(m_rgbController->GetLogoState());
+                rgbController.mutable_logo_status()->set_has_logo(controller.HasLogo());
+                rgbController.mutable_logo_status()->set_logo_on(controller.GetLogoState());
+            }
+
+            // Serialize direct mode status
+            if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_DIRECT_MODE)
+            {
+                const RGBDirectModeEngine::Statistics statistics = controller.DeviceGetDirectModeStatistics();
+                auto*                                 status     = rgbController.mutable_direct_mode_status();
+
+                status->set_supported(controller.DeviceSupportsDirectMode());
+                status->set_active(controller.DeviceIsDirectModeActive());
+                status->set_frames(statistics.m_frames);
+                status->set_dropped(statistics.m_dropped);
+                status->set_send_errors(statistics.m_sinkErrors);
+                status->set_last_frame_us(statistics.m_lastFrame.count());
+                status->set_max_frame_us(statistics.m_maxFrame.count());
+                status->set_budget_us(statistics.m_budget.count());
+                status->set_input_frames(statistics.m_inputFrames);
+                status->set_last_input_latency_us(statistics.m_lastInputLatency.count());
+                status->set_max_input_latency_us(statistics.m_maxInputLatency.count());
+                status->set_avg_input_latency_us(statistics.m_avgInputLatency.count());
+                status->set_unchanged(statistics.m_unchanged);
+            }
+
+            // Serialize HID transport statistics
+            if(requestFlags & legion::messages::RGBControllerRequest::RequestFlags::RGBControllerRequest_RequestFlags_REQUEST_TRANSPORT_STATISTICS)
+            {
+                const HIDWorker::Statistics statistics = controller.DeviceGetTransportStatistics();
+                auto*                       transport  = rgbController.mutable_transport_statistics();
+
+                transport->set_queue_depth(statistics.m_queueDepth);
+                transport->set_max_queue_depth(statistics.m_maxQueueDepth);
+                transport->set_executed(statistics.m_executed);
+                transport->set_coalesced(statistics.m_coalesced);
+                transport->set_skipped(statistics.m_skipped);
+                transport->set_failed(statistics.m_failed);
+                transport->set_last_latency_us(statistics.m_lastLatency.count());
+                transport->set_avg_latency_us(statistics.m_avgLatency.count());
+                transport->set_max_latency_us(statistics.m_maxLatency.count());
             }
         }
 
@@ -231,6 +292,14 @@ namespace LenovoLegionDaemon {
     }
 
     QByteArray DataProviderRGBController::deserializeAndSetData(const QByteArray& data)
+    {
+        /*
+         * Audio source is accepted from a client only
+         */
+        return deserializeAndSetData(data,NO_CLIENT);
+    }
+
+    QByteArray DataProviderRGBController::deserializeAndSetData(const QByteArray& data, uid_t client)
     {
         legion::messages::RGBControllerSetRequest rgbController;
 
@@ -241,36 +310,32 @@ namespace LenovoLegionDaemon {
             THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Parse of data message error !");
         }
 
-        if(m_rgbController == nullptr)
+        if(m_rgbControllers.empty())
         {
             LOG_D(QString(__PRETTY_FUNCTION__) + " - RGB Controller not available");
             return {};
         }
 
-        // Apply profile if changed
-        if(rgbController.set_request_flags() & legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_PROFILE)
+        /*
+         * Direct mode overrides profile effects, any change of profile state stops it
+         */
+        if(rgbController.set_request_flags() & (legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_PROFILE            |
+                                                legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_LED_GROUP_EFFECTS  |
+                                                legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_RESET_EFECTS_TTO_DEF))
         {
-            auto currentProfile = m_rgbController->GetProfiles().active;
-            if(currentProfile != rgbController.profile().current())
-            {
-                LOG_D(QString("Changing profile from %1 to %2").arg(currentProfile).arg(rgbController.profile().current()));
+            stopDirectMode();
+        }
 
-                m_rgbController->SetProfile(rgbController.profile().current());
-                m_rgbController->DeviceUpdateProfile();
-            }
+        // Apply profile if changed, on all controllers
+        if(rgbController.set_request_flags() & legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_PROFILE)
+        {
+            m_rgbControllers.setProfile(rgbController.profile().current());
         }
 
-        // Apply brightness if changed
+        // Apply brightness if changed, on all controllers
         if(rgbController.set_request_flags() & legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_BRITNESS)
         {
-            auto currentBrightness = m_rgbController->GetBrightness().active;
-            if(currentBrightness != rgbController.britness().current())
-            {
-                LOG_D(QString("Changing brightness from %1 to %2").arg(currentBrightness).arg(rgbController.britness().current()));
-
-                m_rgbController->SetBrightness(rgbController.britness().current());
-                m_rgbController->DeviceUpdateBrightness();
-            }
+            m_rgbControllers.setBrightness(rgbController.britness().current());
         }
 
         /*
@@ -278,9 +343,9 @@ namespace LenovoLegionDaemon {
          */
         if(rgbController.set_request_flags() & legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_LED_GROUP_EFFECTS)
         {
-            LOG_D("Applying LED Group Effects");
+            std::vector<LenovoLegionDaemon::led_group_effect> effects;
 
-            m_rgbController->ClearEffects();
+            LOG_D("Applying LED Group Effects");
 
             for(int i = 0; i < rgbController.led_group_effects_size(); i++)
             {
@@ -307,10 +372,10 @@ namespace LenovoLegionDaemon {
                     effect.m_leds.push_back(led);
                 }
 
-                m_rgbController->AddEffect(effect);
+                effects.push_back(effect);
             }
 
-            m_rgbController->DeviceUpdateEfects();
+            m_rgbControllers.setEffects(effects);
         }
 
         /*
@@ -318,7 +383,7 @@ namespace LenovoLegionDaemon {
          */
         if(rgbController.set_request_flags() & legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_RESET_EFECTS_TTO_DEF)
         {
-            m_rgbController->DeviceResetEffectsToDefault();
+            m_rgbControllers.resetEffectsToDefault();
         }
 
         /*
@@ -326,12 +391,91 @@ namespace LenovoLegionDaemon {
          */
         if(rgbController.set_request_flags() & legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_LOGO_STATUS)
         {
-            if(m_rgbController->HasLogo())
+            LOG_D("Changing logo state to " + QString(rgbController.logo_status().logo_on() ? "ON" : "OFF"));
+
+            m_rgbControllers.setLogoState(rgbController.logo_status().logo_on());
+        }
+
+        /*
+         * Start, replace or stop direct mode effect
+         */
+        if(rgbController.set_request_flags() & legion::messages::RGBControllerSetRequest::SetRequestFlags::RGBControllerSetRequest_SetRequestFlags_SET_REQUEST_DIRECT_MODE)
+        {
+            const auto& directMode = rgbController.direct_mode();
+
+            /*
+             * Sampler of replaced metric effect is not needed
+             */
+            m_metricSampler.reset();
+
+            switch (directMode.effect()) {
+            case legion::messages::RGBController::DirectMode::EFFECT_STATIC:
+                if(directMode.colors_size() == 0)
+                {
+                    THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Direct mode static effect without colors !");
+                }
+
+                LOG_D(QString("Starting direct mode static effect, %1 colors").arg(directMode.colors_size()));
+                m_rgbControllers.startDirectMode([colors = std::vector<RGBColor>(directMode.colors().begin(),directMode.colors().end())]() {
+                    return std::make_unique<RGBDirectModeStaticEffect>(colors);
+                });
+                break;
+            case legion::messages::RGBController::DirectMode::EFFECT_RAINBOW_WAVE:
+                LOG_D(QString("Starting direct mode rainbow wave effect, speed %1").arg(directMode.speed()));
+                m_rgbControllers.startDirectMode([speed = directMode.speed()]() {
+                    return std::make_unique<RGBDirectModeRainbowWaveEffect>(speed);
+                });
+                break;
+            case legion::messages::RGBController::DirectMode::EFFECT_AUDIO_SPECTRUM:
             {
-                LOG_D("Changing logo state to " + QString(rgbController.logo_status().logo_on() ? "ON" : "OFF"));
+                if(directMode.audio_source().empty())
+                {
+                    THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Direct mode audio spectrum effect without audio source !");
+                }
+
+                RGBAudioSource::Format raw;
 
-                m_rgbController->SetLogoState(rgbController.logo_status().logo_on());
-                m_rgbController->DeviceUpdateLogoState();
+                raw.m_sampleRate = directMode.sample_rate() != 0 ? directMode.sample_rate() : raw.m_sampleRate;
+                raw.m_channels   = directMode.channels()    != 0 ? static_cast<quint16>(directMode.channels()) : raw.m_channels;
+
+                const std::string source(directMode.audio_source());
+
+                if(client == NO_CLIENT)
+                {
+                    THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Direct mode audio spectrum effect without client !");
+                }
+
+                /*
+                 * One source and analysis for all controllers, FIFO of the client only
+                 */
+                const std::shared_ptr<const RGBAudioSpectrum> spectrum = std::make_shared<RGBAudioSpectrum>(std::make_unique<RGBAudioSource>(source,raw,client));
+
+                LOG_D(QString("Starting direct mode audio spectrum effect, source ") + source.c_str());
+                m_rgbControllers.startDirectMode([spectrum]() {
+                    return std::make_unique<RGBDirectModeAudioSpectrumEffect>(spectrum);
+                });
+                break;
+            }
+            case legion::messages::RGBController::DirectMode::EFFECT_METRICS:
+            {
+                if(!RGBMetricSampler::valid(directMode))
+                {
+                    THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Direct mode metric effect without metrics, gradient or with invalid range !");
+                }
+
+                std::unique_ptr<RGBMetricSampler> sampler = std::make_unique<RGBMetricSampler>(m_dataProviderManager,directMode);
+
+                LOG_D(QString("Starting direct mode metric effect, %1 metrics").arg(directMode.metrics_size()));
+                m_rgbControllers.startDirectMode([&sampler]() {
+                    return sampler->effect();
+                });
+                m_metricSampler = std::move(sampler);
+                break;
+            }
+            default:
+                LOG_D("Stopping direct mode");
+                stopDirectMode();
+                break;
             }
         }
 
@@ -342,6 +486,8 @@ namespace LenovoLegionDaemon {
     {
         LOG_T(__PRETTY_FUNCTION__);
 
+        std::set<std::string> paths;    // Opened devices, enumeration may list one twice
+
         clean();
 
         /*-----------------------------------------------------------------------------*\
@@ -366,13 +512,29 @@ namespace LenovoLegionDaemon {
                 try {
                     if (detector.compare(*current_hid_device)) {
 
-                        if(m_rgbController != nullptr)
+                        if(!paths.insert(current_hid_device->path).second)
+                        {
+                            LOG_W(QString("RGB Controller at ").append(current_hid_device->path).append(" already detected, skipping."));
+                            continue;
+                        }
+
+                        std::unique_ptr<RGBController> controller(detector.m_function(*current_hid_device,detector.m_name));
+
+                        if(controller == nullptr)
+                        {
+                            LOG_W(QString("RGB Controller at ").append(current_hid_device->path).append(" can not be opened, skipping."));
+                            continue;
+                        }
+
+                        /*
+                         * Clients see LED state of primary controller only
+                         */
+                        if(m_rgbControllers.empty())
                         {
-                            LOG_W("RGB Controller already detected, skipping further detection attempts.");
-                            break;
+                            connect(controller.get(),&RGBController::ledStateChanged,this,&DataProviderRGBController::ledStateChanged);
                         }
 
-                        m_rgbController.reset(detector.m_function(*current_hid_device,detector.m_name));
+                        m_rgbControllers.add(std::move(controller));
 
                         LOG_T(QString("RGB Controller Detected: ").append(detector.m_name.c_str()));
                     }
@@ -393,50 +555,57 @@ namespace LenovoLegionDaemon {
 
     void DataProviderRGBController::clean()
     {
-        m_rgbController.reset();
+        m_metricSampler.reset();
+        m_rgbControllers.clear();
+    }
+
+    void DataProviderRGBController::stopDirectMode()
+    {
+        m_rgbControllers.stopDirectMode();
+        m_metricSampler.reset();
     }
 
     void DataProviderRGBController::kernelEventHandler(const SysFsDriver::SubsystemEvent &event)
     {
         LOG_T(__PRETTY_FUNCTION__);
 
-        if(event.m_driverName == SysFsDriverLegionEvents::DRIVER_NAME)
+        if(event.m_driverId == SysFsDriverLegionEvents::DRIVER_ID)
         {
             if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
             {
-                if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LENOVO_WMI_EVENT_UTILITY)
+                if(event.m_eventType == SysFsDriverLegionEvents::LegionVmiEventType::LENOVO_WMI_EVENT_UTILITY)
                 {
-                    if(m_rgbController != nullptr)
+                    if(!m_rgbControllers.empty())
                     {
-                        if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LENOVO_WMI_EVENT_UTILITY)
+                        if(event.m_eventType == SysFsDriverLegionEvents::LegionVmiEventType::LENOVO_WMI_EVENT_UTILITY)
                         {
                             LOG_D("DataProviderRGBController: kernelEventHandler - LENOVO_WMI_EVENT_UTILITY received, refreshing RGB Controller data");
 
-                            switch(static_cast<legion::messages::Notification_SpecialKey>(QString(event.m_DriverSpecificEventValue.data()).toUInt()))
+                            switch(static_cast<legion::messages::Notification_SpecialKey>(event.m_eventValue))
                             {
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMBACKLIGHTOFF:
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMBACKLIGHT1:
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMBACKLIGHT2:
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMBACKLIGHT3:
-                                    m_rgbController->DeviceRefreshBrightness();
+                                    m_rgbControllers.followPrimaryBrightness();
                                     break;
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMPRESET1:
-                                    m_rgbController->DeviceRefresh(1);
+                                    m_rgbControllers.followPrimaryProfile(1);
                                     break;
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMPRESET2:
-                                    m_rgbController->DeviceRefresh(2);
+                                    m_rgbControllers.followPrimaryProfile(2);
                                     break;
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMPRESET3:
-                                    m_rgbController->DeviceRefresh(3);
+                                    m_rgbControllers.followPrimaryProfile(3);
                                     break;
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMPRESET4:
-                                    m_rgbController->DeviceRefresh(4);
+                                    m_rgbControllers.followPrimaryProfile(4);
                                     break;
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMPRESET5:
-                                    m_rgbController->DeviceRefresh(5);
+                                    m_rgbControllers.followPrimaryProfile(5);
                                     break;
                                 case legion::messages::Notification_SpecialKey::Notification_SpecialKey_SPECTRUMPRESET6:
-                                    m_rgbController->DeviceRefresh(6);
+                                    m_rgbControllers.followPrimaryProfile(6);
                                     break;
                                 default:
                                     break;
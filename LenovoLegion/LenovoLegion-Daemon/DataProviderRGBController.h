@@ -9,6 +9,8 @@
 #pragma once
 
 #include "DataProvider.h"
+#include "RGBLedStateCache.h"
+#include "RGBControllerGroup.h"
 
 #include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
 
@@ -22,7 +24,8 @@ namespace LenovoLegionDaemon {
 
 #define HID_INTERFACE_ANY -1
 
-class RGBController;
+class RGBMetricSampler;
+class DataProviderManager;
 class DataProviderRGBController : public DataProvider
 {
     Q_OBJECT
@@ -56,18 +59,27 @@ public:
 
 public:
 
-    DataProviderRGBController(QObject* parent);
+    DataProviderRGBController(DataProviderManager* dataProviderManager);
 
     virtual ~DataProviderRGBController() override;
 
     virtual QByteArray serializeAndGetData(const QByteArray&)                                const override;
     virtual QByteArray deserializeAndSetData(const QByteArray&)                                    override;
+    virtual QByteArray deserializeAndSetData(const QByteArray&,uid_t client)                       override;
 
     virtual void init() override;
     virtual void clean() override;
 
 
     virtual void kernelEventHandler(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent &)       override;
+
+signals:
+
+    /*
+     * Forwarded from detected controller
+     */
+    void ledStateChanged(const LenovoLegionDaemon::RGBLedStateCache::Diff& diff);
+
 public:
 
     static void registerControler(std::string               name,
@@ -82,7 +94,21 @@ private:
 
 private:
 
-    std::unique_ptr<RGBController> m_rgbController;
+    void stopDirectMode();
+
+private:
+
+    DataProviderManager* const          m_dataProviderManager;
+
+    /*
+     * All detected controllers, first detected is primary
+     */
+    RGBControllerGroup                  m_rgbControllers;
+
+    /*
+     * Feeds metric effect while it runs
+     */
+    std::unique_ptr<RGBMetricSampler>   m_metricSampler;
 
 public:
 
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "DataProviderWorkloadRules.h"
+#include "WorkloadRulesEngine.h"
+
+#include "../LenovoLegion-PrepareBuild/WorkloadRules.pb.h"
+
+#include <Core/LoggerHolder.h>
+
+namespace LenovoLegionDaemon {
+
+DataProviderWorkloadRules::DataProviderWorkloadRules(DataProviderManager* dataProviderManager,WorkloadRulesEngine* workloadRulesEngine) :
+    DataProvider(dataProviderManager, dataType),
+    m_workloadRulesEngine(workloadRulesEngine)
+{}
+
+QByteArray DataProviderWorkloadRules::serializeAndGetData() const
+{
+    legion::messages::WorkloadRulesStatus status;
+    QByteArray byteArray;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    status = m_workloadRulesEngine->status();
+
+    byteArray.resize(status.ByteSizeLong());
+    if(!status.SerializeToArray(byteArray.data(), byteArray.size()))
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::SERIALIZE_ERROR, "Serialize of data message error !");
+    }
+
+    return byteArray;
+}
+
+QByteArray DataProviderWorkloadRules::deserializeAndSetData(const QByteArray& data)
+{
+    legion::messages::WorkloadRules rules;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(!rules.ParseFromArray(data.data(), data.size()))
+    {
+        THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Parse of data message error !");
+    }
+
+    try {
+        m_workloadRulesEngine->setRules(rules);
+    } catch(const WorkloadRulesEngine::exception_T&)
+    {
+        THROW_EXCEPTION(exception_T, DataProvider::ERROR_CODES::INVALID_DATA, "Invalid workload rules !");
+    }
+
+    return {};
+}
+
+}
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "DataProvider.h"
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+
+namespace LenovoLegionDaemon {
+
+class DataProviderManager;
+class WorkloadRulesEngine;
+
+/*
+ * GET answers WorkloadRulesStatus, SET takes WorkloadRules
+ */
+class DataProviderWorkloadRules : public DataProvider
+{
+    Q_OBJECT
+
+public:
+    DataProviderWorkloadRules(DataProviderManager* dataProviderManager,WorkloadRulesEngine* workloadRulesEngine);
+    ~DataProviderWorkloadRules() override = default;
+
+    QByteArray serializeAndGetData() const override;
+    QByteArray deserializeAndSetData(const QByteArray& data) override;
+
+public:
+    static constexpr quint8 dataType = legion::messages::DataType::WORKLOAD_RULES;
+
+private:
+    WorkloadRulesEngine* m_workloadRulesEngine;
+};
+
+}
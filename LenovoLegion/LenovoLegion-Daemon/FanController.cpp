@@ -0,0 +1,308 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "FanController.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace LenovoLegionDaemon {
+
+FanController::FanController(std::unique_ptr<FanControllerPlant> plant, const Settings &settings) :
+    m_plant(std::move(plant)),
+    m_stop(false),
+    m_settings(settings),
+    m_status{},
+    m_integral(0),
+    m_readFailures(0)
+{}
+
+FanController::~FanController()
+{
+    stop();
+}
+
+void FanController::start()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(m_thread.joinable())
+    {
+        if(status().m_state == State::RUNNING)
+        {
+            return;
+        }
+
+        // Previous run ended in fallback, thread already left the loop
+        m_thread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stop              = false;
+        m_status            = Status{};
+        m_status.m_state    = State::RUNNING;
+
+        /*
+         * Start in the middle of the allowed range, ramp limits take it to the right level
+         */
+        m_integral          = (m_settings.m_minLevel + m_settings.m_maxLevel) / 2.0;
+    }
+
+    m_lastTemperature.reset();
+    m_level.reset();
+    m_readFailures = 0;
+
+    m_thread = std::thread(&FanController::run,this);
+
+    /*
+     * Loop latency must not depend on the load which heats the machine
+     */
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+    if(pthread_setschedparam(m_thread.native_handle(),SCHED_FIFO,&param) != 0)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Unable to set real time priority, running with default scheduling");
+    }
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + " - Fan controller started");
+}
+
+void FanController::stop()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_status.m_state == State::RUNNING)
+    {
+        m_plant->restoreFirmwareControl();
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + " - Fan controller stopped, firmware fan curve restored");
+    }
+
+    m_status.m_state = State::DISABLED;
+}
+
+void FanController::restart()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    join();
+
+    /*
+     * Curve captured at start is stale now, writing it back would undo the thermal mode change
+     */
+    m_plant->captureFirmwareControl();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_status.m_state = State::DISABLED;
+    }
+
+    start();
+}
+
+void FanController::setSettings(const Settings &settings)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_settings = settings;
+}
+
+FanController::Settings FanController::settings() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_settings;
+}
+
+FanController::Status FanController::status() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_status;
+}
+
+void FanController::join()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    if(m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void FanController::run()
+{
+    auto deadline       = std::chrono::steady_clock::now();
+    auto lastIteration  = deadline;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while(!m_stop)
+    {
+        deadline += m_settings.m_period;
+
+        if(m_wakeUp.wait_until(lock,deadline,[this] { return m_stop; }))
+        {
+            break;
+        }
+
+        lock.unlock();
+
+        const auto woken = std::chrono::steady_clock::now();
+        iterate(woken,std::chrono::duration<double>(woken - lastIteration).count());
+        lastIteration = woken;
+        const auto done  = std::chrono::steady_clock::now();
+
+        lock.lock();
+
+        m_status.m_iterations++;
+        m_status.m_maxWakeupLatency = std::max(m_status.m_maxWakeupLatency,std::chrono::duration_cast<std::chrono::microseconds>(woken - deadline));
+        m_status.m_maxIteration     = std::max(m_status.m_maxIteration,std::chrono::duration_cast<std::chrono::microseconds>(done - woken));
+
+        // Missed periods are dropped, not executed in a burst
+        if(done >= deadline + m_settings.m_period)
+        {
+            m_status.m_overruns++;
+            deadline = done;
+        }
+
+        if(m_status.m_state != State::RUNNING)
+        {
+            break;
+        }
+    }
+}
+
+void FanController::iterate(std::chrono::steady_clock::time_point now, double dt)
+{
+    const Settings settings                 = this->settings();
+    const std::optional<double> temperature = m_plant->readTemperature();
+
+    if(!temperature.has_value())
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Temperature read failed");
+
+        if(++m_readFailures >= MAX_READ_FAILURES)
+        {
+            fallback("temperature sensors can not be read");
+        }
+        return;
+    }
+
+    m_readFailures = 0;
+
+    if(temperature.value() >= settings.m_criticalTemperature)
+    {
+        fallback(QString("critical temperature %1 C reached").arg(temperature.value(),0,'f',1));
+        return;
+    }
+
+    const double minLevel   = settings.m_minLevel;
+    const double maxLevel   = settings.m_maxLevel;
+    const double error      = temperature.value() - settings.m_targetTemperature;
+
+    /*
+     * PID, derivative on measurement so target changes do not kick the output,
+     * integral kept in level units so gain changes do not bump it
+     */
+    const double proportional   = settings.m_kp * error;
+    const double differential   = m_lastTemperature.has_value() && dt > 0 ? settings.m_kd * (temperature.value() - m_lastTemperature.value()) / dt : 0;
+    double       integral       = std::clamp(m_integral + settings.m_ki * error * dt,minLevel,maxLevel);
+    double       output         = proportional + integral + differential;
+
+    // Conditional integration, no wind up against saturated output
+    if((output > maxLevel && error > 0) || (output < minLevel && error < 0))
+    {
+        integral = m_integral;
+        output   = proportional + integral + differential;
+    }
+
+    m_lastTemperature = temperature;
+
+    quint8 level = static_cast<quint8>(std::lround(std::clamp(output,minLevel,maxLevel)));
+
+    if(!m_level.has_value())
+    {
+        // First level is the start point, never jump straight to what the cold error asks for
+        level = static_cast<quint8>(std::lround(m_integral));
+    }
+    else
+    {
+        // Hysteresis, slow down only when clearly under target and keep integral from draining meanwhile
+        if(level < m_level.value() && temperature.value() > settings.m_targetTemperature - settings.m_hysteresis)
+        {
+            level = m_level.value();
+
+            if(error < 0)
+            {
+                integral = m_integral;
+            }
+        }
+
+        // Ramp limits, one level per step
+        if(level > m_level.value())
+        {
+            level = now - m_lastLevelChange >= settings.m_rampUpStep   ? m_level.value() + 1 : m_level.value();
+        }
+        else if(level < m_level.value())
+        {
+            level = now - m_lastLevelChange >= settings.m_rampDownStep ? m_level.value() - 1 : m_level.value();
+        }
+    }
+
+    m_integral = integral;
+
+    if(!m_level.has_value() || level != m_level.value())
+    {
+        if(!m_plant->writeFanLevel(level))
+        {
+            fallback(QString("fan level %1 refused").arg(level));
+            return;
+        }
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + QString(" - temperature=%1 C, level %2 -> %3").arg(temperature.value(),0,'f',1).arg(m_level.value_or(level)).arg(level));
+
+        m_level           = level;
+        m_lastLevelChange = now;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_status.m_temperature = temperature.value();
+    m_status.m_level       = level;
+}
+
+void FanController::fallback(const QString &reason)
+{
+    LOG_W(QString(__PRETTY_FUNCTION__) + " - Fan control handed back to firmware, " + reason);
+
+    m_plant->restoreFirmwareControl();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_status.m_state = State::FALLBACK;
+}
+
+}
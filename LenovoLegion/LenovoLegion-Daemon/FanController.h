@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "FanControllerPlant.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Closed loop fan controller
+ *
+ * PID on the hottest sensor, output is a fan level which is quantized, held inside
+ * the hysteresis band and ramp limited before it reaches the plant. Loop runs on its
+ * own thread with absolute deadlines. Over critical temperature, on repeated sensor
+ * failures or when the plant refuses a level the controller hands control back to
+ * the firmware curve and stays in FALLBACK until it is started again.
+ */
+class FanController
+{
+public:
+
+    static constexpr quint8 MAX_FAN_LEVEL = 10;
+
+    enum class State : int {
+        DISABLED    = 0,
+        RUNNING     = 1,
+        FALLBACK    = 2
+    };
+
+    struct Settings {
+        double                      m_targetTemperature     = 75.0;
+        double                      m_criticalTemperature   = 95.0;
+        double                      m_hysteresis            = 3.0;
+        std::chrono::milliseconds   m_period                {250};
+        std::chrono::milliseconds   m_rampUpStep            {250};
+        std::chrono::milliseconds   m_rampDownStep          {2000};
+        double                      m_kp                    = 0.4;
+        double                      m_ki                    = 0.02;
+        double                      m_kd                    = 0.0;
+        quint8                      m_minLevel              = 0;
+        quint8                      m_maxLevel              = MAX_FAN_LEVEL;
+    };
+
+    struct Status {
+        State                       m_state                 = State::DISABLED;
+        double                      m_temperature           = 0;
+        quint8                      m_level                 = 0;
+        quint64                     m_iterations            = 0;
+        quint64                     m_overruns              = 0;
+        std::chrono::microseconds   m_maxWakeupLatency      {0};
+        std::chrono::microseconds   m_maxIteration          {0};
+    };
+
+public:
+
+    FanController(std::unique_ptr<FanControllerPlant> plant,const Settings& settings);
+    ~FanController();
+
+    FanController(const FanController&)            = delete;
+    FanController& operator=(const FanController&) = delete;
+
+    void    start();
+    void    stop();
+
+    /*
+     * Firmware loaded new fan curve, it becomes the fallback and the loop runs again on top of it
+     */
+    void    restart();
+
+    /*
+     * Thread safe, used from the next iteration
+     */
+    void     setSettings(const Settings& settings);
+    Settings settings()         const;
+
+    Status   status()           const;
+
+private:
+
+    void    join();
+    void    run();
+    void    iterate(std::chrono::steady_clock::time_point now,double dt);
+    void    fallback(const QString& reason);
+
+private:
+
+    /*
+     * Consecutive failed sensor reads before fallback
+     */
+    static constexpr int MAX_READ_FAILURES = 3;
+
+    const std::unique_ptr<FanControllerPlant> m_plant;
+
+    mutable std::mutex                      m_mutex;
+    std::condition_variable                 m_wakeUp;
+    std::thread                             m_thread;
+    bool                                    m_stop;
+
+    Settings                                m_settings;
+    Status                                  m_status;
+
+    /*
+     * Loop state, owned by controller thread
+     */
+    double                                  m_integral;
+    std::optional<double>                   m_lastTemperature;
+    std::optional<quint8>                   m_level;
+    int                                     m_readFailures;
+    std::chrono::steady_clock::time_point   m_lastLevelChange;
+};
+
+}
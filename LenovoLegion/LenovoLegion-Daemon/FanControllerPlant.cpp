@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "FanControllerPlant.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <QFile>
+#include <QStringList>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Number of points of the firmware fan curve
+ */
+static constexpr int FAN_CURVE_POINTS = 10;
+
+
+FanControllerSysFsPlant::FanControllerSysFsPlant(const std::vector<std::filesystem::path> &temperatures, const std::filesystem::path &fanCurve, const std::function<void()> &expectWrite) :
+    m_temperatures(temperatures),
+    m_fanCurve(fanCurve),
+    m_expectWrite(expectWrite)
+{
+    captureFirmwareControl();
+}
+
+std::optional<double> FanControllerSysFsPlant::readTemperature()
+{
+    std::optional<double> hottest;
+
+    for(const auto& path : m_temperatures)
+    {
+        QFile file(path);
+
+        if(!file.open(QIODeviceBase::ReadOnly))
+        {
+            continue;
+        }
+
+        bool ok = false;
+        const double value = file.readAll().trimmed().toLongLong(&ok) / 1000.0;    // hwmon reports millidegrees
+
+        if(ok && (!hottest.has_value() || value > hottest.value()))
+        {
+            hottest = value;
+        }
+    }
+
+    return hottest;
+}
+
+bool FanControllerSysFsPlant::writeFanLevel(quint8 level)
+{
+    QStringList points;
+
+    for (int i = 0; i < FAN_CURVE_POINTS; ++i) {
+        points.append(QString::number(level));
+    }
+
+    return writeFanCurve(points.join(',').toLatin1());
+}
+
+void FanControllerSysFsPlant::restoreFirmwareControl()
+{
+    if(m_firmwareFanCurve.isEmpty())
+    {
+        return;
+    }
+
+    if(!writeFanCurve(m_firmwareFanCurve))
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Restore of firmware fan curve failed !");
+    }
+}
+
+void FanControllerSysFsPlant::captureFirmwareControl()
+{
+    QByteArray fanCurve;
+    QFile      file(m_fanCurve);
+
+    if(file.open(QIODeviceBase::ReadOnly))
+    {
+        fanCurve = file.readAll().trimmed();
+    }
+
+    if(fanCurve.split(',').size() != FAN_CURVE_POINTS)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Firmware fan curve can not be read, it will not be restored !");
+        m_firmwareFanCurve.clear();
+        return;
+    }
+
+    /*
+     * Own level still set, firmware did not load a new curve
+     */
+    if(!m_writtenFanCurve.isEmpty() && fanCurve == m_writtenFanCurve)
+    {
+        return;
+    }
+
+    m_firmwareFanCurve = fanCurve;
+}
+
+bool FanControllerSysFsPlant::writeFanCurve(const QByteArray &fanCurve)
+{
+    QFile file(m_fanCurve);
+
+    if(!file.open(QIODeviceBase::WriteOnly | QIODeviceBase::Unbuffered))
+    {
+        return false;
+    }
+
+    if(m_expectWrite)
+    {
+        m_expectWrite();
+    }
+
+    /*
+     * Firmware refuses the curve (EBUSY) when thermal mode is not custom, it must be seen here
+     */
+    if(file.write(fanCurve) != fanCurve.size())
+    {
+        return false;
+    }
+
+    m_writtenFanCurve = fanCurve;
+
+    return true;
+}
+
+}
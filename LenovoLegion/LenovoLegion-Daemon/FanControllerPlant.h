@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <QtGlobal>
+#include <QString>
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Everything the fan controller knows about the machine, called only from the controller thread
+ */
+class FanControllerPlant
+{
+public:
+
+    virtual ~FanControllerPlant() = default;
+
+    /*
+     * Hottest sensor in Celsius, std::nullopt when no sensor can be read
+     */
+    virtual std::optional<double> readTemperature()         = 0;
+
+    /*
+     * Apply fan level, false when firmware refused it
+     */
+    virtual bool writeFanLevel(quint8 level)                = 0;
+
+    /*
+     * Hand fan control back to the firmware fan curve
+     */
+    virtual void restoreFirmwareControl()                   = 0;
+
+    /*
+     * Firmware replaced its fan control (thermal mode change), restore to the new one from now on
+     */
+    virtual void captureFirmwareControl()                   = 0;
+};
+
+
+/*
+ * Legion hardware, temperatures from legion hwmon, fan level through the fan curve
+ *
+ * The legion hwmon fan attributes are read only, so the level is applied as a flat
+ * fan curve (all points set to the level) and the firmware curve captured at
+ * construction is written back by restoreFirmwareControl(). Every write echoes
+ * kernel event of the fan mode driver, expectWrite is called before each one so
+ * it can be dropped.
+ */
+class FanControllerSysFsPlant : public FanControllerPlant
+{
+public:
+
+    FanControllerSysFsPlant(const std::vector<std::filesystem::path>& temperatures,const std::filesystem::path& fanCurve,const std::function<void()>& expectWrite);
+
+    ~FanControllerSysFsPlant() override = default;
+
+    std::optional<double> readTemperature()         override;
+    bool writeFanLevel(quint8 level)                override;
+    void restoreFirmwareControl()                   override;
+    void captureFirmwareControl()                   override;
+
+private:
+
+    bool writeFanCurve(const QByteArray& fanCurve);
+
+private:
+
+    const std::vector<std::filesystem::path> m_temperatures;
+    const std::filesystem::path              m_fanCurve;
+    const std::function<void()>              m_expectWrite;
+
+    /*
+     * Firmware curve as read before the first write or at last capture
+     */
+    QByteArray                               m_firmwareFanCurve;
+
+    /*
+     * Own curve written last, it is not taken as firmware curve by capture
+     */
+    QByteArray                               m_writtenFanCurve;
+};
+
+}
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "FanControllerThermalPlant.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Integration step of the model, long gaps between reads are split into steps of this size
+ */
+static constexpr double MODEL_STEP_SECONDS = 0.01;
+
+
+FanControllerThermalPlant::FanControllerThermalPlant() : FanControllerThermalPlant(Model{})
+{}
+
+FanControllerThermalPlant::FanControllerThermalPlant(const Model &model) :
+    m_model(model),
+    m_temperature(model.m_initialTemperature),
+    m_fanSpeed(0),
+    m_fanLevel(0),
+    m_failReads(false),
+    m_failWrites(false),
+    m_firmwareControlRestored(false),
+    m_lastUpdate(std::chrono::steady_clock::now())
+{}
+
+std::optional<double> FanControllerThermalPlant::readTemperature()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto now = std::chrono::steady_clock::now();
+    advanceLocked(std::chrono::duration<double>(now - m_lastUpdate).count());
+    m_lastUpdate = now;
+
+    if(m_failReads)
+    {
+        return std::nullopt;
+    }
+
+    return m_temperature;
+}
+
+bool FanControllerThermalPlant::writeFanLevel(quint8 level)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(m_failWrites)
+    {
+        return false;
+    }
+
+    LOG_T(QString(__PRETTY_FUNCTION__) + " - level=" + QString::number(level) + ", temperature=" + QString::number(m_temperature,'f',2));
+
+    m_fanLevel                = level;
+    m_firmwareControlRestored = false;
+
+    return true;
+}
+
+void FanControllerThermalPlant::restoreFirmwareControl()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + " - temperature=" + QString::number(m_temperature,'f',2));
+
+    /*
+     * Firmware curve is modelled as full fan
+     */
+    m_fanLevel                = 10;
+    m_firmwareControlRestored = true;
+}
+
+void FanControllerThermalPlant::captureFirmwareControl()
+{
+    /*
+     * Modelled firmware curve does not depend on thermal mode
+     */
+}
+
+void FanControllerThermalPlant::advance(double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    advanceLocked(seconds);
+}
+
+void FanControllerThermalPlant::setHeatLoad(double watts)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_model.m_heatLoad = watts;
+}
+
+void FanControllerThermalPlant::setFailReads(bool fail)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_failReads = fail;
+}
+
+void FanControllerThermalPlant::setFailWrites(bool fail)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_failWrites = fail;
+}
+
+double FanControllerThermalPlant::temperature() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_temperature;
+}
+
+double FanControllerThermalPlant::fanSpeed() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_fanSpeed;
+}
+
+bool FanControllerThermalPlant::firmwareControlRestored() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_firmwareControlRestored;
+}
+
+void FanControllerThermalPlant::advanceLocked(double seconds)
+{
+    while(seconds > 0)
+    {
+        const double dt = std::min(seconds,MODEL_STEP_SECONDS);
+
+        // Fan follows requested level with first order lag
+        m_fanSpeed += (m_fanLevel - m_fanSpeed) * dt / (m_model.m_fanTimeConstant + dt);
+
+        const double conductance = m_model.m_passiveConductance + m_model.m_fanConductancePerLevel * m_fanSpeed;
+
+        m_temperature += (m_model.m_heatLoad - conductance * (m_temperature - m_model.m_ambient)) * dt / m_model.m_thermalMass;
+
+        seconds -= dt;
+    }
+}
+
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "FanControllerPlant.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Simulated thermal plant for running the fan controller without hardware
+ *
+ * Single thermal mass heated by a constant load and cooled towards ambient,
+ * cooling grows with the fan speed which follows the requested level with a
+ * spin up lag. The model advances with the wall clock on every read, or
+ * explicitly with advance().
+ */
+class FanControllerThermalPlant : public FanControllerPlant
+{
+public:
+
+    struct Model {
+        double m_ambient                = 30.0;     /* Celsius                               */
+        double m_heatLoad               = 45.0;     /* Watts                                 */
+        double m_thermalMass            = 60.0;     /* Joules per Kelvin                     */
+        double m_passiveConductance     = 0.35;     /* Watts per Kelvin with fans stopped    */
+        double m_fanConductancePerLevel = 0.12;     /* Watts per Kelvin added by fan level   */
+        double m_fanTimeConstant        = 1.5;      /* Seconds, fan spin up / down lag       */
+        double m_initialTemperature     = 45.0;     /* Celsius                               */
+    };
+
+public:
+
+    FanControllerThermalPlant();
+    explicit FanControllerThermalPlant(const Model& model);
+
+    ~FanControllerThermalPlant() override = default;
+
+    std::optional<double> readTemperature()         override;
+    bool writeFanLevel(quint8 level)                override;
+    void restoreFirmwareControl()                   override;
+    void captureFirmwareControl()                   override;
+
+    /*
+     * Simulation control, may be called from any thread
+     */
+    void   advance(double seconds);
+    void   setHeatLoad(double watts);
+    void   setFailReads(bool fail);
+    void   setFailWrites(bool fail);
+
+    double temperature()                const;
+    double fanSpeed()                   const;
+    bool   firmwareControlRestored()    const;
+
+private:
+
+    void   advanceLocked(double seconds);
+
+private:
+
+    mutable std::mutex                      m_mutex;
+
+    Model                                   m_model;
+    double                                  m_temperature;
+    double                                  m_fanSpeed;
+    quint8                                  m_fanLevel;
+    bool                                    m_failReads;
+    bool                                    m_failWrites;
+    bool                                    m_firmwareControlRestored;
+
+    std::chrono::steady_clock::time_point   m_lastUpdate;
+};
+
+}
@@ -11,12 +11,23 @@ DESTDIR = $${DESTINATION_BIN_PATH}
 
 SOURCES +=  \
         Application.cpp \
+        CPUStatistics.cpp \
         DaemonSettingsManager.cpp \
         DataProvider.cpp \
+        DataProviderCPUStatistics.cpp \
         DataProviderDaemonSettings.cpp \
+        DataProviderFanController.cpp \
         DataProviderManager.cpp \
         DataProviderNvidiaNvml.cpp \
+        DataProviderProfiles.cpp \
+        DataProviderWorkloadRules.cpp \
         DataProviderRGBController.cpp \
+        FanController.cpp \
+        FanControllerPlant.cpp \
+        FanControllerThermalPlant.cpp \
+        MetricsExporter.cpp \
+        NotificationRouter.cpp \
+        ProfileStore.cpp \
         ProtocolParser.cpp \
         ProtocolProcessor.cpp \
         ProtocolProcessorBase.cpp \
@@ -24,7 +35,15 @@ SOURCES +=  \
         RGBControlers/LenovoRGBControllerC197.cpp \
         RGBControlers/LenovoRGBControllerC9xx.cpp \
         RGBControlers/LenovoUSBControllerC9xx.cpp \
+        RGBAudioSource.cpp \
+        RGBAudioSpectrum.cpp \
         RGBController.cpp \
+        RGBMetricSampler.cpp \
+        RGBControllerGroup.cpp \
+        RGBControllerIndex.cpp \
+        RGBDirectModeEngine.cpp \
+        RGBDirectModeEffects.cpp \
+        RGBLedStateCache.cpp \
         SysFSDriverLegionFanMode.cpp \
         SysFSDriverLegionGameZone.cpp \
         SysFSDriverLegionHWMon.cpp \
@@ -34,6 +53,7 @@ SOURCES +=  \
         SysFsDataProviderCPUFrequency.cpp \
         SysFsDataProviderCPUInfo.cpp \
         SysFsDataProviderCPUOptions.cpp \
+        SysFsDataProviderCPUPolicy.cpp \
         SysFsDataProviderCPUPower.cpp \
         SysFsDataProviderCPUSMT.cpp \
         SysFsDataProviderCPUTopology.cpp \
@@ -59,19 +79,34 @@ SOURCES +=  \
         SysFsDriverLegionOther.cpp \
         SysFsDriverManager.cpp \
         SysFsDriverPowerSuplyBattery0.cpp \
+        SamplingGovernor.cpp \
         Settings.cpp \
+        SettingsApplyGraph.cpp \
         StringUtils.cpp \
+        WorkloadRuleEvaluator.cpp \
+        WorkloadRulesEngine.cpp \
         main.cpp
 
 HEADERS += \
     Application.h \
+    CPUStatistics.h \
     DaemonSettingsManager.h \
     DataProvider.h \
+    DataProviderCPUStatistics.h \
     DataProviderDaemonSettings.h \
+    DataProviderFanController.h \
     DataProviderManager.h \
     DataProviderNvidiaNvml.h \
+    DataProviderProfiles.h \
+    DataProviderWorkloadRules.h \
     DataProviderRGBController.h \
+    FanController.h \
+    FanControllerPlant.h \
+    FanControllerThermalPlant.h \
+    MetricsExporter.h \
     Message.h \
+    NotificationRouter.h \
+    ProfileStore.h \
     ProtocolParser.h \
     ProtocolProcessor.h \
     ProtocolProcessorBase.h \
@@ -81,7 +116,9 @@ HEADERS += \
     RGBControlers/LenovoUSBControllerC9xx.h \
     SysFSDriverLegionFanMode.h \
     SysFSDriverLegionGameZone.h \
+    SamplingGovernor.h \
     Settings.h \
+    SettingsApplyGraph.h \
     SysFSDriverLegionHWMon.h \
     SysFSDriverLegionIntelMSR.h \
     SysFsDataProvider.h \
@@ -89,6 +126,7 @@ HEADERS += \
     SysFsDataProviderCPUFrequency.h \
     SysFsDataProviderCPUInfo.h \
     SysFsDataProviderCPUOptions.h \
+    SysFsDataProviderCPUPolicy.h \
     SysFsDataProviderCPUPower.h \
     SysFsDataProviderCPUSMT.h \
     SysFsDataProviderCPUTopology.h \
@@ -116,20 +154,35 @@ HEADERS += \
     SysFsDriverManager.h \
     SysFsDriverPowerSuplyBattery0.h \
     RGBControllerInterface.h \
+    RGBAudioSource.h \
+    RGBAudioSpectrum.h \
     RGBController.h \
+    RGBMetricSampler.h \
+    RGBControllerGroup.h \
+    RGBControllerIndex.h \
     RGBControllerKeyNames.h \
+    RGBDirectModeEngine.h \
+    RGBDirectModeEffects.h \
+    RGBLedStateCache.h \
     StringUtils.h \
+    WorkloadRuleEvaluator.h \
+    WorkloadRulesEngine.h \
     RGBControllerDetector.h
 
 
 HEADERS += \
         RGBControlers/LenovoRGBController.h \
-        RGBControlers/LenovoUSBController.h
+        RGBControlers/LenovoUSBController.h \
+        RGBControlers/HIDTransport.h \
+        RGBControlers/HIDTransportHidApi.h \
+        RGBControlers/HIDWorker.h
 
 SOURCES += \
         RGBControlers/LenovoRGBController.cpp \
         RGBControlers/LenovoUSBController.cpp \
-        RGBControlers/LenovoUSBControllerDetect.cpp
+        RGBControlers/LenovoUSBControllerDetect.cpp \
+        RGBControlers/HIDTransportHidApi.cpp \
+        RGBControlers/HIDWorker.cpp
 
 
 HEADERS += \
@@ -147,6 +200,10 @@ HEADERS += \
         ../LenovoLegion-PrepareBuild/NvidiaNvml.pb.h   \
         ../LenovoLegion-PrepareBuild/ComputerInfo.pb.h \
         ../LenovoLegion-PrepareBuild/DaemonSettings.pb.h \
+        ../LenovoLegion-PrepareBuild/SettingsSnapshot.pb.h \
+        ../LenovoLegion-PrepareBuild/Profiles.pb.h \
+        ../LenovoLegion-PrepareBuild/WorkloadRules.pb.h \
+        ../LenovoLegion-PrepareBuild/CPUPolicy.pb.h \
         ../LenovoLegion-PrepareBuild/Other.pb.h \
         ../LenovoLegion-PrepareBuild/RGBController.pb.h \
         ../LenovoLegion-PrepareBuild/MessageRegistry.pb.h
@@ -166,6 +223,10 @@ SOURCES += \
         ../LenovoLegion-PrepareBuild/NvidiaNvml.pb.cc   \
         ../LenovoLegion-PrepareBuild/ComputerInfo.pb.cc \
         ../LenovoLegion-PrepareBuild/DaemonSettings.pb.cc \
+        ../LenovoLegion-PrepareBuild/SettingsSnapshot.pb.cc \
+        ../LenovoLegion-PrepareBuild/Profiles.pb.cc \
+        ../LenovoLegion-PrepareBuild/WorkloadRules.pb.cc \
+        ../LenovoLegion-PrepareBuild/CPUPolicy.pb.cc \
         ../LenovoLegion-PrepareBuild/Other.pb.cc \
         ../LenovoLegion-PrepareBuild/RGBController.pb.cc \
         ../LenovoLegion-PrepareBuild/MessageRegistry.pb.cc
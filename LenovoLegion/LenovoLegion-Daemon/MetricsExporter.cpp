@@ -0,0 +1,633 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "MetricsExporter.h"
+#include "DataProviderManager.h"
+#include "SysFsDriverManager.h"
+
+#include "SysFsDataProviderHWMon.h"
+#include "SysFsDataProviderCPUPower.h"
+#include "SysFsDataProviderPowerProfile.h"
+#include "SysFsDataProviderBattery.h"
+#include "DataProviderNvidiaNvml.h"
+#include "SamplingGovernor.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace LenovoLegionDaemon {
+
+namespace {
+
+/*
+ * Client which does not send the request head in time is dropped
+ */
+constexpr int CLIENT_TIMEOUT_MS = 5000;
+
+void appendNumber(std::string& out,double value)
+{
+    /*
+     * Text format spells them out, to_chars would write nan and inf
+     */
+    if(std::isnan(value))
+    {
+        out.append("NaN");
+        return;
+    }
+
+    if(std::isinf(value))
+    {
+        out.append(value > 0 ? "+Inf" : "-Inf");
+        return;
+    }
+
+    char buffer[32];
+    const auto result = std::to_chars(buffer,buffer + sizeof(buffer),value);
+    out.append(buffer,result.ptr);
+}
+
+void appendNumber(std::string& out,quint64 value)
+{
+    char buffer[24];
+    const auto result = std::to_chars(buffer,buffer + sizeof(buffer),value);
+    out.append(buffer,result.ptr);
+}
+
+void appendHeader(std::string& out,std::string_view name,std::string_view help,std::string_view type)
+{
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+void appendLabelValue(std::string& out,std::string_view value)
+{
+    for(const char c : value)
+    {
+        switch (c) {
+        case '\\': out.append("\\\\"); break;
+        case '"':  out.append("\\\"");  break;
+        case '\n': out.append("\\n");  break;
+        default:   out.push_back(c);   break;
+        }
+    }
+}
+
+template<class T>
+void appendSample(std::string& out,std::string_view name,T value)
+{
+    out.append(name).append(" ");
+    appendNumber(out,value);
+    out.append("\n");
+}
+
+template<class T>
+void appendSample(std::string& out,std::string_view name,std::string_view label,std::string_view labelValue,T value)
+{
+    out.append(name).append("{").append(label).append("=\"");
+    appendLabelValue(out,labelValue);
+    out.append("\"} ");
+    appendNumber(out,value);
+    out.append("\n");
+}
+
+/*
+ * POWER_PROFILE_QUIET -> quiet
+ */
+std::string profileName(legion::messages::PowerProfile::Profiles profile)
+{
+    std::string name(legion::messages::PowerProfile::Profiles_Name(profile));
+
+    if(name.rfind("POWER_PROFILE_",0) == 0)
+    {
+        name.erase(0,std::string_view("POWER_PROFILE_").size());
+    }
+
+    for(char& c : name)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    return name;
+}
+
+void renderHardwareMonitor(const legion::messages::HardwareMonitor& hwMon,std::string& out)
+{
+    if(hwMon.legion().temps_size() > 0)
+    {
+        appendHeader(out,"legion_temperature_celsius","Legion sensor temperature.","gauge");
+        for(const auto& temp : hwMon.legion().temps())
+        {
+            appendSample(out,"legion_temperature_celsius","sensor",temp.temp_label(),temp.temp_value() / 1000.0);
+        }
+    }
+
+    if(hwMon.legion().fans_size() > 0)
+    {
+        appendHeader(out,"legion_fan_speed_rpm","Legion fan speed.","gauge");
+        for(const auto& fan : hwMon.legion().fans())
+        {
+            appendSample(out,"legion_fan_speed_rpm","fan",fan.fan_label(),static_cast<quint64>(fan.fan_speed()));
+        }
+
+        appendHeader(out,"legion_fan_speed_max_rpm","Legion fan maximal speed.","gauge");
+        for(const auto& fan : hwMon.legion().fans())
+        {
+            appendSample(out,"legion_fan_speed_max_rpm","fan",fan.fan_label(),static_cast<quint64>(fan.fan_speed_max()));
+        }
+    }
+
+    if(hwMon.has_intel_power())
+    {
+        appendHeader(out,"legion_cpu_energy_joules_total","CPU package energy from Intel RAPL.","counter");
+        appendSample(out,"legion_cpu_energy_joules_total",hwMon.intel_power().power_cap_cpu_energy() / 1000000.0);
+    }
+
+    if(hwMon.cpux_freq_size() > 0)
+    {
+        appendHeader(out,"legion_cpu_scaling_frequency_hertz","Current CPU frequency from cpufreq.","gauge");
+        for(int cpu = 0; cpu < hwMon.cpux_freq_size(); ++cpu)
+        {
+            if(hwMon.cpux_freq(cpu).cpu_online())
+            {
+                appendSample(out,"legion_cpu_scaling_frequency_hertz","cpu",std::to_string(cpu),hwMon.cpux_freq(cpu).cpu_scaling_cur_freq() * 1000.0);
+            }
+        }
+    }
+}
+
+void renderCPUPower(const legion::messages::CPUPower& cpuPower,std::string& out)
+{
+    using Limit = const legion::messages::CPUPower::Limit& (legion::messages::CPUPower::*)() const;
+    using Has   = bool (legion::messages::CPUPower::*)() const;
+
+    /*
+     * One metric per unit, limits of different units never share a name
+     */
+    static constexpr struct {
+        std::string_view    m_name;
+        std::string_view    m_help;
+    } METRICS[] = {
+        {"legion_cpu_power_limit_watts",        "Firmware power limit."},
+        {"legion_cpu_power_limit_tau_seconds",  "Firmware power limit time window."},
+        {"legion_cpu_temperature_limit_celsius","Firmware temperature limit."}
+    };
+
+    static constexpr struct {
+        std::string_view    m_name;
+        size_t              m_metric;
+        Has                 m_has;
+        Limit               m_limit;
+    } LIMITS[] = {
+        {"apus_pptp_limit",             0,  &legion::messages::CPUPower::has_apus_pptp_limit,           &legion::messages::CPUPower::apus_pptp_limit},
+        {"cpu_clp_limit",               0,  &legion::messages::CPUPower::has_cpu_clp_limit,             &legion::messages::CPUPower::cpu_clp_limit},
+        {"cpu_ltp_limit",               0,  &legion::messages::CPUPower::has_cpu_ltp_limit,             &legion::messages::CPUPower::cpu_ltp_limit},
+        {"cpu_pl1_tau",                 1,  &legion::messages::CPUPower::has_cpu_pl1_tau,               &legion::messages::CPUPower::cpu_pl1_tau},
+        {"cpu_pp_limit",                0,  &legion::messages::CPUPower::has_cpu_pp_limit,              &legion::messages::CPUPower::cpu_pp_limit},
+        {"cpu_stp_limit",               0,  &legion::messages::CPUPower::has_cpu_stp_limit,             &legion::messages::CPUPower::cpu_stp_limit},
+        {"cpu_tmp_limit",               2,  &legion::messages::CPUPower::has_cpu_tmp_limit,             &legion::messages::CPUPower::cpu_tmp_limit},
+        {"gpu_to_cpu_dynamic_boost",    0,  &legion::messages::CPUPower::has_gpu_to_cpu_dynamic_boost,  &legion::messages::CPUPower::gpu_to_cpu_dynamic_boost},
+        {"gpu_total_onac",              0,  &legion::messages::CPUPower::has_gpu_total_onac,            &legion::messages::CPUPower::gpu_total_onac}
+    };
+
+    for(size_t metric = 0; metric < std::size(METRICS); ++metric)
+    {
+        bool header = false;
+
+        for(const auto& limit : LIMITS)
+        {
+            if(limit.m_metric != metric || !(cpuPower.*limit.m_has)())
+            {
+                continue;
+            }
+
+            if(!header)
+            {
+                appendHeader(out,METRICS[metric].m_name,METRICS[metric].m_help,"gauge");
+                header = true;
+            }
+
+            appendSample(out,METRICS[metric].m_name,"limit",limit.m_name,static_cast<quint64>((cpuPower.*limit.m_limit)().current_value()));
+        }
+    }
+}
+
+void renderPowerProfile(const legion::messages::PowerProfile& powerProfile,std::string& out)
+{
+    appendHeader(out,"legion_power_profile","Current power profile.","gauge");
+    appendSample(out,"legion_power_profile","profile",profileName(powerProfile.current_value()),quint64(1));
+
+    appendHeader(out,"legion_thermal_mode","Current thermal mode.","gauge");
+    appendSample(out,"legion_thermal_mode","mode",profileName(powerProfile.thermal_mode()),quint64(1));
+}
+
+void renderBattery(const legion::messages::Battery& battery,std::string& out)
+{
+    if(!battery.supported() || battery.current_charge_mode_value() == legion::messages::Battery::POWER_CHARGE_MODE_UNKNOWN)
+    {
+        return;
+    }
+
+    appendHeader(out,"legion_on_ac_power","1 when running on AC adapter.","gauge");
+    appendSample(out,"legion_on_ac_power",quint64(battery.current_charge_mode_value() == legion::messages::Battery::POWER_CHARGE_MODE_AC ? 1 : 0));
+}
+
+void renderNvidiaNvml(const legion::messages::NvidiaNvml& nvml,std::string& out)
+{
+    if(!nvml.has_hardware_monitor())
+    {
+        return;
+    }
+
+    const auto& hwMon = nvml.hardware_monitor();
+
+    appendHeader(out,"legion_gpu_utilization_ratio","GPU utilization.","gauge");
+    appendSample(out,"legion_gpu_utilization_ratio","gpu",nvml.name(),hwMon.gpu_utilization().value() / 100.0);
+
+    appendHeader(out,"legion_gpu_memory_utilization_ratio","GPU memory controller utilization.","gauge");
+    appendSample(out,"legion_gpu_memory_utilization_ratio","gpu",nvml.name(),hwMon.memory_utilization().value() / 100.0);
+
+    appendHeader(out,"legion_gpu_temperature_celsius","GPU temperature.","gauge");
+    appendSample(out,"legion_gpu_temperature_celsius","gpu",nvml.name(),static_cast<quint64>(hwMon.temperature().value()));
+
+    appendHeader(out,"legion_gpu_memory_used_bytes","GPU memory used.","gauge");
+    appendSample(out,"legion_gpu_memory_used_bytes","gpu",nvml.name(),static_cast<quint64>(hwMon.memory_use().used()));
+
+    appendHeader(out,"legion_gpu_memory_total_bytes","GPU memory total.","gauge");
+    appendSample(out,"legion_gpu_memory_total_bytes","gpu",nvml.name(),static_cast<quint64>(hwMon.memory_use().total()));
+
+    appendHeader(out,"legion_gpu_clock_hertz","GPU graphics clock.","gauge");
+    appendSample(out,"legion_gpu_clock_hertz","gpu",nvml.name(),hwMon.gpu_clock().value() * 1000000.0);
+
+    appendHeader(out,"legion_gpu_memory_clock_hertz","GPU memory clock.","gauge");
+    appendSample(out,"legion_gpu_memory_clock_hertz","gpu",nvml.name(),hwMon.memory_clock().value() * 1000000.0);
+
+    appendHeader(out,"legion_gpu_power_watts","GPU power draw.","gauge");
+    appendSample(out,"legion_gpu_power_watts","gpu",nvml.name(),hwMon.power().value() / 1000.0);
+
+    appendHeader(out,"legion_gpu_power_limit_watts","GPU enforced power limit.","gauge");
+    appendSample(out,"legion_gpu_power_limit_watts","gpu",nvml.name(),hwMon.power().enforced_value() / 1000.0);
+
+    appendHeader(out,"legion_gpu_energy_joules_total","GPU energy since driver load.","counter");
+    appendSample(out,"legion_gpu_energy_joules_total","gpu",nvml.name(),hwMon.power().total() / 1000.0);
+}
+
+}
+
+
+MetricsExporter::MetricsExporter(SysFsDriverManager *sysFsDriverManager, DataProviderManager *dataProviderManager, QObject *parent) :
+    QObject(parent),
+    m_sysFsDriverManager(sysFsDriverManager),
+    m_dataProviderManager(dataProviderManager),
+    m_localServer(nullptr),
+    m_tcpServer(nullptr),
+    m_governor("metrics_exporter",SamplingGovernor::Policy{REFRESH_INTERVAL},[] {}),
+    m_scrapes(0),
+    m_lastRender(0),
+    m_maxRender(0)
+{}
+
+MetricsExporter::~MetricsExporter()
+{
+    close();
+}
+
+void MetricsExporter::listen(const QString &address)
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(address == m_address && (m_localServer != nullptr || m_tcpServer != nullptr || address.isEmpty()))
+    {
+        return;
+    }
+
+    close();
+
+    m_address = address;
+
+    if(address.isEmpty())
+    {
+        return;
+    }
+
+    if(!isValidAddress(address))
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Metrics exporter address " + address + " refused, only localhost port or " + UNIX_SOCKET_ADDRESS + " is allowed");
+        return;
+    }
+
+    bool        isPort  = false;
+    const uint  port    = address.toUInt(&isPort);
+
+    if(isPort)
+    {
+        m_tcpServer = new QTcpServer(this);
+
+        connect(m_tcpServer,&QTcpServer::newConnection,this,&MetricsExporter::newConnectionHandler);
+
+        if(!m_tcpServer->listen(QHostAddress::LocalHost,static_cast<quint16>(port)))
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Metrics exporter can not listen on localhost port " + address + ": " + m_tcpServer->errorString());
+            close();
+            return;
+        }
+    }
+    else if(!listenUnixSocket())
+    {
+        close();
+        return;
+    }
+
+    LOG_I(QString("Metrics exporter listening on ") + address);
+}
+
+bool MetricsExporter::isValidAddress(const QString &address)
+{
+    bool        isPort  = false;
+    const uint  port    = address.toUInt(&isPort);
+
+    return address.isEmpty() || address == UNIX_SOCKET_ADDRESS || (isPort && port > 0 && port <= 0xFFFF);
+}
+
+bool MetricsExporter::listenUnixSocket()
+{
+    const std::string directory = RUNTIME_DIRECTORY;
+    const std::string path      = directory + "/" + SOCKET_NAME;
+    struct stat       status;
+
+    /*
+     * Directory must be ours, nobody else may swap the socket for something else
+     */
+    if(::mkdir(directory.c_str(),0755) != 0 && errno != EEXIST)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Metrics exporter can not create " + RUNTIME_DIRECTORY + ": " + std::strerror(errno));
+        return false;
+    }
+
+    if(::lstat(directory.c_str(),&status) != 0 || !S_ISDIR(status.st_mode) || status.st_uid != ::geteuid() || (status.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Metrics exporter refuses " + RUNTIME_DIRECTORY + ", it is not a directory writable only by the daemon");
+        return false;
+    }
+
+    /*
+     * Stale socket of previous run is removed, anything else is left alone
+     */
+    if(::lstat(path.c_str(),&status) == 0)
+    {
+        if(!S_ISSOCK(status.st_mode))
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Metrics exporter refuses " + path.c_str() + ", it is not a socket");
+            return false;
+        }
+
+        if(::unlink(path.c_str()) != 0)
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Metrics exporter can not remove stale socket " + path.c_str() + ": " + std::strerror(errno));
+            return false;
+        }
+    }
+
+    m_localServer = new QLocalServer(this);
+
+    connect(m_localServer,&QLocalServer::newConnection,this,&MetricsExporter::newConnectionHandler);
+
+    m_localServer->setSocketOptions(QLocalServer::WorldAccessOption);
+
+    if(!m_localServer->listen(QString::fromStdString(path)))
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Metrics exporter can not listen on unix socket " + path.c_str() + ": " + m_localServer->errorString());
+        return false;
+    }
+
+    return true;
+}
+
+void MetricsExporter::close()
+{
+    m_snapshotTime.reset();
+
+    if(m_localServer != nullptr)
+    {
+        m_localServer->close();
+        m_localServer->deleteLater();
+        m_localServer = nullptr;
+    }
+
+    if(m_tcpServer != nullptr)
+    {
+        m_tcpServer->close();
+        m_tcpServer->deleteLater();
+        m_tcpServer = nullptr;
+    }
+}
+
+void MetricsExporter::newConnectionHandler()
+{
+    for(;;)
+    {
+        QIODevice* client = nullptr;
+
+        if(m_localServer != nullptr && m_localServer->hasPendingConnections())
+        {
+            QLocalSocket* socket = m_localServer->nextPendingConnection();
+            connect(socket,&QLocalSocket::disconnected,socket,&QObject::deleteLater);
+            client = socket;
+        }
+        else if(m_tcpServer != nullptr && m_tcpServer->hasPendingConnections())
+        {
+            QTcpSocket* socket = m_tcpServer->nextPendingConnection();
+            connect(socket,&QTcpSocket::disconnected,socket,&QObject::deleteLater);
+            client = socket;
+        }
+
+        if(client == nullptr)
+        {
+            return;
+        }
+
+        connect(client,&QIODevice::readyRead,this,[this,client]() { handleClient(client); });
+        QTimer::singleShot(CLIENT_TIMEOUT_MS,client,&QObject::deleteLater);
+    }
+}
+
+void MetricsExporter::handleClient(QIODevice *client)
+{
+    const QByteArray head = client->peek(MAX_REQUEST_SIZE);
+
+    if(!head.contains("\r\n\r\n") && !head.contains("\n\n"))
+    {
+        if(head.size() >= MAX_REQUEST_SIZE)
+        {
+            client->deleteLater();
+        }
+        return;
+    }
+
+    client->disconnect(this);
+
+    std::string response;
+
+    if(head.startsWith("GET "))
+    {
+        refreshSnapshot();
+
+        m_body.clear();
+
+        const auto renderStart = std::chrono::steady_clock::now();
+        render(m_snapshot,m_body);
+        m_lastRender = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - renderStart);
+        m_maxRender  = std::max(m_maxRender,m_lastRender);
+        m_scrapes++;
+
+        appendHeader(m_body,"legion_exporter_scrapes_total","Scrapes served by the exporter.","counter");
+        appendSample(m_body,"legion_exporter_scrapes_total",m_scrapes);
+        appendHeader(m_body,"legion_exporter_render_seconds","Time to render this scrape.","gauge");
+        appendSample(m_body,"legion_exporter_render_seconds",m_lastRender.count() / 1000000.0);
+        appendHeader(m_body,"legion_exporter_render_max_seconds","Longest render since start.","gauge");
+        appendSample(m_body,"legion_exporter_render_max_seconds",m_maxRender.count() / 1000000.0);
+        appendHeader(m_body,"legion_exporter_refresh_seconds","Time of the last snapshot refresh from data providers.","gauge");
+        appendSample(m_body,"legion_exporter_refresh_seconds",m_snapshot.m_refreshDuration.count() / 1000000.0);
+
+        appendHeader(m_body,"legion_kernel_events_raw_total","Kernel events emitted by drivers.","counter");
+        m_sysFsDriverManager->forEachKernelEventCountersDo([this](const QString& driverName,const SysFsDriverManager::KernelEventCounters& counters) {
+            appendSample(m_body,"legion_kernel_events_raw_total","driver",driverName.toStdString(),counters.m_raw);
+        });
+        appendHeader(m_body,"legion_kernel_events_delivered_total","Kernel events delivered after debounce.","counter");
+        m_sysFsDriverManager->forEachKernelEventCountersDo([this](const QString& driverName,const SysFsDriverManager::KernelEventCounters& counters) {
+            appendSample(m_body,"legion_kernel_events_delivered_total","driver",driverName.toStdString(),counters.m_delivered);
+        });
+        appendHeader(m_body,"legion_sampling_wakeups_total","Wakeups of governed daemon samplers.","counter");
+        SamplingGovernor::getInstance().forEachSourceDo([this](const SamplingGovernor::Source& source) {
+            appendSample(m_body,"legion_sampling_wakeups_total","source",source.name(),source.wakeups());
+        });
+        appendHeader(m_body,"legion_sampling_interval_seconds","Current sampling interval picked by the sampling governor.","gauge");
+        SamplingGovernor::getInstance().forEachSourceDo([this](const SamplingGovernor::Source& source) {
+            appendSample(m_body,"legion_sampling_interval_seconds","source",source.name(),source.interval().count() / 1000.0);
+        });
+
+        LOG_T(QString(__PRETTY_FUNCTION__) + QString(" - Scrape rendered in %1 us, %2 bytes").arg(m_lastRender.count()).arg(m_body.size()));
+
+        response.append("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: ");
+        appendNumber(response,static_cast<quint64>(m_body.size()));
+        response.append("\r\nConnection: close\r\n\r\n").append(m_body);
+    }
+    else
+    {
+        response.append("HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    }
+
+    client->write(response.data(),static_cast<qint64>(response.size()));
+
+    if(QLocalSocket* socket = qobject_cast<QLocalSocket*>(client))
+    {
+        socket->disconnectFromServer();
+    }
+    else if(QTcpSocket* socket = qobject_cast<QTcpSocket*>(client))
+    {
+        socket->disconnectFromHost();
+    }
+}
+
+void MetricsExporter::refreshSnapshot()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    if(m_snapshotTime.has_value() && start - m_snapshotTime.value() < m_governor.interval())
+    {
+        return;
+    }
+
+    Snapshot snapshot;
+
+    snapshot.m_hardwareMonitor = readProvider<legion::messages::HardwareMonitor>(SysFsDataProviderHWMon::dataType);
+    snapshot.m_cpuPower        = readProvider<legion::messages::CPUPower>(SysFsDataProviderCPUPower::dataType);
+    snapshot.m_powerProfile    = readProvider<legion::messages::PowerProfile>(SysFsDataProviderPowerProfile::dataType);
+    snapshot.m_battery         = readProvider<legion::messages::Battery>(SysFsDataProviderBattery::dataType);
+    snapshot.m_nvidiaNvml      = readProvider<legion::messages::NvidiaNvml>(DataProviderNvidiaNvml::dataType);
+
+    snapshot.m_refreshDuration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    /*
+     * Stable values stretch the interval, scrapes get the cached snapshot meanwhile
+     */
+    const bool changed = !m_snapshotTime.has_value() || !equals(snapshot,m_snapshot);
+
+    m_snapshot     = std::move(snapshot);
+    m_snapshotTime = start;
+
+    m_governor.next(changed);
+}
+
+bool MetricsExporter::equals(const Snapshot &first, const Snapshot &second)
+{
+    auto same = [](const auto& a,const auto& b) {
+        return a.has_value() == b.has_value() && (!a.has_value() || google::protobuf::util::MessageDifferencer::Equals(a.value(),b.value()));
+    };
+
+    return same(first.m_hardwareMonitor,second.m_hardwareMonitor) &&
+           same(first.m_cpuPower,second.m_cpuPower)               &&
+           same(first.m_powerProfile,second.m_powerProfile)       &&
+           same(first.m_battery,second.m_battery)                 &&
+           same(first.m_nvidiaNvml,second.m_nvidiaNvml);
+}
+
+template<class T>
+std::optional<T> MetricsExporter::readProvider(quint8 dataType) const
+{
+    T message;
+
+    try {
+        const QByteArray data = m_dataProviderManager->getDataProvider(dataType).serializeAndGetData();
+
+        if(!message.ParseFromArray(data.data(),data.size()))
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Parse of data message error, data type " + QString::number(dataType));
+            return std::nullopt;
+        }
+    } catch(...)
+    {
+        LOG_D(QString(__PRETTY_FUNCTION__) + " - Data provider not available, data type " + QString::number(dataType));
+        return std::nullopt;
+    }
+
+    return message;
+}
+
+void MetricsExporter::render(const Snapshot &snapshot, std::string &out)
+{
+    appendHeader(out,"legion_exporter_provider_up","1 when the data provider returned data.","gauge");
+    appendSample(out,"legion_exporter_provider_up","provider","hardware_monitor",quint64(snapshot.m_hardwareMonitor.has_value()));
+    appendSample(out,"legion_exporter_provider_up","provider","cpu_power",quint64(snapshot.m_cpuPower.has_value()));
+    appendSample(out,"legion_exporter_provider_up","provider","power_profile",quint64(snapshot.m_powerProfile.has_value()));
+    appendSample(out,"legion_exporter_provider_up","provider","battery",quint64(snapshot.m_battery.has_value()));
+    appendSample(out,"legion_exporter_provider_up","provider","nvidia_nvml",quint64(snapshot.m_nvidiaNvml.has_value()));
+
+    if(snapshot.m_hardwareMonitor.has_value()) renderHardwareMonitor(snapshot.m_hardwareMonitor.value(),out);
+    if(snapshot.m_cpuPower.has_value())        renderCPUPower(snapshot.m_cpuPower.value(),out);
+    if(snapshot.m_powerProfile.has_value())    renderPowerProfile(snapshot.m_powerProfile.value(),out);
+    if(snapshot.m_battery.has_value())         renderBattery(snapshot.m_battery.value(),out);
+    if(snapshot.m_nvidiaNvml.has_value())      renderNvidiaNvml(snapshot.m_nvidiaNvml.value(),out);
+}
+
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "../LenovoLegion-PrepareBuild/HWMonitoring.pb.h"
+#include "../LenovoLegion-PrepareBuild/CpuPower.pb.h"
+#include "../LenovoLegion-PrepareBuild/PowerProfile.pb.h"
+#include "../LenovoLegion-PrepareBuild/Battery.pb.h"
+#include "../LenovoLegion-PrepareBuild/NvidiaNvml.pb.h"
+
+#include "SamplingGovernor.h"
+
+#include <QObject>
+#include <QString>
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+class QLocalServer;
+class QTcpServer;
+class QIODevice;
+
+namespace LenovoLegionDaemon {
+
+class DataProviderManager;
+class SysFsDriverManager;
+
+/*
+ * Prometheus text format exporter
+ *
+ * Serves hardware monitor, CPU power, power profile, battery and NVML values over HTTP on
+ * a unix socket or a localhost port. Values come from the data providers on the main loop,
+ * so the exporter never races with writes of the daemon. Scrape refreshes the snapshot only
+ * when it is older than the interval picked by the sampling governor, REFRESH_INTERVAL while
+ * values move, other scrapes render the cached snapshot. Without scrapes nothing is read.
+ *
+ * Address is set by any local client, so the unix socket is never a path of its choice,
+ * it is always SOCKET_NAME in RUNTIME_DIRECTORY.
+ */
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /*
+     * Minimal age of snapshot refreshed by a scrape, governed
+     */
+    static constexpr std::chrono::milliseconds  REFRESH_INTERVAL    {1000};
+
+    /*
+     * Address selecting the unix socket
+     */
+    static constexpr const char*                UNIX_SOCKET_ADDRESS = "unix";
+    static constexpr const char*                RUNTIME_DIRECTORY   = "/run/lenovo-legion";
+    static constexpr const char*                SOCKET_NAME         = "metrics.sock";
+
+    /*
+     * Largest HTTP request head accepted, the path is ignored
+     */
+    static constexpr qint64                     MAX_REQUEST_SIZE    = 8 * 1024;
+
+    struct Snapshot {
+        std::optional<legion::messages::HardwareMonitor>    m_hardwareMonitor;
+        std::optional<legion::messages::CPUPower>           m_cpuPower;
+        std::optional<legion::messages::PowerProfile>       m_powerProfile;
+        std::optional<legion::messages::Battery>            m_battery;
+        std::optional<legion::messages::NvidiaNvml>         m_nvidiaNvml;
+        std::chrono::microseconds                           m_refreshDuration {0};
+    };
+
+public:
+
+    MetricsExporter(SysFsDriverManager* sysFsDriverManager,DataProviderManager* dataProviderManager,QObject* parent);
+    ~MetricsExporter() override;
+
+    /*
+     * Empty address stops the exporter, a number listens on that localhost port,
+     * UNIX_SOCKET_ADDRESS on the unix socket, anything else is refused
+     */
+    void listen(const QString& address);
+
+    static bool isValidAddress(const QString& address);
+
+    /*
+     * Appends snapshot in Prometheus text format 0.0.4
+     */
+    static void render(const Snapshot& snapshot,std::string& out);
+
+private slots:
+
+    void newConnectionHandler();
+
+private:
+
+    void close();
+    bool listenUnixSocket();
+    void handleClient(QIODevice* client);
+    /*
+     * Refreshes snapshot older than governed interval
+     */
+    void refreshSnapshot();
+
+    static bool equals(const Snapshot& first,const Snapshot& second);
+
+    template<class T>
+    std::optional<T> readProvider(quint8 dataType) const;
+
+private:
+
+    SysFsDriverManager*                     m_sysFsDriverManager;
+    DataProviderManager*                    m_dataProviderManager;
+
+    QString                                 m_address;
+    QLocalServer*                           m_localServer;
+    QTcpServer*                             m_tcpServer;
+
+    SamplingGovernor::Source                m_governor;
+    Snapshot                                m_snapshot;
+    std::optional<std::chrono::steady_clock::time_point> m_snapshotTime;
+
+    std::string                             m_body;
+    quint64                                 m_scrapes;
+    std::chrono::microseconds               m_lastRender;
+    std::chrono::microseconds               m_maxRender;
+};
+
+}
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "NotificationRouter.h"
+
+#include "SysFsDriverPowerSuplyBattery0.h"
+#include "SysFsDriverCPUXList.h"
+#include "SysFsDriverLegionEvents.h"
+#include "SysFsDriverLegionOther.h"
+#include "SysFSDriverLegionIntelMSR.h"
+#include "SysFSDriverLegionFanMode.h"
+
+namespace LenovoLegionDaemon {
+
+bool NotificationRouter::route(const SysFsDriver::SubsystemEvent &event, legion::messages::Notification &msg)
+{
+    if(event.m_driverId >= SysFsDriver::DRIVER_ID_COUNT || event.m_action < 0 || event.m_action >= SysFsDriver::SubsystemEvent::ACTION_COUNT)
+    {
+        return false;
+    }
+
+    const RouteRow& row   = routeTable()[event.m_driverId * SysFsDriver::SubsystemEvent::ACTION_COUNT + event.m_action];
+    const size_t    slot  = static_cast<size_t>(static_cast<qint64>(event.m_eventType) - row.m_typeBase);
+    const Route&    route = slot < row.m_types.size() ? row.m_types[slot] : row.m_any;
+
+    if(!route.m_valid)
+    {
+        return false;
+    }
+
+    msg.set_action(route.m_action);
+
+    if(route.m_payload != nullptr)
+    {
+        route.m_payload(msg,event.m_eventValue);
+    }
+
+    return true;
+}
+
+const NotificationRouter::RouteTable &NotificationRouter::routeTable()
+{
+    static const RouteTable table = createRouteTable();
+    return table;
+}
+
+NotificationRouter::RouteTable NotificationRouter::createRouteTable()
+{
+    using Notification = legion::messages::Notification;
+    using Action       = SysFsDriver::SubsystemEvent::Action;
+
+    RouteTable table;
+
+    auto row = [&table](SysFsDriver::DriverId driverId,Action action) -> RouteRow& {
+        return table[driverId * SysFsDriver::SubsystemEvent::ACTION_COUNT + action];
+    };
+
+    auto types = [](RouteRow& row,int first,int last) -> RouteRow& {
+        row.m_typeBase = first;
+        row.m_types.resize(last - first + 1);
+        return row;
+    };
+
+    auto route = [](Notification::Action action,void (*payload)(Notification&,quint32) = nullptr) {
+        return Route{.m_valid = true,.m_action = action,.m_payload = payload};
+    };
+
+    row(SysFsDriverPowerSuplyBattery0::DRIVER_ID,Action::CHANGED).m_any  = route(Notification::POWER_SUPPLY_BATTERY0_CHANGE);
+    row(SysFsDriverCPUXList::DRIVER_ID,Action::RELOADED).m_any           = route(Notification::CPU_X_LIST_RELOADED);
+    row(SysFSDriverLegionIntelMSR::DRIVER_ID,Action::CHANGED).m_any      = route(Notification::CPU_OFFSET_CHANGED);
+    row(SysFSDriverLegionFanMode::DRIVER_ID,Action::CHANGED).m_any       = route(Notification::FAN_CURVE_CHANGED);
+
+    /*
+     * CPU hotplug, one CPU per event
+     */
+    {
+        RouteRow& cpus = types(row(SysFsDriverCPUXList::DRIVER_ID,Action::CHANGED),SysFsDriverCPUXList::CPU_X_ONLINE,SysFsDriverCPUXList::CPU_X_OFFLINE);
+
+        cpus.m_types[SysFsDriverCPUXList::CPU_X_ONLINE - cpus.m_typeBase] = route(Notification::CPU_X_CHANGED,[](Notification& msg,quint32 value) {
+            msg.set_cpu_id(value);
+            msg.set_cpu_online(true);
+        });
+        cpus.m_types[SysFsDriverCPUXList::CPU_X_OFFLINE - cpus.m_typeBase] = route(Notification::CPU_X_CHANGED,[](Notification& msg,quint32 value) {
+            msg.set_cpu_id(value);
+            msg.set_cpu_online(false);
+        });
+    }
+
+    /*
+     * Legion WMI events, hotkeys and thermal mode
+     */
+    {
+        RouteRow& events = types(row(SysFsDriverLegionEvents::DRIVER_ID,Action::CHANGED),SysFsDriverLegionEvents::LENOVO_WMI_EVENT_UTILITY,SysFsDriverLegionEvents::LEGION_WMI_EVENT_KEYLOCK_STATUS);
+
+        events.m_types[SysFsDriverLegionEvents::LEGION_WMI_EVENT_KEYLOCK_STATUS - events.m_typeBase] = route(Notification::KEYLOCK_STATUS_CHANGE,[](Notification& msg,quint32 value) {
+            msg.set_key_lock_key(static_cast<legion::messages::Notification_KeylockDisabledBit>(value));
+        });
+        events.m_types[SysFsDriverLegionEvents::LENOVO_WMI_EVENT_UTILITY - events.m_typeBase] = route(Notification::SPECIAL_KEY_PRESSED,[](Notification& msg,quint32 value) {
+            msg.set_special_key(static_cast<legion::messages::Notification_SpecialKey>(value));
+        });
+        events.m_types[SysFsDriverLegionEvents::LEGION_WMI_EVENT_THERMAL_MODE - events.m_typeBase] = route(Notification::THERMAL_MODE_CHANGE);
+    }
+
+    /*
+     * Legion WMI other, power limits and fan curve
+     */
+    {
+        RouteRow& other = types(row(SysFsDriverLegionOther::DRIVER_ID,Action::CHANGED),SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_STP,SysFsDriverLegionOther::LENOVO_WMI_OTHER_SS_M);
+
+        for(const int type : {SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_STP,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_LTP,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_PP,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_TMP,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_CLP,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_CPU_PL1_TAU,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_APU_PPT,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_PB,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_TAC,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_TGP,
+                              SysFsDriverLegionOther::LENOVO_WMI_OTHER_GPU_TMP})
+        {
+            other.m_types[type - other.m_typeBase] = route(Notification::POWER_CONTROL_CHANGED);
+        }
+
+        other.m_types[SysFsDriverLegionOther::LENOVO_WMI_OTHER_FF_S - other.m_typeBase] = route(Notification::FAN_CURVE_CHANGED);
+    }
+
+    return table;
+}
+
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "SysFsDriver.h"
+
+#include "../LenovoLegion-PrepareBuild/Notification.pb.h"
+
+#include <array>
+#include <vector>
+
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Maps kernel events to client notifications
+ *
+ * Static table indexed by (driver id, action), each row maps a contiguous event type range to
+ * notification and optional payload setter, with a fallback route for all other types. Routing
+ * is a table lookup without any string work.
+ */
+class NotificationRouter
+{
+public:
+
+    /*
+     * False when event has no notification, msg is left untouched
+     */
+    static bool route(const SysFsDriver::SubsystemEvent& event,legion::messages::Notification& msg);
+
+private:
+
+    /*
+     * Notification sent for one (driver, action, event type), payload copies event value into it
+     */
+    struct Route {
+        bool                                        m_valid     = false;
+        legion::messages::Notification::Action      m_action    = legion::messages::Notification::LENOVO_DRIVER_ADDED;
+        void                                      (*m_payload)(legion::messages::Notification& msg,quint32 value) = nullptr;
+    };
+
+    /*
+     * Event types m_typeBase .. m_typeBase + m_types.size() - 1 are routed by m_types, any other by m_any
+     */
+    struct RouteRow {
+        int                                         m_typeBase  = 0;
+        std::vector<Route>                          m_types;
+        Route                                       m_any;
+    };
+
+    /*
+     * Flat table indexed by driver id * ACTION_COUNT + action
+     */
+    using RouteTable = std::array<RouteRow,SysFsDriver::DRIVER_ID_COUNT * SysFsDriver::SubsystemEvent::ACTION_COUNT>;
+
+    static const RouteTable& routeTable();
+    static RouteTable        createRouteTable();
+};
+
+}
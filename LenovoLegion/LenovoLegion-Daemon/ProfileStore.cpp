@@ -0,0 +1,428 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "ProfileStore.h"
+#include "Settings.h"
+#include "DaemonSettingsManager.h"
+
+#include "DataProviderManager.h"
+#include "SysFsDataProviderPowerProfile.h"
+#include "SysFsDataProviderCPUOptions.h"
+#include "SysFsDataProviderCPUFrequency.h"
+#include "SysFsDataProviderFanCurve.h"
+#include "SysFsDataProviderFanOption.h"
+#include "SysFsDataProviderCPUSMT.h"
+#include "SysFsDataProviderCPUPower.h"
+#include "SysFsDataProviderGPUPower.h"
+#include "DataProviderNvidiaNvml.h"
+#include "SysFsDataProviderIntelMSR.h"
+#include "SysFsDataProviderOther.h"
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace LenovoLegionDaemon {
+
+ProfileStore &ProfileStore::getInstance()
+{
+    static ProfileStore instance;
+    return instance;
+}
+
+ProfileStore::ProfileStore() :
+    m_loaded(false)
+{}
+
+const std::vector<ProfileStore::DataTypeInfo> &ProfileStore::dataTypes()
+{
+    /*
+     * Same order as start-up apply, power profile first because it resets the limits
+     */
+    static const std::vector<DataTypeInfo> dataTypes = {
+        {SysFsDataProviderPowerProfile::dataType, "PowerProfile", &legion::messages::PowerProfile::default_instance(),
+            {{"current_value"},{"custom_fnq_enabled","current_value"}}, false},
+        {SysFsDataProviderCPUPower::dataType,     "CPUPower",     &legion::messages::CPUPower::default_instance(),
+            {{"cpu_tmp_limit","current_value"},{"cpu_clp_limit","current_value"},{"cpu_ltp_limit","current_value"},{"cpu_stp_limit","current_value"},
+             {"cpu_pl1_tau","current_value"},{"gpu_total_onac","current_value"},{"gpu_to_cpu_dynamic_boost","current_value"}}, true},
+        {SysFsDataProviderGPUPower::dataType,     "GPUPower",     &legion::messages::GPUPower::default_instance(),
+            {{"gpu_power_boost","current_value"},{"gpu_configurable_tgp","current_value"},{"gpu_temperature_limit","current_value"}}, true},
+        {SysFsDataProviderFanCurve::dataType,     "FanCurve",     &legion::messages::FanCurve::default_instance(),
+            {{"current_value"}}, true},
+        {SysFsDataProviderFanOption::dataType,    "FanOption",    &legion::messages::FanOption::default_instance(),
+            {{"full_speed","current_value"}}, false},
+        {SysFsDataProviderCPUSMT::dataType,       "CPUSMT",       &legion::messages::CPUSMT::default_instance(),
+            {{"control"}}, false},
+        {SysFsDataProviderCPUOptions::dataType,   "CPUOptions",   &legion::messages::CPUOptions::default_instance(),
+            {{"cpus","cpu_online"},{"cpus","governor"}}, false},
+        {SysFsDataProviderCPUFrequency::dataType, "CPUFrequency", &legion::messages::CPUFrequency::default_instance(),
+            {{"cpus","scaling_min_freq"},{"cpus","scaling_max_freq"}}, false},
+        {SysFsDataProviderIntelMSR::dataType,     "IntelMSR",     &legion::messages::CpuIntelMSR::default_instance(),
+            {{"analogio","offset"},{"cache","offset"},{"cpu","offset"},{"gpu","offset"},{"uncore","offset"}}, false},
+        {DataProviderNvidiaNvml::dataType,        "NvidiaNvml",   &legion::messages::NvidiaNvml::default_instance(),
+            {{"gpu_offset","value"},{"memory_offset","value"}}, false},
+        {SysFsDataProviderOther::dataType,        "Other",        &legion::messages::OtherSettings::default_instance(),
+            {{"touch_pad","current"},{"win_key","current"}}, false}
+    };
+
+    return dataTypes;
+}
+
+legion::messages::Profiles ProfileStore::list()
+{
+    legion::messages::Profiles profiles(this->profiles());
+
+    for(legion::messages::Profile& profile : *profiles.mutable_profiles())
+    {
+        profile.clear_entries();
+    }
+
+    return profiles;
+}
+
+bool ProfileStore::contains(const QString &name)
+{
+    return find(name) != nullptr;
+}
+
+void ProfileStore::saveCurrent(DataProviderManager *dataProviderManager, const QString &name, const QString &description)
+{
+    legion::messages::Profile       profile;
+    legion::messages::PowerProfile  powerProfile;
+
+    LOG_D(QString("ProfileStore::saveCurrent - ") + name);
+
+    profile.set_name(name.toStdString());
+    profile.set_description(description.toStdString());
+
+    for(const DataTypeInfo& info : dataTypes())
+    {
+        QByteArray data = dataProviderManager->getDataProvider(info.m_dataType).serializeAndGetData();
+
+        if(info.m_dataType == SysFsDataProviderPowerProfile::dataType)
+        {
+            powerProfile.ParseFromArray(data.data(),data.size());
+        }
+
+        // Limits and fan curve are firmware values in other power profiles, same check as settings load
+        if(info.m_customOnly && powerProfile.current_value() != legion::messages::PowerProfile_Profiles_POWER_PROFILE_CUSTOM)
+        {
+            LOG_T(QString("ProfileStore::saveCurrent - ") + info.m_name + " skipped, power profile is not CUSTOM");
+            continue;
+        }
+
+        // Fan controller flat curve is not the curve of the profile, same check as settings save
+        if(info.m_dataType == SysFsDataProviderFanCurve::dataType && DaemonSettingsManager::fanControllerRunning(dataProviderManager))
+        {
+            LOG_D(QString("ProfileStore::saveCurrent - ") + info.m_name + " skipped, fan controller is running");
+            continue;
+        }
+
+        if(info.m_dataType == SysFsDataProviderIntelMSR::dataType && !DaemonSettingsManager::roundIntelMSROffsets(data))
+        {
+            LOG_W(QString("ProfileStore::saveCurrent - ") + info.m_name + " invalid data");
+            continue;
+        }
+
+        legion::messages::Profile::Entry* entry = profile.add_entries();
+        entry->set_data_type(info.m_dataType);
+        entry->set_data(std::string(data.constData(),data.size()));
+    }
+
+    store(profile);
+}
+
+void ProfileStore::store(const legion::messages::Profile &profile)
+{
+    legion::messages::Profile* stored = find(QString::fromStdString(std::string(profile.name())));
+
+    LOG_D(QString("ProfileStore::store - ") + QString::fromStdString(std::string(profile.name())) + ", " + QString::number(profile.entries_size()) + " entries");
+
+    if(stored == nullptr)
+    {
+        stored = profiles().add_profiles();
+    }
+
+    *stored = profile;
+
+    commit();
+}
+
+bool ProfileStore::remove(const QString &name)
+{
+    auto* list = profiles().mutable_profiles();
+
+    const auto found = std::find_if(list->begin(),list->end(),[&name](const legion::messages::Profile& profile) {
+        return QString::fromStdString(std::string(profile.name())) == name;
+    });
+
+    if(found == list->end())
+    {
+        return false;
+    }
+
+    list->erase(found);
+
+    if(QString::fromStdString(std::string(profiles().last_applied())) == name)
+    {
+        profiles().clear_last_applied();
+    }
+
+    commit();
+
+    return true;
+}
+
+ProfileStore::ApplyResult ProfileStore::apply(DataProviderManager *dataProviderManager, const QString &name)
+{
+    ApplyResult           result;
+    std::vector<Written>  written;
+
+    const legion::messages::Profile* profile = find(name);
+
+    if(profile == nullptr)
+    {
+        LOG_W(QString("ProfileStore::apply - ") + name + " not found");
+        result.m_status = legion::messages::ProfileCommandResult::NOT_FOUND;
+        return result;
+    }
+
+    LOG_D(QString("ProfileStore::apply - ") + name);
+
+    for(const DataTypeInfo& info : dataTypes())
+    {
+        const auto entry = std::find_if(profile->entries().begin(),profile->entries().end(),[&info](const legion::messages::Profile::Entry& entry) {
+            return entry.data_type() == info.m_dataType;
+        });
+
+        if(entry == profile->entries().end())
+        {
+            continue;
+        }
+
+        std::unique_ptr<google::protobuf::Message> target(info.m_prototype->New());
+        std::unique_ptr<google::protobuf::Message> live(info.m_prototype->New());
+        std::unique_ptr<google::protobuf::Message> restore(info.m_prototype->New());
+
+        try {
+            /*
+             * Running fan controller would overwrite the curve on its next tick, the curve is not written
+             */
+            if(info.m_dataType == SysFsDataProviderFanCurve::dataType && DaemonSettingsManager::fanControllerRunning(dataProviderManager))
+            {
+                LOG_W(QString("ProfileStore::apply - ") + info.m_name + " skipped, fan controller is running");
+                continue;
+            }
+
+            const QByteArray liveData = dataProviderManager->getDataProvider(info.m_dataType).serializeAndGetData();
+
+            if(!target->ParseFromArray(entry->data().data(),entry->data().size()) || !live->ParseFromArray(liveData.data(),liveData.size()))
+            {
+                THROW_EXCEPTION(exception_T,ERROR_CODES::SERIALIZE_ERROR,"Parse of data message error !");
+            }
+
+            if(!delta(info,*live,*target,*restore))
+            {
+                LOG_T(QString("ProfileStore::apply - ") + info.m_name + " unchanged");
+                continue;
+            }
+
+            /*
+             * Rollback is kept before the write, a write failing half way restores this one too
+             */
+            written.push_back({.m_info = &info,.m_rollback = serialize(*restore)});
+
+            dataProviderManager->getDataProvider(info.m_dataType).deserializeAndSetData(serialize(*target));
+
+            result.m_written.push_back(info.m_dataType);
+
+            LOG_D(QString("ProfileStore::apply - ") + info.m_name + " written");
+        }
+        catch(const bj::framework::exception::Exception& ex)
+        {
+            LOG_E(QString("ProfileStore::apply - ") + info.m_name + " failed, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+            result.m_status = rollback(dataProviderManager,written) ? legion::messages::ProfileCommandResult::FAILED_ROLLED_BACK : legion::messages::ProfileCommandResult::FAILED;
+            result.m_written.clear();
+            return result;
+        }
+        catch(...)
+        {
+            LOG_E(QString("ProfileStore::apply - ") + info.m_name + " failed");
+            result.m_status = rollback(dataProviderManager,written) ? legion::messages::ProfileCommandResult::FAILED_ROLLED_BACK : legion::messages::ProfileCommandResult::FAILED;
+            result.m_written.clear();
+            return result;
+        }
+    }
+
+    LOG_D(QString("ProfileStore::apply - %1 applied, %2 of %3 data types written").arg(name).arg(result.m_written.size()).arg(profile->entries_size()));
+
+    profiles().set_last_applied(name.toStdString());
+    commit();
+
+    return result;
+}
+
+legion::messages::Profiles &ProfileStore::profiles()
+{
+    if(!m_loaded)
+    {
+        SettingsStore::Transaction transaction;
+        const QByteArray           data = SettingsStore::getInstance().data(legion::messages::DataType::PROFILES);
+
+        if(!m_profiles.ParseFromArray(data.data(),data.size()))
+        {
+            LOG_W("ProfileStore: stored profiles are invalid, starting without profiles");
+            m_profiles.Clear();
+        }
+
+        m_loaded = true;
+    }
+
+    return m_profiles;
+}
+
+legion::messages::Profile *ProfileStore::find(const QString &name)
+{
+    for(legion::messages::Profile& profile : *profiles().mutable_profiles())
+    {
+        if(QString::fromStdString(std::string(profile.name())) == name)
+        {
+            return &profile;
+        }
+    }
+
+    return nullptr;
+}
+
+void ProfileStore::commit()
+{
+    SettingsStore::Transaction transaction;
+    SettingsStore::getInstance().setData(legion::messages::DataType::PROFILES,serialize(profiles()));
+}
+
+bool ProfileStore::rollback(DataProviderManager *dataProviderManager, const std::vector<Written> &written)
+{
+    bool restored = true;
+
+    /*
+     * Restored in apply order, power profile has to be back before the limits it resets
+     */
+    for(const Written& write : written)
+    {
+        try {
+            dataProviderManager->getDataProvider(write.m_info->m_dataType).deserializeAndSetData(write.m_rollback);
+            LOG_D(QString("ProfileStore::rollback - ") + write.m_info->m_name + " restored");
+        } catch(...) {
+            LOG_E(QString("ProfileStore::rollback - ") + write.m_info->m_name + " restore failed");
+            restored = false;
+        }
+    }
+
+    return restored;
+}
+
+bool ProfileStore::delta(const DataTypeInfo &info, const google::protobuf::Message &live, google::protobuf::Message &target, google::protobuf::Message &rollback)
+{
+    std::vector<const google::protobuf::FieldDescriptor*> changed;
+
+    for(const std::vector<std::string>& path : info.m_writable)
+    {
+        const google::protobuf::FieldDescriptor* field = target.GetDescriptor()->FindFieldByName(path.front());
+
+        if(field != nullptr && std::find(changed.begin(),changed.end(),field) == changed.end() && differs(live,target,path,0))
+        {
+            changed.push_back(field);
+        }
+    }
+
+    /*
+     * Changed fields go whole, data providers write them the way they did for a full message
+     */
+    std::unique_ptr<google::protobuf::Message> write(target.New());
+    std::unique_ptr<google::protobuf::Message> liveCopy(live.New());
+
+    liveCopy->CopyFrom(live);
+
+    write->GetReflection()->SwapFields(&target,write.get(),changed);
+    rollback.Clear();
+    rollback.GetReflection()->SwapFields(liveCopy.get(),&rollback,changed);
+
+    target.GetReflection()->Swap(&target,write.get());
+
+    return !changed.empty();
+}
+
+bool ProfileStore::differs(const google::protobuf::Message &live, const google::protobuf::Message &target, const std::vector<std::string> &path, size_t depth)
+{
+    const google::protobuf::FieldDescriptor* field = target.GetDescriptor()->FindFieldByName(path[depth]);
+
+    if(field == nullptr)
+    {
+        return false;
+    }
+
+    const google::protobuf::Reflection* liveReflection   = live.GetReflection();
+    const google::protobuf::Reflection* targetReflection = target.GetReflection();
+
+    if(depth + 1 == path.size())
+    {
+        // Value not in profile is not written
+        if(!field->is_repeated() && !targetReflection->HasField(target,field))
+        {
+            return false;
+        }
+
+        google::protobuf::util::MessageDifferencer differencer;
+        return !differencer.CompareWithFields(live,target,{field},{field});
+    }
+
+    if(field->is_repeated())
+    {
+        const int size = targetReflection->FieldSize(target,field);
+
+        if(liveReflection->FieldSize(live,field) < size)
+        {
+            return true;
+        }
+
+        for(int i = 0; i < size; ++i)
+        {
+            if(differs(liveReflection->GetRepeatedMessage(live,field,i),targetReflection->GetRepeatedMessage(target,field,i),path,depth + 1))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    if(!targetReflection->HasField(target,field))
+    {
+        return false;
+    }
+
+    return differs(liveReflection->GetMessage(live,field),targetReflection->GetMessage(target,field),path,depth + 1);
+}
+
+QByteArray ProfileStore::serialize(const google::protobuf::Message &message)
+{
+    QByteArray data(static_cast<qsizetype>(message.ByteSizeLong()),Qt::Uninitialized);
+
+    if(!message.SerializeToArray(data.data(),data.size()))
+    {
+        THROW_EXCEPTION(exception_T,ERROR_CODES::SERIALIZE_ERROR,"Serialize of data message error !");
+    }
+
+    return data;
+}
+
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <Core/ExceptionBuilder.h>
+
+#include "../LenovoLegion-PrepareBuild/Profiles.pb.h"
+
+#include <QString>
+
+#include <google/protobuf/message.h>
+
+#include <string>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+class DataProviderManager;
+
+/*
+ * Named profiles, kept in settings store under PROFILES data type
+ *
+ * Profile holds data provider messages in apply order. Apply reads every data provider right before
+ * writing to it, so values changed by earlier writes (power profile resets limits) are seen, and
+ * sends only top level fields whose writable values differ from hardware. When a write fails, the
+ * data providers written so far get back the values read before their writes. Fan curve is neither
+ * saved nor applied while the software fan controller runs, it owns the curve.
+ *
+ * Called on daemon thread only.
+ */
+class ProfileStore
+{
+public:
+    DEFINE_EXCEPTION(ProfileStore);
+
+    enum ERROR_CODES : int {
+        SERIALIZE_ERROR = -1
+    };
+
+    struct ApplyResult {
+        legion::messages::ProfileCommandResult::Status  m_status = legion::messages::ProfileCommandResult::OK;
+        std::vector<quint8>                             m_written;
+    };
+
+public:
+
+    static ProfileStore& getInstance();
+
+    ProfileStore(const ProfileStore&)            = delete;
+    ProfileStore& operator=(const ProfileStore&) = delete;
+
+    /*
+     * Profiles without entries
+     */
+    legion::messages::Profiles  list();
+
+    bool                        contains(const QString& name);
+
+    void                        saveCurrent(DataProviderManager* dataProviderManager,const QString& name,const QString& description);
+    void                        store(const legion::messages::Profile& profile);
+    bool                        remove(const QString& name);
+
+    ApplyResult                 apply(DataProviderManager* dataProviderManager,const QString& name);
+
+private:
+
+    /*
+     * Data type a profile carries, in apply order
+     */
+    struct DataTypeInfo {
+        quint8                                  m_dataType;
+        const char*                             m_name;
+        const google::protobuf::Message*        m_prototype;
+        std::vector<std::vector<std::string>>   m_writable;     // Field paths data provider writes
+        bool                                    m_customOnly;   // Saved only in CUSTOM power profile
+    };
+
+    struct Written {
+        const DataTypeInfo*                     m_info;
+        QByteArray                              m_rollback;
+    };
+
+private:
+
+    ProfileStore();
+    ~ProfileStore() = default;
+
+    static const std::vector<DataTypeInfo>& dataTypes();
+
+    legion::messages::Profiles& profiles();
+    legion::messages::Profile*  find(const QString& name);
+    void                        commit();
+
+    bool                        rollback(DataProviderManager* dataProviderManager,const std::vector<Written>& written);
+
+    /*
+     * Keeps top level fields of target with a writable value different from live, rollback gets live values of them
+     */
+    static bool                 delta(const DataTypeInfo& info,const google::protobuf::Message& live,google::protobuf::Message& target,google::protobuf::Message& rollback);
+    static bool                 differs(const google::protobuf::Message& live,const google::protobuf::Message& target,const std::vector<std::string>& path,size_t depth);
+
+    static QByteArray           serialize(const google::protobuf::Message& message);
+
+private:
+
+    legion::messages::Profiles  m_profiles;
+    bool                        m_loaded;
+};
+
+}
@@ -14,13 +14,28 @@
 
 #include <QCoreApplication>
 
+#include <sys/socket.h>
+
 
 namespace LenovoLegionDaemon {
 
 ProtocolProcessor::ProtocolProcessor(DataProviderManager* dataProviderManager,QLocalSocket* clientSocket,QObject* parent) :
     ProtocolProcessorBase(clientSocket,parent),
-    m_dataProviderManager(dataProviderManager)
-{}
+    m_dataProviderManager(dataProviderManager),
+    m_clientUid(DataProvider::NO_CLIENT)
+{
+    struct ucred credentials;
+    socklen_t    length = sizeof(credentials);
+
+    if(::getsockopt(clientSocket->socketDescriptor(),SOL_SOCKET,SO_PEERCRED,&credentials,&length) == 0)
+    {
+        m_clientUid = credentials.uid;
+    }
+    else
+    {
+        LOG_W("ProtocolProcessor: Peer credentials of client are not available !");
+    }
+}
 
 ProtocolProcessor::~ProtocolProcessor()
 {
@@ -101,7 +116,7 @@ void ProtocolProcessor::readyReadHandler()
         }
             break;
         case MessageHeader::SET_DATA_REQUEST: {
-            QByteArray reponse = m_dataProviderManager->getDataProvider(header.m_dataType).deserializeAndSetData(data);
+            QByteArray reponse = m_dataProviderManager->getDataProvider(header.m_dataType).deserializeAndSetData(data,m_clientUid);
             m_clientSocket->write(
                 ProtocolParser::parseMessage(
                     MessageHeader {
@@ -15,6 +15,8 @@
 #include <QLocalSocket>
 #include <QFileSystemWatcher>
 
+#include <sys/types.h>
+
 
 namespace LenovoLegionDaemon {
 
@@ -44,6 +46,11 @@ private:
 private:
 
     DataProviderManager*     m_dataProviderManager;
+
+    /*
+     * Peer credentials of client socket
+     */
+    uid_t                    m_clientUid;
 };
 
 }
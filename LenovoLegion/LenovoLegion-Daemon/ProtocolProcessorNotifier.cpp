@@ -8,6 +8,7 @@
 #include "ProtocolProcessorNotifier.h"
 #include "ProtocolParser.h"
 #include "SysFsDriverManager.h"
+#include "NotificationRouter.h"
 
 #include <Core/LoggerHolder.h>
 
@@ -19,8 +20,6 @@
 #include "SysFSDriverLegionIntelMSR.h"
 #include "SysFSDriverLegionFanMode.h"
 
-#include "../LenovoLegion-PrepareBuild/Notification.pb.h"
-
 #include <QCoreApplication>
 
 namespace LenovoLegionDaemon {
@@ -70,8 +69,9 @@ void ProtocolProcessorNotifier::disconnectedHandler()
 
 void ProtocolProcessorNotifier::kernelEventHandler(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent &event)
 {
-    LOG_T("ProtocolProcessorNotifier: kernelEventHandler m_driverName=" + event.m_driverName + ", event.m_action=" + QString::number(static_cast<int>(event.m_action)) + ", m_DriverSpecificAction=" + QString(event.m_DriverSpecificEventType.data()) + ", m_DriverSpecificValue=" + event.m_DriverSpecificEventValue.data());
-
+    /*
+     * Hot path, event is routed by table lookup without any string work
+     */
     if(!isRunning())
     {
         LOG_T("ProtocolProcessorNotifier is not running, ignoring kernel event !");
@@ -80,108 +80,31 @@ void ProtocolProcessorNotifier::kernelEventHandler(const LenovoLegionDaemon::Sys
 
     legion::messages::Notification msg;
 
-    if(event.m_driverName == SysFsDriverPowerSuplyBattery0::DRIVER_NAME)
+    if(NotificationRouter::route(event,msg))
     {
-        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
-        {
-            msg.set_action(legion::messages::Notification::POWER_SUPPLY_BATTERY0_CHANGE);
-        }
-    }
+        sendNotification(msg);
 
-    if(event.m_driverName == SysFsDriverCPUXList::DRIVER_NAME)
-    {
-        if(event.m_action == SysFsDriver::SubsystemEvent::Action::RELOADED)
-        {
-            msg.set_action(legion::messages::Notification::CPU_X_LIST_RELOADED);
-        }
+        LOG_D("ProtocolProcessorNotifier: Notification sent !");
     }
+}
 
-    if(event.m_driverName == SysFsDriverLegionEvents::DRIVER_NAME)
-    {
-        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
-        {
-            if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LEGION_WMI_EVENT_KEYLOCK_STATUS)
-            {
-                msg.set_action(legion::messages::Notification::KEYLOCK_STATUS_CHANGE);
-                msg.set_key_lock_key(static_cast<legion::messages::Notification_KeylockDisabledBit>(QString(event.m_DriverSpecificEventValue.data()).toUInt()));
-            }
-
-            if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LENOVO_WMI_EVENT_UTILITY)
-            {
-                msg.set_action(legion::messages::Notification::SPECIAL_KEY_PRESSED);
-                msg.set_special_key(static_cast<legion::messages::Notification_SpecialKey>(QString(event.m_DriverSpecificEventValue.data()).toUInt()));
-            }
-
-            if(static_cast<SysFsDriverLegionEvents::LegionVmiEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionEvents::LegionVmiEventType::LEGION_WMI_EVENT_THERMAL_MODE)
-            {
-                msg.set_action(legion::messages::Notification::THERMAL_MODE_CHANGE);
-            }
-        }
-    }
+void ProtocolProcessorNotifier::sendNotification(const legion::messages::Notification &msg)
+{
+    QByteArray data;
 
-    if(event.m_driverName == SysFsDriverLegionOther::DRIVER_NAME)
-    {
-        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
-        {
-            if(static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_STP    ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_LTP    ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_PP     ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_TMP    ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_CLP    ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_CPU_PL1_TAU||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_APU_PPT    ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_PB     ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_TAC    ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_TGP    ||
-               static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_GPU_TMP)
-            {
-
-                msg.set_action(legion::messages::Notification::POWER_CONTROL_CHANGED);
-            }
-
-            if(static_cast<SysFsDriverLegionOther::LegionVmiOtherEventType>(QString(event.m_DriverSpecificEventType.data()).toInt()) == SysFsDriverLegionOther::LegionVmiOtherEventType::LENOVO_WMI_OTHER_FF_S)
-            {
-                msg.set_action(legion::messages::Notification::FAN_CURVE_CHANGED);
-            }
-        }
-    }
+    data.resize(msg.ByteSizeLong());
 
-    if(event.m_driverName == SysFSDriverLegionIntelMSR::DRIVER_NAME)
+    if(!msg.SerializeToArray(data.data(),data.size()))
     {
-        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
-        {
-            msg.set_action(legion::messages::Notification::CPU_OFFSET_CHANGED);
-        }
+        THROW_EXCEPTION(exception_T,ERROR_CODES::SERIALIZE_ERROR,"Serialize of data message error !");
     }
 
-    if(event.m_driverName == SysFSDriverLegionFanMode::DRIVER_NAME)
-    {
-        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
-        {
-            msg.set_action(legion::messages::Notification::FAN_CURVE_CHANGED);
-        }
-    }
-
-    if(msg.has_action())
-    {
-        QByteArray data;
-
-        data.resize(msg.ByteSizeLong());
-
-        if(!msg.SerializeToArray(data.data(),data.size()))
-        {
-            THROW_EXCEPTION(exception_T,ERROR_CODES::SERIALIZE_ERROR,"Serialize of data message error !");
-        }
-
 
-        m_clientSocket->write(ProtocolParser::parseMessage(MessageHeader{
-            .m_type         = MessageHeader::NOTIFICATION,
-            .m_dataType     = m_dataType,
-            .m_dataLength   = data.length()
-        },data));
-
-        LOG_D("ProtocolProcessorNotifier: Notification sent !");
-    }
+    m_clientSocket->write(ProtocolParser::parseMessage(MessageHeader{
+        .m_type         = MessageHeader::NOTIFICATION,
+        .m_dataType     = m_dataType,
+        .m_dataLength   = data.length()
+    },data));
 }
 
 void ProtocolProcessorNotifier::moduleSubsystemHandler(const LenovoLegionDaemon::SysFsDriverManager::ModuleSubsystemEvent &event)
@@ -213,21 +136,26 @@ void ProtocolProcessorNotifier::moduleSubsystemHandler(const LenovoLegionDaemon:
 
     if(msg.has_action())
     {
-        QByteArray data;
+        sendNotification(msg);
+    }
+}
 
-        data.resize(msg.ByteSizeLong());
+void ProtocolProcessorNotifier::ledStateChangedHandler(const LenovoLegionDaemon::RGBLedStateCache::Diff &diff)
+{
+    if(!isRunning())
+    {
+        LOG_T("ProtocolProcessorNotifier is not running, ignoring LED state change !");
+        return;
+    }
 
-        if(!msg.SerializeToArray(data.data(),data.size()))
-        {
-            THROW_EXCEPTION(exception_T,ERROR_CODES::SERIALIZE_ERROR,"Serialize of data message error !");
-        }
+    legion::messages::Notification msg;
 
+    msg.set_action(legion::messages::Notification::RGB_LED_STATE_CHANGED);
+    msg.mutable_led_state()->set_version(diff.m_version);
+    msg.mutable_led_state()->set_full(diff.m_full);
+    msg.mutable_led_state()->mutable_indexes()->Add(diff.m_indexes.begin(),diff.m_indexes.end());
+    msg.mutable_led_state()->mutable_colors()->Add(diff.m_colors.begin(),diff.m_colors.end());
 
-        m_clientSocket->write(ProtocolParser::parseMessage(MessageHeader{
-                                                               .m_type         = MessageHeader::NOTIFICATION,
-                                                               .m_dataType     = m_dataType,
-                                                               .m_dataLength   = data.length()
-                                                           },data));
-    }
+    sendNotification(msg);
 }
 }
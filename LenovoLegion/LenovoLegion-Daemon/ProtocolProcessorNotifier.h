@@ -12,7 +12,9 @@
 #include "DataProviderManager.h"
 
 #include "ProtocolProcessorBase.h"
+#include "RGBLedStateCache.h"
 
+#include "../LenovoLegion-PrepareBuild/Notification.pb.h"
 
 
 namespace LenovoLegionDaemon {
@@ -40,6 +42,10 @@ public:
     virtual void stop()  override;
     virtual void start() override;
 
+private:
+
+    void sendNotification(const legion::messages::Notification& msg);
+
 private:
 
     virtual void readyReadHandler() override;
@@ -53,6 +59,7 @@ public slots:
 
     void kernelEventHandler(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent& event);
     void moduleSubsystemHandler(const LenovoLegionDaemon::SysFsDriverManager::ModuleSubsystemEvent& event);
+    void ledStateChangedHandler(const LenovoLegionDaemon::RGBLedStateCache::Diff& diff);
 public:
 
     static constexpr quint8  m_dataType = 0;
@@ -0,0 +1,381 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "RGBAudioSource.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace LenovoLegionDaemon {
+
+namespace {
+
+constexpr quint16 WAVE_FORMAT_PCM        = 0x0001;
+constexpr quint16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+/*
+ * PCM format chunk has 16 bytes, extensible 40
+ */
+constexpr quint32 WAVE_FORMAT_MIN_SIZE   = 16;
+constexpr quint32 WAVE_FORMAT_MAX_SIZE   = 64;
+
+quint16 le16(const uint8_t* data)
+{
+    return static_cast<quint16>(data[0] | data[1] << 8);
+}
+
+quint32 le32(const uint8_t* data)
+{
+    return static_cast<quint32>(data[0]) | static_cast<quint32>(data[1]) << 8 | static_cast<quint32>(data[2]) << 16 | static_cast<quint32>(data[3]) << 24;
+}
+
+bool readExactly(int fd,uint8_t* data,size_t length)
+{
+    while(length > 0)
+    {
+        const ssize_t count = ::read(fd,data,length);
+
+        if(count <= 0)
+        {
+            if(count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+
+        data   += count;
+        length -= static_cast<size_t>(count);
+    }
+
+    return true;
+}
+
+}
+
+RGBAudioSource::RGBAudioSource(const std::filesystem::path &path, const Format &raw, std::optional<uid_t> client) :
+    m_fd(-1),
+    m_paced(false),
+    m_format(raw),
+    m_pending(0),
+    m_frames(0)
+{
+    struct stat info;
+
+    if(client)
+    {
+        m_fd = openClientFIFO(path,*client);
+    }
+    else if(::stat(path.c_str(),&info) != 0)
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::OPEN_ERROR, "Audio source " + path.string() + " not found !");
+    }
+    /*
+     * Nothing else than FIFO and file, device nodes could block or have side effects on read
+     */
+    else if(S_ISFIFO(info.st_mode))
+    {
+        m_fd = ::open(path.c_str(),O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    }
+    else if(S_ISREG(info.st_mode))
+    {
+        m_fd     = ::open(path.c_str(),O_RDONLY | O_CLOEXEC);
+        m_paced  = true;
+    }
+    else
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::OPEN_ERROR, "Audio source " + path.string() + " is not FIFO or file !");
+    }
+
+    if(m_fd < 0)
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::OPEN_ERROR, "Unable to open audio source " + path.string() + ", " + std::strerror(errno) + " !");
+    }
+
+    try {
+        if(m_paced)
+        {
+            readWavHeader();
+        }
+
+        if(m_format.m_sampleRate == 0 || m_format.m_channels == 0)
+        {
+            THROW_EXCEPTION(exception_T, ERROR_CODES::FORMAT_ERROR, "Audio source " + path.string() + " has invalid format !");
+        }
+    } catch(...)
+    {
+        ::close(m_fd);
+        throw;
+    }
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + QString(" - Audio source %1, %2 Hz, %3 channels%4").arg(path.c_str()).arg(m_format.m_sampleRate).arg(m_format.m_channels).arg(m_dataBytes ? ", WAV" : ""));
+}
+
+RGBAudioSource::~RGBAudioSource()
+{
+    ::close(m_fd);
+}
+
+const RGBAudioSource::Format &RGBAudioSource::format() const
+{
+    return m_format;
+}
+
+std::optional<size_t> RGBAudioSource::read(float *mono, size_t frames)
+{
+    const size_t frameBytes = this->frameBytes();
+    size_t       wanted     = frames * frameBytes - m_pending;
+
+    if(m_dataBytes)
+    {
+        wanted = std::min<quint64>(wanted,*m_dataBytes);
+
+        if(wanted == 0)
+        {
+            return std::nullopt;
+        }
+    }
+
+    if(!m_paced)
+    {
+        pollfd pfd { m_fd, POLLIN, 0 };
+
+        const int ret = ::poll(&pfd,1,POLL_TIMEOUT.count());
+
+        if(ret == 0 || (ret < 0 && errno == EINTR))
+        {
+            return 0;
+        }
+
+        if(ret < 0)
+        {
+            return std::nullopt;
+        }
+    }
+
+    m_buffer.resize(m_pending + wanted);
+
+    const ssize_t count = ::read(m_fd,m_buffer.data() + m_pending,wanted);
+
+    if(count < 0)
+    {
+        return errno == EAGAIN || errno == EINTR ? std::optional<size_t>(0) : std::nullopt;
+    }
+
+    if(count == 0)
+    {
+        return std::nullopt;        // End of file, FIFO is held open by us
+    }
+
+    if(m_dataBytes)
+    {
+        *m_dataBytes -= static_cast<quint64>(count);
+    }
+
+    const size_t total    = m_pending + static_cast<size_t>(count);
+    const size_t complete = total / frameBytes;
+
+    for(size_t frame = 0; frame < complete; ++frame)
+    {
+        const uint8_t* data = m_buffer.data() + frame * frameBytes;
+        int            sum  = 0;
+
+        for(quint16 channel = 0; channel < m_format.m_channels; ++channel)
+        {
+            sum += static_cast<int16_t>(le16(data + channel * sizeof(int16_t)));
+        }
+
+        mono[frame] = static_cast<float>(sum) / (32768.0F * m_format.m_channels);
+    }
+
+    m_pending = total - complete * frameBytes;
+    std::memmove(m_buffer.data(),m_buffer.data() + complete * frameBytes,m_pending);
+
+    /*
+     * File is played as if it was captured now
+     */
+    if(m_paced)
+    {
+        if(!m_start)
+        {
+            m_start = Clock::now();
+        }
+
+        std::this_thread::sleep_until(*m_start + std::chrono::nanoseconds((m_frames + complete) * 1000000000ULL / m_format.m_sampleRate));
+    }
+
+    m_frames += complete;
+
+    return complete;
+}
+
+size_t RGBAudioSource::backlog() const
+{
+    int bytes = 0;
+
+    if(m_paced || ::ioctl(m_fd,FIONREAD,&bytes) != 0)
+    {
+        return 0;
+    }
+
+    return static_cast<size_t>(bytes) / frameBytes();
+}
+
+void RGBAudioSource::skip(size_t frames)
+{
+    std::vector<uint8_t> discard(std::min<size_t>(frames,4096) * frameBytes());
+    size_t               bytes = frames * frameBytes();
+
+    while(bytes > 0)
+    {
+        const ssize_t count = ::read(m_fd,discard.data(),std::min(bytes,discard.size()));
+
+        if(count <= 0)
+        {
+            break;
+        }
+
+        bytes -= static_cast<size_t>(count);
+    }
+}
+
+int RGBAudioSource::openClientFIFO(const std::filesystem::path &path, uid_t client)
+{
+    const std::filesystem::path directory = std::filesystem::path(RUNTIME_DIRECTORY) / std::to_string(client);
+    std::error_code             error;
+    struct stat                 info;
+
+    /*
+     * Runtime directory of the client, FIFO has to be inside after symlinks of directories are resolved
+     */
+    const std::filesystem::path parent = std::filesystem::canonical(path.parent_path(),error);
+
+    if(error || path.filename().empty() || path.filename() == "." || path.filename() == "..")
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::OPEN_ERROR, "Audio source " + path.string() + " not found !");
+    }
+
+    if(std::mismatch(directory.begin(),directory.end(),parent.begin(),parent.end()).first != directory.end() || ::lstat(directory.c_str(),&info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != client)
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::ACCESS_ERROR, "Audio source " + path.string() + " is not in runtime directory of client !");
+    }
+
+    /*
+     * Opened as path only and checked, so it can not be replaced before it is opened for reading and other file types are never opened
+     */
+    const int fd = ::open((parent / path.filename()).c_str(),O_PATH | O_NOFOLLOW | O_CLOEXEC);
+
+    if(fd < 0)
+    {
+        return fd;
+    }
+
+    if(::fstat(fd,&info) != 0 || !S_ISFIFO(info.st_mode) || info.st_uid != client)
+    {
+        ::close(fd);
+        THROW_EXCEPTION(exception_T, ERROR_CODES::ACCESS_ERROR, "Audio source " + path.string() + " is not FIFO of client !");
+    }
+
+    const int fifo = ::open(("/proc/self/fd/" + std::to_string(fd)).c_str(),O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    const int code = errno;
+
+    ::close(fd);
+    errno = code;
+
+    return fifo;
+}
+
+void RGBAudioSource::readWavHeader()
+{
+    uint8_t riff[12];
+
+    if(!readExactly(m_fd,riff,sizeof(riff)) || std::memcmp(riff,"RIFF",4) != 0 || std::memcmp(riff + 8,"WAVE",4) != 0)
+    {
+        /*
+         * Raw samples
+         */
+        ::lseek(m_fd,0,SEEK_SET);
+        return;
+    }
+
+    bool hasFormat = false;
+
+    for(;;)
+    {
+        uint8_t chunk[8];
+
+        if(!readExactly(m_fd,chunk,sizeof(chunk)))
+        {
+            THROW_EXCEPTION(exception_T, ERROR_CODES::FORMAT_ERROR, "WAV file without data chunk !");
+        }
+
+        const quint32 size = le32(chunk + 4);
+
+        if(std::memcmp(chunk,"fmt ",4) == 0)
+        {
+            if(size < WAVE_FORMAT_MIN_SIZE || size > WAVE_FORMAT_MAX_SIZE)
+            {
+                THROW_EXCEPTION(exception_T, ERROR_CODES::FORMAT_ERROR, "WAV file with invalid format chunk !");
+            }
+
+            std::vector<uint8_t> fmt(size);
+
+            if(!readExactly(m_fd,fmt.data(),fmt.size()))
+            {
+                THROW_EXCEPTION(exception_T, ERROR_CODES::FORMAT_ERROR, "WAV file with invalid format chunk !");
+            }
+
+            const quint16 format = le16(fmt.data());
+            const quint16 bits   = le16(fmt.data() + 14);
+
+            if((format != WAVE_FORMAT_PCM && format != WAVE_FORMAT_EXTENSIBLE) || bits != 16)
+            {
+                THROW_EXCEPTION(exception_T, ERROR_CODES::FORMAT_ERROR, "Only 16 bit PCM WAV files are supported !");
+            }
+
+            m_format.m_channels   = le16(fmt.data() + 2);
+            m_format.m_sampleRate = le32(fmt.data() + 4);
+            hasFormat             = true;
+
+            if(size % 2 != 0)
+            {
+                ::lseek(m_fd,1,SEEK_CUR);
+            }
+        }
+        else if(std::memcmp(chunk,"data",4) == 0)
+        {
+            if(!hasFormat)
+            {
+                THROW_EXCEPTION(exception_T, ERROR_CODES::FORMAT_ERROR, "WAV file without format chunk !");
+            }
+
+            m_dataBytes = size;
+            return;
+        }
+        else
+        {
+            ::lseek(m_fd,size + size % 2,SEEK_CUR);
+        }
+    }
+}
+
+size_t RGBAudioSource::frameBytes() const
+{
+    return m_format.m_channels * sizeof(int16_t);
+}
+
+}
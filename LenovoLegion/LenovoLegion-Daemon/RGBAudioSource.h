@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <Core/ExceptionBuilder.h>
+
+#include <QtGlobal>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Signed 16 bit PCM read from WAV file or FIFO, downmixed to mono
+ *
+ * Capture from sound server is left to its own tools writing into FIFO, for example
+ * "parec -d <sink>.monitor --format=s16le --rate=48000 --channels=2 > fifo". FIFO carries
+ * raw samples in given format and is opened for writing too, so writer can come and go.
+ * Regular file is WAV or raw and is played in real time, it is meant for testing.
+ * Source of a client is FIFO owned by the client in its runtime directory only.
+ */
+class RGBAudioSource
+{
+public:
+
+    DEFINE_EXCEPTION(RGBAudioSource);
+
+    enum ERROR_CODES : int {
+        OPEN_ERROR   = -1,
+        FORMAT_ERROR = -2,
+        ACCESS_ERROR = -3
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds  POLL_TIMEOUT    {100};
+    static constexpr const char*                RUNTIME_DIRECTORY = "/run/user";
+
+    struct Format {
+        quint32 m_sampleRate = 48000;
+        quint16 m_channels   = 2;
+    };
+
+public:
+
+    /*
+     * Raw format is used unless file has WAV header, with client only its FIFO in RUNTIME_DIRECTORY/<uid> is accepted
+     */
+    RGBAudioSource(const std::filesystem::path& path,const Format& raw,std::optional<uid_t> client = std::nullopt);
+    ~RGBAudioSource();
+
+    RGBAudioSource(const RGBAudioSource&)            = delete;
+    RGBAudioSource& operator=(const RGBAudioSource&) = delete;
+
+    const Format&           format()  const;
+
+    /*
+     * Waits at most POLL_TIMEOUT, 0 frames on timeout, nothing at end of file
+     */
+    std::optional<size_t>   read(float* mono,size_t frames);
+
+    /*
+     * Frames already waiting in FIFO, always 0 for file
+     */
+    size_t                  backlog() const;
+    void                    skip(size_t frames);
+
+private:
+
+    /*
+     * Checks path and opens FIFO without following symlink, FIFO is checked on opened file
+     */
+    static int              openClientFIFO(const std::filesystem::path& path,uid_t client);
+
+    void                    readWavHeader();
+
+    size_t                  frameBytes() const;
+
+private:
+
+    int                         m_fd;
+    bool                        m_paced;            // Regular file, read no faster than sample rate
+    Format                      m_format;
+    std::optional<quint64>      m_dataBytes;        // Left in WAV data chunk
+
+    std::vector<uint8_t>        m_buffer;
+    size_t                      m_pending;          // Bytes of incomplete frame at buffer start
+
+    std::optional<Clock::time_point> m_start;
+    quint64                     m_frames;
+};
+
+}
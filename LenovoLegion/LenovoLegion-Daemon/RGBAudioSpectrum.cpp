@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "RGBAudioSpectrum.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace LenovoLegionDaemon {
+
+RGBAudioSpectrum::RGBAudioSpectrum(std::unique_ptr<RGBAudioSource> source) :
+    m_source(std::move(source)),
+    m_samples(WINDOW,0.0F),
+    m_hann(WINDOW),
+    m_twiddles(WINDOW / 2),
+    m_bins(WINDOW),
+    m_levels{},
+    m_release(static_cast<float>(std::exp(-static_cast<double>(HOP) / m_source->format().m_sampleRate / std::chrono::duration<double>(RELEASE).count()))),
+    m_stop(false)
+{
+    const double rate = m_source->format().m_sampleRate;
+
+    for(size_t i = 0; i < WINDOW; ++i)
+    {
+        m_hann[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * i / (WINDOW - 1)));
+    }
+
+    for(size_t i = 0; i < WINDOW / 2; ++i)
+    {
+        m_twiddles[i] = std::polar(1.0F,static_cast<float>(-2.0 * std::numbers::pi * i / WINDOW));
+    }
+
+    /*
+     * Logarithmic bands, every band has at least one bin
+     */
+    const double maxFrequency = std::min(MAX_FREQUENCY,rate / 2.0);
+
+    for(size_t band = 0; band < BANDS; ++band)
+    {
+        const double low   = MIN_FREQUENCY * std::pow(maxFrequency / MIN_FREQUENCY,static_cast<double>(band) / BANDS);
+        const double high  = MIN_FREQUENCY * std::pow(maxFrequency / MIN_FREQUENCY,static_cast<double>(band + 1) / BANDS);
+        const size_t first = std::min(WINDOW / 2 - 1,static_cast<size_t>(low * WINDOW / rate));
+        const size_t last  = std::clamp(static_cast<size_t>(std::ceil(high * WINDOW / rate)),first + 1,WINDOW / 2);
+
+        m_bands.emplace_back(first,last);
+    }
+
+    m_thread = std::thread(&RGBAudioSpectrum::run,this);
+}
+
+RGBAudioSpectrum::~RGBAudioSpectrum()
+{
+    m_stop = true;
+    m_thread.join();
+}
+
+RGBAudioSpectrum::Snapshot RGBAudioSpectrum::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_snapshot;
+}
+
+void RGBAudioSpectrum::run()
+{
+    std::vector<float> block(HOP);
+    size_t             filled  = 0;
+
+    while(!m_stop)
+    {
+        /*
+         * Reader fell behind, keep only newest samples
+         */
+        const size_t backlog = m_source->backlog();
+
+        if(backlog > MAX_BACKLOG)
+        {
+            m_source->skip(backlog - HOP);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_snapshot.m_dropped += backlog - HOP;
+        }
+
+        const std::optional<size_t> count = m_source->read(block.data() + filled,HOP - filled);
+
+        if(!count)
+        {
+            LOG_D(QString(__PRETTY_FUNCTION__) + " - End of audio source");
+            break;
+        }
+
+        filled += *count;
+
+        if(filled < HOP)
+        {
+            continue;
+        }
+
+        filled = 0;
+
+        std::move(m_samples.begin() + HOP,m_samples.end(),m_samples.begin());
+        std::copy(block.begin(),block.end(),m_samples.end() - HOP);
+
+        analyze(Clock::now());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot.m_levels.fill(0.0F);
+    m_snapshot.m_ended = true;
+}
+
+void RGBAudioSpectrum::analyze(Clock::time_point captured)
+{
+    for(size_t i = 0; i < WINDOW; ++i)
+    {
+        m_bins[i] = m_samples[i] * m_hann[i];
+    }
+
+    fft(m_bins,m_twiddles);
+
+    /*
+     * Peak amplitude in band, Hann window halves amplitude of sine
+     */
+    constexpr float SCALE = 4.0F / WINDOW;
+
+    for(size_t band = 0; band < BANDS; ++band)
+    {
+        float amplitude = 0.0F;
+
+        for(size_t bin = m_bands[band].first; bin < m_bands[band].second; ++bin)
+        {
+            amplitude = std::max(amplitude,std::abs(m_bins[bin]) * SCALE);
+        }
+
+        const float level = amplitude > 0.0F ? std::clamp(static_cast<float>(1.0 - 20.0 * std::log10(amplitude) / FLOOR_DB),0.0F,1.0F) : 0.0F;
+
+        m_levels[band] = std::max(level,m_levels[band] * m_release);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_snapshot.m_levels   = m_levels;
+    m_snapshot.m_captured = captured;
+    ++m_snapshot.m_blocks;
+}
+
+void RGBAudioSpectrum::fft(std::vector<std::complex<float>> &data, const std::vector<std::complex<float>> &twiddles)
+{
+    const size_t size = data.size();
+
+    for(size_t i = 1, j = 0; i < size; ++i)
+    {
+        size_t bit = size >> 1;
+
+        for(; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if(i < j)
+        {
+            std::swap(data[i],data[j]);
+        }
+    }
+
+    for(size_t length = 2; length <= size; length <<= 1)
+    {
+        const size_t step = size / length;
+
+        for(size_t i = 0; i < size; i += length)
+        {
+            for(size_t j = 0; j < length / 2; ++j)
+            {
+                const std::complex<float> even = data[i + j];
+                const std::complex<float> odd  = data[i + j + length / 2] * twiddles[j * step];
+
+                data[i + j]              = even + odd;
+                data[i + j + length / 2] = even - odd;
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBAudioSource.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Spectrum of audio source in logarithmic bands, analyzed on its own thread
+ *
+ * Every HOP frames the last WINDOW frames are transformed, so levels are at most one hop
+ * behind the source. Samples waiting in FIFO over MAX_BACKLOG are dropped, analysis which
+ * does not keep up never drifts behind real time.
+ */
+class RGBAudioSpectrum
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t                     WINDOW          = 1024;     // Power of two
+    static constexpr size_t                     HOP             = 256;
+    static constexpr size_t                     BANDS           = 32;
+    static constexpr size_t                     MAX_BACKLOG     = 2 * WINDOW;
+
+    static constexpr double                     MIN_FREQUENCY   = 40.0;
+    static constexpr double                     MAX_FREQUENCY   = 16000.0;
+    static constexpr double                     FLOOR_DB        = -60.0;    // Level 0, full scale sine is level 1
+
+    static constexpr std::chrono::milliseconds  RELEASE         {150};      // Falling level time constant
+
+    struct Snapshot {
+        std::array<float,BANDS> m_levels        {};     // 0 - 1, lowest frequency first
+        Clock::time_point       m_captured;             // Last sample of analyzed block was read
+        quint64                 m_blocks        = 0;
+        quint64                 m_dropped       = 0;    // Frames skipped to keep up
+        bool                    m_ended         = false;
+    };
+
+public:
+
+    explicit RGBAudioSpectrum(std::unique_ptr<RGBAudioSource> source);
+    ~RGBAudioSpectrum();
+
+    RGBAudioSpectrum(const RGBAudioSpectrum&)            = delete;
+    RGBAudioSpectrum& operator=(const RGBAudioSpectrum&) = delete;
+
+    Snapshot snapshot() const;
+
+private:
+
+    void run();
+
+    void analyze(Clock::time_point captured);
+
+    /*
+     * In place radix 2, twiddles has size / 2 entries
+     */
+    static void fft(std::vector<std::complex<float>>& data,const std::vector<std::complex<float>>& twiddles);
+
+private:
+
+    const std::unique_ptr<RGBAudioSource>   m_source;
+
+    std::vector<float>                      m_samples;      // Last WINDOW frames
+    std::vector<float>                      m_hann;
+    std::vector<std::complex<float>>        m_twiddles;
+    std::vector<std::complex<float>>        m_bins;
+    std::vector<std::pair<size_t,size_t>>   m_bands;        // Bin range of band
+    std::array<float,BANDS>                 m_levels;
+    float                                   m_release;      // Level multiplier per hop
+
+    std::atomic<bool>                       m_stop;
+    std::thread                             m_thread;
+
+    mutable std::mutex                      m_mutex;
+    Snapshot                                m_snapshot;
+};
+
+}
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Feature report transport of HID device
+ *
+ * Return values follow hidapi, number of bytes transferred or -1 on error with
+ * description available from error().
+ */
+class HIDTransport
+{
+public:
+
+    virtual ~HIDTransport() = default;
+
+    virtual int                         sendFeatureReport(const uint8_t* data,size_t length) = 0;
+
+    /*
+     * First byte of data is report ID on input
+     */
+    virtual int                         getFeatureReport(uint8_t* data,size_t length)        = 0;
+
+    virtual std::optional<std::string>  getManufacturerString() = 0;
+    virtual std::optional<std::string>  getProductString()      = 0;
+    virtual std::optional<std::string>  getSerialNumberString() = 0;
+
+    virtual std::string                 error()                 = 0;
+};
+
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "HIDTransportHidApi.h"
+
+#include "StringUtils.h"
+
+#ifndef HID_MAX_STR
+#define HID_MAX_STR                255
+#endif
+
+namespace LenovoLegionDaemon {
+
+HIDTransportHidApi::HIDTransportHidApi(hid_device *dev) :
+    m_dev(dev)
+{}
+
+HIDTransportHidApi::~HIDTransportHidApi()
+{
+    hid_close(m_dev);
+}
+
+int HIDTransportHidApi::sendFeatureReport(const uint8_t *data, size_t length)
+{
+    return hid_send_feature_report(m_dev,data,length);
+}
+
+int HIDTransportHidApi::getFeatureReport(uint8_t *data, size_t length)
+{
+    return hid_get_feature_report(m_dev,data,length);
+}
+
+std::optional<std::string> HIDTransportHidApi::getManufacturerString()
+{
+    wchar_t string[HID_MAX_STR + 1] = {0};
+
+    if(hid_get_manufacturer_string(m_dev, string, HID_MAX_STR))
+    {
+        return std::nullopt;
+    }
+
+    return StringUtils::wstring_to_string(string);
+}
+
+std::optional<std::string> HIDTransportHidApi::getProductString()
+{
+    wchar_t string[HID_MAX_STR + 1] = {0};
+
+    if(hid_get_product_string(m_dev, string, HID_MAX_STR))
+    {
+        return std::nullopt;
+    }
+
+    return StringUtils::wstring_to_string(string);
+}
+
+std::optional<std::string> HIDTransportHidApi::getSerialNumberString()
+{
+    wchar_t string[HID_MAX_STR + 1] = {0};
+
+    if(hid_get_serial_number_string(m_dev, string, HID_MAX_STR))
+    {
+        return std::nullopt;
+    }
+
+    return StringUtils::wstring_to_string(string);
+}
+
+std::string HIDTransportHidApi::error()
+{
+    return StringUtils::wstring_to_string(hid_error(m_dev));
+}
+
+}
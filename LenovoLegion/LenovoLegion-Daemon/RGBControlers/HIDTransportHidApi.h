@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#pragma once
+
+#include "HIDTransport.h"
+
+#include <hidapi.h>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Transport over hidapi device, device is closed with transport
+ */
+class HIDTransportHidApi : public HIDTransport
+{
+public:
+
+    explicit HIDTransportHidApi(hid_device* dev);
+    ~HIDTransportHidApi() override;
+
+    HIDTransportHidApi(const HIDTransportHidApi&)            = delete;
+    HIDTransportHidApi& operator=(const HIDTransportHidApi&) = delete;
+
+    int                         sendFeatureReport(const uint8_t* data,size_t length) override;
+    int                         getFeatureReport(uint8_t* data,size_t length)        override;
+
+    std::optional<std::string>  getManufacturerString() override;
+    std::optional<std::string>  getProductString()      override;
+    std::optional<std::string>  getSerialNumberString() override;
+
+    std::string                 error()                 override;
+
+private:
+
+    hid_device * const m_dev;
+};
+
+}
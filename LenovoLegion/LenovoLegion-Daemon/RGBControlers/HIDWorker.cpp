@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "HIDWorker.h"
+
+#include <Core/LoggerHolder.h>
+#include <Core/ExceptionBuilder.h>
+
+#include <algorithm>
+
+namespace LenovoLegionDaemon {
+
+HIDWorker::HIDWorker(std::unique_ptr<HIDTransport> transport) :
+    m_transport(std::move(transport)),
+    m_stop(false),
+    m_totalLatency(0),
+    m_thread(&HIDWorker::run,this)
+{}
+
+HIDWorker::~HIDWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeUp.notify_all();
+
+    m_thread.join();
+}
+
+std::future<void> HIDWorker::send(std::function<void (HIDTransport &)> transfer, std::optional<uint32_t> coalesceKey)
+{
+    std::shared_ptr<std::promise<void>> promise = std::make_shared<std::promise<void>>();
+    std::future<void>                   future  = promise->get_future();
+
+    submit({
+        .m_execute     = [promise,transfer](HIDTransport& transport) {
+                            try {
+                                transfer(transport);
+                                promise->set_value();
+                            } catch(...) {
+                                promise->set_exception(std::current_exception());
+                                throw;
+                            }
+                         },
+        .m_supersede   = [promise]() { promise->set_value(); },
+        .m_coalesceKey = coalesceKey,
+        .m_reads       = false,
+        .m_submitted   = Clock::now()
+    });
+
+    return future;
+}
+
+void HIDWorker::flush()
+{
+    read<bool>([](HIDTransport&) { return true; }).wait();
+}
+
+void HIDWorker::skipped()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ++m_statistics.m_skipped;
+}
+
+HIDWorker::Statistics HIDWorker::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_statistics;
+}
+
+void HIDWorker::submit(Command command)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        /*
+         * Pending send with same key and no read behind it is superseded
+         */
+        if(command.m_coalesceKey)
+        {
+            for(auto it = m_queue.rbegin(); it != m_queue.rend() && !it->m_reads; ++it)
+            {
+                if(it->m_coalesceKey == command.m_coalesceKey)
+                {
+                    it->m_supersede();
+                    m_queue.erase(std::next(it).base());
+                    ++m_statistics.m_coalesced;
+                    break;
+                }
+            }
+        }
+
+        m_queue.push_back(std::move(command));
+
+        m_statistics.m_queueDepth    = m_queue.size();
+        m_statistics.m_maxQueueDepth = std::max(m_statistics.m_maxQueueDepth,m_queue.size());
+    }
+
+    m_wakeUp.notify_one();
+}
+
+void HIDWorker::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while(true)
+    {
+        m_wakeUp.wait(lock,[this]() { return m_stop || !m_queue.empty(); });
+
+        /*
+         * Queued commands are executed before stop, last settings reach device
+         */
+        if(m_queue.empty())
+        {
+            break;
+        }
+
+        Command command = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_statistics.m_queueDepth = m_queue.size();
+
+        lock.unlock();
+
+        bool failed = false;
+
+        try {
+            command.m_execute(*m_transport);
+        } catch(const bj::framework::exception::Exception& ex)
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - HID transfer failed, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+            failed = true;
+        } catch(...)
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - HID transfer failed");
+            failed = true;
+        }
+
+        const std::chrono::microseconds latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - command.m_submitted);
+
+        lock.lock();
+
+        m_statistics.m_executed    += 1;
+        m_statistics.m_failed      += failed ? 1 : 0;
+        m_statistics.m_lastLatency  = latency;
+        m_statistics.m_maxLatency   = std::max(m_statistics.m_maxLatency,latency);
+        m_totalLatency             += latency;
+        m_statistics.m_avgLatency   = m_totalLatency / m_statistics.m_executed;
+    }
+}
+
+}
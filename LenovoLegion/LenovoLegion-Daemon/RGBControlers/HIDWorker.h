@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#pragma once
+
+#include "HIDTransport.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Worker thread owning transport of one HID device
+ *
+ * All transfers are executed in order of submission. Send which is superseded by a newer
+ * one with the same coalesce key, before any read was queued behind it, is dropped and its
+ * future is made ready without transfer. Read returns its future, caller decides whether
+ * to wait.
+ */
+class HIDWorker
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        size_t                      m_queueDepth    = 0;
+        size_t                      m_maxQueueDepth = 0;
+        uint64_t                    m_executed      = 0;
+        uint64_t                    m_coalesced     = 0;
+        uint64_t                    m_skipped       = 0;    // Identical to report device already has, never queued
+        uint64_t                    m_failed        = 0;
+        std::chrono::microseconds   m_lastLatency   {0};    // From submit to completion
+        std::chrono::microseconds   m_avgLatency    {0};
+        std::chrono::microseconds   m_maxLatency    {0};
+    };
+
+public:
+
+    explicit HIDWorker(std::unique_ptr<HIDTransport> transport);
+    ~HIDWorker();
+
+    HIDWorker(const HIDWorker&)            = delete;
+    HIDWorker& operator=(const HIDWorker&) = delete;
+
+    /*
+     * Sends without waiting
+     */
+    std::future<void> send(std::function<void (HIDTransport&)> transfer,std::optional<uint32_t> coalesceKey = std::nullopt);
+
+    /*
+     * Reads, result is available from future
+     */
+    template<class T>
+    std::future<T>    read(std::function<T (HIDTransport&)> transfer);
+
+    /*
+     * Waits until everything submitted so far is executed
+     */
+    void              flush();
+
+    /*
+     * Counts report which owner did not send because device already has it
+     */
+    void              skipped();
+
+    Statistics        statistics() const;
+
+private:
+
+    struct Command {
+        std::function<void (HIDTransport&)> m_execute;      // Fulfills promise
+        std::function<void ()>              m_supersede;    // Fulfills promise without transfer
+        std::optional<uint32_t>             m_coalesceKey;
+        bool                                m_reads;
+        Clock::time_point                   m_submitted;
+    };
+
+    void submit(Command command);
+    void run();
+
+private:
+
+    const std::unique_ptr<HIDTransport> m_transport;
+
+    mutable std::mutex                  m_mutex;
+    std::condition_variable             m_wakeUp;
+    std::deque<Command>                 m_queue;
+    bool                                m_stop;
+    Statistics                          m_statistics;
+    std::chrono::microseconds           m_totalLatency;
+
+    std::thread                         m_thread;
+};
+
+template<class T>
+std::future<T> HIDWorker::read(std::function<T (HIDTransport &)> transfer)
+{
+    std::shared_ptr<std::promise<T>> promise = std::make_shared<std::promise<T>>();
+    std::future<T>                   future  = promise->get_future();
+
+    submit({
+        .m_execute     = [promise,transfer](HIDTransport& transport) {
+                            try {
+                                promise->set_value(transfer(transport));
+                            } catch(...) {
+                                promise->set_exception(std::current_exception());
+                                throw;
+                            }
+                         },
+        .m_supersede   = {},
+        .m_coalesceKey = std::nullopt,
+        .m_reads       = true,
+        .m_submitted   = Clock::now()
+    });
+
+    return future;
+}
+
+}
@@ -11,8 +11,9 @@
 #include <Core/LoggerHolder.h>
 
 #include <QRandomGenerator>
+#include <QTimer>
 
-#include <thread>
+#include <algorithm>
 
 
 
@@ -33,8 +34,16 @@ LenovoRGBController::LenovoRGBController(LenovoUSBController* controller_ptr,
                                          bool                           hasLogo
                                          ) :
     RGBController( profiles,britnesses,name,vendor,description,serial,location,type,modes,zones,maxEffects,hasLogo),
-    controller(controller_ptr)
-{}
+    controller(controller_ptr),
+    m_profileConfirmTimer(new QTimer(this)),
+    m_ledStateTimer(new QTimer(this))
+{
+    m_profileConfirmTimer->setSingleShot(true);
+    m_ledStateTimer->setSingleShot(true);
+
+    connect(m_profileConfirmTimer,&QTimer::timeout,this,&LenovoRGBController::confirmProfile);
+    connect(m_ledStateTimer,&QTimer::timeout,this,&LenovoRGBController::refreshLedState);
+}
 
 LenovoRGBController::~LenovoRGBController()
 {}
@@ -44,24 +53,9 @@ void LenovoRGBController::DeviceUpdateProfile()
 {
     LOG_T(QString(__PRETTY_FUNCTION__) + ": Updating active profile on device");
 
-    auto waitForApplyProfileOnController = [this](int maxWaitTimeinMicros = 1000000) {
-        while(fromControlerProfile(controller->getCurrentProfileId()) != m_profiles.active)
-        {
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
-            maxWaitTimeinMicros -= 100;
-
-            if(maxWaitTimeinMicros <= 0)
-            {
-                break;
-            }
-        }
-    };
-
     controller->setProfile(toControlerProfile(m_profiles.active));
 
-    waitForApplyProfileOnController();
-
-    DeviceRefreshEffects();
+    startProfileConfirmation(m_profiles.active);
 }
 
 void LenovoRGBController::DeviceRefreshProfile(int expectedProfile)
@@ -72,33 +66,22 @@ void LenovoRGBController::DeviceRefreshProfile(int expectedProfile)
     {
         LOG_D(QString(__PRETTY_FUNCTION__) + ":  Expecting profile " + QString::number(expectedProfile) + " after refresh");
 
-        // Wait for USB device to switch to expected profile
-        int atempt = 0;
-        do {
-            m_profiles.active = fromControlerProfile(controller->getCurrentProfileId());
-
-            if(m_profiles.active  == static_cast<unsigned int>(expectedProfile))
-            {
-                LOG_D(QString(__PRETTY_FUNCTION__) + QString(":  Successfully switched to expected profile %1").arg(m_profiles.active));
-                break;
-            }
-
-            if(atempt > 10)
-            {
-                LOG_W( __PRETTY_FUNCTION__ + QString(":  Timeout waiting for profile switch to profile %1").arg(m_profiles.active));
-                break;
-            }
-
-            LOG_D(QString(__PRETTY_FUNCTION__) + QString(":  Waiting for profile switch to expected profile %1, currently at profile %2").arg(expectedProfile).arg(m_profiles.active));
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            atempt += 1;
-        } while (true);
-    }else
+        startProfileConfirmation(static_cast<unsigned int>(expectedProfile));
+    }
+    else if(!DeviceIsProfileSwitchPending())
     {
         LOG_T(QString(__PRETTY_FUNCTION__) + ":  No expected profile provided, reading current profile from device");
 
-        m_profiles.active = fromControlerProfile(controller->getCurrentProfileId());
+        const uint8_t profile = controller->getCurrentProfileId();
+
+        if(profile == 0x00)
+        {
+            startProfileConfirmation(std::nullopt);
+        }
+        else
+        {
+            m_profiles.active = fromControlerProfile(profile);
+        }
     }
 }
 
@@ -106,12 +89,16 @@ void LenovoRGBController::DeviceUpdateBrightness()
 {
     LOG_T(QString(__PRETTY_FUNCTION__) + ": Updating brightness on device");
     controller->setBrightness(toControlerBrightness(static_cast<uint8_t>(m_britnesses.active)));
+
+    scheduleLedStateRefresh();
 }
 
 void LenovoRGBController::DeviceRefreshBrightness()
 {
     LOG_T(QString(__PRETTY_FUNCTION__) + ":  Refreshing brightness from device");
     m_britnesses.active = fromControlerBrightness(controller->getCurrentBrightness());
+
+    scheduleLedStateRefresh();
 }
 
 std::vector<RGBColor> LenovoRGBController::DeviceGetState() const
@@ -163,6 +150,39 @@ void LenovoRGBController::DeviceRefreshLogoState()
     }
 }
 
+bool LenovoRGBController::DeviceSupportsDirectMode() const
+{
+    return false;
+}
+
+bool LenovoRGBController::DeviceIsDirectModeActive() const
+{
+    return false;
+}
+
+void LenovoRGBController::DeviceStartDirectMode(std::unique_ptr<RGBDirectModeEngine::Effect>,RGBDirectModeEngine::Clock::time_point)
+{
+    THROW_EXCEPTION(exception_T,ERROR_CODES::DIRECT_CONTROL_NOT_SUPPORTED,"Direct control is not supported by device");
+}
+
+void LenovoRGBController::DeviceStopDirectMode()
+{}
+
+RGBDirectModeEngine::Statistics LenovoRGBController::DeviceGetDirectModeStatistics() const
+{
+    return {};
+}
+
+HIDWorker::Statistics LenovoRGBController::DeviceGetTransportStatistics() const
+{
+    return controller->getWorkerStatistics();
+}
+
+bool LenovoRGBController::DeviceIsProfileSwitchPending() const
+{
+    return m_profileConfirmation.has_value();
+}
+
 void LenovoRGBController::DeviceRefresh(int expectedProfile)
 {
     /*
@@ -183,92 +203,233 @@ void LenovoRGBController::DeviceRefresh(int expectedProfile)
 
 void LenovoRGBController::DeviceUpdateEfects()
 {
-    std::vector<LenovoUSBController::led_group> groups;
+    controller->setProfileDescription(toControlerProfile(m_profiles.active), toControlerGroups(m_effects));
 
-    for (auto & effect : m_effects)
-    {
-        groups.push_back({
-            .m_mode         = static_cast<uint8_t>(effect.m_mode),
-            .m_speed        = static_cast<uint8_t>(effect.m_speed),
-            .m_spin         = toControlerSpin(effect.m_direction),
-            .m_direction    = toControlerDirection(effect.m_direction),
-            .m_color_mode   = toControlerColorMode(effect.m_color_mode),
-            .m_colors       = effect.m_colors,
-            .m_leds         = [&effect]() {
-                                std::set<uint16_t> leds;
-                                for(const auto& led: effect.m_leds)
-                                {
-                                    leds.insert(led.value);
-                                }
-                                return std::vector<uint16_t>(leds.begin(), leds.end());
-                            }()
-        });
-    }
+    m_profileEffects[m_profiles.active] = m_effects;
 
-    controller->setProfileDescription(toControlerProfile(m_profiles.active), groups);
+    scheduleLedStateRefresh();
 }
 
 void LenovoRGBController::DeviceResetEffectsToDefault()
 {
     controller->setProfileDefault(toControlerProfile(m_profiles.active));
+
+    m_profileEffects.erase(m_profiles.active);
+
+    scheduleLedStateRefresh();
 }
 
 void LenovoRGBController::DeviceRefreshEffects()
 {
     LOG_T(QString(__PRETTY_FUNCTION__) + ":  Refreshing effects from device");
 
-    readActiveProfileSettings();
+    /*
+     * Effects are read when switch is confirmed
+     */
+    if(DeviceIsProfileSwitchPending())
+    {
+        return;
+    }
+
+    if(!readActiveProfileSettings())
+    {
+        startProfileConfirmation(m_profiles.active);
+    }
 }
 
-void LenovoRGBController::readActiveProfileSettings()
+bool LenovoRGBController::readActiveProfileSettings()
 {
     LOG_T(QString(__PRETTY_FUNCTION__) + ":  Reading active profile settings from device");
 
-    m_effects.clear();
-
     /*---------------------------------------------------------*\
-    | Retrieve current values by readingledIdToIndex the device |
+    | Retrieve current values by reading the device             |
     \*---------------------------------------------------------*/
-    std::vector<LenovoUSBController::led_group> l_currentSettings = controller->getProfileDescription(toControlerProfile(m_profiles.active));
+    std::optional<std::vector<LenovoUSBController::led_group>> l_currentSettings = controller->getProfileDescription(toControlerProfile(m_profiles.active));
+
+    if(!l_currentSettings)
+    {
+        return false;
+    }
+
+    m_effects = fromControlerGroups(*l_currentSettings);
+
+    m_profileEffects[m_profiles.active] = m_effects;
+
+    scheduleLedStateRefresh();
+
+    return true;
+}
 
+void LenovoRGBController::startProfileConfirmation(std::optional<unsigned int> expected)
+{
+    LOG_D(QString(__PRETTY_FUNCTION__) + ":  Waiting for profile " + (expected ? QString::number(*expected) : QString("any")));
 
-    for (const auto & grub: l_currentSettings)
+    m_profileConfirmation = ProfileConfirmation {
+        .m_expected = expected,
+        .m_delay    = PROFILE_CONFIRM_INITIAL_DELAY,
+        .m_deadline = std::chrono::steady_clock::now() + PROFILE_CONFIRM_TIMEOUT
+    };
+
+    /*
+     * Until confirmed, last known effects of expected profile are reported
+     */
+    if(expected)
+    {
+        const auto effects = m_profileEffects.find(*expected);
+
+        m_profiles.active = *expected;
+        m_effects         = effects != m_profileEffects.end() ? effects->second : std::vector<led_group_effect>();
+    }
+
+    m_profileConfirmTimer->start(m_profileConfirmation->m_delay);
+}
+
+void LenovoRGBController::confirmProfile()
+{
+    if(!m_profileConfirmation)
+    {
+        return;
+    }
+
+    const bool expired = std::chrono::steady_clock::now() >= m_profileConfirmation->m_deadline;
+
+    try {
+        const uint8_t      controllerProfile = controller->getCurrentProfileId();
+        const unsigned int profile           = fromControlerProfile(controllerProfile);
+
+        if(controllerProfile != 0x00 && (!m_profileConfirmation->m_expected || *m_profileConfirmation->m_expected == profile || expired))
+        {
+            if(m_profileConfirmation->m_expected && *m_profileConfirmation->m_expected != profile)
+            {
+                LOG_W(QString(__PRETTY_FUNCTION__) + QString(":  Timeout waiting for profile switch to profile %1, device is at profile %2").arg(*m_profileConfirmation->m_expected).arg(profile));
+            }
+
+            m_profiles.active = profile;
+
+            if(readActiveProfileSettings() || expired)
+            {
+                LOG_D(QString(__PRETTY_FUNCTION__) + QString(":  Profile %1 settled").arg(profile));
+
+                m_profileConfirmation.reset();
+                emit profileSettled(profile);
+                return;
+            }
+        }
+    }
+    catch(const bj::framework::exception::Exception& ex)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + ":  Device not available, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+    }
+
+    if(expired)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + ":  Timeout waiting for profile switch, keeping last known profile");
+
+        m_profileConfirmation.reset();
+        emit profileSettled(m_profiles.active);
+        return;
+    }
+
+    m_profileConfirmation->m_delay = std::min(m_profileConfirmation->m_delay * 2,PROFILE_CONFIRM_MAX_DELAY);
+    m_profileConfirmTimer->start(m_profileConfirmation->m_delay);
+}
+
+void LenovoRGBController::scheduleLedStateRefresh()
+{
+    m_ledStateTimer->start(LED_STATE_REFRESH_DELAY);
+}
+
+void LenovoRGBController::refreshLedState()
+{
+    /*
+     * Profile is still resetting, read again when it settles
+     */
+    if(DeviceIsProfileSwitchPending())
+    {
+        return;
+    }
+
+    try {
+        UpdateLedState(DeviceGetState());
+    }
+    catch(const bj::framework::exception::Exception& ex)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + ":  LED state not read, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+    }
+}
+
+std::vector<LenovoUSBController::led_group> LenovoRGBController::toControlerGroups(const std::vector<led_group_effect> &effects) const
+{
+    std::vector<LenovoUSBController::led_group> groups;
+
+    groups.reserve(effects.size());
+
+    for (const auto & effect : effects)
+    {
+        LenovoUSBController::led_group group {
+            .m_mode         = static_cast<uint8_t>(effect.m_mode),
+            .m_speed        = static_cast<uint8_t>(effect.m_speed),
+            .m_spin         = toControlerSpin(effect.m_direction),
+            .m_direction    = toControlerDirection(effect.m_direction),
+            .m_color_mode   = toControlerColorMode(effect.m_color_mode),
+            .m_colors       = effect.m_colors,
+            .m_leds         = {}
+        };
+
+        /*
+         * Device wants every key once, in ascending order
+         */
+        group.m_leds.reserve(effect.m_leds.size());
+
+        for(const auto& led: effect.m_leds)
+        {
+            group.m_leds.push_back(static_cast<uint16_t>(led.value));
+        }
+
+        std::sort(group.m_leds.begin(),group.m_leds.end());
+        group.m_leds.erase(std::unique(group.m_leds.begin(),group.m_leds.end()),group.m_leds.end());
+
+        groups.push_back(std::move(group));
+    }
+
+    return groups;
+}
+
+std::vector<led_group_effect> LenovoRGBController::fromControlerGroups(const std::vector<LenovoUSBController::led_group> &groups) const
+{
+    std::vector<led_group_effect> effects;
+
+    effects.reserve(groups.size());
+
+    for (const auto & group : groups)
     {
-        m_effects.push_back(led_group_effect{
-            .m_mode        = grub.m_mode,
-            .m_speed       = grub.m_speed,
-            .m_direction   = fromControlerDirection(grub.m_direction) == MODE_DIRECTION_NA ? fromControlerSpin(grub.m_spin) : fromControlerDirection(grub.m_direction),
-            .m_color_mode  = fromControlerColorMode(m_modes [std::distance(m_modes.begin(),std::find_if(m_modes.begin(),m_modes.end(),[&grub](const mode& m){ return m.value == grub.m_mode;})) ].flags, grub.m_color_mode),
-            .m_colors      = grub.m_colors,
-            .m_leds        = [this,&grub](){
-                                std::vector<led> leds;
-
-                                std::multimap<unsigned int,size_t>     l_ledIdToIndex;
-
-                                /*
-                                 * Build the led id to index map
-                                 */
-                                for (size_t idx = 0; idx < this->m_leds.size(); ++idx) {
-                                    LOG_T(QString::asprintf("Mapping LED Index %zu to ID %X", idx, this->m_leds.at(idx).value));
-                                    l_ledIdToIndex.insert(std::pair(this->m_leds.at(idx).value,idx));
-                                }
-
-                                for (uint16_t ledId : grub.m_leds)
-                                {
-                                    LOG_T(QString::asprintf("Mapping LED ID %X to colors", ledId));
-                                    auto range = l_ledIdToIndex.equal_range(ledId);
-
-                                    for (auto i = range.first; i != range.second; ++i)
-                                    {
-                                        LOG_T(QString::asprintf(" - Setting color for LED Index %lu", i->second));
-                                        leds.push_back(this->m_leds.at(i->second));
-                                    }
-                                }
-
-                                return leds;
-                            }()
-        });
+        const std::optional<size_t> modeIdx = m_index.modeByValue(group.m_mode);
+
+        led_group_effect effect {
+            .m_mode        = group.m_mode,
+            .m_speed       = group.m_speed,
+            .m_direction   = fromControlerDirection(group.m_direction) == MODE_DIRECTION_NA ? fromControlerSpin(group.m_spin) : fromControlerDirection(group.m_direction),
+            .m_color_mode  = fromControlerColorMode(modeIdx ? m_modes[*modeIdx].flags : 0, group.m_color_mode),
+            .m_colors      = group.m_colors,
+            .m_leds        = {}
+        };
+
+        effect.m_leds.reserve(group.m_leds.size());
+
+        for (const uint16_t ledId : group.m_leds)
+        {
+            for (const int idx : m_index.ledsByValue(ledId))
+            {
+                effect.m_leds.push_back(m_leds[idx]);
+            }
+        }
+
+        LOG_T(QString(__PRETTY_FUNCTION__) + QString::asprintf(":  Mode %X mapped to %zu LEDs from %zu LED IDs", group.m_mode, effect.m_leds.size(), group.m_leds.size()));
+
+        effects.push_back(std::move(effect));
     }
+
+    return effects;
 }
 
 unsigned int LenovoRGBController::fromControlerColorMode(const unsigned int  modeFlags,const uint8_t color_mode) const
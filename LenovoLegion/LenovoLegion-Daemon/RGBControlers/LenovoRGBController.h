@@ -15,7 +15,12 @@
 
 #include <QtTypes>
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <optional>
+
+class QTimer;
 
 namespace LenovoLegionDaemon {
 
@@ -59,6 +64,18 @@ public:
 
     DEFINE_EXCEPTION(LenovoLegionDaemon);
 
+    /*
+     * Profile switch confirmation, device is polled from event loop with exponential backoff
+     */
+    static constexpr std::chrono::milliseconds  PROFILE_CONFIRM_INITIAL_DELAY   {1};
+    static constexpr std::chrono::milliseconds  PROFILE_CONFIRM_MAX_DELAY       {128};
+    static constexpr std::chrono::milliseconds  PROFILE_CONFIRM_TIMEOUT         {2000};
+
+    /*
+     * LED state is read once after burst of changes settles
+     */
+    static constexpr std::chrono::milliseconds  LED_STATE_REFRESH_DELAY         {100};
+
     enum ERROR_CODES : int
     {
         DIRECT_CONTROL_NOT_SUPPORTED = 1
@@ -94,6 +111,8 @@ public:
 
     void        DeviceRefresh(int expectedProfile = -1) override;
 
+    bool        DeviceIsProfileSwitchPending() const   override;
+
     std::vector<RGBColor> DeviceGetState()     const   override;
 
     uint16_t                GetVendorID()         const   override;
@@ -102,8 +121,40 @@ public:
     void            DeviceUpdateLogoState()       override;
     void            DeviceRefreshLogoState()      override;
 
+    /*
+     * Not supported unless device implementation overrides
+     */
+    bool                            DeviceSupportsDirectMode()    const   override;
+    bool                            DeviceIsDirectModeActive()    const   override;
+    void                            DeviceStartDirectMode(std::unique_ptr<RGBDirectModeEngine::Effect> effect,RGBDirectModeEngine::Clock::time_point epoch = RGBDirectModeEngine::Clock::now()) override;
+    void                            DeviceStopDirectMode()                override;
+    RGBDirectModeEngine::Statistics DeviceGetDirectModeStatistics() const override;
+
+    HIDWorker::Statistics           DeviceGetTransportStatistics()  const override;
+
+    /*
+     * Effects to and from device groups, LED values are translated through controller index
+     */
+    std::vector<LenovoUSBController::led_group>     toControlerGroups(const std::vector<led_group_effect>& effects)                 const;
+    std::vector<led_group_effect>                   fromControlerGroups(const std::vector<LenovoUSBController::led_group>& groups)  const;
+
 private:
-    void readActiveProfileSettings();
+
+    struct ProfileConfirmation {
+        std::optional<unsigned int>             m_expected;         // Any valid profile without value
+        std::chrono::milliseconds               m_delay;
+        std::chrono::steady_clock::time_point   m_deadline;
+    };
+
+    /*
+     * Returns false while device is switching profile
+     */
+    bool readActiveProfileSettings();
+
+    void startProfileConfirmation(std::optional<unsigned int> expected);
+    void confirmProfile();
+
+    void refreshLedState();
 
     /*
      * Serialization from controler model
@@ -127,9 +178,25 @@ protected:
     uint8_t                                             toControlerProfile(unsigned int profile)            const;
     uint8_t                                             toControlerBrightness(unsigned int brightness)      const;
 
+protected:
+
+    void                                                scheduleLedStateRefresh();
+
 protected:
 
     std::unique_ptr<LenovoUSBController>  controller;
+
+private:
+
+    QTimer*                                                 m_profileConfirmTimer;
+    std::optional<ProfileConfirmation>                      m_profileConfirmation;
+
+    QTimer*                                                 m_ledStateTimer;
+
+    /*
+     * Last known effects of profiles, shown while switch is not confirmed
+     */
+    std::map<unsigned int,std::vector<led_group_effect>>    m_profileEffects;
 };
 
 }
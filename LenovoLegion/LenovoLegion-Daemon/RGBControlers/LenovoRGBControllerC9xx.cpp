@@ -12,9 +12,6 @@
 
 #include <Core/LoggerHolder.h>
 
-
-#define TIMER_INTERVAL_DIRECT_MODE_UPDATE_MS   25
-
 namespace LenovoLegionDaemon {
 
 LenovoRGBControllerC9xx::LenovoRGBControllerC9xx(LenovoUSBControllerC9xx *controller_ptr) :
@@ -316,4 +313,72 @@ LenovoRGBControllerC9xx::LenovoRGBControllerC9xx(LenovoUSBControllerC9xx *contro
     DeviceRefresh();
 }
 
+LenovoRGBControllerC9xx::~LenovoRGBControllerC9xx()
+{
+    try {
+        DeviceStopDirectMode();
+    } catch(const bj::framework::exception::Exception& ex)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - Direct mode not stopped, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+    }
+}
+
+bool LenovoRGBControllerC9xx::DeviceSupportsDirectMode() const
+{
+    return true;
+}
+
+bool LenovoRGBControllerC9xx::DeviceIsDirectModeActive() const
+{
+    return m_directMode != nullptr && m_directMode->isRunning();
+}
+
+void LenovoRGBControllerC9xx::DeviceStartDirectMode(std::unique_ptr<RGBDirectModeEngine::Effect> effect,RGBDirectModeEngine::Clock::time_point epoch)
+{
+    LOG_D(QString(__PRETTY_FUNCTION__) + ": Starting direct mode");
+
+    if(m_directMode == nullptr)
+    {
+        m_directMode = std::make_unique<RGBDirectModeEngine>(RGBDirectModeEngine::Layout::fromZones(m_zones,m_leds.size()),
+                                                             [usb = usbController()](const std::vector<RGBColor>& frame) {
+                                                                 usb->setLedsDirect(frame);
+                                                             });
+    }
+
+    if(!m_directMode->isRunning())
+    {
+        usbController()->setLedsDirectOn(toControlerProfile(m_profiles.active));
+    }
+
+    m_directMode->start(std::move(effect),epoch);
+
+    scheduleLedStateRefresh();
+}
+
+void LenovoRGBControllerC9xx::DeviceStopDirectMode()
+{
+    if(!DeviceIsDirectModeActive())
+    {
+        return;
+    }
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + ": Stopping direct mode");
+
+    m_directMode->stop();
+
+    usbController()->setLedsDirectOff(toControlerProfile(m_profiles.active));
+
+    scheduleLedStateRefresh();
+}
+
+RGBDirectModeEngine::Statistics LenovoRGBControllerC9xx::DeviceGetDirectModeStatistics() const
+{
+    return m_directMode != nullptr ? m_directMode->statistics() : RGBDirectModeEngine::Statistics{};
+}
+
+LenovoUSBControllerC9xx *LenovoRGBControllerC9xx::usbController() const
+{
+    return static_cast<LenovoUSBControllerC9xx*>(controller.get());
+}
+
 }
@@ -20,6 +20,21 @@ class LenovoRGBControllerC9xx : public LenovoRGBController
 public:
 
     LenovoRGBControllerC9xx(LenovoUSBControllerC9xx* controller_ptr);
+    ~LenovoRGBControllerC9xx() override;
+
+    bool                            DeviceSupportsDirectMode()    const   override;
+    bool                            DeviceIsDirectModeActive()    const   override;
+    void                            DeviceStartDirectMode(std::unique_ptr<RGBDirectModeEngine::Effect> effect,RGBDirectModeEngine::Clock::time_point epoch = RGBDirectModeEngine::Clock::now()) override;
+    void                            DeviceStopDirectMode()                override;
+    RGBDirectModeEngine::Statistics DeviceGetDirectModeStatistics() const override;
+
+private:
+
+    LenovoUSBControllerC9xx* usbController() const;
+
+private:
+
+    std::unique_ptr<RGBDirectModeEngine>  m_directMode;
 };
 
 }
@@ -10,20 +10,18 @@
 
 #include <Core/LoggerHolder.h>
 
-#include "StringUtils.h"
-
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
 #include <string.h>
-#include <thread>
 
 
 namespace LenovoLegionDaemon {
 
 
-LenovoUSBController::LenovoUSBController(hid_device* dev_handle, const char* path, uint16_t in_pid, uint16_t in_vid) :
-    m_dev(dev_handle),
+LenovoUSBController::LenovoUSBController(std::unique_ptr<HIDTransport> transport, const char* path, uint16_t in_pid, uint16_t in_vid) :
+    m_worker(std::make_unique<HIDWorker>(std::move(transport))),
     m_location(path),
     m_pid(in_pid),
     m_vid(in_vid)
@@ -31,33 +29,35 @@ LenovoUSBController::LenovoUSBController(hid_device* dev_handle, const char* pat
     /*---------------------------------------------------------*\
     | Get device name from HID manufacturer and product strings |
     \*---------------------------------------------------------*/
-    wchar_t string[HID_MAX_STR + 1] = {0};
-    if(hid_get_manufacturer_string(m_dev, string, HID_MAX_STR))
-    {
-        hid_close(m_dev);
-        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get device manufacturer string what=(%s)",StringUtils::wstring_to_string(hid_error(m_dev)).c_str()).toStdString().c_str());
-    }
-    m_name = StringUtils::wstring_to_string(string);
+    m_worker->read<bool>([this](HIDTransport& transport) {
+        const std::optional<std::string> manufacturer = transport.getManufacturerString();
+        if(!manufacturer)
+        {
+            THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get device manufacturer string what=(%s)",transport.error().c_str()).toStdString().c_str());
+        }
+        m_name = *manufacturer;
 
-    if(hid_get_product_string(m_dev, string, HID_MAX_STR))
-    {
-        hid_close(m_dev);
-        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get device product string what=(%s)",StringUtils::wstring_to_string(hid_error(m_dev)).c_str()).toStdString().c_str());
-    }
-    m_name.append(" ").append(StringUtils::wstring_to_string(string));
+        const std::optional<std::string> product = transport.getProductString();
+        if(!product)
+        {
+            THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get device product string what=(%s)",transport.error().c_str()).toStdString().c_str());
+        }
+        m_name.append(" ").append(*product);
 
 
-    if(hid_get_serial_number_string(m_dev, string, HID_MAX_STR))
-    {
-        hid_close(m_dev);
-        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get device serial string what=(%s)",StringUtils::wstring_to_string(hid_error(m_dev)).c_str()).toStdString().c_str());
-    }
-    m_serial = StringUtils::wstring_to_string(string);
+        const std::optional<std::string> serial = transport.getSerialNumberString();
+        if(!serial)
+        {
+            THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get device serial string what=(%s)",transport.error().c_str()).toStdString().c_str());
+        }
+        m_serial = *serial;
+
+        return true;
+    }).get();
 
 
     if(!isCompatible())
     {
-        hid_close(m_dev);
         THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_NOT_COMPATIBLE,"Device is not compatible");
     }
 
@@ -65,9 +65,7 @@ LenovoUSBController::LenovoUSBController(hid_device* dev_handle, const char* pat
 }
 
 LenovoUSBController::~LenovoUSBController()
-{
-    hid_close(m_dev);
-}
+{}
 
 uint16_t LenovoUSBController::getPid() const
 {
@@ -93,9 +91,9 @@ void LenovoUSBController::setProfileDescription(uint8_t profile_id,const  std::v
 {
     LOG_T(QString::asprintf("LenovoUSBController::setProfileDescription: Setting LED groups for profile %d", profile_id));
 
-    ByteArray packet = serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::EffectChange,{.value1 = profile_id,
-                                                                                      .value2 = {}
-                                                                                      },[&led_groups](){
+    sendSetting(LENOVO_SPECTRUM_OPERATION_TYPE::EffectChange,{.value1 = profile_id,
+                                                              .value2 = {}
+                                                              },[&led_groups](){
         ByteArray payload;
 
         payload.push_back(0x01); //Unknown field
@@ -135,38 +133,20 @@ void LenovoUSBController::setProfileDescription(uint8_t profile_id,const  std::v
         }
         return payload;
     }(),0x00);
-
-
-    sendFeatureReport(packet);
 }
 
 uint8_t LenovoUSBController::getCurrentProfileId() const
 {
     LOG_T("LenovoUSBController::getCurrentProfileId: Getting current profile ID");
 
-    // Retry up to 10 times if we get profile 0 (device may be in reset state)
-    for(int attempt = 0; attempt < 10; ++attempt)
+    ByteArray result = sendAndGetFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::Profile));
+
+    if(result.size() >= 5 && result[4] != 0x00)
     {
-        ByteArray result = sendAndGetFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::Profile));
-        
-        if(result.size() >= 5 && result[4] != 0x00)
-        {
-            if(attempt > 0)
-            {
-                LOG_T(QString::asprintf("getCurrentProfileId: Got valid profile after %d retries", attempt));
-            }
-            return result[4];
-        }
-        
-        if(attempt < 9)
-        {
-            LOG_T("getCurrentProfileId: Got profile 0 (device may be in reset state), retrying...");
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+        syncSetting(LENOVO_SPECTRUM_OPERATION_TYPE::ProfileChange,result[4]);
     }
-    
-    LOG_W("getCurrentProfileId: Device returned profile 0 after all retries");
-    return 0;
+
+    return result.size() >= 5 ? result[4] : 0;
 }
 
 uint8_t LenovoUSBController::getCurrentBrightness() const
@@ -174,6 +154,12 @@ uint8_t LenovoUSBController::getCurrentBrightness() const
     LOG_T("LenovoUSBController::getCurrentBrightness: Getting current brightness");
 
     ByteArray result = sendAndGetFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::GetBrightness));
+
+    if(result.size() >= 5)
+    {
+        syncSetting(LENOVO_SPECTRUM_OPERATION_TYPE::Brightness,result[4]);
+    }
+
     return  result.size() >= 5 ? result[4] : 0;
 }
 
@@ -182,6 +168,12 @@ bool LenovoUSBController::getLogoStatus() const
     LOG_T("LenovoUSBController::getLogoStatus: Getting current logo LED status");
 
     ByteArray result = sendAndGetFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::GetLogoStatus));
+
+    if(result.size() >= 5)
+    {
+        syncSetting(LENOVO_SPECTRUM_OPERATION_TYPE::LogoStatus,result[4]);
+    }
+
     return  result.size() >= 5 ? result[4] == 0x01 : false;
 }
 
@@ -337,6 +329,124 @@ LenovoUSBController::ByteArray LenovoUSBController::serializeToBuffer(LENOVO_SPE
     return packet;
 }
 
+void LenovoUSBController::sendSetting(LENOVO_SPECTRUM_OPERATION_TYPE type, const Params &params, const ByteArray &payload, uint8_t size)
+{
+    const uint32_t key = settingKey(type,params);
+    ByteArray      packet;
+
+    {
+        std::lock_guard<std::mutex> lock(m_reportsMutex);
+
+        ReportTemplate& report  = m_reports[key];
+        const bool      changed = patchReport(report,type,params,payload,size);
+
+        if(!changed && report.m_sent)
+        {
+            LOG_T(QString::asprintf("LenovoUSBController::sendSetting: Report 0x%02X is identical to last sent, skipped", type));
+
+            m_worker->skipped();
+            return;
+        }
+
+        report.m_sent = true;
+        packet        = report.m_packet;
+    }
+
+    LOG_T(QString::asprintf("LenovoUSBController::sendSetting: Sending packet: %s", convertBytesArrayToHex(packet).c_str()));
+
+    m_worker->send([this,type,params,packet](HIDTransport& transport) {
+        try {
+            send(transport,packet);
+        } catch(...)
+        {
+            invalidateSetting(type,params);
+            throw;
+        }
+    },key);
+}
+
+void LenovoUSBController::syncSetting(LENOVO_SPECTRUM_OPERATION_TYPE type, uint8_t value) const
+{
+    std::lock_guard<std::mutex> lock(m_reportsMutex);
+
+    const auto report = m_reports.find(settingKey(type,{}));
+
+    if(report != m_reports.end() && report->second.m_packet[4] != value)
+    {
+        report->second.m_sent = false;
+    }
+}
+
+void LenovoUSBController::invalidateSetting(LENOVO_SPECTRUM_OPERATION_TYPE type, const Params &params) const
+{
+    std::lock_guard<std::mutex> lock(m_reportsMutex);
+
+    const auto report = m_reports.find(settingKey(type,params));
+
+    if(report != m_reports.end())
+    {
+        report->second.m_sent = false;
+    }
+}
+
+bool LenovoUSBController::patchReport(ReportTemplate &report, LENOVO_SPECTRUM_OPERATION_TYPE type, const Params &params, const ByteArray &payload, uint8_t size)
+{
+    const size_t header = 4 + (params.value1.has_value() ? 1 : 0) + (params.value2.has_value() ? 1 : 0);
+    bool         changed = false;
+    size_t       i       = 0;
+
+    if(payload.size() > PACKET_SIZE - header)
+    {
+        THROW_EXCEPTION(exception_T,ERROR_CODES::DATA_PAYLOAD_TOO_LARGE,"Payload size exceeds maximum packet size");
+    }
+
+    auto put = [&report,&changed,&i](uint8_t value) {
+        changed               |= report.m_packet[i] != value;
+        report.m_packet[i++]   = value;
+    };
+
+    put(REPORT_ID);
+    put(type);
+    put(size == 0x00 ? static_cast<uint8_t>((header + payload.size()) % 256) : size);
+    put(0x03);
+
+    if(params.value1.has_value())
+    {
+        put(params.value1.value());
+    }
+
+    if(params.value2.has_value())
+    {
+        put(params.value2.value());
+    }
+
+    for(const uint8_t value : payload)
+    {
+        put(value);
+    }
+
+    /*
+     * Tail of longer previous report
+     */
+    if(i < report.m_length)
+    {
+        changed = true;
+        std::fill(report.m_packet.begin() + i,report.m_packet.begin() + report.m_length,0x00);
+    }
+
+    report.m_length = i;
+
+    return changed;
+}
+
+uint32_t LenovoUSBController::settingKey(LENOVO_SPECTRUM_OPERATION_TYPE type, const Params &params)
+{
+    /*
+     * Effects are per profile
+     */
+    return type == LENOVO_SPECTRUM_OPERATION_TYPE::EffectChange ? type << 8 | params.value1.value_or(0) : type;
+}
+
 std::string LenovoUSBController::convertBytesArrayToHex(const ByteArray& array)
 {
     std::ostringstream stream;
@@ -360,18 +470,18 @@ void LenovoUSBController::setBrightness(uint8_t brightness)
 {
     LOG_T(QString::asprintf("LenovoUSBController::setBrightness: Setting brightness to %d", brightness));
 
-    sendFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::Brightness, {.value1 = brightness,
-                                                                                     .value2 = {}
-                                                                                    }));
+    sendSetting(LENOVO_SPECTRUM_OPERATION_TYPE::Brightness, {.value1 = brightness,
+                                                             .value2 = {}
+                                                            });
 }
 
 void LenovoUSBController::setProfile(uint8_t profile_id)
 {
     LOG_T(QString::asprintf("LenovoUSBController::switchProfileTo: Switching to profile %d", profile_id));
 
-    sendFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::ProfileChange, {.value1 = profile_id,
-                                                                                        .value2 = {}
-                                                                                       }));
+    sendSetting(LENOVO_SPECTRUM_OPERATION_TYPE::ProfileChange, {.value1 = profile_id,
+                                                                .value2 = {}
+                                                               });
  }
 
 void LenovoUSBController::setProfileDefault(uint8_t profile_id)
@@ -381,183 +491,206 @@ void LenovoUSBController::setProfileDefault(uint8_t profile_id)
     sendFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::ProfileDefault, {.value1 = profile_id,
                                                                                          .value2 = {}
                                                                                          }));
+
+    invalidateSetting(LENOVO_SPECTRUM_OPERATION_TYPE::EffectChange,{.value1 = profile_id,
+                                                                    .value2 = {}
+                                                                    });
 }
 
 void LenovoUSBController::setLogoStatus(bool enabled)
 {
     LOG_T(QString::asprintf("LenovoUSBController::setLogoStatus: Setting logo LED status to %s", enabled ? "enabled" : "disabled"));
 
-    sendFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::LogoStatus, {.value1 = enabled ? 0x01 : 0x00,
-                                                                                     .value2 = {}
-                                                                                     }));
+    sendSetting(LENOVO_SPECTRUM_OPERATION_TYPE::LogoStatus, {.value1 = static_cast<uint8_t>(enabled ? 0x01 : 0x00),
+                                                             .value2 = {}
+                                                             });
 }
 
-std::vector<LenovoUSBController::led_group> LenovoUSBController::getProfileDescription(uint8_t profile_id) const
+std::optional<std::vector<LenovoUSBController::led_group>> LenovoUSBController::getProfileDescription(uint8_t profile_id) const
 {
     LOG_T(QString::asprintf("LenovoUSBController::getProfileDescription: Getting profile description for profile %d", profile_id));
 
-    // Retry up to 10 times if we get invalid profile data (device may be in reset state)
-    for(int attempt = 0; attempt < 10; ++attempt)
-    {
-        ByteArray response = sendAndGetFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::Effect, {.value1 = profile_id,
-                                                                                                                 .value2 = {}
-                                                                                                                 }));
-
-        // Check if response is valid and profile ID matches
-        if(response.size() < 5 || response[4] == 0x00)
-        {
-            if(attempt < 9)
-            {
-                LOG_T(QString::asprintf("getProfileDescription: Got invalid profile data (profile=%d), retrying... (attempt %d/10)", response.size() >= 5 ? response[4] : -1, attempt + 1));
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            continue;
-        }
+    ByteArray response = sendAndGetFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::Effect, {.value1 = profile_id,
+                                                                                                             .value2 = {}
+                                                                                                             }));
 
-        /*
-         * Parse response
-         */
-        std::vector<led_group> groups;
+    // Device in reset state, profile is not available yet
+    if(response.size() < 5 || response[4] == 0x00)
+    {
+        LOG_T(QString::asprintf("getProfileDescription: Got invalid profile data (profile=%d)", response.size() >= 5 ? response[4] : -1));
+        return std::nullopt;
+    }
 
-        /*
-         * Set Header
-         */
-        Header header( response[4]      // profile
-                      ,response[1]      // operation
-                      ,response[2]);    // size
+    /*
+     * Parse response
+     */
+    std::vector<led_group> groups;
 
+    /*
+     * Set Header
+     */
+    Header header( response[4]      // profile
+                  ,response[1]      // operation
+                  ,response[2]);    // size
 
-        LOG_T(QString::asprintf("LenovoUSBController::getProfileDescription: Received profile settings for profile %d, operation: %X, size: %X", header.m_profile, header.m_operation, header.m_size));
 
-        /*
-         * Parse Data
-         */
-        size_t i =  Header::m_dataIndx;
-        qsizetype lastEffectNo = 1;
-        while(i < response.size())
-        {
-            int effectNo = response[i++];
+    LOG_T(QString::asprintf("LenovoUSBController::getProfileDescription: Received profile settings for profile %d, operation: %X, size: %X", header.m_profile, header.m_operation, header.m_size));
 
-            if (effectNo < lastEffectNo)
-                break;
+    /*
+     * Parse Data
+     */
+    size_t i =  Header::m_dataIndx;
+    qsizetype lastEffectNo = 1;
+    while(i < response.size())
+    {
+        int effectNo = response[i++];
 
-            lastEffectNo = effectNo;
+        if (effectNo < lastEffectNo)
+            break;
 
-            led_group group {0,0,0,0,0,{},{}};
+        lastEffectNo = effectNo;
 
-            /*-----------------*\
-            |read group settings|
-            \*-----------------*/
-            if(i >= response.size())
-            {
-                LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Incomplete group settings, packet: %s",convertBytesArrayToHex(response).c_str()));
-                break;
-            }
+        led_group group {0,0,0,0,0,{},{}};
 
-            size_t cnt = response[i++];
-            if(cnt != 6)
-            {
-                LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Invalid group settings count = %ld, packet: %s", cnt,convertBytesArrayToHex(response).c_str()));
-                break;
-            }
-            for(size_t j = 0; j < cnt && (i + 1) < response.size(); j++, i+=2)
-            {
-                switch(response[i])
-                {
-                case 0x01:
-                group.m_mode  = response[i+1];
-                break;
-                case 0x02:
-                group.m_speed = response[i+1];
-                break;
-                case 0x03:
-                group.m_spin = response[i+1];
-                break;
-                case 0x04:
-                group.m_direction = response[i+1];
-                break;
-                case 0x05:
-                group.m_color_mode = response[i+1];
-                break;
-                case 0x06:
-                //group.mode = response[i+1];
-                break;
-                }
-            }
+        /*-----------------*\
+        |read group settings|
+        \*-----------------*/
+        if(i >= response.size())
+        {
+            LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Incomplete group settings, packet: %s",convertBytesArrayToHex(response).c_str()));
+            break;
+        }
 
-            /*-----------------*\
-            |read group colors  |
-            \*-----------------*/
-            if(i >= response.size())
+        size_t cnt = response[i++];
+        if(cnt != 6)
+        {
+            LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Invalid group settings count = %ld, packet: %s", cnt,convertBytesArrayToHex(response).c_str()));
+            break;
+        }
+        for(size_t j = 0; j < cnt && (i + 1) < response.size(); j++, i+=2)
+        {
+            switch(response[i])
             {
-                LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Incomplete group colors, packet: %s",convertBytesArrayToHex(response).c_str()));
-                break;
+            case 0x01:
+            group.m_mode  = response[i+1];
+            break;
+            case 0x02:
+            group.m_speed = response[i+1];
+            break;
+            case 0x03:
+            group.m_spin = response[i+1];
+            break;
+            case 0x04:
+            group.m_direction = response[i+1];
+            break;
+            case 0x05:
+            group.m_color_mode = response[i+1];
+            break;
+            case 0x06:
+            //group.mode = response[i+1];
+            break;
             }
+        }
 
-            cnt = response[i++];
-            for(size_t j = 0; j < cnt && (i + 2) < response.size(); j++, i+=3)
-            {
-                group.m_colors.push_back(ToRGBColor(response[i],response[i+1],response[i+2]));
-            }
+        /*-----------------*\
+        |read group colors  |
+        \*-----------------*/
+        if(i >= response.size())
+        {
+            LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Incomplete group colors, packet: %s",convertBytesArrayToHex(response).c_str()));
+            break;
+        }
 
-            /*-----------------*\
-            |read group LEDs    |
-            \*-----------------*/
-            if(i >= response.size())
-            {
-                LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Incomplete group LEDs, packet: %s",convertBytesArrayToHex(response).c_str()));
-                break;
-            }
+        cnt = response[i++];
+        for(size_t j = 0; j < cnt && (i + 2) < response.size(); j++, i+=3)
+        {
+            group.m_colors.push_back(ToRGBColor(response[i],response[i+1],response[i+2]));
+        }
 
-            cnt = response[i++];
-            for(size_t j = 0; j < cnt && (i + 1) < response.size(); j++, i+=2)
-            {
-                group.m_leds.push_back(response[i] | response[i+1] << 8);
-            }
+        /*-----------------*\
+        |read group LEDs    |
+        \*-----------------*/
+        if(i >= response.size())
+        {
+            LOG_E(QString::asprintf("LenovoUSBController::getProfileSettings: Incomplete group LEDs, packet: %s",convertBytesArrayToHex(response).c_str()));
+            break;
+        }
 
-            groups.push_back(group);
+        cnt = response[i++];
+        for(size_t j = 0; j < cnt && (i + 1) < response.size(); j++, i+=2)
+        {
+            group.m_leds.push_back(response[i] | response[i+1] << 8);
         }
 
-        return groups;
+        groups.push_back(group);
     }
 
-    LOG_W("getProfileDescription: Device returned invalid data after all retries");
+    return groups;
+}
 
-    return std::vector<LenovoUSBController::led_group>();
+void LenovoUSBController::flush() const
+{
+    m_worker->flush();
 }
 
-void LenovoUSBController::sendFeatureReport(const ByteArray& packet) const
+HIDWorker::Statistics LenovoUSBController::getWorkerStatistics() const
 {
-    LOG_T(QString::asprintf("LenovoUSBController::sendFeatureReport: Sending packet: %s", convertBytesArrayToHex(packet).c_str()));
+    return m_worker->statistics();
+}
 
-    int ret = hid_send_feature_report(m_dev, packet.data(), packet.size());
-    if(ret < 0)
+std::future<void> LenovoUSBController::sendFeatureReport(const ByteArray& packet,bool trace) const
+{
+    if(trace)
     {
-        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to send feature report to device what=(%s)", StringUtils::wstring_to_string(hid_error(m_dev)).c_str()).toStdString().c_str());
+        LOG_T(QString::asprintf("LenovoUSBController::sendFeatureReport: Sending packet: %s", convertBytesArrayToHex(packet).c_str()));
     }
 
-    if(static_cast<size_t>(ret) != packet.size())
-    {
-        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,"Unable to send complete feature report to device");
-    }
+    return m_worker->send([packet](HIDTransport& transport) {
+        send(transport,packet);
+    },coalesceKey(packet));
 }
 
 
 LenovoUSBController::ByteArray LenovoUSBController::sendAndGetFeatureReport(const ByteArray &packet) const
 {
-    sendFeatureReport(packet);
-    return getFeatureReport();
+    LOG_T(QString::asprintf("LenovoUSBController::sendAndGetFeatureReport: Sending packet: %s", convertBytesArrayToHex(packet).c_str()));
+
+    return m_worker->read<ByteArray>([packet](HIDTransport& transport) {
+        send(transport,packet);
+        return get(transport);
+    }).get();
 }
 
 
 LenovoUSBController::ByteArray LenovoUSBController::getFeatureReport() const
+{
+    return m_worker->read<ByteArray>([](HIDTransport& transport) {
+        return get(transport);
+    }).get();
+}
+
+void LenovoUSBController::send(HIDTransport &transport, const ByteArray &packet)
+{
+    int ret = transport.sendFeatureReport(packet.data(), packet.size());
+    if(ret < 0)
+    {
+        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to send feature report to device what=(%s)", transport.error().c_str()).toStdString().c_str());
+    }
+
+    if(static_cast<size_t>(ret) != packet.size())
+    {
+        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,"Unable to send complete feature report to device");
+    }
+}
+
+LenovoUSBController::ByteArray LenovoUSBController::get(HIDTransport &transport)
 {
     ByteArray response(PACKET_SIZE, REPORT_ID);
 
-    int ret = hid_get_feature_report(m_dev, response.data(), response.size());
+    int ret = transport.getFeatureReport(response.data(), response.size());
     if(ret < 0)
     {
-        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get feature report from device what=(%s)", StringUtils::wstring_to_string(hid_error(m_dev)).c_str()).toStdString().c_str());
+        THROW_EXCEPTION(exception_T,ERROR_CODES::DEVICE_COMMUNICATION_ERROR,QString::asprintf("Unable to get feature report from device what=(%s)", transport.error().c_str()).toStdString().c_str());
     }
 
     response.resize(ret);
@@ -567,4 +700,27 @@ LenovoUSBController::ByteArray LenovoUSBController::getFeatureReport() const
     return response;
 }
 
+std::optional<uint32_t> LenovoUSBController::coalesceKey(const ByteArray &packet)
+{
+    if(packet.size() < 5)
+    {
+        return std::nullopt;
+    }
+
+    /*
+     * Only the last value of a setting matters, effects are per profile
+     */
+    switch (packet[1]) {
+    case LENOVO_SPECTRUM_OPERATION_TYPE::Brightness:
+    case LENOVO_SPECTRUM_OPERATION_TYPE::ProfileChange:
+    case LENOVO_SPECTRUM_OPERATION_TYPE::LogoStatus:
+    case LENOVO_SPECTRUM_OPERATION_TYPE::AuroraSendBitmap:
+        return packet[1];
+    case LENOVO_SPECTRUM_OPERATION_TYPE::EffectChange:
+        return packet[1] << 8 | packet[4];
+    default:
+        return std::nullopt;
+    }
+}
+
 }
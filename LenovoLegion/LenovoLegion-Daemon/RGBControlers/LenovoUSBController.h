@@ -9,22 +9,23 @@
 #pragma once
 
 #include "RGBControllerInterface.h"
+#include "HIDWorker.h"
 
 #include <Core/ExceptionBuilder.h>
 
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
-#include <hidapi.h>
 #include <stdint.h>
 
 namespace LenovoLegionDaemon {
 
-#ifndef HID_MAX_STR
-#define HID_MAX_STR                255
-#endif
-
 #define PACKET_SIZE                960
 #define REPORT_ID                  0x07
 
@@ -123,7 +124,7 @@ public:
     /*--------------*\
     |ctor(s) and dtor|
     \*--------------*/
-    LenovoUSBController(hid_device* dev_handle, const char* path, uint16_t in_pid,uint16_t in_vid);
+    LenovoUSBController(std::unique_ptr<HIDTransport> transport, const char* path, uint16_t in_pid,uint16_t in_vid);
     virtual ~LenovoUSBController();
 
 
@@ -149,28 +150,64 @@ public:
     std::string                             getLocation()           const;
     std::string                             getSerialString()       const;
 
+    /*
+     * Single read, 0 while device is switching profile
+     */
     uint8_t                                 getCurrentProfileId()   const;
     uint8_t                                 getCurrentBrightness()  const;
     const KeyMap&                           getKeyMap()             const;
     bool                                    getLogoStatus()         const;
 
+    /*
+     * Waits until queued transfers are executed
+     */
+    void                                    flush()                 const;
+    HIDWorker::Statistics                   getWorkerStatistics()   const;
+
     /*
      * Current LED state
      */
     std::unordered_map<uint16_t,RGBColor>   getState()              const;
 \
     /*
-     * GEt profile description
+     * Get profile description, nothing while device is switching profile
      */
-    std::vector<led_group>  getProfileDescription(uint8_t profile_id) const;
+    std::optional<std::vector<led_group>>  getProfileDescription(uint8_t profile_id) const;
 
 protected:
 
     static ByteArray    serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE type, const Params& params = {},ByteArray payload = ByteArray(),uint8_t size = 0xC0);
     static std::string  convertBytesArrayToHex(const ByteArray &array);
 
+    /*
+     * Sends setting unless device already has identical report
+     */
+    void                sendSetting(LENOVO_SPECTRUM_OPERATION_TYPE type, const Params& params,const ByteArray& payload = ByteArray(),uint8_t size = 0xC0);
+
+    /*
+     * Value read back from device, report of setting is sent again next time when it differs
+     */
+    void                syncSetting(LENOVO_SPECTRUM_OPERATION_TYPE type, uint8_t value) const;
+    void                invalidateSetting(LENOVO_SPECTRUM_OPERATION_TYPE type, const Params& params = {}) const;
+
 private:
 
+    /*
+     * Last report of a setting, next one is patched into it in place
+     */
+    struct ReportTemplate
+    {
+        ByteArray   m_packet = ByteArray(PACKET_SIZE, 0x00);
+        size_t      m_length = 0;           // Bytes in use, rest is zero
+        bool        m_sent   = false;       // Device has m_packet
+    };
+
+    /*
+     * Returns true when a byte changed
+     */
+    static bool             patchReport(ReportTemplate& report,LENOVO_SPECTRUM_OPERATION_TYPE type, const Params& params,const ByteArray& payload,uint8_t size);
+    static uint32_t         settingKey(LENOVO_SPECTRUM_OPERATION_TYPE type, const Params& params);
+
     bool                    isCompatible();
     void                    initilizeKeyMap();
 
@@ -180,7 +217,17 @@ private:
     |data members    |
     \*--------------*/
     std::string        m_name;
-    hid_device * const m_dev;
+
+    /*
+     * Per setting key, failed transfer invalidates from worker thread
+     */
+    mutable std::mutex                          m_reportsMutex;
+    mutable std::map<uint32_t,ReportTemplate>   m_reports;
+
+    /*
+     * Owns transport, all transfers run on its thread
+     */
+    const std::unique_ptr<HIDWorker> m_worker;
 
     const std::string  m_location;
     const uint16_t     m_pid;
@@ -195,10 +242,23 @@ private:
     |device functions|
     \*--------------*/
 protected:
-    void        sendFeatureReport(const ByteArray& packet)       const;
-    ByteArray   sendAndGetFeatureReport(const ByteArray& packet) const;
+    /*
+     * Queued without waiting, superseded settings are coalesced
+     */
+    std::future<void> sendFeatureReport(const ByteArray& packet,bool trace = true) const;
+    ByteArray         sendAndGetFeatureReport(const ByteArray& packet) const;
+
+    ByteArray         getFeatureReport() const;
+
+private:
+
+    /*
+     * Executed on worker thread
+     */
+    static void       send(HIDTransport& transport,const ByteArray& packet);
+    static ByteArray  get(HIDTransport& transport);
 
-    ByteArray   getFeatureReport() const;
+    static std::optional<uint32_t> coalesceKey(const ByteArray& packet);
 };
 
 }
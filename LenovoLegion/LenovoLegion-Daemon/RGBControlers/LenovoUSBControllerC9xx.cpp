@@ -10,10 +10,31 @@
 
 #include <Core/LoggerHolder.h>
 
+#include <algorithm>
+
 namespace LenovoLegionDaemon {
 
-LenovoUSBControllerC9xx::LenovoUSBControllerC9xx(hid_device *dev_handle, const char *path, uint16_t in_pid,uint16_t in_vid) :
-    LenovoUSBController(dev_handle,path,in_pid,in_vid)
+LenovoUSBControllerC9xx::LenovoUSBControllerC9xx(std::unique_ptr<HIDTransport> transport, const char *path, uint16_t in_pid,uint16_t in_vid) :
+    LenovoUSBController(std::move(transport),path,in_pid,in_vid),
+    m_directBitmap([this]() {
+        /*
+         * Same order as LEDs of keyboard zone
+         */
+        std::vector<uint16_t> keyCodes;
+
+        for(size_t y = 0; y < getKeyMap().m_height; ++y)
+        {
+            for(size_t x = 0; x < getKeyMap().m_width; ++x)
+            {
+                if(getKeyMap().m_keyCodes[x][y] != 0x0000)
+                {
+                    keyCodes.push_back(getKeyMap().m_keyCodes[x][y]);
+                }
+            }
+        }
+
+        return keyCodes;
+    }())
 {}
 
 
@@ -38,28 +59,50 @@ void LenovoUSBControllerC9xx::setLedsDirectOff(uint8_t profile_id)
 
 void LenovoUSBControllerC9xx::setLedsDirect(const std::vector<RGBColor> &colors)
 {
-    LOG_T("LenovoUSBController::setLedsDirect: Setting direct LED colors");
+    /*
+     * Frame waits for device, engine measures real frame time
+     */
+    sendFeatureReport(m_directBitmap.encode(colors),false).get();
+}
 
-    sendFeatureReport(serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::AuroraSendBitmap,{},[this,&colors](){
-        ByteArray payload;
+LenovoUSBControllerC9xx::DirectBitmap::DirectBitmap(const std::vector<uint16_t> &keyCodes) :
+    m_leds(keyCodes.size())
+{
+    ByteArray payload;
 
-        for(size_t height = 0; height < getKeyMap().m_height; height++)
-        {
-            for (int width = 0; width < getKeyMap().m_width; ++width) {
+    payload.reserve(m_leds * ENTRY_SIZE);
 
-                if(getKeyMap().m_keyCodes[width][height])
-                    continue;
+    for(const uint16_t keyCode : keyCodes)
+    {
+        payload.push_back(keyCode & 0xFF);
+        payload.push_back(keyCode >> 8 & 0xFF);
+        payload.push_back(0x00);
+        payload.push_back(0x00);
+        payload.push_back(0x00);
+    }
 
-                payload.push_back(getKeyMap().m_keyCodes[width][height] & 0xFF);
-                payload.push_back(getKeyMap().m_keyCodes[width][height] >> 8 & 0xFF);
-                payload.push_back(RGBGetRValue(colors[width + (height * getKeyMap().m_width)]));
-                payload.push_back(RGBGetGValue(colors[width + (height * getKeyMap().m_width)]));
-                payload.push_back(RGBGetBValue(colors[width + (height * getKeyMap().m_width)]));
+    m_packet = serializeToBuffer(LENOVO_SPECTRUM_OPERATION_TYPE::AuroraSendBitmap,{},payload);
+}
 
-            }
-        }
-        return payload;
-    }()));
+const LenovoUSBController::ByteArray &LenovoUSBControllerC9xx::DirectBitmap::encode(const std::vector<RGBColor> &colors)
+{
+    const size_t leds = std::min(m_leds,colors.size());
+
+    for(size_t i = 0; i < leds; ++i)
+    {
+        uint8_t* entry = m_packet.data() + HEADER_SIZE + i * ENTRY_SIZE;
+
+        entry[2] = RGBGetRValue(colors[i]);
+        entry[3] = RGBGetGValue(colors[i]);
+        entry[4] = RGBGetBValue(colors[i]);
+    }
+
+    return m_packet;
+}
+
+size_t LenovoUSBControllerC9xx::DirectBitmap::size() const
+{
+    return m_leds;
 }
 
 }
@@ -17,8 +17,35 @@ class LenovoUSBControllerC9xx : public LenovoUSBController
 {
 public:
 
+    /*
+     * AuroraSendBitmap report, key codes are written once and only colors are patched per frame
+     */
+    class DirectBitmap
+    {
+    public:
+
+        /*
+         * Key codes in LED order
+         */
+        explicit DirectBitmap(const std::vector<uint16_t>& keyCodes);
+
+        const ByteArray&    encode(const std::vector<RGBColor> &colors);
+
+        size_t              size() const;
+
+    private:
 
-    LenovoUSBControllerC9xx(hid_device* dev_handle, const char* path, uint16_t in_pid,uint16_t in_vid);
+        static constexpr size_t HEADER_SIZE = 4;
+        static constexpr size_t ENTRY_SIZE  = 5;        // Key code LSB, MSB, R, G, B
+
+        const size_t            m_leds;
+        ByteArray               m_packet;
+    };
+
+public:
+
+
+    LenovoUSBControllerC9xx(std::unique_ptr<HIDTransport> transport, const char* path, uint16_t in_pid,uint16_t in_vid);
 
 
     /*
@@ -30,6 +57,9 @@ public:
 
     void setLedsDirectOff(uint8_t profile_id);
 
+private:
+
+    DirectBitmap m_directBitmap;
 };
 
 }
@@ -7,6 +7,7 @@
  */
 #include "LenovoRGBControllerC9xx.h"
 #include "LenovoRGBControllerC197.h"
+#include "HIDTransportHidApi.h"
 
 #include "RGBControllerDetector.h"
 
@@ -24,7 +25,7 @@ RGBController * DetectLenovoLegionUSBControllersC9xx(const hid_device_info& info
 
     if(dev)
     {
-        LenovoRGBController*     rgb_controller  = new LenovoRGBControllerC9xx(new LenovoUSBControllerC9xx(dev, info.path, info.product_id,info.vendor_id));
+        LenovoRGBController*     rgb_controller  = new LenovoRGBControllerC9xx(new LenovoUSBControllerC9xx(std::make_unique<HIDTransportHidApi>(dev), info.path, info.product_id,info.vendor_id));
         rgb_controller->GetName()                     = name;
 
         return rgb_controller;
@@ -42,7 +43,7 @@ RGBController * DetectLenovoLegionUSBControllersC197(const hid_device_info& info
 
     if(dev)
     {
-        LenovoRGBController*     rgb_controller  = new LenovoRGBControllerC197(new LenovoUSBController(dev, info.path, info.product_id,info.vendor_id));
+        LenovoRGBController*     rgb_controller  = new LenovoRGBControllerC197(new LenovoUSBController(std::make_unique<HIDTransportHidApi>(dev), info.path, info.product_id,info.vendor_id));
         rgb_controller->GetName()                     = name;
 
         return rgb_controller;
@@ -10,6 +10,8 @@
 
 #include "RGBController.h"
 
+#include <Core/LoggerHolder.h>
+
 namespace LenovoLegionDaemon {
 
 RGBController::RGBController(const Profiles&            profiles,
@@ -44,6 +46,7 @@ RGBController::RGBController(const Profiles&            profiles,
             return leds;
         }(zones)
     ),
+    m_index(m_leds,m_modes),
     m_maxEffects(maxEffects),
     m_hasLogo(hasLogo),
     m_logoState(false)
@@ -84,15 +87,14 @@ std::string RGBController::GetModeNameByIdx(unsigned int mode) const
 
 mode RGBController::GetModeByModeValue(int mode) const
 {
-    for (const auto & m : m_modes)
+    const std::optional<size_t> idx = m_index.modeByValue(mode);
+
+    if(!idx)
     {
-        if(m.value == mode)
-        {
-            return m;
-        }
+        throw std::out_of_range("Mode value not found");
     }
 
-    throw std::out_of_range("Mode value not found");
+    return m_modes[*idx];
 }
 
 mode RGBController::GetModeByIdx(unsigned int mode) const
@@ -189,24 +191,31 @@ void RGBController::ResetEffectsToDefault()
     DeviceResetEffectsToDefault();
 }
 
-std::set<int> RGBController::GetLedsIndexesByDeviceSpecificValue(unsigned int value) const
+std::span<const int> RGBController::GetLedsIndexesByDeviceSpecificValue(unsigned int value) const
 {
-    std::set<int> indices;
+    return m_index.ledsByValue(value);
+}
 
-    for(std::size_t i = 0; i < m_leds.size(); i++)
-    {
-        if(m_leds[i].value == value)
-        {
-            indices.insert((int)i);
-        }
-    }
+std::vector<RGBColor> RGBController::GetStateForAllLeds() const
+{
+    return m_ledState.state();
+}
 
-    return indices;
+quint64 RGBController::GetLedStateVersion() const
+{
+    return m_ledState.version();
 }
 
-std::vector<RGBColor> RGBController::GetStateForAllLeds() const
+void RGBController::UpdateLedState(const std::vector<RGBColor> &state)
 {
-    return DeviceGetState();
+    const std::optional<RGBLedStateCache::Diff> diff = m_ledState.update(state);
+
+    if(diff)
+    {
+        LOG_T(QString(__PRETTY_FUNCTION__) + QString(":  LED state version %1, %2 LEDs changed").arg(diff->m_version).arg(diff->m_full ? diff->m_colors.size() : diff->m_indexes.size()));
+
+        emit ledStateChanged(*diff);
+    }
 }
 
 bool RGBController::HasLogo() const
@@ -9,6 +9,10 @@
 #pragma once
 
 #include "RGBControllerInterface.h"
+#include "RGBControllerIndex.h"
+#include "RGBDirectModeEngine.h"
+#include "RGBLedStateCache.h"
+#include "RGBControlers/HIDWorker.h"
 
 namespace LenovoLegionDaemon {
 
@@ -107,12 +111,13 @@ public:
      */
     virtual const std::vector<led>&       GetLEDs()                                               const  override;
     virtual std::string                   GetLEDName(unsigned int led)                            const  override;
-    virtual std::set<int>                 GetLedsIndexesByDeviceSpecificValue(unsigned int value) const  override;
+    virtual std::span<const int>          GetLedsIndexesByDeviceSpecificValue(unsigned int value) const  override;
 
     /*
-     * Get current colors for all LEDs
+     * Get current colors for all LEDs, served from LED state cache
      */
     virtual std::vector<RGBColor>         GetStateForAllLeds()                                    const override;
+    quint64                               GetLedStateVersion()                                    const;
 
 
     /*
@@ -139,6 +144,11 @@ public:
 
     virtual void        DeviceRefresh(int expectedProfile = -1) =   0;
 
+    /*
+     * Profile switch is confirmed asynchronously, profileSettled is emitted when done
+     */
+    virtual bool        DeviceIsProfileSwitchPending() const    =   0;
+
     virtual std::vector<RGBColor>        DeviceGetState() const =   0;
 
     virtual uint16_t                GetVendorID()         const   = 0;
@@ -147,6 +157,33 @@ public:
     virtual void                    DeviceUpdateLogoState()       = 0;
     virtual void                    DeviceRefreshLogoState()      = 0;
 
+    /*
+     * Direct mode, software effect rendered by daemon replaces profile effects until stopped,
+     * devices started with the same epoch render the same phase
+     */
+    virtual bool                    DeviceSupportsDirectMode()    const = 0;
+    virtual bool                    DeviceIsDirectModeActive()    const = 0;
+    virtual void                    DeviceStartDirectMode(std::unique_ptr<RGBDirectModeEngine::Effect> effect,RGBDirectModeEngine::Clock::time_point epoch = RGBDirectModeEngine::Clock::now()) = 0;
+    virtual void                    DeviceStopDirectMode()        = 0;
+    virtual RGBDirectModeEngine::Statistics DeviceGetDirectModeStatistics() const = 0;
+
+    /*
+     * Queue of HID worker thread
+     */
+    virtual HIDWorker::Statistics   DeviceGetTransportStatistics() const = 0;
+
+signals:
+
+    void profileSettled(unsigned int profile);
+    void ledStateChanged(const LenovoLegionDaemon::RGBLedStateCache::Diff& diff);
+
+protected:
+
+    /*
+     * Stores state read from device, ledStateChanged is emitted when it differs
+     */
+    void                  UpdateLedState(const std::vector<RGBColor>& state);
+
 protected:
 
     Profiles             m_profiles         = {0,0,0};              /* Supported Device Profiles*/
@@ -170,6 +207,11 @@ protected:
      */
     const std::vector<led>         m_leds;           /* LEDs                     */
 
+    /*
+     * Value to index lookups, built once from modes and LEDs
+     */
+    const RGBControllerIndex       m_index;
+
     /*
      * Profile effects
      */
@@ -181,6 +223,10 @@ protected:
      */
     const bool                      m_hasLogo;       /* Whether the device has a logo zone */
           bool                      m_logoState;     /* Current state of the logo zone      */
+
+private:
+
+    RGBLedStateCache                m_ledState;
 };
 
 }
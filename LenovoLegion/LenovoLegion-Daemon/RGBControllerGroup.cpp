@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "RGBControllerGroup.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace LenovoLegionDaemon {
+
+void RGBControllerGroup::add(std::unique_ptr<RGBController> controller)
+{
+    LOG_D(QString(__PRETTY_FUNCTION__) + QString(" - Controller %1 at %2 added to group as %3").arg(controller->GetName().c_str()).arg(controller->GetLocation().c_str()).arg(m_controllers.empty() ? "primary" : "secondary"));
+
+    m_controllers.push_back(std::move(controller));
+}
+
+void RGBControllerGroup::clear()
+{
+    m_controllers.clear();
+}
+
+bool RGBControllerGroup::empty() const
+{
+    return m_controllers.empty();
+}
+
+size_t RGBControllerGroup::size() const
+{
+    return m_controllers.size();
+}
+
+RGBController &RGBControllerGroup::primary() const
+{
+    return *m_controllers.front();
+}
+
+const std::vector<std::unique_ptr<RGBController>> &RGBControllerGroup::controllers() const
+{
+    return m_controllers;
+}
+
+void RGBControllerGroup::setProfile(unsigned int profile)
+{
+    for(const auto& controller : m_controllers)
+    {
+        applyProfile(*controller,profile);
+    }
+}
+
+void RGBControllerGroup::setBrightness(unsigned int brightness)
+{
+    const double level = brightnessLevel(brightness);
+
+    for(const auto& controller : m_controllers)
+    {
+        applyBrightness(*controller,level);
+    }
+}
+
+void RGBControllerGroup::setEffects(const std::vector<led_group_effect> &effects)
+{
+    for(const auto& controller : m_controllers)
+    {
+        controller->SetEfects(effects);
+        controller->DeviceUpdateEfects();
+    }
+}
+
+void RGBControllerGroup::resetEffectsToDefault()
+{
+    for(const auto& controller : m_controllers)
+    {
+        controller->DeviceResetEffectsToDefault();
+    }
+}
+
+void RGBControllerGroup::setLogoState(bool on)
+{
+    for(const auto& controller : m_controllers)
+    {
+        if(controller->HasLogo())
+        {
+            controller->SetLogoState(on);
+            controller->DeviceUpdateLogoState();
+        }
+    }
+}
+
+void RGBControllerGroup::startDirectMode(const EffectFactory &factory)
+{
+    const RGBDirectModeEngine::Clock::time_point epoch   = RGBDirectModeEngine::Clock::now();
+    size_t                                       started = 0;
+
+    try {
+        for(const auto& controller : m_controllers)
+        {
+            if(controller->DeviceSupportsDirectMode())
+            {
+                controller->DeviceStartDirectMode(factory(),epoch);
+                ++started;
+            }
+        }
+    } catch(...)
+    {
+        stopDirectMode();
+        throw;
+    }
+
+    if(started == 0)
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::DIRECT_MODE_NOT_SUPPORTED, "Direct mode is not supported by any controller !");
+    }
+}
+
+void RGBControllerGroup::stopDirectMode()
+{
+    for(const auto& controller : m_controllers)
+    {
+        controller->DeviceStopDirectMode();
+    }
+}
+
+void RGBControllerGroup::refresh(int expectedProfile)
+{
+    for(const auto& controller : m_controllers)
+    {
+        controller->DeviceRefresh(expectedProfile);
+    }
+}
+
+void RGBControllerGroup::refreshBrightness()
+{
+    for(const auto& controller : m_controllers)
+    {
+        controller->DeviceRefreshBrightness();
+    }
+}
+
+void RGBControllerGroup::refreshLogoState()
+{
+    for(const auto& controller : m_controllers)
+    {
+        controller->DeviceRefreshLogoState();
+    }
+}
+
+void RGBControllerGroup::followPrimaryBrightness()
+{
+    primary().DeviceRefreshBrightness();
+
+    const double level = brightnessLevel(primary().GetBrightness().active);
+
+    for(size_t i = 1; i < m_controllers.size(); ++i)
+    {
+        applyBrightness(*m_controllers[i],level);
+    }
+}
+
+void RGBControllerGroup::followPrimaryProfile(unsigned int profile)
+{
+    primary().DeviceRefresh(static_cast<int>(profile));
+
+    for(size_t i = 1; i < m_controllers.size(); ++i)
+    {
+        applyProfile(*m_controllers[i],profile);
+    }
+}
+
+void RGBControllerGroup::applyProfile(RGBController &controller, unsigned int profile)
+{
+    const Profiles& profiles = controller.GetProfiles();
+
+    if(profile < profiles.min || profile > profiles.max)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + QString(" - Profile %1 not supported by %2, skipped").arg(profile).arg(controller.GetLocation().c_str()));
+        return;
+    }
+
+    if(profiles.active != profile)
+    {
+        LOG_D(QString("Changing profile of %1 from %2 to %3").arg(controller.GetLocation().c_str()).arg(profiles.active).arg(profile));
+
+        controller.SetProfile(profile);
+        controller.DeviceUpdateProfile();
+    }
+}
+
+void RGBControllerGroup::applyBrightness(RGBController &controller, double level)
+{
+    const Brightnesses& brightnesses = controller.GetBrightness();
+    const unsigned int  brightness   = brightnesses.min + static_cast<unsigned int>(std::lround(level * (brightnesses.max - brightnesses.min)));
+
+    if(brightnesses.active != brightness)
+    {
+        LOG_D(QString("Changing brightness of %1 from %2 to %3").arg(controller.GetLocation().c_str()).arg(brightnesses.active).arg(brightness));
+
+        controller.SetBrightness(brightness);
+        controller.DeviceUpdateBrightness();
+    }
+}
+
+double RGBControllerGroup::brightnessLevel(unsigned int brightness) const
+{
+    const Brightnesses& range = primary().GetBrightness();
+
+    return range.max > range.min ? std::clamp((static_cast<double>(brightness) - range.min) / (range.max - range.min),0.0,1.0) : 1.0;
+}
+
+}
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBController.h"
+
+#include <Core/ExceptionBuilder.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Detected RGB controllers driven as one device
+ *
+ * First controller is primary, clients see its description, layout and state. Every change
+ * is applied to all controllers. Updates only queue reports to HID worker of the controller,
+ * so all devices are written in parallel. Profile is applied where it is in range, brightness
+ * is scaled to range of the controller. Direct mode effect is created per controller and all
+ * engines share one epoch, so animations stay in phase across devices.
+ */
+class RGBControllerGroup
+{
+public:
+
+    DEFINE_EXCEPTION(RGBControllerGroup);
+
+    enum ERROR_CODES : int {
+        DIRECT_MODE_NOT_SUPPORTED = -1
+    };
+
+    /*
+     * Called once per controller, effects may share their input
+     */
+    using EffectFactory = std::function<std::unique_ptr<RGBDirectModeEngine::Effect> ()>;
+
+public:
+
+    RGBControllerGroup() = default;
+
+    RGBControllerGroup(const RGBControllerGroup&)            = delete;
+    RGBControllerGroup& operator=(const RGBControllerGroup&) = delete;
+
+    void                add(std::unique_ptr<RGBController> controller);
+    void                clear();
+
+    bool                empty() const;
+    size_t              size()  const;
+
+    /*
+     * Group must not be empty
+     */
+    RGBController&      primary() const;
+
+    const std::vector<std::unique_ptr<RGBController>>& controllers() const;
+
+    /*
+     * Values are in range of primary controller, controller which has them already is not written
+     */
+    void setProfile(unsigned int profile);
+    void setBrightness(unsigned int brightness);
+    void setEffects(const std::vector<led_group_effect>& effects);
+    void resetEffectsToDefault();
+    void setLogoState(bool on);
+
+    /*
+     * Starts on every controller supporting direct mode, already started ones are stopped
+     * when one fails
+     */
+    void startDirectMode(const EffectFactory& factory);
+    void stopDirectMode();
+
+    void refresh(int expectedProfile = -1);
+    void refreshBrightness();
+    void refreshLogoState();
+
+    /*
+     * Primary changed by its hardware keys, other controllers follow it
+     */
+    void followPrimaryBrightness();
+    void followPrimaryProfile(unsigned int profile);
+
+private:
+
+    static void applyProfile(RGBController& controller,unsigned int profile);
+    static void applyBrightness(RGBController& controller,double level);
+
+    /*
+     * 0 - 1 in range of primary
+     */
+    double      brightnessLevel(unsigned int brightness) const;
+
+private:
+
+    std::vector<std::unique_ptr<RGBController>> m_controllers;
+};
+
+}
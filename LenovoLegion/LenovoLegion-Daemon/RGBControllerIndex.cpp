@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "RGBControllerIndex.h"
+
+#include <algorithm>
+
+namespace LenovoLegionDaemon {
+
+RGBControllerIndex::RGBControllerIndex(const std::vector<led> &leds, const std::vector<mode> &modes)
+{
+    m_ledIndexes.resize(leds.size());
+
+    for(size_t i = 0; i < leds.size(); ++i)
+    {
+        m_ledIndexes[i] = static_cast<int>(i);
+    }
+
+    /*
+     * Same values next to each other, LED order kept inside the group
+     */
+    std::stable_sort(m_ledIndexes.begin(),m_ledIndexes.end(),[&leds](int a,int b) { return leds[a].value < leds[b].value; });
+
+    m_ledRanges.reserve(leds.size());
+
+    for(size_t i = 0; i < m_ledIndexes.size(); ++i)
+    {
+        auto [range,inserted] = m_ledRanges.try_emplace(leds[m_ledIndexes[i]].value,Range{static_cast<quint32>(i),0});
+
+        ++range->second.m_count;
+    }
+
+    m_modeIndexes.reserve(modes.size());
+
+    for(size_t i = 0; i < modes.size(); ++i)
+    {
+        m_modeIndexes.try_emplace(modes[i].value,i);
+    }
+}
+
+std::span<const int> RGBControllerIndex::ledsByValue(unsigned int value) const
+{
+    const auto range = m_ledRanges.find(value);
+
+    if(range == m_ledRanges.end())
+    {
+        return {};
+    }
+
+    return std::span<const int>(m_ledIndexes).subspan(range->second.m_offset,range->second.m_count);
+}
+
+std::optional<size_t> RGBControllerIndex::modeByValue(int value) const
+{
+    const auto index = m_modeIndexes.find(value);
+
+    if(index == m_modeIndexes.end())
+    {
+        return std::nullopt;
+    }
+
+    return index->second;
+}
+
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBControllerInterface.h"
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Lookups from device specific values to LED and mode indexes
+ *
+ * Built once from LED and mode lists of the controller. LED indexes are kept in one
+ * flat vector grouped by device value, every value points to its range, so a lookup
+ * returns a view without allocation. Index has to be rebuilt when the lists change.
+ */
+class RGBControllerIndex
+{
+public:
+
+    RGBControllerIndex() = default;
+    RGBControllerIndex(const std::vector<led>& leds,const std::vector<mode>& modes);
+
+    /*
+     * Indexes into LED list in ascending order, empty for unknown value
+     */
+    std::span<const int>        ledsByValue(unsigned int value) const;
+
+    /*
+     * Index into mode list
+     */
+    std::optional<size_t>       modeByValue(int value)          const;
+
+private:
+
+    struct Range {
+        quint32 m_offset;
+        quint32 m_count;
+    };
+
+    std::vector<int>                        m_ledIndexes;
+    std::unordered_map<unsigned int,Range>  m_ledRanges;
+    std::unordered_map<int,size_t>          m_modeIndexes;
+};
+
+}
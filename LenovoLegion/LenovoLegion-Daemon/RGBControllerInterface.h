@@ -10,6 +10,7 @@
 #include <QString>
 #include <QObject>
 
+#include <span>
 #include <string>
 #include <vector>
 #include <set>
@@ -313,7 +314,7 @@ public:
      */
     virtual const std::vector<led>&       GetLEDs() const                                                       = 0;
     virtual std::string                   GetLEDName(unsigned int led)        const                             = 0;
-    virtual std::set<int>                 GetLedsIndexesByDeviceSpecificValue(unsigned int value)   const       = 0;
+    virtual std::span<const int>          GetLedsIndexesByDeviceSpecificValue(unsigned int value)   const       = 0;
 
 
     /*
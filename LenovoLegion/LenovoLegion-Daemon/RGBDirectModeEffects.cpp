@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "RGBDirectModeEffects.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LenovoLegionDaemon {
+
+RGBDirectModeStaticEffect::RGBDirectModeStaticEffect(const std::vector<RGBColor> &colors) :
+    m_colors(colors)
+{}
+
+void RGBDirectModeStaticEffect::render(RGBDirectModeEngine::Clock::duration, const RGBDirectModeEngine::Layout &, std::vector<RGBColor> &frame)
+{
+    if(m_colors.size() == 1)
+    {
+        std::fill(frame.begin(),frame.end(),m_colors.front());
+        return;
+    }
+
+    for(size_t i = 0; i < frame.size(); ++i)
+    {
+        frame[i] = i < m_colors.size() ? m_colors[i] : 0;
+    }
+}
+
+RGBDirectModeRainbowWaveEffect::RGBDirectModeRainbowWaveEffect(unsigned int speed) :
+    m_speed(std::max(1U,speed))
+{}
+
+void RGBDirectModeRainbowWaveEffect::render(RGBDirectModeEngine::Clock::duration time, const RGBDirectModeEngine::Layout &layout, std::vector<RGBColor> &frame)
+{
+    const double width  = std::max(1U,layout.m_width);
+    const double offset = std::chrono::duration<double>(time).count() * m_speed / width;
+
+    for(size_t i = 0; i < frame.size(); ++i)
+    {
+        frame[i] = fromHue(std::fmod(layout.m_positions[i].m_x / width + offset,1.0));
+    }
+}
+
+RGBDirectModeAudioSpectrumEffect::RGBDirectModeAudioSpectrumEffect(std::shared_ptr<const RGBAudioSpectrum> spectrum) :
+    m_spectrum(std::move(spectrum)),
+    m_lastRender(0),
+    m_blocks(0)
+{}
+
+void RGBDirectModeAudioSpectrumEffect::render(RGBDirectModeEngine::Clock::duration time, const RGBDirectModeEngine::Layout &layout, std::vector<RGBColor> &frame)
+{
+    const RGBAudioSpectrum::Snapshot snapshot = m_spectrum->snapshot();
+    const unsigned int               width    = std::max(1U,layout.m_width);
+    const unsigned int               height   = std::max(1U,layout.m_height);
+    const double                     elapsed  = std::chrono::duration<double>(time - m_lastRender).count();
+
+    m_columns.resize(width,0.0);
+    m_peaks.resize(width,0.0);
+
+    /*
+     * Band levels interpolated at column centers
+     */
+    for(unsigned int x = 0; x < width; ++x)
+    {
+        const double position = std::clamp((x + 0.5) * RGBAudioSpectrum::BANDS / width - 0.5,0.0,RGBAudioSpectrum::BANDS - 1.0);
+        const size_t band     = static_cast<size_t>(position);
+        const size_t next     = std::min(band + 1,RGBAudioSpectrum::BANDS - 1);
+        const double fraction = position - band;
+
+        m_columns[x] = snapshot.m_levels[band] * (1.0 - fraction) + snapshot.m_levels[next] * fraction;
+        m_peaks[x]   = std::max(m_columns[x],m_peaks[x] - PEAK_FALL * elapsed);
+    }
+
+    for(size_t i = 0; i < frame.size(); ++i)
+    {
+        const unsigned int x    = std::min(layout.m_positions[i].m_x,width - 1);
+        const unsigned int row  = height - 1 - std::min(layout.m_positions[i].m_y,height - 1);     // From bottom
+        const int          peak = static_cast<int>(std::ceil(m_peaks[x] * height)) - 1;
+
+        if(static_cast<int>(row) == peak)
+        {
+            frame[i] = ToRGBColor(255U,255U,255U);
+        }
+        else if(row < m_columns[x] * height)
+        {
+            frame[i] = RGBDirectModeRainbowWaveEffect::fromHue((1.0 - static_cast<double>(row) / std::max(1U,height - 1)) / 3.0);
+        }
+        else
+        {
+            frame[i] = 0;
+        }
+    }
+
+    m_lastRender = time;
+    m_inputTime  = snapshot.m_blocks != m_blocks ? std::optional(snapshot.m_captured) : std::nullopt;
+    m_blocks     = snapshot.m_blocks;
+}
+
+std::optional<RGBDirectModeEngine::Clock::time_point> RGBDirectModeAudioSpectrumEffect::inputTime() const
+{
+    return m_inputTime;
+}
+
+RGBColor RGBDirectModeMetricEffect::Gradient::at(double position) const
+{
+    if(m_stops.empty())
+    {
+        return 0;
+    }
+
+    const auto next = std::find_if(m_stops.begin(),m_stops.end(),[position](const Stop& stop) { return stop.m_position > position; });
+
+    if(next == m_stops.begin())
+    {
+        return m_stops.front().m_color;
+    }
+
+    if(next == m_stops.end())
+    {
+        return m_stops.back().m_color;
+    }
+
+    const Stop&  low      = *(next - 1);
+    const double fraction = (position - low.m_position) / (next->m_position - low.m_position);
+    const auto   mix      = [fraction](unsigned int a,unsigned int b) { return static_cast<unsigned int>(std::lround(a + (static_cast<double>(b) - a) * fraction)); };
+
+    return ToRGBColor(mix(RGBGetRValue(low.m_color),RGBGetRValue(next->m_color)),
+                      mix(RGBGetGValue(low.m_color),RGBGetGValue(next->m_color)),
+                      mix(RGBGetBValue(low.m_color),RGBGetBValue(next->m_color)));
+}
+
+void RGBDirectModeMetricEffect::Levels::set(std::vector<std::optional<double>> levels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_sample.m_levels = std::move(levels);
+    m_sample.m_time   = RGBDirectModeEngine::Clock::now();
+    ++m_sample.m_sequence;
+}
+
+RGBDirectModeMetricEffect::Levels::Sample RGBDirectModeMetricEffect::Levels::get() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_sample;
+}
+
+RGBDirectModeMetricEffect::RGBDirectModeMetricEffect(std::vector<Binding> bindings, std::shared_ptr<const Levels> levels, std::chrono::milliseconds interval) :
+    m_bindings(std::move(bindings)),
+    m_levels(std::move(levels)),
+    m_interval(interval),
+    m_sequence(0)
+{}
+
+void RGBDirectModeMetricEffect::render(RGBDirectModeEngine::Clock::duration, const RGBDirectModeEngine::Layout &layout, std::vector<RGBColor> &frame)
+{
+    const Levels::Sample sample = m_levels->get();
+    const unsigned int   width  = std::max(1U,layout.m_width);
+
+    std::fill(frame.begin(),frame.end(),0);
+
+    /*
+     * Later binding is drawn over earlier one
+     */
+    for(size_t binding = 0; binding < m_bindings.size(); ++binding)
+    {
+        if(binding >= sample.m_levels.size() || !sample.m_levels[binding])
+        {
+            continue;
+        }
+
+        const double level = std::round(std::clamp(*sample.m_levels[binding],0.0,1.0) * GRADIENT_STEPS) / GRADIENT_STEPS;
+
+        switch (m_bindings[binding].m_target) {
+        case Binding::ALL_KEYS:
+            std::fill(frame.begin(),frame.end(),m_bindings[binding].m_gradient.at(level));
+            break;
+        case Binding::ROW_BAR:
+            for(size_t i = 0; i < frame.size(); ++i)
+            {
+                if(layout.m_positions[i].m_y == m_bindings[binding].m_row)
+                {
+                    const double position = (layout.m_positions[i].m_x + 0.5) / width;
+
+                    frame[i] = position <= level ? m_bindings[binding].m_gradient.at(position) : 0;
+                }
+            }
+            break;
+        }
+    }
+
+    m_inputTime = sample.m_sequence != m_sequence ? std::optional(sample.m_time) : std::nullopt;
+    m_sequence  = sample.m_sequence;
+}
+
+std::optional<RGBDirectModeEngine::Clock::time_point> RGBDirectModeMetricEffect::inputTime() const
+{
+    return m_inputTime;
+}
+
+std::optional<RGBDirectModeEngine::Clock::duration> RGBDirectModeMetricEffect::interval() const
+{
+    return m_interval;
+}
+
+RGBColor RGBDirectModeRainbowWaveEffect::fromHue(double hue)
+{
+    const double       h = hue * 6.0;
+    const unsigned int x = static_cast<unsigned int>((1.0 - std::fabs(std::fmod(h,2.0) - 1.0)) * 255.0);
+
+    switch (static_cast<int>(h) % 6) {
+    case 0:  return ToRGBColor(255U,x,0U);
+    case 1:  return ToRGBColor(x,255U,0U);
+    case 2:  return ToRGBColor(0U,255U,x);
+    case 3:  return ToRGBColor(0U,x,255U);
+    case 4:  return ToRGBColor(x,0U,255U);
+    default: return ToRGBColor(255U,0U,x);
+    }
+}
+
+}
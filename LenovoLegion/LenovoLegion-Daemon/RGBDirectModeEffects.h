@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBDirectModeEngine.h"
+#include "RGBAudioSpectrum.h"
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Same frame every time, one color for all LEDs or one color per LED
+ */
+class RGBDirectModeStaticEffect : public RGBDirectModeEngine::Effect
+{
+public:
+
+    explicit RGBDirectModeStaticEffect(const std::vector<RGBColor>& colors);
+
+    void render(RGBDirectModeEngine::Clock::duration time,const RGBDirectModeEngine::Layout& layout,std::vector<RGBColor>& frame) override;
+
+private:
+
+    const std::vector<RGBColor> m_colors;
+};
+
+/*
+ * Hue moving along matrix columns
+ */
+class RGBDirectModeRainbowWaveEffect : public RGBDirectModeEngine::Effect
+{
+public:
+
+    /*
+     * Speed in columns per second
+     */
+    explicit RGBDirectModeRainbowWaveEffect(unsigned int speed);
+
+    void render(RGBDirectModeEngine::Clock::duration time,const RGBDirectModeEngine::Layout& layout,std::vector<RGBColor>& frame) override;
+
+    static RGBColor fromHue(double hue);
+
+private:
+
+    const unsigned int m_speed;
+};
+
+/*
+ * Spectrum bars of audio source, one matrix column per frequency range
+ *
+ * Bands are spread over matrix width, low frequencies on the left. Bar grows from the
+ * bottom row, green to red, white peak falls slowly after the bar. One spectrum can feed
+ * effects of several devices.
+ */
+class RGBDirectModeAudioSpectrumEffect : public RGBDirectModeEngine::Effect
+{
+public:
+
+    static constexpr double PEAK_FALL = 1.5;        // Matrix heights per second
+
+    explicit RGBDirectModeAudioSpectrumEffect(std::shared_ptr<const RGBAudioSpectrum> spectrum);
+
+    void render(RGBDirectModeEngine::Clock::duration time,const RGBDirectModeEngine::Layout& layout,std::vector<RGBColor>& frame) override;
+
+    std::optional<RGBDirectModeEngine::Clock::time_point> inputTime() const override;
+
+private:
+
+    const std::shared_ptr<const RGBAudioSpectrum>           m_spectrum;
+
+    std::vector<double>                                     m_columns;
+    std::vector<double>                                     m_peaks;
+    RGBDirectModeEngine::Clock::duration                    m_lastRender;
+    quint64                                                 m_blocks;
+    std::optional<RGBDirectModeEngine::Clock::time_point>   m_inputTime;
+};
+
+/*
+ * System metrics shown through color gradients, levels are sampled elsewhere
+ *
+ * Frame is rendered once per sampling interval. Levels are quantized to GRADIENT_STEPS,
+ * so noise of a sensor does not change colors and unchanged frame is not sent by engine.
+ */
+class RGBDirectModeMetricEffect : public RGBDirectModeEngine::Effect
+{
+public:
+
+    static constexpr unsigned int GRADIENT_STEPS = 32;
+
+    struct Gradient {
+
+        struct Stop {
+            double      m_position;     // 0 - 1
+            RGBColor    m_color;
+        };
+
+        std::vector<Stop>   m_stops;    // Ascending positions
+
+        RGBColor at(double position) const;
+    };
+
+    struct Binding {
+
+        enum Target {
+            ALL_KEYS,                   // Every key has color of level
+            ROW_BAR                     // Keys of row lit from the left up to level
+        };
+
+        Target          m_target    = ALL_KEYS;
+        unsigned int    m_row       = 0;
+        Gradient        m_gradient;
+    };
+
+    /*
+     * Normalized level per binding, written by sampler and read on engine thread
+     */
+    class Levels
+    {
+    public:
+
+        struct Sample {
+            std::vector<std::optional<double>>      m_levels;           // Nothing when metric is not available
+            RGBDirectModeEngine::Clock::time_point  m_time;
+            quint64                                 m_sequence = 0;
+        };
+
+        void    set(std::vector<std::optional<double>> levels);
+        Sample  get() const;
+
+    private:
+
+        mutable std::mutex  m_mutex;
+        Sample              m_sample;
+    };
+
+public:
+
+    RGBDirectModeMetricEffect(std::vector<Binding> bindings,std::shared_ptr<const Levels> levels,std::chrono::milliseconds interval);
+
+    void render(RGBDirectModeEngine::Clock::duration time,const RGBDirectModeEngine::Layout& layout,std::vector<RGBColor>& frame) override;
+
+    std::optional<RGBDirectModeEngine::Clock::time_point> inputTime() const override;
+    std::optional<RGBDirectModeEngine::Clock::duration>   interval()  const override;
+
+private:
+
+    const std::vector<Binding>                              m_bindings;
+    const std::shared_ptr<const Levels>                     m_levels;
+    const std::chrono::milliseconds                         m_interval;
+
+    quint64                                                 m_sequence;
+    std::optional<RGBDirectModeEngine::Clock::time_point>   m_inputTime;
+};
+
+}
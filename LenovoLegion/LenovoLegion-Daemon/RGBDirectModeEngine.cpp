@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "RGBDirectModeEngine.h"
+#include "RGBControllerKeyNames.h"
+
+#include <Core/LoggerHolder.h>
+#include <Core/ExceptionBuilder.h>
+
+#include <algorithm>
+
+namespace LenovoLegionDaemon {
+
+RGBDirectModeEngine::Layout RGBDirectModeEngine::Layout::fromZones(const std::vector<zone> &zones, size_t leds)
+{
+    Layout layout;
+
+    layout.m_positions.resize(leds,{0,0});
+
+    for(const auto& zone : zones)
+    {
+        if(zone.type != ZONE_TYPE_MATRIX)
+        {
+            continue;
+        }
+
+        layout.m_width  = std::max(layout.m_width,zone.matrix_map.width);
+        layout.m_height = std::max(layout.m_height,zone.matrix_map.height);
+
+        for(unsigned int y = 0; y < zone.matrix_map.height; ++y)
+        {
+            for(unsigned int x = 0; x < zone.matrix_map.width; ++x)
+            {
+                const unsigned int index = zone.matrix_map.map.at(y * zone.matrix_map.width + x);
+
+                if(index != NA && zone.start_idx + index < leds)
+                {
+                    layout.m_positions[zone.start_idx + index] = {x,y};
+                }
+            }
+        }
+    }
+
+    return layout;
+}
+
+RGBDirectModeEngine::RGBDirectModeEngine(const Layout &layout, FrameSink sink, std::chrono::microseconds interval) :
+    m_layout(layout),
+    m_sink(std::move(sink)),
+    m_interval(interval),
+    m_stop(false)
+{}
+
+RGBDirectModeEngine::~RGBDirectModeEngine()
+{
+    stop();
+}
+
+void RGBDirectModeEngine::start(std::unique_ptr<Effect> effect,Clock::time_point epoch)
+{
+    stop();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_statistics = {};
+    }
+
+    m_stop   = false;
+    m_thread = std::thread(&RGBDirectModeEngine::run,this,std::move(effect),epoch);
+}
+
+void RGBDirectModeEngine::stop()
+{
+    if(!m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeUp.notify_all();
+
+    m_thread.join();
+}
+
+bool RGBDirectModeEngine::isRunning() const
+{
+    return m_thread.joinable() && !m_stop;
+}
+
+RGBDirectModeEngine::Statistics RGBDirectModeEngine::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_statistics;
+}
+
+void RGBDirectModeEngine::run(std::unique_ptr<Effect> effect,Clock::time_point epoch)
+{
+    std::vector<RGBColor>           frame(m_layout.m_positions.size(),0);
+    std::vector<RGBColor>           lastSent;
+    const std::chrono::microseconds interval = std::max<std::chrono::microseconds>(m_interval,std::chrono::duration_cast<std::chrono::microseconds>(effect->interval().value_or(m_interval)));
+    const Clock::time_point         now      = Clock::now();
+
+    /*
+     * First slot not before now
+     */
+    Clock::time_point               next     = now <= epoch ? epoch : epoch + ((now - epoch + interval - Clock::duration(1)) / interval) * interval;
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + QString(" - Direct mode started, %1 LEDs, interval %2 us").arg(frame.size()).arg(interval.count()));
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_statistics.m_budget = interval;
+
+        m_wakeUp.wait_until(lock,next,[this]() { return m_stop.load(); });
+    }
+
+    while(!m_stop)
+    {
+        const Clock::time_point frameStart = Clock::now();
+        bool                    sent       = true;
+        bool                    unchanged  = false;
+
+        effect->render(next - epoch,m_layout,frame);
+
+        try {
+            /*
+             * Device keeps direct mode bitmap, same frame is not sent again
+             */
+            if(frame == lastSent)
+            {
+                unchanged = true;
+            }
+            else
+            {
+                m_sink(frame);
+                lastSent = frame;
+            }
+        } catch(const bj::framework::exception::Exception& ex)
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Frame not sent, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+            sent = false;
+        } catch(const std::exception& ex)
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Frame not sent, " + ex.what());
+            sent = false;
+        }
+
+        const Clock::time_point                 frameEnd = Clock::now();
+        const std::chrono::microseconds         elapsed  = std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - frameStart);
+        const std::optional<Clock::time_point>  input    = sent && !unchanged ? effect->inputTime() : std::nullopt;
+
+        next += interval;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_statistics.m_frames    += sent && !unchanged ? 1 : 0;
+        m_statistics.m_unchanged += unchanged ? 1 : 0;
+        m_statistics.m_sinkErrors+= sent ? 0 : 1;
+
+        if(!unchanged)
+        {
+            m_statistics.m_lastFrame  = elapsed;
+            m_statistics.m_maxFrame   = std::max(m_statistics.m_maxFrame,elapsed);
+        }
+
+        if(input)
+        {
+            const std::chrono::microseconds latency = std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - *input);
+
+            ++m_statistics.m_inputFrames;
+            m_statistics.m_lastInputLatency = latency;
+            m_statistics.m_maxInputLatency  = std::max(m_statistics.m_maxInputLatency,latency);
+            m_statistics.m_avgInputLatency += (latency - m_statistics.m_avgInputLatency) / static_cast<long long>(m_statistics.m_inputFrames);
+        }
+
+        /*
+         * Over budget, missed slots are dropped
+         */
+        if(next <= frameEnd)
+        {
+            const auto missed = (frameEnd - next) / interval + 1;
+
+            m_statistics.m_dropped += static_cast<quint64>(missed);
+            next                   += missed * interval;
+        }
+
+        m_wakeUp.wait_until(lock,next,[this]() { return m_stop.load(); });
+    }
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + QString(" - Direct mode stopped, %1 frames, %2 dropped").arg(m_statistics.m_frames).arg(m_statistics.m_dropped));
+}
+
+}
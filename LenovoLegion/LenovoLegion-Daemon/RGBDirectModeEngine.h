@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBControllerInterface.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Software effects rendered by the daemon and pushed to the device frame by frame
+ *
+ * Runs on its own thread. Every frame is rendered into the same buffer in LED order
+ * (GetLEDs()) and handed to the sink, which sends it as one direct mode report. Frame
+ * equal to the last sent one is not sent again. Frame which does not fit into the
+ * interval is counted as dropped and the next slot is taken, rendering never runs behind.
+ *
+ * Slots are multiples of interval from epoch and effect time is time of the slot, so
+ * engines of several devices started with the same epoch render the same phase.
+ */
+class RGBDirectModeEngine
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds FRAME_INTERVAL {25};   // 40 fps
+
+    /*
+     * Position of every LED in the matrix of its zone
+     */
+    struct Layout {
+
+        struct Position {
+            unsigned int m_x;
+            unsigned int m_y;
+        };
+
+        unsigned int            m_width  = 0;
+        unsigned int            m_height = 0;
+        std::vector<Position>   m_positions;        // Per LED
+
+        static Layout fromZones(const std::vector<zone>& zones,size_t leds);
+    };
+
+    class Effect
+    {
+    public:
+        virtual ~Effect() = default;
+
+        /*
+         * Called on engine thread, time since start, frame has one color per LED
+         */
+        virtual void render(Clock::duration time,const Layout& layout,std::vector<RGBColor>& frame) = 0;
+
+        /*
+         * Input driven effect, when input of last rendered frame was captured, nothing when frame has no new input
+         */
+        virtual std::optional<Clock::time_point> inputTime() const { return std::nullopt; }
+
+        /*
+         * Effect with slow input renders less often than engine interval
+         */
+        virtual std::optional<Clock::duration>   interval()  const { return std::nullopt; }
+    };
+
+    using FrameSink = std::function<void(const std::vector<RGBColor>& frame)>;
+
+    struct Statistics {
+        quint64                     m_frames        = 0;
+        quint64                     m_dropped       = 0;    // Slots missed because a frame took longer than interval
+        quint64                     m_sinkErrors    = 0;
+        quint64                     m_unchanged     = 0;    // Same as last sent frame, not sent
+        std::chrono::microseconds   m_lastFrame     {0};    // Render and send
+        std::chrono::microseconds   m_maxFrame      {0};
+        std::chrono::microseconds   m_budget        {0};
+
+        /*
+         * From input capture until frame was sent, input driven effects only
+         */
+        quint64                     m_inputFrames       = 0;
+        std::chrono::microseconds   m_lastInputLatency  {0};
+        std::chrono::microseconds   m_maxInputLatency   {0};
+        std::chrono::microseconds   m_avgInputLatency   {0};
+    };
+
+public:
+
+    RGBDirectModeEngine(const Layout& layout,FrameSink sink,std::chrono::microseconds interval = FRAME_INTERVAL);
+    ~RGBDirectModeEngine();
+
+    RGBDirectModeEngine(const RGBDirectModeEngine&)            = delete;
+    RGBDirectModeEngine& operator=(const RGBDirectModeEngine&) = delete;
+
+    /*
+     * Starts thread with effect, running effect is replaced
+     */
+    void        start(std::unique_ptr<Effect> effect,Clock::time_point epoch = Clock::now());
+    void        stop();
+
+    bool        isRunning()  const;
+    Statistics  statistics() const;
+
+private:
+
+    void run(std::unique_ptr<Effect> effect,Clock::time_point epoch);
+
+private:
+
+    const Layout                    m_layout;
+    const FrameSink                 m_sink;
+    const std::chrono::microseconds m_interval;
+
+    std::thread                     m_thread;
+    std::atomic<bool>               m_stop;
+
+    mutable std::mutex              m_mutex;
+    std::condition_variable         m_wakeUp;
+    Statistics                      m_statistics;
+};
+
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "RGBLedStateCache.h"
+
+namespace LenovoLegionDaemon {
+
+const std::vector<RGBColor> &RGBLedStateCache::state() const
+{
+    return m_state;
+}
+
+quint64 RGBLedStateCache::version() const
+{
+    return m_version;
+}
+
+std::optional<RGBLedStateCache::Diff> RGBLedStateCache::update(const std::vector<RGBColor> &state)
+{
+    Diff diff;
+
+    if(state.size() == m_state.size())
+    {
+        for(size_t i = 0; i < state.size(); ++i)
+        {
+            if(state[i] != m_state[i])
+            {
+                diff.m_indexes.push_back(static_cast<quint32>(i));
+                diff.m_colors.push_back(state[i]);
+            }
+        }
+
+        if(diff.m_indexes.empty())
+        {
+            return std::nullopt;
+        }
+    }
+
+    /*
+     * Index and color per LED, whole state is smaller when more than half changed
+     */
+    if(state.size() != m_state.size() || diff.m_indexes.size() * 2 > state.size())
+    {
+        diff.m_full = true;
+        diff.m_indexes.clear();
+        diff.m_colors = state;
+    }
+
+    m_state        = state;
+    diff.m_version = ++m_version;
+
+    return diff;
+}
+
+}
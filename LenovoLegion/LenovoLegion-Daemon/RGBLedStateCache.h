@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBControllerInterface.h"
+
+#include <optional>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Last known color of every LED, in LED order (GetLEDs())
+ *
+ * Every update which changes something bumps version and yields diff against previous
+ * state. Client applies diffs in version order, after a gap it reads whole state again.
+ */
+class RGBLedStateCache
+{
+public:
+
+    struct Diff {
+        quint64                 m_version   = 0;
+        bool                    m_full      = false;    // m_colors has all LEDs, m_indexes is empty
+        std::vector<quint32>    m_indexes;
+        std::vector<RGBColor>   m_colors;
+    };
+
+public:
+
+    const std::vector<RGBColor>&    state()   const;
+    quint64                         version() const;
+
+    /*
+     * Nothing when state is not changed
+     */
+    std::optional<Diff>             update(const std::vector<RGBColor>& state);
+
+private:
+
+    std::vector<RGBColor>   m_state;
+    quint64                 m_version = 0;
+};
+
+}
@@ -0,0 +1,198 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "RGBMetricSampler.h"
+#include "DataProviderManager.h"
+#include "DataProviderNvidiaNvml.h"
+#include "SysFsDataProviderHWMon.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <QTimer>
+
+#include <algorithm>
+
+namespace LenovoLegionDaemon {
+
+using MetricBinding = legion::messages::RGBController::DirectMode::MetricBinding;
+
+namespace {
+
+bool usesMetric(const std::vector<MetricBinding>& bindings,std::initializer_list<MetricBinding::Metric> metrics)
+{
+    return std::any_of(bindings.begin(),bindings.end(),[&metrics](const MetricBinding& binding) {
+        return std::find(metrics.begin(),metrics.end(),binding.metric()) != metrics.end();
+    });
+}
+
+}
+
+RGBMetricSampler::RGBMetricSampler(DataProviderManager *dataProviderManager, const legion::messages::RGBController::DirectMode &directMode, QObject *parent) :
+    QObject(parent),
+    m_dataProviderManager(dataProviderManager),
+    m_bindings(directMode.metrics().begin(),directMode.metrics().end()),
+    m_interval(directMode.metric_interval_ms() == 0 ? DEFAULT_INTERVAL : std::max(MIN_INTERVAL,std::chrono::milliseconds(directMode.metric_interval_ms()))),
+    m_levels(std::make_shared<RGBDirectModeMetricEffect::Levels>()),
+    m_usesHWMon(usesMetric(m_bindings,{MetricBinding::METRIC_LEGION_TEMPERATURE,MetricBinding::METRIC_LEGION_FAN_SPEED})),
+    m_usesNvml(usesMetric(m_bindings,{MetricBinding::METRIC_GPU_TEMPERATURE,MetricBinding::METRIC_GPU_UTILIZATION,MetricBinding::METRIC_GPU_POWER})),
+    m_timer(new QTimer(this))
+{
+    connect(m_timer,&QTimer::timeout,this,&RGBMetricSampler::sample);
+
+    /*
+     * First frame has values already
+     */
+    sample();
+
+    m_timer->start(m_interval);
+}
+
+std::unique_ptr<RGBDirectModeMetricEffect> RGBMetricSampler::effect() const
+{
+    std::vector<RGBDirectModeMetricEffect::Binding> bindings;
+
+    for(const MetricBinding& binding : m_bindings)
+    {
+        RGBDirectModeMetricEffect::Binding effectBinding;
+
+        effectBinding.m_target = binding.target() == MetricBinding::TARGET_ROW_BAR ? RGBDirectModeMetricEffect::Binding::ROW_BAR : RGBDirectModeMetricEffect::Binding::ALL_KEYS;
+        effectBinding.m_row    = binding.row();
+
+        for(const auto& stop : binding.gradient())
+        {
+            effectBinding.m_gradient.m_stops.push_back({stop.position(),stop.color()});
+        }
+
+        std::stable_sort(effectBinding.m_gradient.m_stops.begin(),effectBinding.m_gradient.m_stops.end(),[](const auto& a,const auto& b) { return a.m_position < b.m_position; });
+
+        bindings.push_back(std::move(effectBinding));
+    }
+
+    return std::make_unique<RGBDirectModeMetricEffect>(std::move(bindings),m_levels,m_interval);
+}
+
+bool RGBMetricSampler::valid(const legion::messages::RGBController::DirectMode &directMode)
+{
+    if(directMode.metrics_size() == 0)
+    {
+        return false;
+    }
+
+    return std::all_of(directMode.metrics().begin(),directMode.metrics().end(),[](const MetricBinding& binding) {
+        return binding.gradient_size() > 0 && binding.min() <= binding.max();
+    });
+}
+
+void RGBMetricSampler::sample()
+{
+    const std::optional<legion::messages::HardwareMonitor> hwMon = m_usesHWMon ? readProvider<legion::messages::HardwareMonitor>(SysFsDataProviderHWMon::dataType) : std::nullopt;
+    const std::optional<legion::messages::NvidiaNvml>      nvml  = m_usesNvml  ? readProvider<legion::messages::NvidiaNvml>(DataProviderNvidiaNvml::dataType)   : std::nullopt;
+    std::vector<std::optional<double>>                     levels;
+
+    levels.reserve(m_bindings.size());
+
+    for(const MetricBinding& binding : m_bindings)
+    {
+        levels.push_back(level(binding,hwMon,nvml));
+    }
+
+    m_levels->set(std::move(levels));
+}
+
+std::optional<double> RGBMetricSampler::level(const MetricBinding &binding, const std::optional<legion::messages::HardwareMonitor> &hwMon, const std::optional<legion::messages::NvidiaNvml> &nvml)
+{
+    double value = 0.0;
+    double min   = 0.0;
+    double max   = 0.0;
+
+    switch (binding.metric()) {
+    case MetricBinding::METRIC_LEGION_TEMPERATURE:
+        if(!hwMon || static_cast<int>(binding.sensor()) >= hwMon->legion().temps_size())
+        {
+            return std::nullopt;
+        }
+        value = hwMon->legion().temps(binding.sensor()).temp_value() / 1000.0;
+        min   = TEMPERATURE_MIN;
+        max   = TEMPERATURE_MAX;
+        break;
+    case MetricBinding::METRIC_LEGION_FAN_SPEED:
+        if(!hwMon || static_cast<int>(binding.sensor()) >= hwMon->legion().fans_size())
+        {
+            return std::nullopt;
+        }
+        value = hwMon->legion().fans(binding.sensor()).fan_speed();
+        min   = hwMon->legion().fans(binding.sensor()).fan_speed_min();
+        max   = hwMon->legion().fans(binding.sensor()).fan_speed_max();
+        break;
+    case MetricBinding::METRIC_GPU_TEMPERATURE:
+        if(!nvml || !nvml->hardware_monitor().has_temperature())
+        {
+            return std::nullopt;
+        }
+        value = nvml->hardware_monitor().temperature().value();
+        min   = TEMPERATURE_MIN;
+        max   = nvml->hardware_monitor().temperature().slowdown() != 0 ? nvml->hardware_monitor().temperature().slowdown() : TEMPERATURE_MAX;
+        break;
+    case MetricBinding::METRIC_GPU_UTILIZATION:
+        if(!nvml || !nvml->hardware_monitor().has_gpu_utilization())
+        {
+            return std::nullopt;
+        }
+        value = nvml->hardware_monitor().gpu_utilization().value();
+        min   = 0.0;
+        max   = 100.0;
+        break;
+    case MetricBinding::METRIC_GPU_POWER:
+        if(!nvml || !nvml->hardware_monitor().has_power())
+        {
+            return std::nullopt;
+        }
+        value = nvml->hardware_monitor().power().value() / 1000.0;              // mW
+        min   = 0.0;
+        max   = nvml->hardware_monitor().power().max_value() / 1000.0;
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    if(binding.max() > binding.min())
+    {
+        min = binding.min();
+        max = binding.max();
+    }
+
+    if(max <= min)
+    {
+        return std::nullopt;
+    }
+
+    return std::clamp((value - min) / (max - min),0.0,1.0);
+}
+
+template<class T>
+std::optional<T> RGBMetricSampler::readProvider(quint8 dataType) const
+{
+    T message;
+
+    try {
+        const QByteArray data = m_dataProviderManager->getDataProvider(dataType).serializeAndGetData();
+
+        if(!message.ParseFromArray(data.data(),data.size()))
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Parse of data message error, data type " + QString::number(dataType));
+            return std::nullopt;
+        }
+    } catch(...)
+    {
+        LOG_D(QString(__PRETTY_FUNCTION__) + " - Data provider not available, data type " + QString::number(dataType));
+        return std::nullopt;
+    }
+
+    return message;
+}
+
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "RGBDirectModeEffects.h"
+
+#include "../LenovoLegion-PrepareBuild/RGBController.pb.h"
+#include "../LenovoLegion-PrepareBuild/HWMonitoring.pb.h"
+#include "../LenovoLegion-PrepareBuild/NvidiaNvml.pb.h"
+
+#include <QObject>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class QTimer;
+
+namespace LenovoLegionDaemon {
+
+class DataProviderManager;
+
+/*
+ * Samples metrics of metric effect bindings from daemon data providers
+ *
+ * Runs on event loop, data providers are read the same way as by clients. Every value is
+ * normalized to its range and stored in levels shared with effect on engine thread.
+ */
+class RGBMetricSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    static constexpr std::chrono::milliseconds  DEFAULT_INTERVAL    {1000};
+    static constexpr std::chrono::milliseconds  MIN_INTERVAL        {250};
+
+    /*
+     * Range when binding has none
+     */
+    static constexpr double                     TEMPERATURE_MIN     = 30.0;
+    static constexpr double                     TEMPERATURE_MAX     = 100.0;
+
+public:
+
+    RGBMetricSampler(DataProviderManager* dataProviderManager,const legion::messages::RGBController::DirectMode& directMode,QObject* parent = nullptr);
+
+    ~RGBMetricSampler() override = default;
+
+    /*
+     * Effect bound to levels of this sampler
+     */
+    std::unique_ptr<RGBDirectModeMetricEffect> effect() const;
+
+    static bool valid(const legion::messages::RGBController::DirectMode& directMode);
+
+private slots:
+
+    void sample();
+
+private:
+
+    /*
+     * Normalized to range of binding, or to range of metric when binding has none
+     */
+    static std::optional<double> level(const legion::messages::RGBController::DirectMode::MetricBinding& binding,
+                                       const std::optional<legion::messages::HardwareMonitor>& hwMon,
+                                       const std::optional<legion::messages::NvidiaNvml>& nvml);
+
+    template<class T>
+    std::optional<T> readProvider(quint8 dataType) const;
+
+private:
+
+    DataProviderManager* const                                                      m_dataProviderManager;
+    const std::vector<legion::messages::RGBController::DirectMode::MetricBinding>   m_bindings;
+    const std::chrono::milliseconds                                                 m_interval;
+    const std::shared_ptr<RGBDirectModeMetricEffect::Levels>                        m_levels;
+    const bool                                                                      m_usesHWMon;
+    const bool                                                                      m_usesNvml;
+
+    QTimer*                                                                         m_timer;
+};
+
+}
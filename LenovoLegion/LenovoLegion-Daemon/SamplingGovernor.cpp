@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "SamplingGovernor.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+
+namespace LenovoLegionDaemon {
+
+SamplingGovernor::Source::Source(const std::string &name, const Policy &policy, std::function<void ()> wake) :
+    m_name(name),
+    m_policy(policy),
+    m_wake(std::move(wake)),
+    m_stable(0),
+    m_reset(false),
+    m_interval(policy.m_base),
+    m_wakeups(0)
+{
+    SamplingGovernor::getInstance().registerSource(this);
+}
+
+SamplingGovernor::Source::~Source()
+{
+    SamplingGovernor::getInstance().unregisterSource(this);
+}
+
+std::chrono::milliseconds SamplingGovernor::Source::next(bool changed)
+{
+    const SamplingGovernor& governor = SamplingGovernor::getInstance();
+
+    m_wakeups++;
+
+    if(m_reset.exchange(false))
+    {
+        m_stable = 0;
+    }
+
+    m_stable = changed ? 0 : std::min(m_stable + 1,m_policy.m_stableSamples * 16);
+
+    std::chrono::milliseconds interval = m_policy.m_base;
+
+    // Back off while values stay where they are
+    for(int run = m_stable / m_policy.m_stableSamples; run > 0 && interval < m_policy.m_max; --run)
+    {
+        interval *= 2;
+    }
+
+    if(governor.onBattery())
+    {
+        interval *= m_policy.m_batteryFactor;
+    }
+
+    if(governor.subscribers() == 0)
+    {
+        interval = std::max(interval,m_policy.m_idle);
+    }
+
+    interval = std::clamp(interval,m_policy.m_base,std::max(m_policy.m_max,m_policy.m_idle));
+
+    if(interval != m_interval.load())
+    {
+        LOG_T(QString(__PRETTY_FUNCTION__) + QString(" - %1 sampling interval %2 ms -> %3 ms").arg(m_name.c_str()).arg(m_interval.load().count()).arg(interval.count()));
+    }
+
+    m_interval = interval;
+
+    return interval;
+}
+
+std::chrono::milliseconds SamplingGovernor::Source::interval() const
+{
+    return m_interval;
+}
+
+quint64 SamplingGovernor::Source::wakeups() const
+{
+    return m_wakeups;
+}
+
+const std::string &SamplingGovernor::Source::name() const
+{
+    return m_name;
+}
+
+
+SamplingGovernor &SamplingGovernor::getInstance()
+{
+    static SamplingGovernor instance;
+    return instance;
+}
+
+SamplingGovernor::SamplingGovernor() :
+    m_onBattery(false),
+    m_subscribers(0)
+{}
+
+void SamplingGovernor::setOnBattery(bool onBattery)
+{
+    if(m_onBattery.exchange(onBattery) != onBattery)
+    {
+        LOG_D(QString(__PRETTY_FUNCTION__) + " - Sampling on " + (onBattery ? "battery" : "AC"));
+        wakeSources();
+    }
+}
+
+void SamplingGovernor::setSubscribers(int subscribers)
+{
+    if(m_subscribers.exchange(subscribers) != subscribers)
+    {
+        LOG_D(QString(__PRETTY_FUNCTION__) + " - Sampling subscribers " + QString::number(subscribers));
+        wakeSources();
+    }
+}
+
+bool SamplingGovernor::onBattery() const
+{
+    return m_onBattery;
+}
+
+int SamplingGovernor::subscribers() const
+{
+    return m_subscribers;
+}
+
+void SamplingGovernor::forEachSourceDo(const std::function<void (const Source &)> &func) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for(const Source* source : m_sources)
+    {
+        func(*source);
+    }
+}
+
+void SamplingGovernor::registerSource(Source *source)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_sources.push_back(source);
+}
+
+void SamplingGovernor::unregisterSource(Source *source)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_sources.erase(std::remove(m_sources.begin(),m_sources.end(),source),m_sources.end());
+}
+
+void SamplingGovernor::wakeSources()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for(Source* source : m_sources)
+    {
+        // Next interval is computed again from the new state
+        source->m_reset = true;
+        source->m_wake();
+    }
+}
+
+}
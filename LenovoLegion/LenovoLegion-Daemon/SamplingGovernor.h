@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Picks sampling interval of periodic daemon samplers
+ *
+ * Every sampler owns a Source and asks it for the next interval after each sample, telling
+ * whether the values changed. Interval starts at the base of the source policy, doubles after
+ * every run of stable samples up to the maximum, is stretched on battery and falls to the idle
+ * interval when no client is connected. Battery or subscriber changes wake the samplers so a
+ * connecting client does not wait for a long idle sleep to run out.
+ *
+ * Safety loops (fan controller) are not governed.
+ */
+class SamplingGovernor
+{
+public:
+
+    struct Policy {
+        std::chrono::milliseconds   m_base;
+        std::chrono::milliseconds   m_max               {5000};
+        std::chrono::milliseconds   m_idle              {5000};
+        int                         m_batteryFactor     = 4;
+        int                         m_stableSamples     = 10;   // Unchanged samples before each doubling
+    };
+
+    class Source
+    {
+    public:
+
+        /*
+         * Wake is called from the thread changing governor state, it must only wake the sampler
+         */
+        Source(const std::string& name,const Policy& policy,std::function<void()> wake);
+        ~Source();
+
+        Source(const Source&)            = delete;
+        Source& operator=(const Source&) = delete;
+
+        /*
+         * Called once per sampler wakeup
+         */
+        std::chrono::milliseconds next(bool changed);
+
+        std::chrono::milliseconds   interval()  const;
+        quint64                     wakeups()   const;
+        const std::string&          name()      const;
+
+    private:
+
+        friend class SamplingGovernor;
+
+        const std::string                       m_name;
+        const Policy                            m_policy;
+        const std::function<void()>             m_wake;
+
+        int                                     m_stable;
+        std::atomic<bool>                       m_reset;
+        std::atomic<std::chrono::milliseconds>  m_interval;
+        std::atomic<quint64>                    m_wakeups;
+    };
+
+public:
+
+    static SamplingGovernor& getInstance();
+
+    SamplingGovernor(const SamplingGovernor&)            = delete;
+    SamplingGovernor& operator=(const SamplingGovernor&) = delete;
+
+    void    setOnBattery(bool onBattery);
+    void    setSubscribers(int subscribers);
+
+    bool    onBattery()     const;
+    int     subscribers()   const;
+
+    /*
+     * Calls func for every registered source
+     */
+    void    forEachSourceDo(const std::function<void(const Source&)>& func) const;
+
+private:
+
+    SamplingGovernor();
+    ~SamplingGovernor() = default;
+
+    void    registerSource(Source* source);
+    void    unregisterSource(Source* source);
+    void    wakeSources();
+
+private:
+
+    mutable std::mutex      m_mutex;
+    std::vector<Source*>    m_sources;
+
+    std::atomic<bool>       m_onBattery;
+    std::atomic<int>        m_subscribers;
+};
+
+}
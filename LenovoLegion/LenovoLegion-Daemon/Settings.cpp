@@ -7,25 +7,426 @@
  */
 #include <Settings.h>
 #include <Core/Application.h>
+#include <Core/LoggerHolder.h>
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace LenovoLegionDaemon {
 
-Settings::Settings(const QString &group) :
-    m_settings(QCoreApplication::applicationDirPath()
-               .append(QDir::separator())
-               .append(bj::framework::Application::data_dir)
-               .append(QDir::separator())
-               .append("/LenovoLegion-Daemon.ini"), QSettings::IniFormat)
+namespace {
+
+QString dataFilePath(const QString& name)
 {
-    m_settings.setValue("LenovoLegion", "LenovoLegion-Daemon");
-    m_settings.beginGroup(group);
+    return QCoreApplication::applicationDirPath()
+            .append(QDir::separator())
+            .append(bj::framework::Application::data_dir)
+            .append(QDir::separator())
+            .append(name);
 }
 
-Settings::~Settings()
+bool syncToDisk(const QString& path)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(),O_RDONLY | O_CLOEXEC);
+
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    const bool synced = ::fsync(fd) == 0;
+
+    ::close(fd);
+
+    return synced;
+}
+
+QByteArray toByteArray(std::string_view data)
+{
+    return QByteArray(data.data(),static_cast<qsizetype>(data.size()));
+}
+
+template<class T,class Load>
+void importMessage(QMap<quint32,QByteArray>& entries,quint32 dataType,Load load)
+{
+    T message;
+
+    load(message);
+
+    if(message.ByteSizeLong() > 0)
+    {
+        QByteArray data(static_cast<qsizetype>(message.ByteSizeLong()),Qt::Uninitialized);
+
+        if(message.SerializeToArray(data.data(),data.size()))
+        {
+            entries.insert(dataType,data);
+        }
+    }
+}
+
+}
+
+SettingsStore::Transaction::Transaction() :
+    m_lock(SettingsStore::getInstance().m_mutex)
+{
+    SettingsStore::getInstance().m_depth++;
+}
+
+SettingsStore::Transaction::~Transaction()
+{
+    SettingsStore& store = SettingsStore::getInstance();
+
+    if(--store.m_depth == 0 && store.m_entriesDirty)
+    {
+        store.commitSnapshot();
+    }
+}
+
+SettingsStore::Group::Group(const QString &group) :
+    m_group(group)
+{}
+
+bool SettingsStore::Group::contains(const QString &key) const
 {
-    m_settings.endGroup();
+    return SettingsStore::getInstance().values().contains(path(key));
+}
+
+QVariant SettingsStore::Group::value(const QString &key, const QVariant &defaultValue) const
+{
+    return SettingsStore::getInstance().values().value(path(key),defaultValue);
+}
+
+int SettingsStore::Group::beginReadArray(const QString &prefix)
+{
+    m_array      = prefix;
+    m_arrayIndex = -1;
+
+    return value("size").toInt();
+}
+
+void SettingsStore::Group::setArrayIndex(int i)
+{
+    m_arrayIndex = i;
+}
+
+void SettingsStore::Group::endArray()
+{
+    m_arrayIndex = -1;
+    m_array.clear();
+}
+
+QString SettingsStore::Group::path(const QString &key) const
+{
+    QString keyPath = m_group.isEmpty() ? QString() : m_group + "/";
+
+    if(!m_array.isEmpty())
+    {
+        keyPath += m_array + "/";
+
+        if(m_arrayIndex >= 0)
+        {
+            keyPath += QString::number(m_arrayIndex + 1) + "/";
+        }
+    }
+
+    return keyPath + key;
+}
+
+
+SettingsStore &SettingsStore::getInstance()
+{
+    static SettingsStore instance;
+    return instance;
+}
+
+SettingsStore::SettingsStore() :
+    m_path(dataFilePath("LenovoLegion-Daemon.ini")),
+    m_snapshotPath(dataFilePath("LenovoLegion-Daemon.snapshot")),
+    m_loaded(false),
+    m_depth(0),
+    m_entriesLoaded(false),
+    m_entriesDirty(false),
+    m_writable(true)
+{}
+
+QSettings::SettingsMap &SettingsStore::values()
+{
+    if(!m_loaded)
+    {
+        const auto started = std::chrono::steady_clock::now();
+
+        QSettings settings(m_path,QSettings::IniFormat);
+
+        for(const QString& key : settings.allKeys())
+        {
+            m_values.insert(key,settings.value(key));
+        }
+
+        m_loaded = true;
+
+        LOG_D(QString("SettingsStore: %1 keys parsed in %2 us").arg(m_values.size()).arg(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count()));
+    }
+
+    return m_values;
+}
+
+QByteArray SettingsStore::data(quint32 dataType)
+{
+    return entries().value(dataType);
+}
+
+void SettingsStore::setData(quint32 dataType, const QByteArray &data)
+{
+    QMap<quint32,QByteArray>& values = entries();
+
+    const auto it = values.constFind(dataType);
+
+    if(it == values.constEnd() || it.value() != data)
+    {
+        values.insert(dataType,data);
+        m_entriesDirty = true;
+    }
+}
+
+bool SettingsStore::setMessage(quint32 dataType, google::protobuf::Message &message)
+{
+    const QByteArray                            data = this->data(dataType);
+    std::unique_ptr<google::protobuf::Message>  stored(message.New());
+
+    if(!data.isEmpty() && stored->ParseFromArray(data.data(),data.size()))
+    {
+        keepUnknownFields(message,*stored);
+    }
+
+    QByteArray merged(static_cast<qsizetype>(message.ByteSizeLong()),Qt::Uninitialized);
+
+    if(!message.SerializeToArray(merged.data(),merged.size()))
+    {
+        LOG_E(QString("SettingsStore: serialize of data type ") + QString::number(dataType) + " failed !");
+        return false;
+    }
+
+    setData(dataType,merged);
+
+    return true;
+}
+
+void SettingsStore::keepUnknownFields(google::protobuf::Message &message, const google::protobuf::Message &stored)
+{
+    const google::protobuf::Reflection* reflection = message.GetReflection();
+    const google::protobuf::Descriptor* descriptor = message.GetDescriptor();
+
+    /*
+     * Unknown fields the message brings itself are newer than the stored ones
+     */
+    if(reflection->GetUnknownFields(message).empty())
+    {
+        reflection->MutableUnknownFields(&message)->MergeFrom(reflection->GetUnknownFields(stored));
+    }
+
+    /*
+     * Nested messages present in both, repeated ones have no identity to pair them by
+     */
+    for(int i = 0; i < descriptor->field_count(); ++i)
+    {
+        const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+
+        if(field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE && !field->is_repeated() &&
+           reflection->HasField(message,field) && reflection->HasField(stored,field))
+        {
+            keepUnknownFields(*reflection->MutableMessage(&message,field),reflection->GetMessage(stored,field));
+        }
+    }
+}
+
+QMap<quint32,QByteArray> &SettingsStore::entries()
+{
+    if(!m_entriesLoaded)
+    {
+        const auto started = std::chrono::steady_clock::now();
+
+        if(!loadSnapshot() && m_writable)
+        {
+            importIni();
+        }
+
+        m_entriesLoaded = true;
+
+        LOG_D(QString("SettingsStore: %1 entries loaded in %2 us").arg(m_entries.size()).arg(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count()));
+    }
+
+    return m_entries;
+}
+
+bool SettingsStore::loadSnapshot()
+{
+    QFile file(m_snapshotPath);
+
+    if(!file.exists())
+    {
+        return false;
+    }
+
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        LOG_W(QString("SettingsStore: ") + m_snapshotPath + " can not be opened !");
+        m_writable = false;
+        return false;
+    }
+
+    const QByteArray                        content = file.readAll();
+    legion::messages::SettingsSnapshotFile  snapshotFile;
+
+    if(snapshotFile.ParseFromArray(content.constData(),content.size()) && snapshotFile.format() > SNAPSHOT_FORMAT)
+    {
+        LOG_W(QString("SettingsStore: ") + m_snapshotPath + " has newer format " + QString::number(snapshotFile.format()) + ", settings will not be saved !");
+        m_writable = false;
+        return false;
+    }
+
+    const QByteArray snapshot = toByteArray(snapshotFile.snapshot());
+
+    if(snapshotFile.format() == 0 ||
+       QCryptographicHash::hash(snapshot,QCryptographicHash::Sha256) != toByteArray(snapshotFile.checksum()) ||
+       !m_snapshot.ParseFromArray(snapshot.constData(),snapshot.size()))
+    {
+        /*
+         * Kept aside for inspection, new snapshot is written from imported settings
+         */
+        LOG_W(QString("SettingsStore: ") + m_snapshotPath + " is corrupted !");
+        file.close();
+        QFile::remove(m_snapshotPath + ".corrupted");
+        QFile::rename(m_snapshotPath,m_snapshotPath + ".corrupted");
+        m_snapshot.Clear();
+        return false;
+    }
+
+    for(const auto& entry : m_snapshot.entries())
+    {
+        m_entries.insert(entry.data_type(),toByteArray(entry.data()));
+    }
+
+    m_snapshot.clear_entries();
+
+    return true;
+}
+
+void SettingsStore::importIni()
+{
+    if(!QFile::exists(m_path))
+    {
+        return;
+    }
+
+    importMessage<legion::messages::DaemonSettings>(m_entries,legion::messages::DataType::DAEMON_SETTINGS,[](auto& message) { SettingsLoaderDaemonSettings().loadDaemonSettings(message); });
+    importMessage<legion::messages::PowerProfile>(m_entries,legion::messages::DataType::POWER_PROFILE,[](auto& message) { SettingsLoaderPowerProfiles().loadPowerProfile(message); });
+    importMessage<legion::messages::CPUOptions>(m_entries,legion::messages::DataType::CPU_OPTIONS,[](auto& message) { SettingsLoaderCPUControlData().loadPowerProfile(message); });
+    importMessage<legion::messages::CPUFrequency>(m_entries,legion::messages::DataType::CPU_FREQUENCY,[](auto& message) { SettingsLoaderCPUFrequency().loadCPUFrequency(message); });
+    importMessage<legion::messages::FanCurve>(m_entries,legion::messages::DataType::FAN_CURVE,[](auto& message) { SettingsLoaderFanCurve().loadFanCurve(message); });
+    importMessage<legion::messages::FanController>(m_entries,legion::messages::DataType::FAN_CONTROLLER,[](auto& message) { SettingsLoaderFanController().loadFanController(*message.mutable_settings()); });
+    importMessage<legion::messages::FanOption>(m_entries,legion::messages::DataType::FAN_OPTION,[](auto& message) { SettingsLoaderFanOption().loadFanOption(message); });
+    importMessage<legion::messages::CPUSMT>(m_entries,legion::messages::DataType::CPU_SMT,[](auto& message) { SettingsLoaderCPUSMT().loadCPUSMT(message); });
+    importMessage<legion::messages::CPUPower>(m_entries,legion::messages::DataType::CPU_POWER,[](auto& message) { SettingsLoaderCPUPower().loadCPUPower(message); });
+    importMessage<legion::messages::GPUPower>(m_entries,legion::messages::DataType::GPU_POWER,[](auto& message) { SettingsLoaderGPUPower().loadGPUPower(message); });
+    importMessage<legion::messages::NvidiaNvml>(m_entries,legion::messages::DataType::NVIDIA_NWML,[](auto& message) { SettingsLoaderNvidiaNvml().loadNvidiaNvml(message); });
+    importMessage<legion::messages::CpuIntelMSR>(m_entries,legion::messages::DataType::CPU_INTEL_MSR,[](auto& message) { SettingsLoaderIntelMSR().loadIntelMSR(message); });
+    importMessage<legion::messages::OtherSettings>(m_entries,legion::messages::DataType::OTHER,[](auto& message) { SettingsLoaderOther().loadOther(message); });
+
+    LOG_I(QString("SettingsStore: %1 settings imported from ").arg(m_entries.size()) + m_path);
+
+    /*
+     * Snapshot is written at the end of the current transaction, INI file stays as it is
+     */
+    m_entriesDirty = true;
+}
+
+void SettingsStore::commitSnapshot()
+{
+    if(!m_writable)
+    {
+        return;
+    }
+
+    const auto    started       = std::chrono::steady_clock::now();
+    const QString temporaryPath = m_snapshotPath + ".tmp";
+
+    legion::messages::SettingsSnapshot      snapshot(m_snapshot);
+    legion::messages::SettingsSnapshotFile  snapshotFile;
+    std::string                             serializedSnapshot;
+    std::string                             content;
+
+    for(auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+    {
+        legion::messages::SettingsSnapshot::Entry* entry = snapshot.add_entries();
+
+        entry->set_data_type(it.key());
+        entry->set_data(std::string(it.value().constData(),it.value().size()));
+    }
+
+    if(!snapshot.SerializeToString(&serializedSnapshot))
+    {
+        LOG_E("SettingsStore: serialize of snapshot failed !");
+        return;
+    }
+
+    snapshotFile.set_format(SNAPSHOT_FORMAT);
+    snapshotFile.set_checksum(QCryptographicHash::hash(QByteArray::fromRawData(serializedSnapshot.data(),serializedSnapshot.size()),QCryptographicHash::Sha256).toStdString());
+    snapshotFile.set_snapshot(std::move(serializedSnapshot));
+
+    if(!snapshotFile.SerializeToString(&content))
+    {
+        LOG_E("SettingsStore: serialize of snapshot file failed !");
+        return;
+    }
+
+    {
+        QFile file(temporaryPath);
+
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content.data(),static_cast<qint64>(content.size())) != static_cast<qint64>(content.size()) || !file.flush())
+        {
+            LOG_E(QString("SettingsStore: write of ") + temporaryPath + " failed !");
+            file.close();
+            QFile::remove(temporaryPath);
+            return;
+        }
+    }
+
+    /*
+     * Data are on disk before the rename, the rename is on disk before return
+     */
+    if(!syncToDisk(temporaryPath) || std::rename(QFile::encodeName(temporaryPath).constData(),QFile::encodeName(m_snapshotPath).constData()) != 0)
+    {
+        LOG_E(QString("SettingsStore: commit of ") + m_snapshotPath + " failed !");
+        QFile::remove(temporaryPath);
+        return;
+    }
+
+    syncToDisk(QFileInfo(m_snapshotPath).absolutePath());
+
+    m_entriesDirty = false;
+
+    LOG_D(QString("SettingsStore: %1 entries, %2 bytes committed in %3 us").arg(m_entries.size()).arg(content.size()).arg(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count()));
 }
 
+
+Settings::Settings(const QString &group) :
+    m_settings(group)
+{}
+
+Settings::~Settings()
+{}
+
 SettingsLoaderPowerProfiles::SettingsLoaderPowerProfiles() :
     Settings("PowerProfileData")
 {
@@ -45,18 +446,6 @@ SettingsLoaderPowerProfiles& SettingsLoaderPowerProfiles::loadPowerProfile(legio
     return *this;
 }
 
-SettingsSaverPowerProfiles::SettingsSaverPowerProfiles() :
-    Settings("PowerProfileData")
-{
-}
-
-SettingsSaverPowerProfiles& SettingsSaverPowerProfiles::saverPowerProfile(const legion::messages::PowerProfile &profile)
-{
-    m_settings.setValue("PowerProfile", static_cast<quint32>(profile.current_value()));
-    m_settings.setValue("custom_fnq_enabled", profile.custom_fnq_enabled().current_value());
-    return *this;
-}
-
 SettingsLoaderCPUControlData::SettingsLoaderCPUControlData() :
     Settings("CPUsControlData")
 {
@@ -79,24 +468,6 @@ SettingsLoaderCPUControlData& SettingsLoaderCPUControlData::loadPowerProfile(leg
     return *this;
 }
 
-SettingsSaverCPUControlData::SettingsSaverCPUControlData() :
-    Settings("CPUsControlData")
-{
-}
-
-SettingsSaverCPUControlData& SettingsSaverCPUControlData::saverPowerProfile(const legion::messages::CPUOptions &profile)
-{
-    m_settings.beginWriteArray("CPUControl");
-    for (int i = 0; i < profile.cpus().size(); ++i) {
-        m_settings.setArrayIndex(i);
-        m_settings.setValue("online", profile.cpus().at(i).cpu_online());
-        m_settings.setValue("governor", QString(profile.cpus().at(i).governor().data()).trimmed());
-    }
-    m_settings.endArray();
-    return *this;
-}
-
-// CPU Frequency Settings
 SettingsLoaderCPUFrequency::SettingsLoaderCPUFrequency() :
     Settings("CPUFrequencyData")
 {
@@ -119,24 +490,6 @@ SettingsLoaderCPUFrequency& SettingsLoaderCPUFrequency::loadCPUFrequency(legion:
     return *this;
 }
 
-SettingsSaverCPUFrequency::SettingsSaverCPUFrequency() :
-    Settings("CPUFrequencyData")
-{
-}
-
-SettingsSaverCPUFrequency& SettingsSaverCPUFrequency::saveCPUFrequency(const legion::messages::CPUFrequency &frequency)
-{
-    m_settings.beginWriteArray("CPUFrequency");
-    for (int i = 0; i < frequency.cpus().size(); ++i) {
-        m_settings.setArrayIndex(i);
-        m_settings.setValue("scaling_min_freq", frequency.cpus().at(i).scaling_min_freq());
-        m_settings.setValue("scaling_max_freq", frequency.cpus().at(i).scaling_max_freq());
-    }
-    m_settings.endArray();
-    return *this;
-}
-
-// Fan Curve Settings
 SettingsLoaderFanCurve::SettingsLoaderFanCurve() :
     Settings("FanCurveData")
 {
@@ -177,27 +530,6 @@ SettingsLoaderFanCurve& SettingsLoaderFanCurve::loadFanCurve(legion::messages::F
     return *this;
 }
 
-SettingsSaverFanCurve::SettingsSaverFanCurve() :
-    Settings("FanCurveData")
-{
-}
-
-SettingsSaverFanCurve& SettingsSaverFanCurve::saveFanCurve(const legion::messages::FanCurve &fanCurve)
-{
-    m_settings.setValue("point1", fanCurve.current_value().point1());
-    m_settings.setValue("point2", fanCurve.current_value().point2());
-    m_settings.setValue("point3", fanCurve.current_value().point3());
-    m_settings.setValue("point4", fanCurve.current_value().point4());
-    m_settings.setValue("point5", fanCurve.current_value().point5());
-    m_settings.setValue("point6", fanCurve.current_value().point6());
-    m_settings.setValue("point7", fanCurve.current_value().point7());
-    m_settings.setValue("point8", fanCurve.current_value().point8());
-    m_settings.setValue("point9", fanCurve.current_value().point9());
-    m_settings.setValue("point10", fanCurve.current_value().point10());
-    return *this;
-}
-
-// Fan Option Settings
 SettingsLoaderFanOption::SettingsLoaderFanOption() :
     Settings("FanOptionData")
 {
@@ -211,18 +543,52 @@ SettingsLoaderFanOption& SettingsLoaderFanOption::loadFanOption(legion::messages
     return *this;
 }
 
-SettingsSaverFanOption::SettingsSaverFanOption() :
-    Settings("FanOptionData")
+SettingsLoaderFanController::SettingsLoaderFanController() :
+    Settings("FanControllerData")
 {
 }
 
-SettingsSaverFanOption& SettingsSaverFanOption::saveFanOption(const legion::messages::FanOption &fanOption)
+SettingsLoaderFanController& SettingsLoaderFanController::loadFanController(legion::messages::FanController::Settings &fanController)
 {
-    m_settings.setValue("full_speed", fanOption.full_speed().current_value());
+    if (m_settings.contains("enabled")) {
+        fanController.set_enabled(m_settings.value("enabled").toBool());
+    }
+    if (m_settings.contains("target_temperature")) {
+        fanController.set_target_temperature(m_settings.value("target_temperature").toUInt());
+    }
+    if (m_settings.contains("critical_temperature")) {
+        fanController.set_critical_temperature(m_settings.value("critical_temperature").toUInt());
+    }
+    if (m_settings.contains("hysteresis")) {
+        fanController.set_hysteresis(m_settings.value("hysteresis").toUInt());
+    }
+    if (m_settings.contains("period_ms")) {
+        fanController.set_period_ms(m_settings.value("period_ms").toUInt());
+    }
+    if (m_settings.contains("ramp_up_step_ms")) {
+        fanController.set_ramp_up_step_ms(m_settings.value("ramp_up_step_ms").toUInt());
+    }
+    if (m_settings.contains("ramp_down_step_ms")) {
+        fanController.set_ramp_down_step_ms(m_settings.value("ramp_down_step_ms").toUInt());
+    }
+    if (m_settings.contains("kp")) {
+        fanController.set_kp(m_settings.value("kp").toDouble());
+    }
+    if (m_settings.contains("ki")) {
+        fanController.set_ki(m_settings.value("ki").toDouble());
+    }
+    if (m_settings.contains("kd")) {
+        fanController.set_kd(m_settings.value("kd").toDouble());
+    }
+    if (m_settings.contains("min_level")) {
+        fanController.set_min_level(m_settings.value("min_level").toUInt());
+    }
+    if (m_settings.contains("max_level")) {
+        fanController.set_max_level(m_settings.value("max_level").toUInt());
+    }
     return *this;
 }
 
-// CPU SMT Settings
 SettingsLoaderCPUSMT::SettingsLoaderCPUSMT() :
     Settings("CPUSMTData")
 {
@@ -236,18 +602,6 @@ SettingsLoaderCPUSMT& SettingsLoaderCPUSMT::loadCPUSMT(legion::messages::CPUSMT
     return *this;
 }
 
-SettingsSaverCPUSMT::SettingsSaverCPUSMT() :
-    Settings("CPUSMTData")
-{
-}
-
-SettingsSaverCPUSMT& SettingsSaverCPUSMT::saveCPUSMT(const legion::messages::CPUSMT &cpuSmt)
-{
-    m_settings.setValue("control", QString::fromStdString(cpuSmt.control().data()));
-    return *this;
-}
-
-// CPU Power Settings
 SettingsLoaderCPUPower::SettingsLoaderCPUPower() :
     Settings("CPUPowerData")
 {
@@ -279,38 +633,6 @@ SettingsLoaderCPUPower& SettingsLoaderCPUPower::loadCPUPower(legion::messages::C
     return *this;
 }
 
-SettingsSaverCPUPower::SettingsSaverCPUPower() :
-    Settings("CPUPowerData")
-{
-}
-
-SettingsSaverCPUPower& SettingsSaverCPUPower::saveCPUPower(const legion::messages::CPUPower &cpuPower)
-{
-    if (cpuPower.has_cpu_stp_limit()) {
-        m_settings.setValue("cpu_stp_limit", cpuPower.cpu_stp_limit().current_value());
-    }
-    if (cpuPower.has_cpu_ltp_limit()) {
-        m_settings.setValue("cpu_ltp_limit", cpuPower.cpu_ltp_limit().current_value());
-    }
-    if (cpuPower.has_cpu_clp_limit()) {
-        m_settings.setValue("cpu_clp_limit", cpuPower.cpu_clp_limit().current_value());
-    }
-    if (cpuPower.has_cpu_tmp_limit()) {
-        m_settings.setValue("cpu_tmp_limit", cpuPower.cpu_tmp_limit().current_value());
-    }
-    if (cpuPower.has_cpu_pl1_tau()) {
-        m_settings.setValue("cpu_pl1_tau", cpuPower.cpu_pl1_tau().current_value());
-    }
-    if (cpuPower.has_gpu_total_onac()) {
-        m_settings.setValue("gpu_total_onac", cpuPower.gpu_total_onac().current_value());
-    }
-    if (cpuPower.has_gpu_to_cpu_dynamic_boost()) {
-        m_settings.setValue("gpu_to_cpu_dynamic_boost", cpuPower.gpu_to_cpu_dynamic_boost().current_value());
-    }
-    return *this;
-}
-
-// GPU Power Settings
 SettingsLoaderGPUPower::SettingsLoaderGPUPower() :
     Settings("GPUPowerData")
 {
@@ -330,25 +652,6 @@ SettingsLoaderGPUPower& SettingsLoaderGPUPower::loadGPUPower(legion::messages::G
     return *this;
 }
 
-SettingsSaverGPUPower::SettingsSaverGPUPower() :
-    Settings("GPUPowerData")
-{
-}
-
-SettingsSaverGPUPower& SettingsSaverGPUPower::saveGPUPower(const legion::messages::GPUPower &gpuPower)
-{
-    if (gpuPower.has_gpu_power_boost()) {
-        m_settings.setValue("gpu_power_boost", gpuPower.gpu_power_boost().current_value());
-    }
-    if (gpuPower.has_gpu_configurable_tgp()) {
-        m_settings.setValue("gpu_configurable_tgp", gpuPower.gpu_configurable_tgp().current_value());
-    }
-    if (gpuPower.has_gpu_temperature_limit()) {
-        m_settings.setValue("gpu_temperature_limit", gpuPower.gpu_temperature_limit().current_value());
-    }
-    return *this;
-}
-// Nvidia NVML Settings
 SettingsLoaderNvidiaNvml::SettingsLoaderNvidiaNvml() :
     Settings("NvidiaNvmlData")
 {
@@ -365,23 +668,6 @@ SettingsLoaderNvidiaNvml& SettingsLoaderNvidiaNvml::loadNvidiaNvml(legion::messa
     return *this;
 }
 
-SettingsSaverNvidiaNvml::SettingsSaverNvidiaNvml() :
-    Settings("NvidiaNvmlData")
-{
-}
-
-SettingsSaverNvidiaNvml& SettingsSaverNvidiaNvml::saveNvidiaNvml(const legion::messages::NvidiaNvml &nvidiaNvml)
-{
-    if (nvidiaNvml.has_gpu_offset()) {
-        m_settings.setValue("gpu_offset", nvidiaNvml.gpu_offset().value());
-    }
-    if (nvidiaNvml.has_memory_offset()) {
-        m_settings.setValue("memory_offset", nvidiaNvml.memory_offset().value());
-    }
-    return *this;
-}
-
-// Daemon Settings
 SettingsLoaderDaemonSettings::SettingsLoaderDaemonSettings() :
     Settings("DaemonSettings")
 {
@@ -393,26 +679,11 @@ SettingsLoaderDaemonSettings& SettingsLoaderDaemonSettings::loadDaemonSettings(l
     daemonSettings.set_save_settings_on_exit(m_settings.value("save_settings_on_exit", true).toBool());
     daemonSettings.set_debug_logging(m_settings.value("debug_logging", false).toBool());
     daemonSettings.set_trace_logging(m_settings.value("trace_logging", false).toBool());
+    daemonSettings.set_metrics_exporter_listen(m_settings.value("metrics_exporter_listen", "").toString().toStdString());
     // Note: save_now is not loaded - it's a command flag, not a persistent setting
     return *this;
 }
 
-SettingsSaverDaemonSettings::SettingsSaverDaemonSettings() :
-    Settings("DaemonSettings")
-{
-}
-
-SettingsSaverDaemonSettings& SettingsSaverDaemonSettings::saveDaemonSettings(const legion::messages::DaemonSettings &daemonSettings)
-{
-    m_settings.setValue("apply_settings_on_start", daemonSettings.apply_settings_on_start());
-    m_settings.setValue("save_settings_on_exit", daemonSettings.save_settings_on_exit());
-    m_settings.setValue("debug_logging", daemonSettings.debug_logging());
-    m_settings.setValue("trace_logging", daemonSettings.trace_logging());
-    // Note: save_now is not saved - it's a command flag, not a persistent setting
-    return *this;
-}
-
-// Intel MSR Settings
 SettingsLoaderIntelMSR::SettingsLoaderIntelMSR() :
     Settings("IntelMSRData")
 {
@@ -448,42 +719,6 @@ SettingsLoaderIntelMSR& SettingsLoaderIntelMSR::loadIntelMSR(legion::messages::C
     return *this;
 }
 
-SettingsSaverIntelMSR::SettingsSaverIntelMSR() :
-    Settings("IntelMSRData")
-{
-}
-
-SettingsSaverIntelMSR& SettingsSaverIntelMSR::saveIntelMSR(const legion::messages::CpuIntelMSR &intelMSR)
-{
-    // Save analogio offset if present
-    if (intelMSR.has_analogio() && intelMSR.analogio().has_offset()) {
-        m_settings.setValue("analogio_offset", intelMSR.analogio().offset());
-    }
-    
-    // Save cache offset if present
-    if (intelMSR.has_cache() && intelMSR.cache().has_offset()) {
-        m_settings.setValue("cache_offset", intelMSR.cache().offset());
-    }
-    
-    // Save CPU offset if present
-    if (intelMSR.has_cpu() && intelMSR.cpu().has_offset()) {
-        m_settings.setValue("cpu_offset", intelMSR.cpu().offset());
-    }
-    
-    // Save GPU offset if present
-    if (intelMSR.has_gpu() && intelMSR.gpu().has_offset()) {
-        m_settings.setValue("gpu_offset", intelMSR.gpu().offset());
-    }
-    
-    // Save uncore offset if present
-    if (intelMSR.has_uncore() && intelMSR.uncore().has_offset()) {
-        m_settings.setValue("uncore_offset", intelMSR.uncore().offset());
-    }
-    
-    return *this;
-}
-
-// Other Settings
 SettingsLoaderOther::SettingsLoaderOther() :
     Settings("OtherData")
 {
@@ -504,24 +739,4 @@ SettingsLoaderOther& SettingsLoaderOther::loadOther(legion::messages::OtherSetti
     return *this;
 }
 
-SettingsSaverOther::SettingsSaverOther() :
-    Settings("OtherData")
-{
-}
-
-SettingsSaverOther& SettingsSaverOther::saveOther(const legion::messages::OtherSettings &otherSettings)
-{
-    // Save touchpad setting if present
-    if (otherSettings.has_touch_pad() && otherSettings.touch_pad().has_current()) {
-        m_settings.setValue("disable_touchpad", otherSettings.touch_pad().current());
-    }
-    
-    // Save win key setting if present
-    if (otherSettings.has_win_key() && otherSettings.win_key().has_current()) {
-        m_settings.setValue("disable_win_key", otherSettings.win_key().current());
-    }
-    
-    return *this;
-}
-
 }
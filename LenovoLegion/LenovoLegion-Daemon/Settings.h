@@ -8,7 +8,11 @@
 #pragma once
 
 #include <QSettings>
+#include <QByteArray>
+#include <QMap>
+#include <QVariant>
 
+#include <mutex>
 
 #include "../LenovoLegion-PrepareBuild/PowerProfile.pb.h"
 #include "../LenovoLegion-PrepareBuild/CPUOptions.pb.h"
@@ -20,11 +24,127 @@
 #include "../LenovoLegion-PrepareBuild/CpuIntelMSR.pb.h"
 #include "../LenovoLegion-PrepareBuild/DaemonSettings.pb.h"
 #include "../LenovoLegion-PrepareBuild/Other.pb.h"
+#include "../LenovoLegion-PrepareBuild/SettingsSnapshot.pb.h"
 
 
 namespace LenovoLegionDaemon {
 
 
+/*
+ * Daemon settings files, parsed once and kept in memory
+ *
+ * Settings are serialized data provider messages keyed by data type, kept in one binary snapshot
+ * file. Snapshot is checked with SHA-256 on load. Entries of data types unknown to this daemon and
+ * unknown fields inside of messages are written back untouched. Without a valid snapshot the old
+ * INI settings are imported once through their loaders, the INI file is only read, never written.
+ *
+ * Callers work on the in memory copy inside of a transaction. When the outermost transaction ends
+ * and something changed, the snapshot is written once to a temporary file, synced to disk and
+ * renamed over the old one, a crash leaves either the old or the new snapshot.
+ */
+class SettingsStore
+{
+public:
+
+    static constexpr quint32 SNAPSHOT_FORMAT = 1;
+
+    class Transaction
+    {
+    public:
+
+        Transaction();
+        ~Transaction();
+
+        Transaction(const Transaction&)            = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+    private:
+
+        std::unique_lock<std::recursive_mutex> m_lock;
+    };
+
+    /*
+     * QSettings like read access to one group of INI settings for the import loaders, valid only
+     * inside of a transaction
+     */
+    class Group
+    {
+    public:
+
+        explicit Group(const QString& group);
+
+        bool     contains(const QString& key) const;
+        QVariant value(const QString& key,const QVariant& defaultValue = QVariant()) const;
+
+        int      beginReadArray(const QString& prefix);
+        void     setArrayIndex(int i);
+        void     endArray();
+
+    private:
+
+        QString  path(const QString& key) const;
+
+    private:
+
+        const QString m_group;
+        QString       m_array;
+        int           m_arrayIndex = -1;
+    };
+
+public:
+
+    static SettingsStore& getInstance();
+
+    SettingsStore(const SettingsStore&)            = delete;
+    SettingsStore& operator=(const SettingsStore&) = delete;
+
+    /*
+     * Valid only inside of a transaction, empty data when nothing is saved
+     */
+    QByteArray  data(quint32 dataType);
+    void        setData(quint32 dataType,const QByteArray& data);
+
+    /*
+     * Stores message with unknown fields of the stored entry (written by newer daemon) added to it,
+     * false when it can not be serialized
+     */
+    bool        setMessage(quint32 dataType,google::protobuf::Message& message);
+
+private:
+
+    SettingsStore();
+    ~SettingsStore() = default;
+
+    QSettings::SettingsMap&     values();
+
+    QMap<quint32,QByteArray>&   entries();
+    bool                        loadSnapshot();
+    void                        importIni();
+    void                        commitSnapshot();
+
+    static void                 keepUnknownFields(google::protobuf::Message& message,const google::protobuf::Message& stored);
+
+private:
+
+    const QString                       m_path;
+    const QString                       m_snapshotPath;
+
+    std::recursive_mutex                m_mutex;
+    QSettings::SettingsMap              m_values;
+    bool                                m_loaded;
+    int                                 m_depth;
+
+    QMap<quint32,QByteArray>            m_entries;
+    legion::messages::SettingsSnapshot  m_snapshot;     // Unknown fields of loaded snapshot, entries are in m_entries
+    bool                                m_entriesLoaded;
+    bool                                m_entriesDirty;
+    bool                                m_writable;
+};
+
+
+/*
+ * Readers of old INI settings, used for the import only
+ */
 class Settings {
 
 protected:
@@ -44,7 +164,8 @@ public:
 
 protected:
 
-    QSettings m_settings;
+    SettingsStore::Transaction m_transaction;
+    SettingsStore::Group       m_settings;
 };
 
 
@@ -56,12 +177,6 @@ public:
 };
 
 
-class SettingsSaverPowerProfiles: protected Settings
-{
-public:
-    explicit SettingsSaverPowerProfiles();
-    SettingsSaverPowerProfiles& saverPowerProfile(const legion::messages::PowerProfile& profile);
-};
 
 
 
@@ -73,12 +188,6 @@ public:
     SettingsLoaderCPUControlData& loadPowerProfile(legion::messages::CPUOptions &profile);
 };
 
-class SettingsSaverCPUControlData: protected Settings
-{
-public:
-    explicit SettingsSaverCPUControlData();
-    SettingsSaverCPUControlData& saverPowerProfile(const legion::messages::CPUOptions &profile);
-};
 
 // CPU Frequency Settings
 class SettingsLoaderCPUFrequency: protected Settings
@@ -88,12 +197,6 @@ public:
     SettingsLoaderCPUFrequency& loadCPUFrequency(legion::messages::CPUFrequency &frequency);
 };
 
-class SettingsSaverCPUFrequency: protected Settings
-{
-public:
-    explicit SettingsSaverCPUFrequency();
-    SettingsSaverCPUFrequency& saveCPUFrequency(const legion::messages::CPUFrequency &frequency);
-};
 
 // Fan Curve Settings
 class SettingsLoaderFanCurve: protected Settings
@@ -103,12 +206,6 @@ public:
     SettingsLoaderFanCurve& loadFanCurve(legion::messages::FanCurve &fanCurve);
 };
 
-class SettingsSaverFanCurve: protected Settings
-{
-public:
-    explicit SettingsSaverFanCurve();
-    SettingsSaverFanCurve& saveFanCurve(const legion::messages::FanCurve &fanCurve);
-};
 
 // Fan Option Settings
 class SettingsLoaderFanOption: protected Settings
@@ -118,13 +215,16 @@ public:
     SettingsLoaderFanOption& loadFanOption(legion::messages::FanOption &fanOption);
 };
 
-class SettingsSaverFanOption: protected Settings
+
+// Fan Controller Settings
+class SettingsLoaderFanController: protected Settings
 {
 public:
-    explicit SettingsSaverFanOption();
-    SettingsSaverFanOption& saveFanOption(const legion::messages::FanOption &fanOption);
+    explicit SettingsLoaderFanController();
+    SettingsLoaderFanController& loadFanController(legion::messages::FanController::Settings &fanController);
 };
 
+
 // CPU SMT Settings
 class SettingsLoaderCPUSMT: protected Settings
 {
@@ -133,12 +233,6 @@ public:
     SettingsLoaderCPUSMT& loadCPUSMT(legion::messages::CPUSMT &cpuSmt);
 };
 
-class SettingsSaverCPUSMT: protected Settings
-{
-public:
-    explicit SettingsSaverCPUSMT();
-    SettingsSaverCPUSMT& saveCPUSMT(const legion::messages::CPUSMT &cpuSmt);
-};
 
 // CPU Power Settings
 class SettingsLoaderCPUPower: protected Settings
@@ -148,12 +242,6 @@ public:
     SettingsLoaderCPUPower& loadCPUPower(legion::messages::CPUPower &cpuPower);
 };
 
-class SettingsSaverCPUPower: protected Settings
-{
-public:
-    explicit SettingsSaverCPUPower();
-    SettingsSaverCPUPower& saveCPUPower(const legion::messages::CPUPower &cpuPower);
-};
 
 // GPU Power Settings
 class SettingsLoaderGPUPower: protected Settings
@@ -163,12 +251,6 @@ public:
     SettingsLoaderGPUPower& loadGPUPower(legion::messages::GPUPower &gpuPower);
 };
 
-class SettingsSaverGPUPower: protected Settings
-{
-public:
-    explicit SettingsSaverGPUPower();
-    SettingsSaverGPUPower& saveGPUPower(const legion::messages::GPUPower &gpuPower);
-};
 
 // Nvidia NVML Settings
 class SettingsLoaderNvidiaNvml: protected Settings
@@ -178,12 +260,6 @@ public:
     SettingsLoaderNvidiaNvml& loadNvidiaNvml(legion::messages::NvidiaNvml &nvidiaNvml);
 };
 
-class SettingsSaverNvidiaNvml: protected Settings
-{
-public:
-    explicit SettingsSaverNvidiaNvml();
-    SettingsSaverNvidiaNvml& saveNvidiaNvml(const legion::messages::NvidiaNvml &nvidiaNvml);
-};
 
 // Intel MSR Settings
 class SettingsLoaderIntelMSR: protected Settings
@@ -193,12 +269,6 @@ public:
     SettingsLoaderIntelMSR& loadIntelMSR(legion::messages::CpuIntelMSR &intelMSR);
 };
 
-class SettingsSaverIntelMSR: protected Settings
-{
-public:
-    explicit SettingsSaverIntelMSR();
-    SettingsSaverIntelMSR& saveIntelMSR(const legion::messages::CpuIntelMSR &intelMSR);
-};
 
 // Daemon Settings
 class SettingsLoaderDaemonSettings: protected Settings
@@ -208,12 +278,6 @@ public:
     SettingsLoaderDaemonSettings& loadDaemonSettings(legion::messages::DaemonSettings &daemonSettings);
 };
 
-class SettingsSaverDaemonSettings: protected Settings
-{
-public:
-    explicit SettingsSaverDaemonSettings();
-    SettingsSaverDaemonSettings& saveDaemonSettings(const legion::messages::DaemonSettings &daemonSettings);
-};
 
 // Other Settings
 class SettingsLoaderOther: protected Settings
@@ -223,11 +287,5 @@ public:
     SettingsLoaderOther& loadOther(legion::messages::OtherSettings &otherSettings);
 };
 
-class SettingsSaverOther: protected Settings
-{
-public:
-    explicit SettingsSaverOther();
-    SettingsSaverOther& saveOther(const legion::messages::OtherSettings &otherSettings);
-};
 
 }
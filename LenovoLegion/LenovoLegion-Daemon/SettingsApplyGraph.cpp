@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#include "SettingsApplyGraph.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace LenovoLegionDaemon {
+
+void SettingsApplyGraph::addStep(const QString &name, std::function<void ()> apply, const QStringList &after)
+{
+    m_steps.push_back({.m_name = name,.m_apply = std::move(apply),.m_after = after});
+}
+
+std::vector<SettingsApplyGraph::Timing> SettingsApplyGraph::run(unsigned int workers)
+{
+    std::vector<Timing>     timings;
+    std::deque<size_t>      ready;
+    std::mutex              mutex;
+    std::condition_variable condition;
+    size_t                  running = 0;
+    size_t                  done    = 0;
+    bool                    stalled = false;
+
+    for(Step& step : m_steps)
+    {
+        step.m_pending = 0;
+        step.m_dependents.clear();
+    }
+
+    for(size_t i = 0; i < m_steps.size(); ++i)
+    {
+        for(const QString& name : m_steps[i].m_after)
+        {
+            const auto dependency = std::find_if(m_steps.begin(),m_steps.end(),[&name](const Step& step) { return step.m_name == name; });
+
+            if(dependency == m_steps.end())
+            {
+                LOG_T(QString("SettingsApplyGraph: ") + m_steps[i].m_name + " - " + name + " is not in graph, taken as done");
+                continue;
+            }
+
+            dependency->m_dependents.push_back(i);
+            m_steps[i].m_pending++;
+        }
+
+        if(m_steps[i].m_pending == 0)
+        {
+            ready.push_back(i);
+        }
+    }
+
+    stalled = ready.empty() && !m_steps.empty();
+
+    const auto started = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        for(;;)
+        {
+            condition.wait(lock,[&] { return !ready.empty() || done == m_steps.size() || stalled; });
+
+            if(ready.empty())
+            {
+                return;
+            }
+
+            const size_t index = ready.front();
+            ready.pop_front();
+            running++;
+
+            lock.unlock();
+
+            const auto stepStarted = std::chrono::steady_clock::now();
+
+            try {
+                m_steps[index].m_apply();
+            } catch(...) {
+                LOG_W(QString("SettingsApplyGraph: ") + m_steps[index].m_name + " - failed");
+            }
+
+            const auto stepDone = std::chrono::steady_clock::now();
+
+            lock.lock();
+
+            running--;
+            done++;
+
+            timings.push_back({
+                .m_name     = m_steps[index].m_name,
+                .m_started  = std::chrono::duration_cast<std::chrono::microseconds>(stepStarted - started),
+                .m_duration = std::chrono::duration_cast<std::chrono::microseconds>(stepDone - stepStarted)
+            });
+
+            for(const size_t dependent : m_steps[index].m_dependents)
+            {
+                if(--m_steps[dependent].m_pending == 0)
+                {
+                    ready.push_back(dependent);
+                }
+            }
+
+            /*
+             * Nothing to run, nothing running and steps left, they wait on each other
+             */
+            stalled = ready.empty() && running == 0 && done != m_steps.size();
+
+            condition.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    workers = std::clamp<unsigned int>(workers,1,std::max<size_t>(m_steps.size(),1));
+
+    for(unsigned int i = 0; i < workers; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto total = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+
+    std::chrono::microseconds sequential {0};
+
+    for(const Timing& timing : timings)
+    {
+        sequential += timing.m_duration;
+
+        LOG_D(QString("SettingsApplyGraph: %1 started at %2 ms, took %3 ms").arg(timing.m_name).arg(timing.m_started.count() / 1000.0,0,'f',1).arg(timing.m_duration.count() / 1000.0,0,'f',1));
+    }
+
+    for(const Step& step : m_steps)
+    {
+        if(step.m_pending > 0)
+        {
+            LOG_E(QString("SettingsApplyGraph: ") + step.m_name + " - not applied, dependency cycle");
+        }
+    }
+
+    LOG_D(QString("SettingsApplyGraph: %1 steps on %2 workers took %3 ms, %4 ms one after another").arg(timings.size()).arg(workers).arg(total.count() / 1000.0,0,'f',1).arg(sequential.count() / 1000.0,0,'f',1));
+
+    return timings;
+}
+
+}
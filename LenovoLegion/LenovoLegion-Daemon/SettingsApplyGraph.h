@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Applies settings steps ordered by their dependencies
+ *
+ * Step starts when every step it depends on has finished, independent branches run concurrently
+ * on worker threads. Dependency on a step which is not in the graph is taken as satisfied, so
+ * optional steps can be left out. Steps must handle their own errors, steps sharing a driver must
+ * be ordered by dependencies because drivers are not thread safe.
+ */
+class SettingsApplyGraph
+{
+public:
+
+    struct Timing {
+        QString                     m_name;
+        std::chrono::microseconds   m_started   {0};    // Since start of run
+        std::chrono::microseconds   m_duration  {0};
+    };
+
+public:
+
+    void addStep(const QString& name,std::function<void()> apply,const QStringList& after = {});
+
+    /*
+     * Blocks until all steps are done, returns timings in finish order
+     */
+    std::vector<Timing> run(unsigned int workers);
+
+private:
+
+    struct Step {
+        QString                 m_name;
+        std::function<void()>   m_apply;
+        QStringList             m_after;
+        std::vector<size_t>     m_dependents;
+        int                     m_pending = 0;
+    };
+
+private:
+
+    std::vector<Step> m_steps;
+};
+
+}
@@ -15,7 +15,7 @@
 
 namespace LenovoLegionDaemon {
 
-SysFSDriverLegionFanMode::SysFSDriverLegionFanMode(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-firmware-attributes/legion-wmi-fan-mode-0/attributes/",{"wmi",{}},parrent,MODULE_NAME)
+SysFSDriverLegionFanMode::SysFSDriverLegionFanMode(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-firmware-attributes/legion-wmi-fan-mode-0/attributes/",{"wmi",{},{DRIVER_NAME,DEPENDENCY[0]}},parrent,MODULE_NAME)
 {}
 
 void SysFSDriverLegionFanMode::init()
@@ -92,11 +92,18 @@ void SysFSDriverLegionFanMode::handleKernelEvent(const KernelEvent::Event &event
 
         if(event.m_action == "change")
         {
+            if(dropExpectedKernelEvent())
+            {
+                LOG_T(QString("Echo of own write dropped for driver: ") + m_name);
+                return;
+            }
+
             emit kernelEvent({
                 .m_driverName = DRIVER_NAME,
+                .m_driverId = DRIVER_ID,
                 .m_action = SubsystemEvent::Action::CHANGED,
-                .m_DriverSpecificEventType = event.m_properties.value("EVENT_TYPE", ""),
-                .m_DriverSpecificEventValue = event.m_properties.value("EVENT_VALUE", "")
+                .m_eventType = static_cast<int>(numericProperty(event,"EVENT_TYPE",SubsystemEvent::NO_EVENT_TYPE)),
+                .m_eventValue = static_cast<quint32>(numericProperty(event,"EVENT_VALUE",0))
             });
         }
     }
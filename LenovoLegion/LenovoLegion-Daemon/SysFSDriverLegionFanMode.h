@@ -80,9 +80,15 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME   =  "legion_wmi_fan_method";
+    static constexpr DriverId    DRIVER_ID     =  DRIVER_ID_LEGION_FAN_MODE;
     static constexpr const char* MODULE_NAME   =  LEGION_MODULE_NAME;
     static constexpr const char* DEPENDENCY[]  =  {"legion_wmi_ftable"};
 
+    /*
+     * Kernel emits one change event per fan curve write
+     */
+    static constexpr int FAN_CURVE_WRITE_EVENTS = 1;
+
 };
 
 
@@ -17,7 +17,7 @@
 
 namespace LenovoLegionDaemon {
 
-SysFSDriverLegionGameZone::SysFSDriverLegionGameZone(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-firmware-attributes/legion-wmi-gamezone-0/attributes/",{"wmi",{}},parrent,MODULE_NAME)
+SysFSDriverLegionGameZone::SysFSDriverLegionGameZone(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-firmware-attributes/legion-wmi-gamezone-0/attributes/",{"wmi",{},{DRIVER_NAME}},parrent,MODULE_NAME)
 {}
 
 
@@ -4,7 +4,7 @@
 
 namespace LenovoLegionDaemon {
 
-SysFSDriverLegionIntelMSR::SysFSDriverLegionIntelMSR(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-intel-msr/intel-msr-0/",{"legion-intel-msr",{}},parrent,MODULE_NAME) {}
+SysFSDriverLegionIntelMSR::SysFSDriverLegionIntelMSR(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-intel-msr/intel-msr-0/",{"legion-intel-msr",{},{DRIVER_NAME}},parrent,MODULE_NAME) {}
 
 void SysFSDriverLegionIntelMSR::init()
 {
@@ -55,9 +55,10 @@ void SysFSDriverLegionIntelMSR::handleKernelEvent(const KernelEvent::Event &even
         {
             emit kernelEvent({
                 .m_driverName = DRIVER_NAME,
+                .m_driverId = DRIVER_ID,
                 .m_action = SubsystemEvent::Action::CHANGED,
-                .m_DriverSpecificEventType = event.m_properties.value("EVENT_TYPE", ""),
-                .m_DriverSpecificEventValue = event.m_properties.value("EVENT_VALUE", "")
+                .m_eventType = static_cast<int>(numericProperty(event,"EVENT_TYPE",SubsystemEvent::NO_EVENT_TYPE)),
+                .m_eventValue = static_cast<quint32>(numericProperty(event,"EVENT_VALUE",0))
             });
         }
     }
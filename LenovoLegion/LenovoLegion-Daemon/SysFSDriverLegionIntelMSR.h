@@ -107,6 +107,7 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME =  "legion-intel-msr";
+    static constexpr DriverId    DRIVER_ID   =  DRIVER_ID_LEGION_INTEL_MSR;
     static constexpr const char* MODULE_NAME =  LEGION_MODULE_NAME;
 };
 
@@ -189,6 +189,28 @@ void SysFsDataProvider::setData(const std::filesystem::path &path, qint64 value)
 
 }
 
+void SysFsDataProvider::markCPUs(const QString &cpus, std::vector<bool> &mask)
+{
+    if(cpus.trimmed().isEmpty())
+    {
+        return;
+    }
+
+    for(const auto& item : cpus.trimmed().split(','))
+    {
+        auto range = item.split('-');
+
+        if(range.size() < 1 || range.size() > 2)
+        {
+            THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,std::string("Invalid CPU topology data !").c_str());
+        }
+
+        for(uint cpu = range.at(0).toUInt(); cpu <= range.at(range.size() - 1).toUInt() && cpu < mask.size(); ++cpu)
+        {
+            mask[cpu] = true;
+        }
+    }
+}
 
 
 
@@ -50,6 +50,13 @@ namespace LenovoLegionDaemon {
         static void setData(const std::filesystem::path &path, const std::vector<quint32>& values);
         static void setData(const std::filesystem::path &path, const std::string_view &value);
 
+    protected:
+
+        /*
+         * Marks CPUs of a list like "0-11,16" in mask
+         */
+        static void markCPUs(const QString& cpus,std::vector<bool>& mask);
+
     protected:
 
         SysFsDriverManager * m_sysFsDriverManager;
@@ -9,6 +9,7 @@
 #include "SysFsDataProviderBattery.h"
 #include "SysFsDriverPowerSuplyBattery0.h"
 #include "SysFSDriverLegionGameZone.h"
+#include "SamplingGovernor.h"
 
 
 #include "../LenovoLegion-PrepareBuild/Battery.pb.h"
@@ -66,5 +67,41 @@ QByteArray SysFsDataProviderBattery::deserializeAndSetData(const QByteArray &)
     return {};
 }
 
+void SysFsDataProviderBattery::init()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    updateSamplingGovernor();
+}
+
+void SysFsDataProviderBattery::kernelEventHandler(const SysFsDriver::SubsystemEvent &event)
+{
+    /*
+     * AC plug and unplug are reported as change of the battery
+     */
+    if(event.m_driverName == SysFsDriverPowerSuplyBattery0::DRIVER_NAME)
+    {
+        updateSamplingGovernor();
+    }
+}
+
+void SysFsDataProviderBattery::updateSamplingGovernor() const
+{
+    try {
+        SysFSDriverLegionGameZone::GameZone::Other        other(m_sysFsDriverManager->getDriverDesriptor(SysFSDriverLegionGameZone::DRIVER_NAME));
+
+        SamplingGovernor::getInstance().setOnBattery(getData(other.get_power_charge_mode).toUShort() == legion::messages::Battery::POWER_CHARGE_MODE_BATTERY);
+    } catch(SysFsDriver::exception_T& ex)
+    {
+        if(ex.errcodeInfo().value() != SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+        {
+            throw;
+        }
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + "- Driver not available, sampling governor assumes AC");
+        SamplingGovernor::getInstance().setOnBattery(false);
+    }
+}
+
 
 }
@@ -23,6 +23,17 @@ public:
     virtual QByteArray serializeAndGetData()                    const;
     virtual QByteArray deserializeAndSetData(const QByteArray&)      ;
 
+    virtual void init()                                             override;
+
+    virtual void kernelEventHandler(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent &event) override;
+
+private:
+
+    /*
+     * Tells sampling governor whether the machine runs on battery
+     */
+    void updateSamplingGovernor() const;
+
 public:
 
     static constexpr quint8  dataType = legion::messages::DataType::BATTERY;
@@ -97,10 +97,10 @@ QByteArray SysFsDataProviderCPUOptions::deserializeAndSetData(const QByteArray &
         return {};
     }
 
-    m_sysFsDriverManager->blockKernelEvent(SysFsDriverCPUXList::DRIVER_NAME,true);
-    auto cleanup =  qScopeGuard([this] { m_sysFsDriverManager->blockKernelEvent(SysFsDriverCPUXList::DRIVER_NAME,false); });
-
-
+    /*
+     * Only toggled CPUs are written and taken again, each of them echoes one udev event
+     */
+    std::vector<int> toggledCpus;
 
     for (int i = 0 ; i < cpuOptions.cpus_size() ;++i)
     {
@@ -110,9 +110,13 @@ QByteArray SysFsDataProviderCPUOptions::deserializeAndSetData(const QByteArray &
             break;
         }
 
-        if(cpuXlist.cpuList().at(i).isOnlineAvailable())
+        if(cpuXlist.cpuList().at(i).isOnlineAvailable() && (getData(cpuXlist.cpuList().at(i).m_cpuOnline.value()).toUShort() == 1) != cpuOptions.cpus().at(i).cpu_online())
         {
+            m_sysFsDriverManager->expectKernelEvents(SysFsDriverCPUXList::DRIVER_NAME,1,std::chrono::milliseconds(1000),i);
+
             setData(cpuXlist.cpuList().at(i).m_cpuOnline.value(),cpuOptions.cpus().at(i).cpu_online());
+
+            toggledCpus.push_back(i);
         }
 
         if(!cpuOptions.cpus().at(i).governor().empty())
@@ -121,9 +125,14 @@ QByteArray SysFsDataProviderCPUOptions::deserializeAndSetData(const QByteArray &
         }
     }
 
+    for (const int cpu : toggledCpus)
+    {
+        m_sysFsDriverManager->refreshDriver(SysFsDriverCPUXList::DRIVER_NAME,cpu);
+
+        emit cpuOnlineChanged(cpu,cpuOptions.cpus().at(cpu).cpu_online());
+    }
 
-    m_sysFsDriverManager->processAllUdevEvents(100);
-    m_sysFsDriverManager->refreshDriver(SysFsDriverCPUXList::DRIVER_NAME);
+    LOG_D(QString(__PRETTY_FUNCTION__) + "- " + QString::number(toggledCpus.size()) + " CPUs toggled");
 
     return {};
 }
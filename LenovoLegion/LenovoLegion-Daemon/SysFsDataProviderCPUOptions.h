@@ -15,6 +15,8 @@ namespace LenovoLegionDaemon {
 
 class SysFsDataProviderCPUOptions : public SysFsDataProvider
 {
+    Q_OBJECT
+
 public:
 
     SysFsDataProviderCPUOptions(SysFsDriverManager* sysFsDriverManager,QObject* parent);
@@ -23,6 +25,13 @@ public:
     virtual QByteArray serializeAndGetData()                    const;
     virtual QByteArray deserializeAndSetData(const QByteArray&)      ;
 
+signals:
+
+    /*
+     * Emitted for CPU toggled by the daemon, its udev event is taken as echo and not reported
+     */
+    void cpuOnlineChanged(int cpu,bool online);
+
 public:
 
     static constexpr quint8  dataType = legion::messages::DataType::CPU_OPTIONS;
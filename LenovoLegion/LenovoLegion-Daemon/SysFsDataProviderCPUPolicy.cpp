@@ -0,0 +1,385 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "SysFsDataProviderCPUPolicy.h"
+#include "SysFsDriverCPUCore.h"
+#include "SysFsDriverCPUAtom.h"
+#include "SysFsDriverPowerSuplyBattery0.h"
+#include "SysFSDriverLegionGameZone.h"
+#include "Settings.h"
+
+#include "../LenovoLegion-PrepareBuild/Battery.pb.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <QTimer>
+
+#include <time.h>
+
+namespace LenovoLegionDaemon {
+
+SysFsDataProviderCPUPolicy::SysFsDataProviderCPUPolicy(SysFsDriverManager* sysFsDriverManager,QObject* parent) :
+    SysFsDataProvider(sysFsDriverManager,parent,dataType),
+    m_resumeTimer(new QTimer(this)),
+    m_suspendedTime(0),
+    m_onAC(true),
+    m_coreCpus(0),
+    m_atomCpus(0),
+    m_enforcements(0),
+    m_writes(0),
+    m_failures(0)
+{
+    connect(m_resumeTimer,&QTimer::timeout,this,&SysFsDataProviderCPUPolicy::checkResume);
+}
+
+QByteArray SysFsDataProviderCPUPolicy::serializeAndGetData() const
+{
+    legion::messages::CPUPolicyStatus status;
+    QByteArray                        byteArray;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    *status.mutable_policy() = m_policy;
+    status.set_on_ac(m_onAC);
+    status.set_core_cpus(m_coreCpus);
+    status.set_atom_cpus(m_atomCpus);
+    status.set_enforcements(m_enforcements);
+    status.set_writes(m_writes);
+    status.set_failures(m_failures);
+
+    byteArray.resize(status.ByteSizeLong());
+    if(!status.SerializeToArray(byteArray.data(),byteArray.size()))
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::SERIALIZE_ERROR,"Serialize of data message error !");
+    }
+
+    return byteArray;
+}
+
+QByteArray SysFsDataProviderCPUPolicy::deserializeAndSetData(const QByteArray &data)
+{
+    legion::messages::CPUPolicy policy;
+
+    LOG_T(__PRETTY_FUNCTION__);
+
+    if(!policy.ParseFromArray(data.data(),data.size()))
+    {
+        THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,"Parse of data message error !");
+    }
+
+    for(const legion::messages::CPUPolicy::Target* target : {&policy.core().on_ac(),&policy.core().on_battery(),&policy.atom().on_ac(),&policy.atom().on_battery()})
+    {
+        if(target->has_scaling_min_freq() && target->has_scaling_max_freq() && target->scaling_min_freq() > target->scaling_max_freq())
+        {
+            THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,"Minimal frequency above maximal frequency !");
+        }
+    }
+
+    m_policy = policy;
+
+    {
+        SettingsStore::Transaction transaction;
+        SettingsStore::getInstance().setMessage(dataType,policy);
+    }
+
+    updateResumeCheck();
+    enforce();
+
+    return {};
+}
+
+void SysFsDataProviderCPUPolicy::init()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    {
+        SettingsStore::Transaction transaction;
+        const QByteArray           data = SettingsStore::getInstance().data(dataType);
+
+        if(!m_policy.ParseFromArray(data.data(),data.size()))
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Stored CPU policy is invalid, starting without policy");
+            m_policy.Clear();
+        }
+    }
+
+    updateResumeCheck();
+
+    /*
+     * Start-up settings are loaded after data providers init, policy goes over them from event loop
+     */
+    QTimer::singleShot(0,this,[this]() {
+        enforce();
+    });
+}
+
+void SysFsDataProviderCPUPolicy::clean()
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    m_resumeTimer->stop();
+}
+
+void SysFsDataProviderCPUPolicy::kernelEventHandler(const SysFsDriver::SubsystemEvent &event)
+{
+    if(event.m_driverName == SysFsDriverCPUXList::DRIVER_NAME)
+    {
+        if(event.m_action == SysFsDriver::SubsystemEvent::Action::CHANGED)
+        {
+            if(event.m_eventType == SysFsDriverCPUXList::CPU_X_ONLINE)
+            {
+                enforce(event.m_eventValue);
+            }
+        }
+        else if(event.m_action == SysFsDriver::SubsystemEvent::Action::RELOADED)
+        {
+            enforce();
+        }
+    }
+    else if(event.m_driverName == SysFsDriverPowerSuplyBattery0::DRIVER_NAME)
+    {
+        /*
+         * AC plug and unplug are reported as change of the battery
+         */
+        if(readOnAC() != m_onAC)
+        {
+            enforce();
+        }
+    }
+}
+
+void SysFsDataProviderCPUPolicy::cpuOnlineChanged(int cpu, bool online)
+{
+    if(online)
+    {
+        enforce(cpu);
+    }
+}
+
+void SysFsDataProviderCPUPolicy::enforce(std::optional<size_t> cpu)
+{
+    if(!m_policy.enabled())
+    {
+        return;
+    }
+
+    try {
+        SysFsDriverCPUXList::CPUXList cpuXlist(m_sysFsDriverManager->getDriverDescriptorsInVector(SysFsDriverCPUXList::DRIVER_NAME));
+        std::vector<bool>             core;
+        std::vector<bool>             atom;
+        const quint64                 writes   = m_writes;
+        const quint64                 failures = m_failures;
+
+        m_onAC = readOnAC();
+        classes(cpuXlist.cpuList().size(),core,atom);
+
+        m_coreCpus = 0;
+        m_atomCpus = 0;
+
+        for(size_t i = 0; i < cpuXlist.cpuList().size(); ++i)
+        {
+            const SysFsDriverCPUXList::CPUXList::CPUX& cpux = cpuXlist.cpuList().at(i);
+
+            /*
+             * Offline CPU has no cpufreq policy
+             */
+            if(cpux.m_freq.m_cpuScalingGovernor.empty() || (cpux.isOnlineAvailable() && getData(cpux.m_cpuOnline.value()).toUShort() != 1))
+            {
+                continue;
+            }
+
+            const legion::messages::CPUPolicy::ClassPolicy* classPolicy = atom[i] ? &m_policy.atom() : (core[i] ? &m_policy.core() : nullptr);
+
+            m_coreCpus += core[i] ? 1 : 0;
+            m_atomCpus += atom[i] ? 1 : 0;
+
+            if(classPolicy != nullptr && (!cpu.has_value() || cpu.value() == i))
+            {
+                /*
+                 * CPU may go offline meanwhile, the others are enforced anyway
+                 */
+                try {
+                    enforceCPU(cpux,m_onAC ? classPolicy->on_ac() : classPolicy->on_battery());
+                } catch(exception_T& ex)
+                {
+                    LOG_W(QString(__PRETTY_FUNCTION__) + " - CPU " + QString::number(i) + " failed, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+                    ++m_failures;
+                }
+            }
+        }
+
+        ++m_enforcements;
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + QString(" - %1 values written, %2 refused, %3").arg(m_writes - writes).arg(m_failures - failures).arg(m_onAC ? "AC" : "battery"));
+    } catch(SysFsDriver::exception_T& ex)
+    {
+        if(ex.errcodeInfo().value() != SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+        {
+            throw;
+        }
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + "- Driver not available");
+    }
+}
+
+void SysFsDataProviderCPUPolicy::enforceCPU(const SysFsDriverCPUXList::CPUXList::CPUX &cpux, const legion::messages::CPUPolicy::Target &target)
+{
+    /*
+     * Governor first, intel_pstate refuses EPP other than performance under performance governor
+     */
+    if(target.has_governor())
+    {
+        if(getData(cpux.m_freq.m_cpuScalingAvailableGovernors).split(' ',Qt::SkipEmptyParts).contains(QString::fromStdString(std::string(target.governor()))))
+        {
+            writeIfDiffers(cpux.m_freq.m_cpuScalingGovernor,std::string(target.governor()),true);
+        }
+        else
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Governor " + QString::fromStdString(std::string(target.governor())) + " not available");
+            ++m_failures;
+        }
+    }
+
+    if(target.has_epp())
+    {
+        if(cpux.m_freq.m_cpuEnergyPerformancePreference.has_value() &&
+           getData(cpux.m_freq.m_cpuEnergyPerformanceAvailablePreferences.value()).split(' ',Qt::SkipEmptyParts).contains(QString::fromStdString(std::string(target.epp()))))
+        {
+            writeIfDiffers(cpux.m_freq.m_cpuEnergyPerformancePreference.value(),std::string(target.epp()),true);
+        }
+        else
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - EPP " + QString::fromStdString(std::string(target.epp())) + " not available");
+            ++m_failures;
+        }
+    }
+
+    /*
+     * Minimum above current maximum is refused, maximum goes first then
+     */
+    const bool maxFirst = target.has_scaling_min_freq() && target.scaling_min_freq() > getData(cpux.m_freq.m_cpuScalingMaxFreq).toUInt();
+
+    if(maxFirst && target.has_scaling_max_freq())
+    {
+        writeIfDiffers(cpux.m_freq.m_cpuScalingMaxFreq,std::to_string(target.scaling_max_freq()),false);
+    }
+
+    if(target.has_scaling_min_freq())
+    {
+        writeIfDiffers(cpux.m_freq.m_cpuScalingMinFreq,std::to_string(target.scaling_min_freq()),false);
+    }
+
+    if(!maxFirst && target.has_scaling_max_freq())
+    {
+        writeIfDiffers(cpux.m_freq.m_cpuScalingMaxFreq,std::to_string(target.scaling_max_freq()),false);
+    }
+}
+
+bool SysFsDataProviderCPUPolicy::writeIfDiffers(const std::filesystem::path &path, const std::string &value, bool verify)
+{
+    if(getData(path).toStdString() == value)
+    {
+        return true;
+    }
+
+    setData(path,value);
+    ++m_writes;
+
+    /*
+     * Kernel reports refused write on close only, value is read back. Frequencies are clamped by kernel, not verified
+     */
+    if(verify && getData(path).toStdString() != value)
+    {
+        LOG_W(QString(__PRETTY_FUNCTION__) + " - " + value.c_str() + " refused by " + path.c_str());
+        ++m_failures;
+        return false;
+    }
+
+    return true;
+}
+
+void SysFsDataProviderCPUPolicy::updateResumeCheck()
+{
+    if(!m_policy.enabled())
+    {
+        m_resumeTimer->stop();
+        return;
+    }
+
+    if(!m_resumeTimer->isActive())
+    {
+        m_suspendedTime = suspendedTime();
+        m_resumeTimer->start(RESUME_CHECK_INTERVAL);
+    }
+}
+
+void SysFsDataProviderCPUPolicy::checkResume()
+{
+    const std::chrono::nanoseconds suspended = suspendedTime();
+
+    if(suspended - m_suspendedTime > std::chrono::seconds(1))
+    {
+        LOG_I(QString(__PRETTY_FUNCTION__) + QString(" - Resume after %1 s of suspend, enforcing CPU policy").arg(std::chrono::duration_cast<std::chrono::seconds>(suspended - m_suspendedTime).count()));
+
+        enforce();
+    }
+
+    m_suspendedTime = suspended;
+}
+
+bool SysFsDataProviderCPUPolicy::readOnAC() const
+{
+    try {
+        SysFSDriverLegionGameZone::GameZone::Other other(m_sysFsDriverManager->getDriverDesriptor(SysFSDriverLegionGameZone::DRIVER_NAME));
+
+        return getData(other.get_power_charge_mode).toUShort() != legion::messages::Battery::POWER_CHARGE_MODE_BATTERY;
+    } catch(SysFsDriver::exception_T& ex)
+    {
+        if(ex.errcodeInfo().value() != SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+        {
+            throw;
+        }
+
+        LOG_D(QString(__PRETTY_FUNCTION__) + "- Driver not available, AC assumed");
+        return true;
+    }
+}
+
+void SysFsDataProviderCPUPolicy::classes(size_t cpus, std::vector<bool> &core, std::vector<bool> &atom) const
+{
+    core.assign(cpus,false);
+    atom.assign(cpus,false);
+
+    try {
+        markCPUs(getData(SysFsDriverCPUCore::CPUCore(m_sysFsDriverManager->getDriverDesriptor(SysFsDriverCPUCore::DRIVER_NAME)).m_cpus),core);
+        markCPUs(getData(SysFsDriverCPUAtom::CPUAtom(m_sysFsDriverManager->getDriverDesriptor(SysFsDriverCPUAtom::DRIVER_NAME)).m_cpus),atom);
+    } catch(SysFsDriver::exception_T& ex)
+    {
+        if(ex.errcodeInfo().value() != SysFsDriver::ERROR_CODES::DRIVER_NOT_AVAILABLE)
+        {
+            throw;
+        }
+
+        LOG_T(QString(__PRETTY_FUNCTION__) + "- CPU core/atom driver not available, all CPUs are cores");
+        core.assign(cpus,true);
+        atom.assign(cpus,false);
+    }
+}
+
+std::chrono::nanoseconds SysFsDataProviderCPUPolicy::suspendedTime()
+{
+    timespec boottime {};
+    timespec monotonic {};
+
+    clock_gettime(CLOCK_BOOTTIME,&boottime);
+    clock_gettime(CLOCK_MONOTONIC,&monotonic);
+
+    return std::chrono::seconds(boottime.tv_sec - monotonic.tv_sec) + std::chrono::nanoseconds(boottime.tv_nsec - monotonic.tv_nsec);
+}
+
+}
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include <SysFsDataProvider.h>
+#include "SysFsDriverCPUXList.h"
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+#include "../LenovoLegion-PrepareBuild/CPUPolicy.pb.h"
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+class QTimer;
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Governor, EPP and scaling limits per core class
+ *
+ * Policy is kept in settings store under CPU_POLICY data type. It is enforced in bulk after start-up
+ * settings are loaded, and again for a CPU coming online, after CPU list reload, AC plug or unplug
+ * and resume. Only values which differ from target are written, so manual changes stay until the
+ * next of these events.
+ */
+class SysFsDataProviderCPUPolicy : public SysFsDataProvider
+{
+    Q_OBJECT
+
+public:
+
+    /*
+     * Resume is detected by growth of time spent in suspend, checked with this period while policy is enabled
+     */
+    static constexpr std::chrono::milliseconds  RESUME_CHECK_INTERVAL   {5000};
+
+public:
+
+    SysFsDataProviderCPUPolicy(SysFsDriverManager* sysFsDriverManager,QObject* parent);
+
+    ~SysFsDataProviderCPUPolicy() override = default;
+
+    virtual QByteArray serializeAndGetData()                    const override;
+    virtual QByteArray deserializeAndSetData(const QByteArray&)       override;
+
+    virtual void init()  override;
+    virtual void clean() override;
+
+    virtual void kernelEventHandler(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent &event) override;
+
+    /*
+     * CPU toggled by the daemon itself, its udev event never gets here
+     */
+    void cpuOnlineChanged(int cpu,bool online);
+
+private:
+
+    /*
+     * All CPUs without cpu
+     */
+    void enforce(std::optional<size_t> cpu = std::nullopt);
+
+    void enforceCPU(const SysFsDriverCPUXList::CPUXList::CPUX& cpux,const legion::messages::CPUPolicy::Target& target);
+
+    /*
+     * Writes value when it differs, returns false when value is not accepted
+     */
+    bool writeIfDiffers(const std::filesystem::path& path,const std::string& value,bool verify);
+
+    /*
+     * Resume check runs only while policy is enabled
+     */
+    void updateResumeCheck();
+
+    void checkResume();
+
+    bool readOnAC() const;
+
+    /*
+     * Core and atom masks, without hybrid topology all CPUs are cores
+     */
+    void classes(size_t cpus,std::vector<bool>& core,std::vector<bool>& atom) const;
+
+    static std::chrono::nanoseconds suspendedTime();
+
+private:
+
+    legion::messages::CPUPolicy     m_policy;
+
+    QTimer*                         m_resumeTimer;
+    std::chrono::nanoseconds        m_suspendedTime;
+
+    bool                            m_onAC;
+    quint32                         m_coreCpus;
+    quint32                         m_atomCpus;
+    quint64                         m_enforcements;
+    quint64                         m_writes;
+    quint64                         m_failures;
+
+public:
+
+    static constexpr quint8  dataType = legion::messages::DataType::CPU_POLICY;
+};
+
+}
@@ -169,9 +169,6 @@ QByteArray SysFsDataProviderFanCurve::deserializeAndSetData(const QByteArray &da
         THROW_EXCEPTION(exception_T,DataProvider::ERROR_CODES::INVALID_DATA,"Parse of data message error !");
     }
 
-    m_sysFsDriverManager->blockKernelEvent(SysFSDriverLegionFanMode::DRIVER_NAME,true);
-    auto cleanup =  qScopeGuard([this] { m_sysFsDriverManager->blockKernelEvent(SysFSDriverLegionFanMode::DRIVER_NAME,false); });
-
     if(fanCurveMsg.has_current_value()) {
         setData(fanCurve.m_current_value,std::vector<quint8>{
                 static_cast<quint8>(fanCurveMsg.current_value().point1()),
@@ -185,9 +182,12 @@ QByteArray SysFsDataProviderFanCurve::deserializeAndSetData(const QByteArray &da
                 static_cast<quint8>(fanCurveMsg.current_value().point9()),
                 static_cast<quint8>(fanCurveMsg.current_value().point10())
                 });
-    }
 
-    m_sysFsDriverManager->processAllUdevEvents(100);
+        /*
+         * Echo of the write arrives later on the event loop and is dropped there
+         */
+        m_sysFsDriverManager->expectKernelEvents(SysFSDriverLegionFanMode::DRIVER_NAME,SysFSDriverLegionFanMode::FAN_CURVE_WRITE_EVENTS);
+    }
 
     return {};
 }
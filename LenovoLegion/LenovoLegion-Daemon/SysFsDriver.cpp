@@ -42,12 +42,81 @@ void SysFsDriver::validate() const
     }
 }
 
+void SysFsDriver::refreshDescriptorInVector(int)
+{
+    init();
+    validate();
+}
+
 void SysFsDriver::handleKernelEvent(const KernelEvent::Event &)
 {}
 
 void SysFsDriver::blockKernelEvent(bool block)
 {
-    m_blockKernelEvent = block;
+    if(block)
+    {
+        m_blockKernelEvent++;
+    }
+    else if(m_blockKernelEvent.fetch_sub(1) <= 0)
+    {
+        m_blockKernelEvent++;
+    }
+}
+
+void SysFsDriver::expectKernelEvents(int count, std::chrono::milliseconds timeout, int key)
+{
+    std::lock_guard<std::mutex> lock(m_expectedKernelEventsMutex);
+
+    ExpectedKernelEvents& expected = m_expectedKernelEvents[key];
+
+    expected.m_count    += count;
+    expected.m_deadline  = std::chrono::steady_clock::now() + timeout;
+}
+
+void SysFsDriver::restartExpectedKernelEvents(std::chrono::milliseconds timeout)
+{
+    std::lock_guard<std::mutex> lock(m_expectedKernelEventsMutex);
+
+    for(auto& expected : m_expectedKernelEvents)
+    {
+        expected.second.m_deadline = std::chrono::steady_clock::now() + timeout;
+    }
+}
+
+bool SysFsDriver::dropExpectedKernelEvent(int key)
+{
+    std::lock_guard<std::mutex> lock(m_expectedKernelEventsMutex);
+
+    const auto expected = m_expectedKernelEvents.find(key);
+
+    if(expected == m_expectedKernelEvents.end())
+    {
+        return false;
+    }
+
+    /*
+     * Echo never came (write refused), later events are real
+     */
+    if(std::chrono::steady_clock::now() > expected->second.m_deadline)
+    {
+        m_expectedKernelEvents.erase(expected);
+        return false;
+    }
+
+    if(--expected->second.m_count <= 0)
+    {
+        m_expectedKernelEvents.erase(expected);
+    }
+
+    return true;
+}
+
+qint64 SysFsDriver::numericProperty(const KernelEvent::Event &event, const QString &name, qint64 fallback)
+{
+    bool         ok    = false;
+    const qint64 value = event.m_properties.value(name).toLongLong(&ok);
+
+    return ok ? value : fallback;
 }
 
 const SysFsDriver::DescriptorsInVectorType &SysFsDriver::descriptorsInVector() const
@@ -15,7 +15,11 @@
 #include <QVector>
 #include <QSet>
 
+#include <atomic>
 #include <filesystem>
+#include <chrono>
+#include <map>
+#include <mutex>
 
 namespace LenovoLegionDaemon {
 
@@ -43,6 +47,8 @@ public:
             static constexpr std::string_view NAME      = "kernel";
             QString          m_subSystem;
             QSet<QString>    m_properties;
+            QSet<QString>    m_drivers;      // Only events of these udev DRIVERs are routed to driver, empty for all
+            QString          m_sysName;      // Only events of this SYSNAME are routed to driver, empty for all
         };
 
         struct Event {
@@ -55,19 +61,44 @@ public:
         };
     };
 
+    /*
+     * Dense ids of drivers emitting subsystem events, consumers index tables with them
+     */
+    enum DriverId : quint8
+    {
+        DRIVER_ID_UNKNOWN                   = 0,
+        DRIVER_ID_ACPI_PLATFORM_PROFILE     = 1,
+        DRIVER_ID_CPU_X_LIST                = 2,
+        DRIVER_ID_INTEL_POWERCAP_RAPL       = 3,
+        DRIVER_ID_LEGION_EVENTS             = 4,
+        DRIVER_ID_LEGION_FAN_MODE           = 5,
+        DRIVER_ID_LEGION_INTEL_MSR          = 6,
+        DRIVER_ID_LEGION_OTHER              = 7,
+        DRIVER_ID_POWER_SUPPLY_BATTERY0     = 8,
+        DRIVER_ID_COUNT
+    };
+
     struct SubsystemEvent
     {
         enum Action : int
         {
             RELOADED        = 0,
             CHANGED         = 1,
-            DRIVER_SPECIFIC = 2
+            DRIVER_SPECIFIC = 2,
+            ACTION_COUNT
         };
 
-        QString m_driverName;
-        Action  m_action;
-        QString m_DriverSpecificEventType;
-        QString m_DriverSpecificEventValue;
+        static constexpr int NO_EVENT_TYPE = -1;
+
+        QString  m_driverName;
+        DriverId m_driverId   = DRIVER_ID_UNKNOWN;
+        Action   m_action;
+
+        /*
+         * Driver specific EVENT_TYPE/EVENT_VALUE, parsed once by the emitting driver
+         */
+        int      m_eventType  = NO_EVENT_TYPE;
+        quint32  m_eventValue = 0;
     };
 
 public:
@@ -96,16 +127,37 @@ public:
      */
     virtual void validate()         const;
 
+    /*
+     * Take again single vectored descriptor, whole driver by default
+     */
+    virtual void refreshDescriptorInVector(int index);
+
     /*
      * Handle Kernel event
      */
     virtual void handleKernelEvent(const KernelEvent::Event& event);
 
     /*
-     * Block kernel event
+     * Block kernel event, blocks nest and may be set from any thread
      */
     virtual void blockKernelEvent(bool block);
 
+    /*
+     * Key of expectations not bound to a single device of the driver
+     */
+    static constexpr int ANY_KERNEL_EVENT = -1;
+
+    /*
+     * Expect kernel events echoed by own write, they are dropped as they arrive, may be called from any thread.
+     * Key tells apart devices of vectored driver (CPU index), echo of one does not consume expectation of other
+     */
+    virtual void expectKernelEvents(int count,std::chrono::milliseconds timeout,int key = ANY_KERNEL_EVENT);
+
+    /*
+     * Pending expectations wait timeout from now, for writes done while events could not be handled
+     */
+    virtual void restartExpectedKernelEvents(std::chrono::milliseconds timeout);
+
     /*
      * Get descriptors
      */
@@ -126,9 +178,27 @@ protected:
 
 
     /*
-     * Kernel event filter
+     * Kernel event filter, events are blocked while above zero
+     */
+    std::atomic<int> m_blockKernelEvent {0};
+
+    /*
+     * Drop one expected echo event of key, false when none is pending
+     */
+    bool dropExpectedKernelEvent(int key = ANY_KERNEL_EVENT);
+
+    /*
+     * Numeric property of udev event, fallback when it is missing or not a number
      */
-    bool m_blockKernelEvent = false;
+    static qint64 numericProperty(const KernelEvent::Event& event,const QString& name,qint64 fallback);
+
+    struct ExpectedKernelEvents {
+        int                                   m_count = 0;
+        std::chrono::steady_clock::time_point m_deadline;
+    };
+
+    std::mutex                            m_expectedKernelEventsMutex;
+    std::map<int,ExpectedKernelEvents>    m_expectedKernelEvents;
 
 signals:
 
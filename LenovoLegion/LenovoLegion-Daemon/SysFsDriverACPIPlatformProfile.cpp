@@ -53,9 +53,8 @@ void SysFsDriverACPIPlatformProfile::handleKernelEvent(const KernelEvent::Event
     {
         emit kernelEvent({
             .m_driverName = DRIVER_NAME,
-            .m_action = SubsystemEvent::Action::CHANGED,
-            .m_DriverSpecificEventType = "change",
-            .m_DriverSpecificEventValue = {}
+            .m_driverId = DRIVER_ID,
+            .m_action = SubsystemEvent::Action::CHANGED
         });
     }
     else
@@ -65,9 +64,8 @@ void SysFsDriverACPIPlatformProfile::handleKernelEvent(const KernelEvent::Event
 
         emit kernelEvent({
             .m_driverName = DRIVER_NAME,
-            .m_action = SubsystemEvent::Action::RELOADED,
-            .m_DriverSpecificEventType = "reloaded",
-            .m_DriverSpecificEventValue = {}
+            .m_driverId = DRIVER_ID,
+            .m_action = SubsystemEvent::Action::RELOADED
         });
     }
 }
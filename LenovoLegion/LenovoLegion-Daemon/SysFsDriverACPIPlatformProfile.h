@@ -49,6 +49,7 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME =  "platform_profile";
+    static constexpr DriverId    DRIVER_ID   =  DRIVER_ID_ACPI_PLATFORM_PROFILE;
 };
 
 }
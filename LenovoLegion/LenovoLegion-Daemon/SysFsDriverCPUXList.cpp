@@ -11,7 +11,7 @@
 
 namespace LenovoLegionDaemon {
 
-SysFsDriverCPUXList::SysFsDriverCPUXList(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/devices/system/cpu/",{"cpu",{}},parrent) {}
+SysFsDriverCPUXList::SysFsDriverCPUXList(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/devices/system/cpu/",{"cpu",{},{DRIVER_NAME}},parrent) {}
 
 void SysFsDriverCPUXList::init()
 {
@@ -26,82 +26,168 @@ void SysFsDriverCPUXList::init()
     {
         if(entry.is_directory())
         {
+            const int cpuIndex = cpuIndexOf((--entry.path().end())->string());
 
-            auto dir = (--entry.path().end())->string();
-            if(dir.find("cpu") != std::string::npos && dir.substr(std::string("cpu").size()).size() > 0 && std::isdigit(dir.substr(std::string("cpu").size())[0]))
+            if(cpuIndex >= 0)
             {
                 LOG_D(QString("Found CPUX driver in path: ") + entry.path().c_str());
 
-                qsizetype cpuIndex = std::stoi(dir.substr(std::string("cpu").size()));
-
-                m_descriptorsInVector.resize(std::max(cpuIndex + 1,m_descriptorsInVector.size()));
-
-                if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("cpufreq")))
-                {
-                    LOG_D(QString("Found CPUX cpufreq driver in path: ") + std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("cpufreq").c_str());
-
-                    m_descriptorsInVector[cpuIndex]["affectedCpus"]                    = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("affected_cpus");
-                    if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("base_frequency")))
-                    {
-                        m_descriptorsInVector[cpuIndex]["cpuBaseFreq"]                     = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("base_frequency");
-                    }
-                    m_descriptorsInVector[cpuIndex]["cpuInfoMinFreq"]                  = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("cpuinfo_min_freq");
-                    m_descriptorsInVector[cpuIndex]["cpuInfoMaxFreq"]                  = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("cpuinfo_max_freq");
-                    m_descriptorsInVector[cpuIndex]["cpuScalingAvailableGovernors"]    = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_available_governors");
-                    m_descriptorsInVector[cpuIndex]["cpuScalingGovernor"]              = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_governor");
-                    m_descriptorsInVector[cpuIndex]["cpuScalingCurFreq"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_cur_freq");
-                    m_descriptorsInVector[cpuIndex]["cpuScalingMinFreq"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_min_freq");
-                    m_descriptorsInVector[cpuIndex]["cpuScalingMaxFreq"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_max_freq");
-
-
-                    if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology")))
-                    {
-                        LOG_D(QString("Found CPUX topology driver in path: ") + std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").c_str());
-
-                        m_descriptorsInVector[cpuIndex]["clusterId"]                       = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("cluster_id");
-                        m_descriptorsInVector[cpuIndex]["physicalPackageId"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("physical_package_id");
-                        m_descriptorsInVector[cpuIndex]["coreId"]                          = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("core_id");
-                        m_descriptorsInVector[cpuIndex]["dieId"]                           = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("die_id");
-                        m_descriptorsInVector[cpuIndex]["clusterCpusList"]                 = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("cluster_cpus_list");
-                        m_descriptorsInVector[cpuIndex]["packageCpusList"]                 = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("package_cpus_list");
-                        m_descriptorsInVector[cpuIndex]["dieCpusList"]                     = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("die_cpus_list");
-                        m_descriptorsInVector[cpuIndex]["coreCpusList"]                    = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("core_cpus_list");
-                        m_descriptorsInVector[cpuIndex]["coreSiblingsList"]                = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("core_siblings_list");
-                        m_descriptorsInVector[cpuIndex]["threadSiblingsList"]              = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("thread_siblings_list");
-                    }
-
-                    if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("online")))
-                    {
-                        m_descriptorsInVector[cpuIndex]["cpuOnline"]                       = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("online");
-                    }
-                }
+                m_descriptorsInVector.resize(std::max(static_cast<qsizetype>(cpuIndex + 1),m_descriptorsInVector.size()));
+
+                scanCPU(cpuIndex);
             }
         }
     }
 }
 
+void SysFsDriverCPUXList::refreshDescriptorInVector(int index)
+{
+    LOG_T(__PRETTY_FUNCTION__);
+
+    /*
+     * CPU not known yet, whole list has to be taken again
+     */
+    if(index < 0 || index >= m_descriptorsInVector.size() || !std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(index))))
+    {
+        SysFsDriver::refreshDescriptorInVector(index);
+        return;
+    }
+
+    scanCPU(index);
+
+    for (const auto& path : m_descriptorsInVector.at(index)) {
+        if(!std::filesystem::exists(path))
+        {
+            THROW_EXCEPTION(exception_T,ERROR_CODES::VALIDATION_ERROR,std::string("Driver not found in path: ").append(path).c_str());
+        }
+    }
+}
+
+int SysFsDriverCPUXList::cpuIndexOf(const std::string &name)
+{
+    if(name.size() <= std::string("cpu").size() || name.compare(0,std::string("cpu").size(),"cpu") != 0)
+    {
+        return -1;
+    }
+
+    for(size_t i = std::string("cpu").size(); i < name.size(); ++i)
+    {
+        if(!std::isdigit(static_cast<unsigned char>(name[i])))
+        {
+            return -1;
+        }
+    }
+
+    return std::stoi(name.substr(std::string("cpu").size()));
+}
+
+void SysFsDriverCPUXList::scanCPU(int cpuIndex)
+{
+    /*
+     * Offline CPU loses its topology directory, descriptor is built from scratch every time
+     */
+    m_descriptorsInVector[cpuIndex].clear();
+
+    if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("cpufreq")))
+    {
+        LOG_D(QString("Found CPUX cpufreq driver in path: ") + std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("cpufreq").c_str());
+
+        m_descriptorsInVector[cpuIndex]["affectedCpus"]                    = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("affected_cpus");
+        if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("base_frequency")))
+        {
+            m_descriptorsInVector[cpuIndex]["cpuBaseFreq"]                     = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("base_frequency");
+        }
+        m_descriptorsInVector[cpuIndex]["cpuInfoMinFreq"]                  = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("cpuinfo_min_freq");
+        m_descriptorsInVector[cpuIndex]["cpuInfoMaxFreq"]                  = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("cpuinfo_max_freq");
+        m_descriptorsInVector[cpuIndex]["cpuScalingAvailableGovernors"]    = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_available_governors");
+        m_descriptorsInVector[cpuIndex]["cpuScalingGovernor"]              = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_governor");
+        m_descriptorsInVector[cpuIndex]["cpuScalingCurFreq"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_cur_freq");
+        m_descriptorsInVector[cpuIndex]["cpuScalingMinFreq"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_min_freq");
+        m_descriptorsInVector[cpuIndex]["cpuScalingMaxFreq"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("scaling_max_freq");
+
+        if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("energy_performance_preference")))
+        {
+            m_descriptorsInVector[cpuIndex]["cpuEnergyPerformancePreference"]           = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("energy_performance_preference");
+            m_descriptorsInVector[cpuIndex]["cpuEnergyPerformanceAvailablePreferences"] = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string( cpuIndex)).append("cpufreq").append("energy_performance_available_preferences");
+        }
+
+
+        if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology")))
+        {
+            LOG_D(QString("Found CPUX topology driver in path: ") + std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").c_str());
+
+            m_descriptorsInVector[cpuIndex]["clusterId"]                       = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("cluster_id");
+            m_descriptorsInVector[cpuIndex]["physicalPackageId"]               = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("physical_package_id");
+            m_descriptorsInVector[cpuIndex]["coreId"]                          = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("core_id");
+            m_descriptorsInVector[cpuIndex]["dieId"]                           = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("die_id");
+            m_descriptorsInVector[cpuIndex]["clusterCpusList"]                 = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("cluster_cpus_list");
+            m_descriptorsInVector[cpuIndex]["packageCpusList"]                 = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("package_cpus_list");
+            m_descriptorsInVector[cpuIndex]["dieCpusList"]                     = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("die_cpus_list");
+            m_descriptorsInVector[cpuIndex]["coreCpusList"]                    = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("core_cpus_list");
+            m_descriptorsInVector[cpuIndex]["coreSiblingsList"]                = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("core_siblings_list");
+            m_descriptorsInVector[cpuIndex]["threadSiblingsList"]              = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("topology").append("thread_siblings_list");
+        }
+
+        if(std::filesystem::exists(std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("online")))
+        {
+            m_descriptorsInVector[cpuIndex]["cpuOnline"]                       = std::filesystem::path(m_path).append(std::string("cpu") + std::to_string(cpuIndex)).append("online");
+        }
+    }
+}
+
 void SysFsDriverCPUXList::handleKernelEvent(const KernelEvent::Event &event)
 {
     LOG_D(__PRETTY_FUNCTION__ + QString(": Kernel event received ACTION=") + event.m_action + ", DRIVER=" + event.m_driver + ", SYSNAME=" + event.m_sysName + ", SUBSYSTEM=" + event.m_subSystem + ", DEVPATH=" + event.m_devPath);
 
+    if(event.m_driver != DRIVER_NAME)
+    {
+        return;
+    }
+
+    const int  cpuIndex = cpuIndexOf(event.m_sysName.toStdString());
+    const bool hotplug  = (event.m_action == "online" || event.m_action == "offline") && cpuIndex >= 0 && cpuIndex < m_descriptorsInVector.size();
+
+    /*
+     * Echo takes its expectation even while blocked, it must not wait there for a real event
+     */
+    if(hotplug && dropExpectedKernelEvent(cpuIndex))
+    {
+        LOG_T(QString("Expected kernel event dropped for driver: ") + m_name);
+        return;
+    }
+
     if(m_blockKernelEvent)
     {
         LOG_T(QString("Kernel event blocked for driver: ") + m_name);
         return;
     }
 
-    if(event.m_driver == DRIVER_NAME)
+    /*
+     * CPU hotplug, only descriptor of toggled CPU is taken again
+     */
+    if(hotplug)
     {
-        init();
-        validate();
+        scanCPU(cpuIndex);
 
         emit kernelEvent({
             .m_driverName = DRIVER_NAME,
-            .m_action = SubsystemEvent::Action::RELOADED,
-            .m_DriverSpecificEventType = "reloaded",
-            .m_DriverSpecificEventValue = {}
+            .m_driverId = DRIVER_ID,
+            .m_action = SubsystemEvent::Action::CHANGED,
+            .m_eventType = event.m_action == "online" ? CPU_X_ONLINE : CPU_X_OFFLINE,
+            .m_eventValue = static_cast<quint32>(cpuIndex)
         });
+
+        return;
     }
+
+    init();
+    validate();
+
+    emit kernelEvent({
+        .m_driverName = DRIVER_NAME,
+        .m_driverId = DRIVER_ID,
+        .m_action = SubsystemEvent::Action::RELOADED
+    });
 }
 
 }
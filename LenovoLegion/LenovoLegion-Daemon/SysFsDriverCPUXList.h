@@ -34,7 +34,9 @@ public:
                     m_cpuScalingGovernor(descriptor["cpuScalingGovernor"]),
                     m_cpuScalingCurFreq(descriptor["cpuScalingCurFreq"]),
                     m_cpuScalingMinFreq(descriptor["cpuScalingMinFreq"]),
-                    m_cpuScalingMaxFreq(descriptor["cpuScalingMaxFreq"])
+                    m_cpuScalingMaxFreq(descriptor["cpuScalingMaxFreq"]),
+                    m_cpuEnergyPerformancePreference((descriptor.find("cpuEnergyPerformancePreference") == descriptor.end()) ? std::optional<std::filesystem::path>() : descriptor["cpuEnergyPerformancePreference"]),
+                    m_cpuEnergyPerformanceAvailablePreferences((descriptor.find("cpuEnergyPerformanceAvailablePreferences") == descriptor.end()) ? std::optional<std::filesystem::path>() : descriptor["cpuEnergyPerformanceAvailablePreferences"])
                 {}
 
                 const std::filesystem::path                m_affectedCpus;                    //List of online CPUs belonging to this policy (i.e. sharing the hardware performance scaling interface represented by the policyX policy object).
@@ -46,6 +48,8 @@ public:
                 const std::filesystem::path                m_cpuScalingCurFreq;               //Current frequency of all of the CPUs belonging to this policy (in kHz).
                 const std::filesystem::path                m_cpuScalingMinFreq;               //Minimum frequency the CPUs belonging to this policy are allowed to be running at (in kHz).
                 const std::filesystem::path                m_cpuScalingMaxFreq;               //Maximum frequency the CPUs belonging to this policy are allowed to be running at (in kHz).
+                const std::optional<std::filesystem::path> m_cpuEnergyPerformancePreference;  //Energy vs performance hint of this policy, only with intel_pstate or amd_pstate in active mode.
+                const std::optional<std::filesystem::path> m_cpuEnergyPerformanceAvailablePreferences; //List of energy vs performance hints accepted by this policy.
             };
 
             struct CPUXTopology {
@@ -138,6 +142,12 @@ public:
     virtual void init() override;
 
 
+    /*
+     * Take again descriptor of single CPU
+     */
+    virtual void refreshDescriptorInVector(int index) override;
+
+
     virtual void handleKernelEvent(const KernelEvent::Event& event) override;
 
 
@@ -145,6 +155,24 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME =  "processor";
+    static constexpr DriverId    DRIVER_ID   =  DRIVER_ID_CPU_X_LIST;
+
+    /*
+     * Event types of CHANGED event, event value is CPU index
+     */
+    enum CPUXEventType : int {
+        CPU_X_ONLINE  = 0,
+        CPU_X_OFFLINE = 1
+    };
+
+private:
+
+    /*
+     * Index of cpuN directory name, -1 for other names
+     */
+    static int cpuIndexOf(const std::string& name);
+
+    void scanCPU(int cpuIndex);
 };
 
 }
@@ -12,7 +12,7 @@
 namespace LenovoLegionDaemon {
 
 
-SysFsDriverIntelPowercapRapl::SysFsDriverIntelPowercapRapl(QObject* parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/powercap/",{"powercap",{}},parrent) {}
+SysFsDriverIntelPowercapRapl::SysFsDriverIntelPowercapRapl(QObject* parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/powercap/",{"powercap",{},{},"intel-rapl:0"},parrent) {}
 
 void SysFsDriverIntelPowercapRapl::init()
 {
@@ -124,9 +124,8 @@ void SysFsDriverIntelPowercapRapl::handleKernelEvent(const KernelEvent::Event &e
 
         emit kernelEvent({
             .m_driverName = DRIVER_NAME,
-            .m_action = SubsystemEvent::Action::RELOADED,
-            .m_DriverSpecificEventType = "reloaded",
-            .m_DriverSpecificEventValue = {}
+            .m_driverId = DRIVER_ID,
+            .m_action = SubsystemEvent::Action::RELOADED
         });
     }
 }
@@ -120,6 +120,7 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME =  "intel-rapl";
+    static constexpr DriverId    DRIVER_ID   =  DRIVER_ID_INTEL_POWERCAP_RAPL;
 };
 
 }
@@ -11,7 +11,7 @@
 
 namespace LenovoLegionDaemon {
 
-SysFsDriverLegionEvents::SysFsDriverLegionEvents(QObject *parrent) :SysFsDriver(DRIVER_NAME,"",{"wmi",{EVENT_TYPE.data(),EVENT_VALUE.data()}},parrent) {}
+SysFsDriverLegionEvents::SysFsDriverLegionEvents(QObject *parrent) :SysFsDriver(DRIVER_NAME,"",{"wmi",{EVENT_TYPE.data(),EVENT_VALUE.data()},{DRIVER_NAME}},parrent) {}
 
 void SysFsDriverLegionEvents::init()
 {}
@@ -36,9 +36,10 @@ void SysFsDriverLegionEvents::handleKernelEvent(const SysFsDriver::KernelEvent::
          {
              emit kernelEvent({
                  .m_driverName = DRIVER_NAME,
+                 .m_driverId = DRIVER_ID,
                  .m_action = SubsystemEvent::Action::CHANGED,
-                 .m_DriverSpecificEventType = event.m_properties[EVENT_TYPE.data()],
-                 .m_DriverSpecificEventValue  = event.m_properties[EVENT_VALUE.data()]
+                 .m_eventType = static_cast<int>(numericProperty(event,EVENT_TYPE.data(),SubsystemEvent::NO_EVENT_TYPE)),
+                 .m_eventValue  = static_cast<quint32>(numericProperty(event,EVENT_VALUE.data(),0))
              });
          }
      }
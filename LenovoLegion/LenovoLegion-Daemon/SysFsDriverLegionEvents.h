@@ -46,6 +46,7 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME =  "legion_wmi_events";
+    static constexpr DriverId    DRIVER_ID   =  DRIVER_ID_LEGION_EVENTS;
     static constexpr const char* MODULE_NAME =  LEGION_MODULE_NAME;
 
 private:
@@ -16,7 +16,7 @@
 
 namespace LenovoLegionDaemon {
 
-SysFsDriverLegionOther::SysFsDriverLegionOther(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-firmware-attributes/legion-wmi-other-0/attributes/",{"wmi",{}},parrent,MODULE_NAME)
+SysFsDriverLegionOther::SysFsDriverLegionOther(QObject *parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/legion-firmware-attributes/legion-wmi-other-0/attributes/",{"wmi",{},{DRIVER_NAME,DEPENDENCY[0],DEPENDENCY[1]}},parrent,MODULE_NAME)
 {}
 
 void SysFsDriverLegionOther::init()
@@ -107,9 +107,10 @@ void SysFsDriverLegionOther::handleKernelEvent(const KernelEvent::Event &event)
         {
             emit kernelEvent({
                 .m_driverName = DRIVER_NAME,
+                .m_driverId = DRIVER_ID,
                 .m_action = SubsystemEvent::Action::CHANGED,
-                .m_DriverSpecificEventType = event.m_properties.value("EVENT_TYPE", ""),
-                .m_DriverSpecificEventValue = event.m_properties.value("EVENT_VALUE", "")
+                .m_eventType = static_cast<int>(numericProperty(event,"EVENT_TYPE",SubsystemEvent::NO_EVENT_TYPE)),
+                .m_eventValue = static_cast<quint32>(numericProperty(event,"EVENT_VALUE",0))
             });
         }
     }
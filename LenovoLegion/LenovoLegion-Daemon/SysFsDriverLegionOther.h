@@ -156,6 +156,7 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME   =  "legion_wmi_other";
+    static constexpr DriverId    DRIVER_ID     =  DRIVER_ID_LEGION_OTHER;
     static constexpr const char* MODULE_NAME   =  LEGION_MODULE_NAME;
     static constexpr const char* DEPENDENCY[]  =  {"legion_wmi_cd01","legion_wmi_dd"};
 };
@@ -10,6 +10,8 @@
 #include <Core/LoggerHolder.h>
 
 #include <QSocketNotifier>
+#include <QThread>
+#include <QTimer>
 
 #include <SysFsDriver.h>
 
@@ -17,6 +19,8 @@
 
 #include <poll.h>
 
+#include <algorithm>
+
 namespace LenovoLegionDaemon {
 
 const  SysFsDriver::KernelEvent::Filter SysFsDriverManager::MODULE_SUBSYSTEM_EVENT_FILTER = { "module" ,{}};
@@ -52,6 +56,13 @@ SysFsDriverManager::SysFsDriverManager(QObject *parent)
      * Add module subsystem filter
      */
     addUdevMonitorFilter(MODULE_SUBSYSTEM_EVENT_FILTER);
+
+    /*
+     * Default debounce windows, battery ticks and CPU/RAPL reloads come in bursts, hotkeys must not wait
+     */
+    setKernelEventDebounce(SysFsDriver::DRIVER_ID_POWER_SUPPLY_BATTERY0,std::chrono::milliseconds(50));
+    setKernelEventDebounce(SysFsDriver::DRIVER_ID_CPU_X_LIST,std::chrono::milliseconds(50));
+    setKernelEventDebounce(SysFsDriver::DRIVER_ID_INTEL_POWERCAP_RAPL,std::chrono::milliseconds(50));
 }
 
 SysFsDriverManager::~SysFsDriverManager()
@@ -99,6 +110,8 @@ void SysFsDriverManager::initDrivers()
 
         addUdevMonitorFilter(driver.second->m_filter);
     }
+
+    buildKernelEventRoutes();
 }
 
 void SysFsDriverManager::cleanDrivers()
@@ -110,6 +123,8 @@ void SysFsDriverManager::cleanDrivers()
     }
 
     m_drivers.clear();
+    m_kernelEventRoutes.clear();
+    m_moduleRoutes.clear();
 }
 
 void SysFsDriverManager::blockKernelEvent(const QString &driverName, bool block)
@@ -121,6 +136,23 @@ void SysFsDriverManager::blockKernelEvent(const QString &driverName, bool block)
     }
 }
 
+void SysFsDriverManager::expectKernelEvents(const QString &driverName, int count, std::chrono::milliseconds timeout, int key)
+{
+    try {
+        m_drivers.at(driverName)->expectKernelEvents(count,timeout,key);
+    } catch (const std::out_of_range& ex) {
+        THROW_EXCEPTION(exception_T,ERROR_CODES::DRIVER_NOT_FOUND,"Driver not found !");
+    }
+}
+
+void SysFsDriverManager::restartExpectedKernelEvents(std::chrono::milliseconds timeout)
+{
+    for(auto& driver : m_drivers)
+    {
+        driver.second->restartExpectedKernelEvents(timeout);
+    }
+}
+
 void SysFsDriverManager::blockSignals(const QString &driverName,bool block)
 {
     try {
@@ -140,6 +172,15 @@ void SysFsDriverManager::refreshDriver(const QString &driverName)
     }
 }
 
+void SysFsDriverManager::refreshDriver(const QString &driverName, int descriptorIndex)
+{
+    try {
+        m_drivers.at(driverName)->refreshDescriptorInVector(descriptorIndex);
+    } catch (const std::out_of_range& ex) {
+        THROW_EXCEPTION(exception_T,ERROR_CODES::DRIVER_NOT_FOUND,"Driver not found !");
+    }
+}
+
 const SysFsDriver::DescriptorType&  SysFsDriverManager::getDriverDesriptor(const QString &driverName) const
 {
     try {
@@ -160,6 +201,15 @@ const SysFsDriver::DescriptorsInVectorType &SysFsDriverManager::getDriverDescrip
 
 void SysFsDriverManager::processAllUdevEvents(int timeoutInMiliseconds)
 {
+    /*
+     * Settings applied on worker threads, monitor and drivers belong to daemon thread, events
+     * are handled there once it gets back to its event loop
+     */
+    if(QThread::currentThread() != thread())
+    {
+        return;
+    }
+
     // Process ALL pending SocketNotifier events
     // Use poll to check if FD is ready
     pollfd pfd;
@@ -212,103 +262,289 @@ void SysFsDriverManager::processAllUdevEvents(int timeoutInMiliseconds)
 
 void SysFsDriverManager::onDataReceived(int)
 {
-    struct udev_device *dev = udev_monitor_receive_device(m_mon);
+    /*
+     * Drain every queued message, storm of events costs one notifier activation
+     */
+    int events = 0;
+
+    for(struct udev_device *dev = udev_monitor_receive_device(m_mon); dev != nullptr; dev = udev_monitor_receive_device(m_mon))
+    {
+        dispatchUdevDevice(dev);
+        udev_device_unref(dev);
+
+        ++events;
+    }
+
+    LOG_T(QString(__PRETTY_FUNCTION__) + QString(": %1 kernel events drained").arg(events));
+
+    // NULL device can mean:
+    // 1. No data available (EAGAIN) - normal, queue is drained
+    // 2. Socket error or disconnect - need to check
+    checkUdevMonitor();
+}
+
+void SysFsDriverManager::dispatchUdevDevice(udev_device *dev)
+{
+    SysFsDriver::KernelEvent::Event event = {
+        .m_action       = udev_device_get_action(dev)   ,
+        .m_driver       = udev_device_get_driver(dev)   ,
+        .m_sysName      = udev_device_get_sysname(dev)  ,
+        .m_subSystem    = udev_device_get_subsystem(dev),
+        .m_devPath      = udev_device_get_devpath(dev)  ,
+        .m_properties   = {}
+    };
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + ": Kernel event received ACTION=" + event.m_action + ", DRIVER=" + event.m_driver + ", SYSNAME=" + event.m_sysName + ", SUBSYSTEM=" + event.m_subSystem + ", DEVPATH=" + event.m_devPath);
 
-    if(dev != nullptr)
+    if(event.m_subSystem == MODULE_SUBSYSTEM_EVENT_FILTER.m_subSystem)
     {
-        SysFsDriver::KernelEvent::Event event = {
-            .m_action       = udev_device_get_action(dev)   ,
-            .m_driver       = udev_device_get_driver(dev)   ,
-            .m_sysName      = udev_device_get_sysname(dev)  ,
-            .m_subSystem    = udev_device_get_subsystem(dev),
-            .m_devPath      = udev_device_get_devpath(dev)  ,
-            .m_properties   = {}
-        };
-
-         LOG_D(QString(__PRETTY_FUNCTION__) + ": Kernel event received ACTION=" + event.m_action + ", DRIVER=" + event.m_driver + ", SYSNAME=" + event.m_sysName + ", SUBSYSTEM=" + event.m_subSystem + ", DEVPATH=" + event.m_devPath);
-
-        if(event.m_subSystem == MODULE_SUBSYSTEM_EVENT_FILTER.m_subSystem)
+        const auto module = m_moduleRoutes.constFind(event.m_sysName);
+
+        if(module == m_moduleRoutes.constEnd())
         {
-            for(auto& driver : m_drivers)
-            {
-                if(driver.second->m_module == event.m_sysName)
-                {
-                    if(event.m_action == "add")
-                    {
-                        driver.second->init();
-                        driver.second->validate();
-
-                        emit moduleSubsystem({
-                            .m_moduleName = driver.second->m_module,
-                            .m_action     = ModuleSubsystemEvent::Action::ADD
-                        });
-                    }
-
-                    if(event.m_action == "remove")
-                    {
-                        driver.second->clean();
-
-                        emit moduleSubsystem({
-                            .m_moduleName = driver.second->m_module,
-                            .m_action     = ModuleSubsystemEvent::Action::REMOVE
-                        });
-                    }
-                }
-            }
+            return;
         }
-        else
+
+        for(SysFsDriver* driver : module.value())
         {
-            for (auto& driver : m_drivers)
+            if(event.m_action == "add")
             {
-                if(driver.second->m_filter.m_subSystem == event.m_subSystem)
-                {
-                    for (const auto & property :driver.second->m_filter.m_properties)
-                    {
-                        event.m_properties[property] = udev_device_get_property_value(dev, property.toStdString().c_str());
-                    }
-
-                    driver.second->handleKernelEvent(event);
-                }
+                driver->init();
+                driver->validate();
+
+                emit moduleSubsystem({
+                    .m_moduleName = driver->m_module,
+                    .m_action     = ModuleSubsystemEvent::Action::ADD
+                });
+            }
+
+            if(event.m_action == "remove")
+            {
+                driver->clean();
+
+                emit moduleSubsystem({
+                    .m_moduleName = driver->m_module,
+                    .m_action     = ModuleSubsystemEvent::Action::REMOVE
+                });
             }
         }
 
-        udev_device_unref(dev);
+        return;
     }
-    else
+
+    const auto routes = m_kernelEventRoutes.constFind(event.m_subSystem);
+
+    if(routes == m_kernelEventRoutes.constEnd())
     {
-        // NULL device can mean:
-        // 1. No data available (EAGAIN) - normal, just return
-        // 2. Socket error or disconnect - need to check
-        
-        // Use poll to check the actual socket state
-        pollfd pfd;
-        pfd.fd = udev_monitor_get_fd(m_mon);
-        pfd.events = POLLIN;
-        pfd.revents = 0;
-        
-        int ret = poll(&pfd, 1, 0);
-        
-        // Check for error conditions
-        if (ret > 0 && (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))) {
-            if (pfd.revents & POLLERR) {
-                LOG_E(QString(__PRETTY_FUNCTION__) + ": Socket error detected");
-            }
-            if (pfd.revents & POLLHUP) {
-                LOG_E(QString(__PRETTY_FUNCTION__) + ": Socket hangup detected");
-            }
-            if (pfd.revents & POLLNVAL) {
-                LOG_E(QString(__PRETTY_FUNCTION__) + ": Invalid socket detected");
+        return;
+    }
+
+    dispatchKernelEvent(routes->m_any,dev,event);
+
+    if(const auto route = routes->m_byDriver.constFind(event.m_driver); route != routes->m_byDriver.constEnd())
+    {
+        dispatchKernelEvent(route.value(),dev,event);
+    }
+
+    if(const auto route = routes->m_bySysName.constFind(event.m_sysName); route != routes->m_bySysName.constEnd())
+    {
+        dispatchKernelEvent(route.value(),dev,event);
+    }
+}
+
+void SysFsDriverManager::dispatchKernelEvent(const KernelEventRoute &route, udev_device *dev, SysFsDriver::KernelEvent::Event &event)
+{
+    /*
+     * Every property is read from udev once per event, whichever route asks first
+     */
+    for(const auto& property : route.m_properties)
+    {
+        if(!event.m_properties.contains(property.first))
+        {
+            event.m_properties.insert(property.first,udev_device_get_property_value(dev,property.second.constData()));
+        }
+    }
+
+    for(SysFsDriver* driver : route.m_drivers)
+    {
+        driver->handleKernelEvent(event);
+    }
+}
+
+void SysFsDriverManager::checkUdevMonitor()
+{
+    // Use poll to check the actual socket state
+    pollfd pfd;
+    pfd.fd = udev_monitor_get_fd(m_mon);
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ret = poll(&pfd, 1, 0);
+
+    // Check for error conditions
+    if (ret > 0 && (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))) {
+        if (pfd.revents & POLLERR) {
+            LOG_E(QString(__PRETTY_FUNCTION__) + ": Socket error detected");
+        }
+        if (pfd.revents & POLLHUP) {
+            LOG_E(QString(__PRETTY_FUNCTION__) + ": Socket hangup detected");
+        }
+        if (pfd.revents & POLLNVAL) {
+            LOG_E(QString(__PRETTY_FUNCTION__) + ": Invalid socket detected");
+        }
+
+        // Disconnect is detected - attempt reconnection
+        reconnectUdevMonitor();
+    }
+}
+
+void SysFsDriverManager::buildKernelEventRoutes()
+{
+    m_kernelEventRoutes.clear();
+    m_moduleRoutes.clear();
+
+    for(const auto& driver : m_drivers)
+    {
+        const SysFsDriver::KernelEvent::Filter& filter = driver.second->m_filter;
+
+        if(!driver.second->m_module.isEmpty())
+        {
+            m_moduleRoutes[driver.second->m_module].push_back(driver.second);
+        }
+
+        if(filter.m_subSystem.isEmpty())
+        {
+            continue;
+        }
+
+        SubsystemRoutes& routes = m_kernelEventRoutes[filter.m_subSystem];
+
+        if(!filter.m_drivers.isEmpty())
+        {
+            for(const QString& name : filter.m_drivers)
+            {
+                addKernelEventRoute(routes.m_byDriver[name],driver.second);
             }
-            
-            // Disconnect is detected - attempt reconnection
-            reconnectUdevMonitor();
+        }
+        else if(!filter.m_sysName.isEmpty())
+        {
+            addKernelEventRoute(routes.m_bySysName[filter.m_sysName],driver.second);
+        }
+        else
+        {
+            addKernelEventRoute(routes.m_any,driver.second);
+        }
+    }
+
+    LOG_D(QString(__PRETTY_FUNCTION__) + QString(": Kernel event routes built for %1 subsystems and %2 modules").arg(m_kernelEventRoutes.size()).arg(m_moduleRoutes.size()));
+}
+
+void SysFsDriverManager::addKernelEventRoute(KernelEventRoute &route, SysFsDriver *driver)
+{
+    route.m_drivers.push_back(driver);
+
+    for(const QString& property : driver->m_filter.m_properties)
+    {
+        if(std::find_if(route.m_properties.begin(),route.m_properties.end(),[&property](const auto& item) { return item.first == property; }) == route.m_properties.end())
+        {
+            route.m_properties.emplace_back(property,property.toUtf8());
         }
     }
 }
 
 void SysFsDriverManager::onKernelEvent(const SysFsDriver::SubsystemEvent &event)
 {
-    emit kernelEvent(event);
+    KernelEventDebounce& debounce = m_kernelEventDebounce[event.m_driverId < SysFsDriver::DRIVER_ID_COUNT ? event.m_driverId : SysFsDriver::DRIVER_ID_UNKNOWN];
+
+    debounce.m_driverName = event.m_driverName;
+    debounce.m_counters.m_raw++;
+
+    if(debounce.m_window.count() == 0)
+    {
+        debounce.m_counters.m_delivered++;
+
+        emit kernelEvent(event);
+        return;
+    }
+
+    /*
+     * Identical event pending earlier is dropped and the new one goes to the tail, so the delivered
+     * order ends with what happened last (ONLINE, OFFLINE, ONLINE of one CPU ends ONLINE)
+     */
+    const auto merged = std::find_if(debounce.m_pending.begin(),debounce.m_pending.end(),[&event](const SysFsDriver::SubsystemEvent& pending) {
+        return pending.m_action == event.m_action && pending.m_eventType == event.m_eventType && pending.m_eventValue == event.m_eventValue;
+    });
+
+    if(merged != debounce.m_pending.end())
+    {
+        LOG_T(QString(__PRETTY_FUNCTION__) + ": Kernel event merged for driver " + event.m_driverName);
+        debounce.m_pending.erase(merged);
+    }
+
+    debounce.m_pending.push_back(event);
+
+    /*
+     * Window starts with the first pending event, a steady storm still gets delivered every window
+     */
+    if(!debounce.m_timer->isActive())
+    {
+        debounce.m_timer->start(debounce.m_window);
+    }
+}
+
+void SysFsDriverManager::flushKernelEvents(SysFsDriver::DriverId driverId)
+{
+    std::vector<SysFsDriver::SubsystemEvent> pending;
+
+    pending.swap(m_kernelEventDebounce[driverId].m_pending);
+
+    for(const auto& event : pending)
+    {
+        m_kernelEventDebounce[driverId].m_counters.m_delivered++;
+
+        emit kernelEvent(event);
+    }
+}
+
+void SysFsDriverManager::setKernelEventDebounce(SysFsDriver::DriverId driverId, std::chrono::milliseconds window)
+{
+    if(driverId >= SysFsDriver::DRIVER_ID_COUNT)
+    {
+        THROW_EXCEPTION(exception_T,ERROR_CODES::DRIVER_NOT_FOUND,"Driver not found !");
+    }
+
+    KernelEventDebounce& debounce = m_kernelEventDebounce[driverId];
+
+    debounce.m_window = window;
+
+    if(debounce.m_timer == nullptr)
+    {
+        debounce.m_timer = new QTimer(this);
+        debounce.m_timer->setSingleShot(true);
+        debounce.m_timer->setTimerType(Qt::PreciseTimer);
+
+        connect(debounce.m_timer,&QTimer::timeout,this,[this,driverId] { flushKernelEvents(driverId); });
+    }
+
+    /*
+     * Events pending under the old window are not kept waiting
+     */
+    if(window.count() == 0)
+    {
+        debounce.m_timer->stop();
+        flushKernelEvents(driverId);
+    }
+}
+
+void SysFsDriverManager::forEachKernelEventCountersDo(const std::function<void (const QString &, const KernelEventCounters &)> &func) const
+{
+    for(const auto& debounce : m_kernelEventDebounce)
+    {
+        if(debounce.m_counters.m_raw > 0)
+        {
+            func(debounce.m_driverName,debounce.m_counters);
+        }
+    }
 }
 
 void SysFsDriverManager::addUdevMonitorFilter(const SysFsDriver::KernelEvent::Filter &filter)
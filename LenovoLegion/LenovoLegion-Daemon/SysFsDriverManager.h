@@ -13,12 +13,19 @@
 
 #include <QObject>
 #include <QString>
+#include <QHash>
+#include <QByteArray>
 
+#include <array>
+#include <chrono>
+#include <functional>
 #include <map>
+#include <vector>
 
 #include <libudev.h>
 
 class QSocketNotifier;
+class QTimer;
 
 namespace LenovoLegionDaemon {
 
@@ -51,6 +58,12 @@ public:
         Action  m_action;
     };
 
+    struct KernelEventCounters
+    {
+        quint64 m_raw       = 0;    // Emitted by driver
+        quint64 m_delivered = 0;    // Emitted by manager after debounce
+    };
+
 public:
 
     explicit SysFsDriverManager(QObject *parent = nullptr);
@@ -65,14 +78,24 @@ public:
 
 
     void  blockKernelEvent(const QString& driverName,bool block);
+    void  expectKernelEvents(const QString& driverName,int count,std::chrono::milliseconds timeout = std::chrono::milliseconds(1000),int key = SysFsDriver::ANY_KERNEL_EVENT);
+    void  restartExpectedKernelEvents(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
     void  blockSignals(const QString& driverName,bool block);
     void  refreshDriver(const QString& driverName);
+    void  refreshDriver(const QString& driverName,int descriptorIndex);
 
     const SysFsDriver::DescriptorType&          getDriverDesriptor(const QString& driverName) const;
     const SysFsDriver::DescriptorsInVectorType& getDriverDescriptorsInVector(const QString& driverName) const;
 
     void processAllUdevEvents(int timeoutInMiliseconds);
 
+    /*
+     * Identical events of driver arriving within window are delivered once at its end, zero delivers at once
+     */
+    void setKernelEventDebounce(SysFsDriver::DriverId driverId,std::chrono::milliseconds window);
+
+    void forEachKernelEventCountersDo(const std::function<void(const QString& driverName,const KernelEventCounters& counters)>& func) const;
+
 private slots:
 
     void onDataReceived(int socket);
@@ -83,11 +106,47 @@ signals:
     void moduleSubsystem(const LenovoLegionDaemon::SysFsDriverManager::ModuleSubsystemEvent& event);
     void kernelEvent(const LenovoLegionDaemon::SysFsDriver::SubsystemEvent& event);
 
+private:
+
+    /*
+     * Drivers interested in one kind of event and union of the udev properties they read
+     */
+    struct KernelEventRoute {
+        std::vector<SysFsDriver*>                   m_drivers;
+        std::vector<std::pair<QString,QByteArray>>  m_properties;      // Name and its udev key
+    };
+
+    struct KernelEventDebounce {
+        std::chrono::milliseconds                   m_window {0};
+        QTimer*                                     m_timer     = nullptr;
+        std::vector<SysFsDriver::SubsystemEvent>    m_pending;
+        QString                                     m_driverName;
+        KernelEventCounters                         m_counters;
+    };
+
+    /*
+     * Routes of one subsystem, events go to drivers of m_any and of the matching DRIVER and SYSNAME
+     */
+    struct SubsystemRoutes {
+        KernelEventRoute                            m_any;
+        QHash<QString,KernelEventRoute>             m_byDriver;
+        QHash<QString,KernelEventRoute>             m_bySysName;
+    };
+
 private:
 
     void addUdevMonitorFilter(const SysFsDriver::KernelEvent::Filter& filter);
     void reconnectUdevMonitor();
 
+    void buildKernelEventRoutes();
+    static void addKernelEventRoute(KernelEventRoute& route,SysFsDriver* driver);
+
+    void dispatchUdevDevice(struct udev_device *dev);
+    void dispatchKernelEvent(const KernelEventRoute& route,struct udev_device *dev,SysFsDriver::KernelEvent::Event& event);
+    void checkUdevMonitor();
+
+    void flushKernelEvents(SysFsDriver::DriverId driverId);
+
 private:
 
     struct udev         *m_udev;
@@ -96,6 +155,14 @@ private:
     QSocketNotifier     *m_socketNotifier;
 
     std::map<QString,SysFsDriver *> m_drivers;
+
+    /*
+     * Built by initDrivers, udev events are routed by hash lookups instead of scanning all drivers
+     */
+    QHash<QString,SubsystemRoutes>              m_kernelEventRoutes;
+    QHash<QString,std::vector<SysFsDriver*>>    m_moduleRoutes;
+
+    std::array<KernelEventDebounce,SysFsDriver::DRIVER_ID_COUNT> m_kernelEventDebounce;
 };
 
 }
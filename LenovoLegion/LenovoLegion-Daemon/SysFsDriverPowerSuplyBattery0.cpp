@@ -12,7 +12,7 @@
 namespace LenovoLegionDaemon {
 
 
-SysFsDriverPowerSuplyBattery0::SysFsDriverPowerSuplyBattery0(QObject* parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/power_supply/BAT0/",{"power_supply",{}},parrent) {}
+SysFsDriverPowerSuplyBattery0::SysFsDriverPowerSuplyBattery0(QObject* parrent) : SysFsDriver(DRIVER_NAME,"/sys/class/power_supply/BAT0/",{"power_supply",{},{},"BAT0"},parrent) {}
 
 void SysFsDriverPowerSuplyBattery0::init()
 {
@@ -48,9 +48,8 @@ void SysFsDriverPowerSuplyBattery0::handleKernelEvent(const KernelEvent::Event &
         {
             emit kernelEvent({
                 .m_driverName = DRIVER_NAME,
-                .m_action = SubsystemEvent::Action::CHANGED,
-                .m_DriverSpecificEventType = "changed",
-                .m_DriverSpecificEventValue = {}
+                .m_driverId = DRIVER_ID,
+                .m_action = SubsystemEvent::Action::CHANGED
             });
         }
         else
@@ -60,9 +59,8 @@ void SysFsDriverPowerSuplyBattery0::handleKernelEvent(const KernelEvent::Event &
 
             emit kernelEvent({
                 .m_driverName = DRIVER_NAME,
-                .m_action = SubsystemEvent::Action::RELOADED,
-                .m_DriverSpecificEventType = "reloaded",
-                .m_DriverSpecificEventValue = {}
+                .m_driverId = DRIVER_ID,
+                .m_action = SubsystemEvent::Action::RELOADED
             });
         }
     }
@@ -50,6 +50,7 @@ public:
      * Driver name, system driver __ prefix is used to mark  system driver no modprobe loadable
      */
     static constexpr const char* DRIVER_NAME =  "power_supply";
+    static constexpr DriverId    DRIVER_ID   =  DRIVER_ID_POWER_SUPPLY_BATTERY0;
 };
 
 }
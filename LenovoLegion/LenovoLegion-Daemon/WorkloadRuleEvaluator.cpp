@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "WorkloadRuleEvaluator.h"
+
+namespace LenovoLegionDaemon {
+
+WorkloadRuleEvaluator::WorkloadRuleEvaluator(const legion::messages::WorkloadRules &rules) :
+    m_rules(rules),
+    m_signals(0)
+{
+    for(const auto& rule : m_rules.rules())
+    {
+        for(const auto& condition : rule.conditions())
+        {
+            if(legion::messages::WorkloadRules::Condition::Signal_IsValid(condition.signal()))
+            {
+                m_signals |= 1u << condition.signal();
+            }
+        }
+    }
+
+    reset();
+}
+
+void WorkloadRuleEvaluator::reset()
+{
+    m_states.assign(m_rules.rules_size(),RuleState());
+
+    for(int i = 0; i < m_rules.rules_size(); ++i)
+    {
+        m_states[i].m_matched.assign(m_rules.rules(i).conditions_size(),false);
+    }
+
+    m_decided    = false;
+    m_activeRule = -1;
+    m_lastSwitch = {};
+}
+
+bool WorkloadRuleEvaluator::valid(const legion::messages::WorkloadRules &rules)
+{
+    for(const auto& rule : rules.rules())
+    {
+        if(rule.profile().empty())
+        {
+            return false;
+        }
+
+        for(const auto& condition : rule.conditions())
+        {
+            if(!legion::messages::WorkloadRules::Condition::Signal_IsValid(condition.signal()) ||
+               !legion::messages::WorkloadRules::Condition::Comparison_IsValid(condition.comparison()) ||
+               condition.hysteresis() < 0.0)
+            {
+                return false;
+            }
+
+            if(condition.signal() == legion::messages::WorkloadRules::Condition::PROCESS && (condition.process().empty() || condition.process().size() > MAX_PROCESS_NAME))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+std::optional<WorkloadRuleEvaluator::Decision> WorkloadRuleEvaluator::evaluate(const Signals &sampled, Clock::time_point now)
+{
+    int wanted = -1;
+
+    for(int i = 0; i < m_rules.rules_size(); ++i)
+    {
+        const auto& rule  = m_rules.rules(i);
+        RuleState&  state = m_states[i];
+        bool        all   = rule.conditions_size() > 0;
+
+        for(int j = 0; j < rule.conditions_size(); ++j)
+        {
+            state.m_matched[j] = matches(rule.conditions(j),sampled,state.m_matched[j]);
+            all               &= state.m_matched[j];
+        }
+
+        if(all == state.m_active)
+        {
+            state.m_pendingSince.reset();
+        }
+        else
+        {
+            if(!state.m_pendingSince)
+            {
+                state.m_pendingSince = now;
+            }
+
+            const std::chrono::milliseconds delay(state.m_active ? rule.exit_delay_ms() : rule.enter_delay_ms());
+
+            if(now - *state.m_pendingSince >= delay)
+            {
+                state.m_active = all;
+                state.m_pendingSince.reset();
+            }
+        }
+
+        if(wanted < 0 && state.m_active)
+        {
+            wanted = i;
+        }
+    }
+
+    if(m_decided)
+    {
+        if(wanted == m_activeRule)
+        {
+            return {};
+        }
+
+        if(now - m_lastSwitch < std::chrono::milliseconds(m_rules.min_dwell_ms()))
+        {
+            return {};
+        }
+    }
+
+    m_decided    = true;
+    m_activeRule = wanted;
+    m_lastSwitch = now;
+
+    return Decision {wanted,std::string(wanted < 0 ? m_rules.default_profile() : m_rules.rules(wanted).profile())};
+}
+
+bool WorkloadRuleEvaluator::matches(const legion::messages::WorkloadRules::Condition &condition, const Signals &sampled, bool matched)
+{
+    std::optional<double> value;
+
+    switch (condition.signal()) {
+    case legion::messages::WorkloadRules::Condition::PACKAGE_POWER:
+        value = sampled.m_packagePower;
+        break;
+    case legion::messages::WorkloadRules::Condition::CPU_BUSY:
+        value = sampled.m_cpuBusy;
+        break;
+    case legion::messages::WorkloadRules::Condition::ON_AC:
+        if(sampled.m_onAC)
+        {
+            value = *sampled.m_onAC ? 1.0 : 0.0;
+        }
+        break;
+    case legion::messages::WorkloadRules::Condition::PROCESS:
+        value = sampled.m_processes.count(std::string(condition.process())) ? 1.0 : 0.0;
+        break;
+    default:
+        break;
+    }
+
+    /*
+     * Unknown value releases condition
+     */
+    if(!value)
+    {
+        return false;
+    }
+
+    const double release = matched ? condition.hysteresis() : 0.0;
+
+    return condition.comparison() == legion::messages::WorkloadRules::Condition::BELOW ? *value < condition.threshold() + release
+                                                                                      : *value > condition.threshold() - release;
+}
+
+}
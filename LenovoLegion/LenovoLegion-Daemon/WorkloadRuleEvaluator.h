@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "../LenovoLegion-PrepareBuild/WorkloadRules.pb.h"
+
+#include <chrono>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace LenovoLegionDaemon {
+
+/*
+ * Decides which profile workload rules want
+ *
+ * Has no access to hardware, signals and time are passed in, so a recorded or synthetic trace
+ * replayed through evaluate() gives the same switches as the daemon did.
+ *
+ * Condition with a threshold matches once the value crosses the threshold and keeps matching until
+ * the value crosses back over threshold -/+ hysteresis. Rule gets active when all its conditions
+ * match for enter delay and inactive when they do not for exit delay. First active rule wins,
+ * default profile is wanted when none is active. Wanted profile changes at most once per minimal dwell.
+ */
+class WorkloadRuleEvaluator
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    /*
+     * Kernel truncates comm to TASK_COMM_LEN - 1 characters, longer process names never match
+     */
+    static constexpr size_t MAX_PROCESS_NAME = 15;
+
+    struct Signals {
+        std::optional<double>   m_packagePower;     // W
+        std::optional<double>   m_cpuBusy;          // Percent
+        std::optional<bool>     m_onAC;
+        std::set<std::string>   m_processes;        // comm of running processes
+    };
+
+    struct Decision {
+        int                     m_rule;             // -1 for default profile
+        std::string             m_profile;
+    };
+
+public:
+
+    explicit WorkloadRuleEvaluator(const legion::messages::WorkloadRules& rules = {});
+
+    /*
+     * Returns decision when wanted profile changes, first call always decides
+     */
+    std::optional<Decision> evaluate(const Signals& sampled,Clock::time_point now);
+
+    /*
+     * Every rule names a profile, signals and comparisons of conditions are known, process names fit comm
+     */
+    static bool valid(const legion::messages::WorkloadRules& rules);
+
+    /*
+     * Forgets state, next evaluate() decides again
+     */
+    void reset();
+
+    const legion::messages::WorkloadRules& rules()       const { return m_rules; }
+
+    /*
+     * Some condition reads signal, others do not have to be sampled
+     */
+    bool                                   uses(legion::messages::WorkloadRules::Condition::Signal signal) const { return m_signals & (1u << signal); }
+
+    /*
+     * Rule decided last, -1 for default profile
+     */
+    int                                    activeRule()  const { return m_activeRule; }
+
+private:
+
+    struct RuleState {
+        std::vector<bool>                   m_matched;          // Condition latches
+        bool                                m_active  = false;
+        std::optional<Clock::time_point>    m_pendingSince;     // Conditions disagree with m_active since
+    };
+
+private:
+
+    static bool matches(const legion::messages::WorkloadRules::Condition& condition,const Signals& sampled,bool matched);
+
+private:
+
+    legion::messages::WorkloadRules     m_rules;
+    unsigned                            m_signals;          // Bit per used signal
+
+    std::vector<RuleState>              m_states;
+    bool                                m_decided;
+    int                                 m_activeRule;
+    Clock::time_point                   m_lastSwitch;
+};
+
+}
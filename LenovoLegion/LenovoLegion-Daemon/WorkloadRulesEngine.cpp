@@ -0,0 +1,349 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+
+#include "WorkloadRulesEngine.h"
+#include "DataProviderManager.h"
+#include "SysFsDriverManager.h"
+#include "SysFsDriverIntelPowercapRapl.h"
+#include "SysFsDataProviderBattery.h"
+#include "ProfileStore.h"
+#include "Settings.h"
+
+#include "../LenovoLegion-PrepareBuild/MessageRegistry.pb.h"
+#include "../LenovoLegion-PrepareBuild/Battery.pb.h"
+
+#include <Core/LoggerHolder.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+
+#include <algorithm>
+#include <utility>
+
+namespace LenovoLegionDaemon {
+
+WorkloadRulesEngine::WorkloadRulesEngine(SysFsDriverManager *sysFsDriverManager, DataProviderManager *dataProviderManager, QObject *parent) :
+    QObject(parent),
+    m_sysFsDriverManager(sysFsDriverManager),
+    m_dataProviderManager(dataProviderManager),
+    m_timer(new QTimer(this)),
+    m_switches(0),
+    m_totalTicks(0)
+{
+    connect(m_timer,&QTimer::timeout,this,&WorkloadRulesEngine::sample);
+}
+
+void WorkloadRulesEngine::start()
+{
+    legion::messages::WorkloadRules rules;
+
+    {
+        SettingsStore::Transaction transaction;
+        const QByteArray           data = SettingsStore::getInstance().data(legion::messages::DataType::WORKLOAD_RULES);
+
+        if(!rules.ParseFromArray(data.data(),data.size()) || !WorkloadRuleEvaluator::valid(rules))
+        {
+            LOG_W("WorkloadRulesEngine: stored rules are invalid, starting without rules");
+            rules.Clear();
+        }
+    }
+
+    m_evaluator = WorkloadRuleEvaluator(rules);
+    restart();
+}
+
+void WorkloadRulesEngine::stop()
+{
+    m_timer->stop();
+}
+
+void WorkloadRulesEngine::setRules(const legion::messages::WorkloadRules &rules)
+{
+    legion::messages::WorkloadRules stored(rules);
+
+    if(!WorkloadRuleEvaluator::valid(rules))
+    {
+        THROW_EXCEPTION(exception_T, ERROR_CODES::INVALID_RULES, "Invalid workload rules !");
+    }
+
+    {
+        SettingsStore::Transaction transaction;
+
+        if(!SettingsStore::getInstance().setMessage(legion::messages::DataType::WORKLOAD_RULES,stored))
+        {
+            THROW_EXCEPTION(exception_T, ERROR_CODES::SERIALIZE_ERROR, "Serialize of data message error !");
+        }
+    }
+
+    m_evaluator = WorkloadRuleEvaluator(rules);
+    restart();
+}
+
+legion::messages::WorkloadRulesStatus WorkloadRulesEngine::status() const
+{
+    legion::messages::WorkloadRulesStatus status;
+
+    *status.mutable_rules() = m_evaluator.rules();
+
+    if(m_evaluator.activeRule() >= 0)
+    {
+        status.set_active_rule(m_evaluator.rules().rules(m_evaluator.activeRule()).name());
+    }
+    status.set_active_profile(m_activeProfile.toStdString());
+    status.set_switches(m_switches);
+
+    if(m_signals.m_packagePower) status.mutable_sampled()->set_package_power(*m_signals.m_packagePower);
+    if(m_signals.m_cpuBusy)      status.mutable_sampled()->set_cpu_busy(*m_signals.m_cpuBusy);
+    if(m_signals.m_onAC)         status.mutable_sampled()->set_on_ac(*m_signals.m_onAC);
+
+    return status;
+}
+
+void WorkloadRulesEngine::restart()
+{
+    const legion::messages::WorkloadRules& rules = m_evaluator.rules();
+
+    m_timer->stop();
+
+    m_evaluator.reset();
+    m_signals = {};
+    m_energy.reset();
+    m_busyTicks.reset();
+    m_activeProfile.clear();
+
+    if(!rules.enabled() || (rules.rules_size() == 0 && rules.default_profile().empty()))
+    {
+        LOG_D("WorkloadRulesEngine: no enabled rules, not sampling");
+        return;
+    }
+
+    const std::chrono::milliseconds interval = rules.sample_interval_ms() == 0 ? DEFAULT_SAMPLE_INTERVAL
+                                                                               : std::max(MIN_SAMPLE_INTERVAL,std::chrono::milliseconds(rules.sample_interval_ms()));
+
+    LOG_I(QString("WorkloadRulesEngine: sampling %1 rules every %2 ms").arg(rules.rules_size()).arg(interval.count()));
+
+    m_timer->start(interval);
+}
+
+void WorkloadRulesEngine::sample()
+{
+    m_signals = readSignals();
+
+    const std::optional<WorkloadRuleEvaluator::Decision> decision = m_evaluator.evaluate(m_signals,WorkloadRuleEvaluator::Clock::now());
+
+    if(!decision)
+    {
+        return;
+    }
+
+    const QString profile = QString::fromStdString(decision->m_profile);
+    const QString rule    = decision->m_rule < 0 ? QString("default") : QString::fromStdString(std::string(m_evaluator.rules().rules(decision->m_rule).name()));
+
+    if(profile.isEmpty() || profile == m_activeProfile)
+    {
+        m_activeProfile = profile;
+        return;
+    }
+
+    try {
+        const ProfileStore::ApplyResult result = ProfileStore::getInstance().apply(m_dataProviderManager,profile);
+
+        switch (result.m_status) {
+        case legion::messages::ProfileCommandResult::OK:
+            LOG_I(QString("WorkloadRulesEngine: rule ") + rule + " applied profile " + profile + QString(", %1 data providers written").arg(result.m_written.size()));
+            m_activeProfile = profile;
+            ++m_switches;
+            break;
+        case legion::messages::ProfileCommandResult::NOT_FOUND:
+            LOG_W(QString("WorkloadRulesEngine: rule ") + rule + " wants unknown profile " + profile);
+            break;
+        default:
+            LOG_E(QString("WorkloadRulesEngine: rule ") + rule + " failed to apply profile " + profile);
+            break;
+        }
+    }
+    catch(const bj::framework::exception::Exception& ex)
+    {
+        LOG_E(QString("WorkloadRulesEngine: applying profile ") + profile + " failed, " + bj::framework::exception::ExceptionBuilder::print(ex).c_str());
+    }
+}
+
+WorkloadRuleEvaluator::Signals WorkloadRulesEngine::readSignals()
+{
+    WorkloadRuleEvaluator::Signals sampled;
+
+    if(m_evaluator.uses(legion::messages::WorkloadRules::Condition::PACKAGE_POWER))
+    {
+        sampled.m_packagePower = readPackagePower();
+    }
+
+    if(m_evaluator.uses(legion::messages::WorkloadRules::Condition::CPU_BUSY))
+    {
+        sampled.m_cpuBusy = readCPUBusy();
+    }
+
+    if(m_evaluator.uses(legion::messages::WorkloadRules::Condition::ON_AC))
+    {
+        sampled.m_onAC = readOnAC();
+    }
+
+    if(m_evaluator.uses(legion::messages::WorkloadRules::Condition::PROCESS))
+    {
+        readProcesses(sampled.m_processes);
+    }
+
+    return sampled;
+}
+
+std::optional<double> WorkloadRulesEngine::readPackagePower()
+{
+    QByteArray  data;
+    bool        ok  = false;
+
+    /*
+     * Only the energy counter is read, not the whole hardware monitor
+     */
+    try {
+        QFile file(SysFsDriverIntelPowercapRapl::IntelPowercapRapl(m_sysFsDriverManager->getDriverDesriptor(SysFsDriverIntelPowercapRapl::DRIVER_NAME)).m_powercapCPUEnergy);
+
+        if(file.open(QIODevice::ReadOnly))
+        {
+            data = file.readAll();
+        }
+    } catch(...)
+    {
+        LOG_T("WorkloadRulesEngine: RAPL not available");
+    }
+
+    const quint64                                   energy = data.trimmed().toULongLong(&ok);
+    const WorkloadRuleEvaluator::Clock::time_point  now    = WorkloadRuleEvaluator::Clock::now();
+
+    if(!ok)
+    {
+        m_energy.reset();
+        return std::nullopt;
+    }
+
+    const std::optional<quint64>   previous = std::exchange(m_energy,energy);
+    const auto                     elapsed  = std::chrono::duration_cast<std::chrono::microseconds>(now - std::exchange(m_energyTime,now));
+
+    /*
+     * First sample or counter wrapped
+     */
+    if(!previous || energy < *previous || elapsed.count() <= 0)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<double>(energy - *previous) / static_cast<double>(elapsed.count());   // uJ / us = W
+}
+
+std::optional<double> WorkloadRulesEngine::readCPUBusy()
+{
+    QFile stat("/proc/stat");
+
+    if(!stat.open(QIODevice::ReadOnly))
+    {
+        m_busyTicks.reset();
+        return std::nullopt;
+    }
+
+    /*
+     * cpu  user nice system idle iowait irq softirq steal guest guest_nice, guests are in user already
+     */
+    const QList<QByteArray> fields = stat.readLine().simplified().split(' ');
+
+    if(fields.size() < 9 || fields.at(0) != "cpu")
+    {
+        m_busyTicks.reset();
+        return std::nullopt;
+    }
+
+    quint64 total = 0;
+
+    for(int i = 1; i <= 8; ++i)
+    {
+        total += fields.at(i).toULongLong();
+    }
+
+    const quint64                   busy     = total - fields.at(4).toULongLong() - fields.at(5).toULongLong();
+    const std::optional<quint64>    previous      = std::exchange(m_busyTicks,busy);
+    const quint64                   previousTotal = std::exchange(m_totalTicks,total);
+
+    /*
+     * First sample or nothing elapsed
+     */
+    if(!previous || busy < *previous || total <= previousTotal)
+    {
+        return std::nullopt;
+    }
+
+    return 100.0 * static_cast<double>(busy - *previous) / static_cast<double>(total - previousTotal);
+}
+
+std::optional<bool> WorkloadRulesEngine::readOnAC() const
+{
+    const std::optional<legion::messages::Battery> battery = readProvider<legion::messages::Battery>(SysFsDataProviderBattery::dataType);
+
+    if(!battery || battery->current_charge_mode_value() == legion::messages::Battery::POWER_CHARGE_MODE_UNKNOWN)
+    {
+        return std::nullopt;
+    }
+
+    return battery->current_charge_mode_value() == legion::messages::Battery::POWER_CHARGE_MODE_AC;
+}
+
+void WorkloadRulesEngine::readProcesses(std::set<std::string> &processes)
+{
+    const QStringList pids = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+
+    for(const QString& pid : pids)
+    {
+        bool isPid = false;
+
+        pid.toULong(&isPid);
+        if(!isPid)
+        {
+            continue;
+        }
+
+        /*
+         * Process may exit between listing and reading
+         */
+        QFile comm(QString("/proc/%1/comm").arg(pid));
+        if(comm.open(QIODevice::ReadOnly))
+        {
+            processes.insert(comm.readAll().trimmed().toStdString());
+        }
+    }
+}
+
+template<class T>
+std::optional<T> WorkloadRulesEngine::readProvider(quint8 dataType) const
+{
+    T message;
+
+    try {
+        const QByteArray data = m_dataProviderManager->getDataProvider(dataType).serializeAndGetData();
+
+        if(!message.ParseFromArray(data.data(),data.size()))
+        {
+            LOG_W(QString(__PRETTY_FUNCTION__) + " - Parse of data message error, data type " + QString::number(dataType));
+            return std::nullopt;
+        }
+    } catch(...)
+    {
+        LOG_D(QString(__PRETTY_FUNCTION__) + " - Data provider not available, data type " + QString::number(dataType));
+        return std::nullopt;
+    }
+
+    return message;
+}
+
+}
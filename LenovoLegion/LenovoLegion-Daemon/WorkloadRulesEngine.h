@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Copyright Jaroslav Bolek 2025
+ *
+ * Author(s):
+ *   Jaroslav Bolek <jaroslav.bolek@gmail.com>
+ */
+#pragma once
+
+#include "WorkloadRuleEvaluator.h"
+
+#include <Core/ExceptionBuilder.h>
+
+#include "../LenovoLegion-PrepareBuild/WorkloadRules.pb.h"
+
+#include <QObject>
+#include <QString>
+
+#include <chrono>
+#include <optional>
+
+class QTimer;
+
+namespace LenovoLegionDaemon {
+
+class DataProviderManager;
+class SysFsDriverManager;
+
+/*
+ * Switches profiles by workload
+ *
+ * Samples signals the rules use from RAPL, data providers and /proc on the main loop, passes them
+ * to the evaluator and applies the profile it decides through the profile store. Package power and
+ * CPU busy are deltas over the engine's own sample interval, independent of other samplers. Rules
+ * are kept in settings store under WORKLOAD_RULES data type.
+ */
+class WorkloadRulesEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    DEFINE_EXCEPTION(WorkloadRulesEngine);
+
+    enum ERROR_CODES : int {
+        INVALID_RULES   = -1,
+        SERIALIZE_ERROR = -2
+    };
+
+    static constexpr std::chrono::milliseconds  DEFAULT_SAMPLE_INTERVAL {2000};
+    static constexpr std::chrono::milliseconds  MIN_SAMPLE_INTERVAL     {250};
+
+public:
+
+    WorkloadRulesEngine(SysFsDriverManager* sysFsDriverManager,DataProviderManager* dataProviderManager,QObject* parent);
+    ~WorkloadRulesEngine() override = default;
+
+    /*
+     * Loads rules from settings store and starts sampling when they are enabled
+     */
+    void start();
+    void stop();
+
+    /*
+     * Stores rules and starts over with them
+     */
+    void setRules(const legion::messages::WorkloadRules& rules);
+
+    legion::messages::WorkloadRulesStatus status() const;
+
+private slots:
+
+    void sample();
+
+private:
+
+    void restart();
+
+    WorkloadRuleEvaluator::Signals readSignals();
+
+    std::optional<double>   readPackagePower();
+    std::optional<double>   readCPUBusy();
+    std::optional<bool>     readOnAC() const;
+    static void             readProcesses(std::set<std::string>& processes);
+
+    template<class T>
+    std::optional<T> readProvider(quint8 dataType) const;
+
+private:
+
+    SysFsDriverManager*                                 m_sysFsDriverManager;
+    DataProviderManager*                                m_dataProviderManager;
+    QTimer*                                             m_timer;
+
+    WorkloadRuleEvaluator                               m_evaluator;
+    WorkloadRuleEvaluator::Signals                      m_signals;
+    QString                                             m_activeProfile;
+    quint64                                             m_switches;
+
+    /*
+     * Last RAPL package energy, power is computed from two samples
+     */
+    std::optional<quint64>                              m_energy;
+    WorkloadRuleEvaluator::Clock::time_point            m_energyTime;
+
+    /*
+     * Last busy and total ticks of all CPUs from /proc/stat
+     */
+    std::optional<quint64>                              m_busyTicks;
+    quint64                                             m_totalTicks;
+};
+
+}
@@ -28,6 +28,10 @@ DISTFILES += \
     Other.proto \
     PowerProfile.proto \
     DaemonSettings.proto \
+    SettingsSnapshot.proto \
+    Profiles.proto \
+    WorkloadRules.proto \
+    CPUPolicy.proto \
     RGBController.proto
 
 for (PFILE, DISTFILES) {
@@ -4,10 +4,12 @@ SUBDIRS +=                          \
     LenovoLegion-PrepareBuild       \
     BJLibs                          \
     LenovoLegion-Daemon             \
-    LenovoLegion-Application
+    LenovoLegion-Application        \
+    LenovoLegion-Benchmark
 
 LenovoLegion-Application.depends = LenovoLegion-PrepareBuild BJLibs
 LenovoLegion-Daemon.depends = LenovoLegion-PrepareBuild BJLibs
+LenovoLegion-Benchmark.depends = LenovoLegion-PrepareBuild BJLibs
 
 DISTFILES +=     \
     .qmake.conf  \